@@ -38,6 +38,44 @@ void TfLiteClassificationResultDelete(
   delete classification_result;
 }
 
+TfLiteClassificationResultBuffer TfLiteClassificationResultBufferCreate() {
+  TfLiteClassificationResultBuffer buffer;
+  buffer.result.size = 0;
+  buffer.result.classifications = nullptr;
+  buffer.classifications = nullptr;
+  buffer.classifications_capacity = 0;
+  buffer.categories = nullptr;
+  buffer.categories_capacity = 0;
+  return buffer;
+}
+
+void TfLiteClassificationResultBufferReserve(
+    TfLiteClassificationResultBuffer* buffer, int num_heads,
+    int num_categories) {
+  // The previous results are discarded rather than copied, so the arrays are
+  // simply replaced.
+  if (num_heads > buffer->classifications_capacity) {
+    delete[] buffer->classifications;
+    buffer->classifications = new TfLiteClassifications[num_heads];
+    buffer->classifications_capacity = num_heads;
+    buffer->result.size = 0;
+  }
+  if (num_categories > buffer->categories_capacity) {
+    delete[] buffer->categories;
+    buffer->categories = new TfLiteCategory[num_categories];
+    buffer->categories_capacity = num_categories;
+    buffer->result.size = 0;
+  }
+  buffer->result.classifications = buffer->classifications;
+}
+
+void TfLiteClassificationResultBufferClear(
+    TfLiteClassificationResultBuffer* buffer) {
+  delete[] buffer->classifications;
+  delete[] buffer->categories;
+  *buffer = TfLiteClassificationResultBufferCreate();
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -56,6 +56,48 @@ typedef struct TfLiteClassificationResult {
 void TfLiteClassificationResultDelete(
     TfLiteClassificationResult* classification_result);
 
+// Caller-owned storage for classification results, reusable across calls, e.g.
+// to TfLiteImageClassifierClassifyWithRoiIntoBuffer().
+//
+// Unlike the results returned by the other classification functions, which
+// allocate arrays and copy the labels on every call, results written into a
+// buffer only allocate when the storage below is too small, and their `label`
+// and `display_name` point to strings owned by the classifier. They remain
+// valid until the next call using the same buffer, or until the classifier is
+// deleted, and must not be freed with TfLiteClassificationResultDelete() nor
+// TfLiteCategoryDelete().
+//
+// Create the buffer with TfLiteClassificationResultBufferCreate(), and release
+// its storage with TfLiteClassificationResultBufferClear() once done. Its
+// fields are managed by the library and must not be modified.
+typedef struct TfLiteClassificationResultBuffer {
+  // The results written by the last call, pointing into the storage below.
+  TfLiteClassificationResult result;
+  // Storage for the per-head results.
+  TfLiteClassifications* classifications;
+  int classifications_capacity;
+  // Storage for the categories of all the heads.
+  TfLiteCategory* categories;
+  int categories_capacity;
+} TfLiteClassificationResultBuffer;
+
+// Creates an empty TfLiteClassificationResultBuffer: all sizes and capacities
+// are 0, and all pointers are NULL.
+TfLiteClassificationResultBuffer TfLiteClassificationResultBufferCreate();
+
+// Grows the storage of `buffer`, if needed, so that it can hold the results of
+// `num_heads` heads with `num_categories` categories in total. Called by the
+// functions writing into the buffer, but can also be called beforehand so that
+// even the first of these calls doesn't allocate. Invalidates the results
+// held by the buffer if it grows.
+void TfLiteClassificationResultBufferReserve(
+    TfLiteClassificationResultBuffer* buffer, int num_heads,
+    int num_categories);
+
+// Releases the storage of `buffer`, leaving it empty and still usable.
+void TfLiteClassificationResultBufferClear(
+    TfLiteClassificationResultBuffer* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -36,6 +36,52 @@ void TfLiteDetectionResultDelete(TfLiteDetectionResult* detection_result) {
   delete detection_result;
 }
 
+TfLiteDetectionResultBuffer TfLiteDetectionResultBufferCreate() {
+  TfLiteDetectionResultBuffer buffer;
+  buffer.result.size = 0;
+  buffer.result.detections = nullptr;
+  buffer.detections = nullptr;
+  buffer.detections_capacity = 0;
+  buffer.categories = nullptr;
+  buffer.categories_capacity = 0;
+  buffer.strings = nullptr;
+  buffer.strings_capacity = 0;
+  return buffer;
+}
+
+void TfLiteDetectionResultBufferReserve(TfLiteDetectionResultBuffer* buffer,
+                                        int num_detections, int num_categories,
+                                        int strings_size) {
+  // The previous results are discarded rather than copied, so the arrays are
+  // simply replaced.
+  if (num_detections > buffer->detections_capacity) {
+    delete[] buffer->detections;
+    buffer->detections = new TfLiteDetection[num_detections];
+    buffer->detections_capacity = num_detections;
+    buffer->result.size = 0;
+  }
+  if (num_categories > buffer->categories_capacity) {
+    delete[] buffer->categories;
+    buffer->categories = new TfLiteCategory[num_categories];
+    buffer->categories_capacity = num_categories;
+    buffer->result.size = 0;
+  }
+  if (strings_size > buffer->strings_capacity) {
+    delete[] buffer->strings;
+    buffer->strings = new char[strings_size];
+    buffer->strings_capacity = strings_size;
+    buffer->result.size = 0;
+  }
+  buffer->result.detections = buffer->detections;
+}
+
+void TfLiteDetectionResultBufferClear(TfLiteDetectionResultBuffer* buffer) {
+  delete[] buffer->detections;
+  delete[] buffer->categories;
+  delete[] buffer->strings;
+  *buffer = TfLiteDetectionResultBufferCreate();
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -58,6 +58,51 @@ typedef struct TfLiteDetectionResult {
 // Frees up the DetectionResult Structure.
 void TfLiteDetectionResultDelete(TfLiteDetectionResult* detection_result);
 
+// Caller-owned storage for detection results, reusable across calls to
+// TfLiteObjectDetectorDetectIntoBuffer().
+//
+// Unlike the results returned by TfLiteObjectDetectorDetect(), which allocate
+// arrays and copy the labels on every call, results written into a buffer only
+// allocate when the storage below is too small: the labels and display names
+// are copied into `strings`. The results remain valid until the next call
+// using the same buffer, and must not be freed with
+// TfLiteDetectionResultDelete() nor TfLiteCategoryDelete().
+//
+// Create the buffer with TfLiteDetectionResultBufferCreate(), and release its
+// storage with TfLiteDetectionResultBufferClear() once done. Its fields are
+// managed by the library and must not be modified.
+typedef struct TfLiteDetectionResultBuffer {
+  // The results written by the last call, pointing into the storage below.
+  TfLiteDetectionResult result;
+  // Storage for the detections.
+  TfLiteDetection* detections;
+  int detections_capacity;
+  // Storage for the categories of all the detections.
+  TfLiteCategory* categories;
+  int categories_capacity;
+  // Storage for the null-terminated labels and display names of all the
+  // categories.
+  char* strings;
+  int strings_capacity;
+} TfLiteDetectionResultBuffer;
+
+// Creates an empty TfLiteDetectionResultBuffer: all sizes and capacities are 0,
+// and all pointers are NULL.
+TfLiteDetectionResultBuffer TfLiteDetectionResultBufferCreate();
+
+// Grows the storage of `buffer`, if needed, so that it can hold
+// `num_detections` detections with `num_categories` categories and
+// `strings_size` bytes of strings (terminators included) in total. Called by
+// the functions writing into the buffer, but can also be called beforehand so
+// that even the first of these calls doesn't allocate. Invalidates the results
+// held by the buffer if it grows.
+void TfLiteDetectionResultBufferReserve(TfLiteDetectionResultBuffer* buffer,
+                                        int num_detections, int num_categories,
+                                        int strings_size);
+
+// Releases the storage of `buffer`, leaving it empty and still usable.
+void TfLiteDetectionResultBufferClear(TfLiteDetectionResultBuffer* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/c/task/text/utils/categories_utils.h"
 #include "tensorflow_lite_support/cc/task/core/category.h"
 #include "tensorflow_lite_support/cc/task/text/bert_nl_classifier.h"
 #include "tensorflow_lite_support/cc/task/text/proto/bert_nl_classifier_options_proto_inc.h"
@@ -82,6 +83,16 @@ Categories* TfLiteBertNLClassifierClassify(
   return c_categories;
 }
 
+const Categories* TfLiteBertNLClassifierClassifyIntoBuffer(
+    const TfLiteBertNLClassifier* classifier, const char* text,
+    NLClassifierCategoriesBuffer* buffer) {
+  if (classifier == nullptr || buffer == nullptr) {
+    return nullptr;
+  }
+  return tflite::task::text::FillCategoriesBuffer(
+      classifier->impl->Classify(absl::string_view(text).data()), buffer);
+}
+
 void TfLiteBertNLClassifierDelete(TfLiteBertNLClassifier* classifier) {
   delete classifier;
 }
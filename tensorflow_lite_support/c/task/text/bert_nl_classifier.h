@@ -59,6 +59,14 @@ TfLiteBertNLClassifier* TfLiteBertNLClassifierCreate(const char* model_path);
 Categories* TfLiteBertNLClassifierClassify(
     const TfLiteBertNLClassifier* classifier, const char* text);
 
+// Same as TfLiteBertNLClassifierClassify(), except that the categories are
+// written into the caller-owned `buffer` instead of being allocated, as with
+// TfLiteNLClassifierClassifyIntoBuffer(). Returns a pointer to
+// `buffer->result`, or NULL if `classifier` or `buffer` is NULL.
+const Categories* TfLiteBertNLClassifierClassifyIntoBuffer(
+    const TfLiteBertNLClassifier* classifier, const char* text,
+    NLClassifierCategoriesBuffer* buffer);
+
 void TfLiteBertNLClassifierDelete(TfLiteBertNLClassifier* classifier);
 
 #ifdef __cplusplus
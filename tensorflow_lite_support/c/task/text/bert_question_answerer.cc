@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow_lite_support/c/task/text/bert_question_answerer.h"
 
+#include <cstring>
 #include <memory>
+#include <string>
 
 #include "tensorflow_lite_support/cc/task/text/bert_question_answerer.h"
 #include "tensorflow_lite_support/cc/task/text/question_answerer.h"
@@ -83,6 +85,72 @@ void TfLiteQaAnswersDelete(TfLiteQaAnswers* qa_answers) {
   delete qa_answers;
 }
 
+TfLiteQaAnswersBuffer TfLiteQaAnswersBufferCreate() {
+  TfLiteQaAnswersBuffer buffer;
+  buffer.result.size = 0;
+  buffer.result.answers = nullptr;
+  buffer.answers = nullptr;
+  buffer.answers_capacity = 0;
+  buffer.strings = nullptr;
+  buffer.strings_capacity = 0;
+  return buffer;
+}
+
+void TfLiteQaAnswersBufferReserve(TfLiteQaAnswersBuffer* buffer,
+                                  int num_answers, int strings_size) {
+  // The previous answers are discarded rather than copied, so the arrays are
+  // simply replaced.
+  if (num_answers > buffer->answers_capacity) {
+    delete[] buffer->answers;
+    buffer->answers = new TfLiteQaAnswer[num_answers];
+    buffer->answers_capacity = num_answers;
+    buffer->result.size = 0;
+  }
+  if (strings_size > buffer->strings_capacity) {
+    delete[] buffer->strings;
+    buffer->strings = new char[strings_size];
+    buffer->strings_capacity = strings_size;
+    buffer->result.size = 0;
+  }
+  buffer->result.answers = buffer->answers;
+}
+
+void TfLiteQaAnswersBufferClear(TfLiteQaAnswersBuffer* buffer) {
+  delete[] buffer->answers;
+  delete[] buffer->strings;
+  *buffer = TfLiteQaAnswersBufferCreate();
+}
+
+const TfLiteQaAnswers* TfLiteBertQuestionAnswererAnswerIntoBuffer(
+    const TfLiteBertQuestionAnswerer* question_answerer, const char* context,
+    const char* question, TfLiteQaAnswersBuffer* buffer) {
+  if (question_answerer == nullptr || buffer == nullptr) {
+    return nullptr;
+  }
+  std::vector<QaAnswerCpp> answers = question_answerer->impl->Answer(
+      absl::string_view(context).data(), absl::string_view(question).data());
+
+  // Sizes the storage before filling it, as growing it discards its contents.
+  int strings_size = 0;
+  for (const QaAnswerCpp& answer : answers) {
+    strings_size += answer.text.size() + 1;
+  }
+  TfLiteQaAnswersBufferReserve(buffer, answers.size(), strings_size);
+
+  char* strings = buffer->strings;
+  for (size_t i = 0; i < answers.size(); ++i) {
+    const std::string& text = answers[i].text;
+    std::memcpy(strings, text.c_str(), text.size() + 1);
+    buffer->answers[i].start = answers[i].pos.start;
+    buffer->answers[i].end = answers[i].pos.end;
+    buffer->answers[i].logit = answers[i].pos.logit;
+    buffer->answers[i].text = strings;
+    strings += text.size() + 1;
+  }
+  buffer->result.size = answers.size();
+  return &buffer->result;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -61,6 +61,52 @@ TfLiteQaAnswers* TfLiteBertQuestionAnswererAnswer(
     const TfLiteBertQuestionAnswerer* question_answerer, const char* context,
     const char* question);
 
+// Caller-owned storage for answers, reusable across calls to
+// TfLiteBertQuestionAnswererAnswerIntoBuffer().
+//
+// Unlike the answers returned by TfLiteBertQuestionAnswererAnswer(), which
+// allocate an array and copy the texts on every call, answers written into a
+// buffer only allocate when the storage below is too small: the texts are
+// copied into `strings`. The answers remain valid until the next call using
+// the same buffer, and must not be freed with TfLiteQaAnswersDelete().
+//
+// Create the buffer with TfLiteQaAnswersBufferCreate(), and release its
+// storage with TfLiteQaAnswersBufferClear() once done. Its fields are managed
+// by the library and must not be modified.
+typedef struct TfLiteQaAnswersBuffer {
+  // The answers written by the last call, pointing into the storage below.
+  TfLiteQaAnswers result;
+  // Storage for the answers.
+  TfLiteQaAnswer* answers;
+  int answers_capacity;
+  // Storage for the null-terminated texts of the answers.
+  char* strings;
+  int strings_capacity;
+} TfLiteQaAnswersBuffer;
+
+// Creates an empty TfLiteQaAnswersBuffer: all sizes and capacities are 0, and
+// all pointers are NULL.
+TfLiteQaAnswersBuffer TfLiteQaAnswersBufferCreate();
+
+// Grows the storage of `buffer`, if needed, so that it can hold `num_answers`
+// answers and `strings_size` bytes of texts (terminators included). Called by
+// TfLiteBertQuestionAnswererAnswerIntoBuffer(), but can also be called
+// beforehand so that even its first call doesn't allocate. Invalidates the
+// answers held by the buffer if it grows.
+void TfLiteQaAnswersBufferReserve(TfLiteQaAnswersBuffer* buffer,
+                                  int num_answers, int strings_size);
+
+// Releases the storage of `buffer`, leaving it empty and still usable.
+void TfLiteQaAnswersBufferClear(TfLiteQaAnswersBuffer* buffer);
+
+// Same as TfLiteBertQuestionAnswererAnswer(), except that the answers are
+// written into the caller-owned `buffer` instead of being allocated: see
+// TfLiteQaAnswersBuffer. Returns a pointer to `buffer->result`, or NULL if
+// `question_answerer` or `buffer` is NULL.
+const TfLiteQaAnswers* TfLiteBertQuestionAnswererAnswerIntoBuffer(
+    const TfLiteBertQuestionAnswerer* question_answerer, const char* context,
+    const char* question, TfLiteQaAnswersBuffer* buffer);
+
 void TfLiteBertQuestionAnswererDelete(
     TfLiteBertQuestionAnswerer* bert_question_answerer);
 
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/c/task/text/utils/categories_utils.h"
 #include "tensorflow_lite_support/cc/task/core/category.h"
 #include "tensorflow_lite_support/cc/task/text/nlclassifier/nl_classifier.h"
 
@@ -84,6 +85,16 @@ Categories* TfLiteNLClassifierClassify(const TfLiteNLClassifier* classifier,
   return c_categories;
 }
 
+const Categories* TfLiteNLClassifierClassifyIntoBuffer(
+    const TfLiteNLClassifier* classifier, const char* text,
+    NLClassifierCategoriesBuffer* buffer) {
+  if (classifier == nullptr || buffer == nullptr) {
+    return nullptr;
+  }
+  return tflite::task::text::FillCategoriesBuffer(
+      classifier->impl->Classify(absl::string_view(text).data()), buffer);
+}
+
 void TfLiteNLClassifierDelete(TfLiteNLClassifier* classifier) {
   delete classifier;
 }
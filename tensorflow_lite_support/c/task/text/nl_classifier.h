@@ -54,6 +54,24 @@ TfLiteNLClassifier* TfLiteNLClassifierCreateFromOptions(
 Categories* TfLiteNLClassifierClassify(const TfLiteNLClassifier* classifier,
                                        const char* text);
 
+// Same as TfLiteNLClassifierClassify(), except that the categories are written
+// into the caller-owned `buffer` instead of being allocated: see
+// NLClassifierCategoriesBuffer. This avoids the per-call allocations of the
+// results, e.g. for callers classifying many texts in a row:
+//
+// NLClassifierCategoriesBuffer buffer = NLClassifierCategoriesBufferCreate();
+// For each text:
+//   const Categories* categories =
+//       TfLiteNLClassifierClassifyIntoBuffer(classifier, text, &buffer);
+//   if (categories) { Use the categories. }
+// NLClassifierCategoriesBufferClear(&buffer);
+//
+// Returns a pointer to `buffer->result`, or NULL if `classifier` or `buffer`
+// is NULL.
+const Categories* TfLiteNLClassifierClassifyIntoBuffer(
+    const TfLiteNLClassifier* classifier, const char* text,
+    NLClassifierCategoriesBuffer* buffer);
+
 void TfLiteNLClassifierDelete(TfLiteNLClassifier* classifier);
 
 #ifdef __cplusplus
@@ -31,6 +31,42 @@ void NLClassifierCategoriesDelete(Categories* categories) {
   delete categories;
 }
 
+NLClassifierCategoriesBuffer NLClassifierCategoriesBufferCreate() {
+  NLClassifierCategoriesBuffer buffer;
+  buffer.result.size = 0;
+  buffer.result.categories = nullptr;
+  buffer.categories = nullptr;
+  buffer.categories_capacity = 0;
+  buffer.strings = nullptr;
+  buffer.strings_capacity = 0;
+  return buffer;
+}
+
+void NLClassifierCategoriesBufferReserve(NLClassifierCategoriesBuffer* buffer,
+                                         int num_categories, int strings_size) {
+  // The previous categories are discarded rather than copied, so the arrays
+  // are simply replaced.
+  if (num_categories > buffer->categories_capacity) {
+    delete[] buffer->categories;
+    buffer->categories = new Category[num_categories];
+    buffer->categories_capacity = num_categories;
+    buffer->result.size = 0;
+  }
+  if (strings_size > buffer->strings_capacity) {
+    delete[] buffer->strings;
+    buffer->strings = new char[strings_size];
+    buffer->strings_capacity = strings_size;
+    buffer->result.size = 0;
+  }
+  buffer->result.categories = buffer->categories;
+}
+
+void NLClassifierCategoriesBufferClear(NLClassifierCategoriesBuffer* buffer) {
+  delete[] buffer->categories;
+  delete[] buffer->strings;
+  *buffer = NLClassifierCategoriesBufferCreate();
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -36,6 +36,45 @@ typedef struct Categories {
 
 void NLClassifierCategoriesDelete(Categories* categories);
 
+// Caller-owned storage for categories, reusable across calls to
+// TfLiteNLClassifierClassifyIntoBuffer() or
+// TfLiteBertNLClassifierClassifyIntoBuffer().
+//
+// Unlike the categories returned by the other classification functions, which
+// allocate an array and copy the labels on every call, categories written into
+// a buffer only allocate when the storage below is too small: the labels are
+// copied into `strings`. The categories remain valid until the next call using
+// the same buffer, and must not be freed with NLClassifierCategoriesDelete().
+//
+// Create the buffer with NLClassifierCategoriesBufferCreate(), and release its
+// storage with NLClassifierCategoriesBufferClear() once done. Its fields are
+// managed by the library and must not be modified.
+typedef struct NLClassifierCategoriesBuffer {
+  // The categories written by the last call, pointing into the storage below.
+  Categories result;
+  // Storage for the categories.
+  Category* categories;
+  int categories_capacity;
+  // Storage for the null-terminated labels of the categories.
+  char* strings;
+  int strings_capacity;
+} NLClassifierCategoriesBuffer;
+
+// Creates an empty NLClassifierCategoriesBuffer: all sizes and capacities are
+// 0, and all pointers are NULL.
+NLClassifierCategoriesBuffer NLClassifierCategoriesBufferCreate();
+
+// Grows the storage of `buffer`, if needed, so that it can hold
+// `num_categories` categories and `strings_size` bytes of labels (terminators
+// included). Called by the functions writing into the buffer, but can also be
+// called beforehand so that even the first of these calls doesn't allocate.
+// Invalidates the categories held by the buffer if it grows.
+void NLClassifierCategoriesBufferReserve(NLClassifierCategoriesBuffer* buffer,
+                                         int num_categories, int strings_size);
+
+// Releases the storage of `buffer`, leaving it empty and still usable.
+void NLClassifierCategoriesBufferClear(NLClassifierCategoriesBuffer* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,49 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/c/task/text/utils/categories_utils.h"
+
+#include <cstring>
+#include <string>
+
+namespace tflite {
+namespace task {
+namespace text {
+
+const Categories* FillCategoriesBuffer(
+    const std::vector<core::Category>& categories,
+    NLClassifierCategoriesBuffer* buffer) {
+  // Sizes the storage before filling it, as growing it discards its contents.
+  int strings_size = 0;
+  for (const core::Category& category : categories) {
+    strings_size += category.class_name.size() + 1;
+  }
+  NLClassifierCategoriesBufferReserve(buffer, categories.size(), strings_size);
+
+  char* strings = buffer->strings;
+  for (size_t i = 0; i < categories.size(); ++i) {
+    const std::string& class_name = categories[i].class_name;
+    std::memcpy(strings, class_name.c_str(), class_name.size() + 1);
+    buffer->categories[i].text = strings;
+    buffer->categories[i].score = categories[i].score;
+    strings += class_name.size() + 1;
+  }
+  buffer->result.size = categories.size();
+  return &buffer->result;
+}
+
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,40 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_C_TASK_TEXT_UTILS_CATEGORIES_UTILS_H_
+#define TENSORFLOW_LITE_SUPPORT_C_TASK_TEXT_UTILS_CATEGORIES_UTILS_H_
+
+#include <vector>
+
+#include "tensorflow_lite_support/c/task/text/nl_classifier_common.h"
+#include "tensorflow_lite_support/cc/task/core/category.h"
+
+// Utils for writing NLClassifier results into a NLClassifierCategoriesBuffer.
+
+namespace tflite {
+namespace task {
+namespace text {
+
+// Writes `categories` into `buffer`, copying their labels into its storage,
+// and returns `buffer->result`.
+const Categories* FillCategoriesBuffer(
+    const std::vector<core::Category>& categories,
+    NLClassifierCategoriesBuffer* buffer);
+
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_C_TASK_TEXT_UTILS_CATEGORIES_UTILS_H_
@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow_lite_support/c/task/vision/image_classifier.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "tensorflow_lite_support/c/common_utils.h"
 #include "tensorflow_lite_support/c/task/core/utils/base_options_utils.h"
@@ -90,6 +92,27 @@ StatusOr<ImageClassifierOptionsCpp> CreateImageClassifierCppOptionsFromCOptions(
 
   return cpp_options;
 }
+
+// Converts `roi`, or the whole frame if null, to the C++ bounding box.
+BoundingBoxCpp CreateCppRoi(const TfLiteFrameBuffer* frame_buffer,
+                            const TfLiteBoundingBox* roi) {
+  BoundingBoxCpp cc_roi;
+  if (roi == nullptr) {
+    cc_roi.set_width(frame_buffer->dimension.width);
+    cc_roi.set_height(frame_buffer->dimension.height);
+  } else {
+    cc_roi.set_origin_x(roi->origin_x);
+    cc_roi.set_origin_y(roi->origin_y);
+    cc_roi.set_width(roi->width);
+    cc_roi.set_height(roi->height);
+  }
+  return cc_roi;
+}
+
+// Returns `value` as a C string owned by the classifier, or NULL if empty.
+char* GetLabelOrNull(const std::string& value) {
+  return value.empty() ? nullptr : const_cast<char*>(value.c_str());
+}
 }  // namespace
 
 #ifdef __cplusplus
@@ -98,6 +121,9 @@ extern "C" {
 
 struct TfLiteImageClassifier {
   std::unique_ptr<ImageClassifierCpp> impl;
+  // Scratch results of TfLiteImageClassifierClassifyWithRoiIntoBuffer(), kept
+  // across calls to avoid reallocating them.
+  mutable std::vector<ImageClassifierCpp::ScoredClass> scored_classes;
 };
 
 TfLiteImageClassifierOptions TfLiteImageClassifierOptionsCreate() {
@@ -193,20 +219,10 @@ TfLiteClassificationResult* TfLiteImageClassifierClassifyWithRoi(
     return nullptr;
   }
 
-  BoundingBoxCpp cc_roi;
-  if (roi == nullptr) {
-    cc_roi.set_width(frame_buffer->dimension.width);
-    cc_roi.set_height(frame_buffer->dimension.height);
-  } else {
-    cc_roi.set_origin_x(roi->origin_x);
-    cc_roi.set_origin_y(roi->origin_y);
-    cc_roi.set_width(roi->width);
-    cc_roi.set_height(roi->height);
-  }
-
   // fnc_sample(cpp_frame_buffer_status);
   StatusOr<ClassificationResultCpp> cpp_classification_result_status =
-      classifier->impl->Classify(*(cpp_frame_buffer_status.value()), cc_roi);
+      classifier->impl->Classify(*(cpp_frame_buffer_status.value()),
+                                 CreateCppRoi(frame_buffer, roi));
 
   if (!cpp_classification_result_status.ok()) {
     tflite::support::CreateTfLiteSupportErrorWithStatus(
@@ -218,6 +234,69 @@ TfLiteClassificationResult* TfLiteImageClassifierClassifyWithRoi(
       cpp_classification_result_status.value());
 }
 
+const TfLiteClassificationResult*
+TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+    const TfLiteImageClassifier* classifier,
+    const TfLiteFrameBuffer* frame_buffer, const TfLiteBoundingBox* roi,
+    TfLiteClassificationResultBuffer* buffer, TfLiteSupportError** error) {
+  if (classifier == nullptr) {
+    tflite::support::CreateTfLiteSupportError(
+        kInvalidArgumentError, "Expected non null image classifier.", error);
+    return nullptr;
+  }
+  if (buffer == nullptr) {
+    tflite::support::CreateTfLiteSupportError(
+        kInvalidArgumentError, "Expected non null result buffer.", error);
+    return nullptr;
+  }
+
+  StatusOr<std::unique_ptr<FrameBufferCpp>> cpp_frame_buffer_status =
+      ::tflite::task::vision::CreateCppFrameBuffer(frame_buffer);
+  if (!cpp_frame_buffer_status.ok()) {
+    tflite::support::CreateTfLiteSupportErrorWithStatus(
+        cpp_frame_buffer_status.status(), error);
+    return nullptr;
+  }
+
+  std::vector<ImageClassifierCpp::ScoredClass>& scored_classes =
+      classifier->scored_classes;
+  absl::Status status = classifier->impl->ClassifyInto(
+      *(cpp_frame_buffer_status.value()), CreateCppRoi(frame_buffer, roi),
+      &scored_classes);
+  if (!status.ok()) {
+    tflite::support::CreateTfLiteSupportErrorWithStatus(status, error);
+    return nullptr;
+  }
+
+  // The scored classes are sorted by head: each head gets the next slice of
+  // the categories.
+  const int num_heads = classifier->impl->GetOutputCount();
+  TfLiteClassificationResultBufferReserve(buffer, num_heads,
+                                          scored_classes.size());
+  int category_index = 0;
+  for (int head = 0; head < num_heads; ++head) {
+    TfLiteClassifications& classifications = buffer->classifications[head];
+    classifications.head_index = head;
+    classifications.size = 0;
+    classifications.categories = buffer->categories + category_index;
+    for (; category_index < static_cast<int>(scored_classes.size()) &&
+           scored_classes[category_index].head_index == head;
+         ++category_index) {
+      const ImageClassifierCpp::ScoredClass& scored_class =
+          scored_classes[category_index];
+      TfLiteCategory& category = buffer->categories[category_index];
+      category.index = scored_class.index;
+      category.score = scored_class.score;
+      category.label = GetLabelOrNull(scored_class.label_map_item->name);
+      category.display_name =
+          GetLabelOrNull(scored_class.label_map_item->display_name);
+      ++classifications.size;
+    }
+  }
+  buffer->result.size = num_heads;
+  return &buffer->result;
+}
+
 TfLiteClassificationResult* TfLiteImageClassifierClassify(
     const TfLiteImageClassifier* classifier,
     const TfLiteFrameBuffer* frame_buffer, TfLiteSupportError** error) {
@@ -201,6 +201,29 @@ TfLiteClassificationResult* TfLiteImageClassifierClassifyWithRoi(
     const TfLiteFrameBuffer* frame_buffer, const TfLiteBoundingBox* roi,
     TfLiteSupportError** error);
 
+// Same as TfLiteImageClassifierClassifyWithRoi(), except that the results are
+// written into the caller-owned `buffer` instead of being allocated: see
+// TfLiteClassificationResultBuffer. This avoids the per-call allocations of
+// the results, e.g. for callers classifying many frames in a row:
+//
+// TfLiteClassificationResultBuffer buffer =
+//     TfLiteClassificationResultBufferCreate();
+// For each frame:
+//   const TfLiteClassificationResult* classification_result =
+//       TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+//           image_classifier, &frame_buffer, NULL, &buffer, NULL);
+//   if (classification_result) { Use the results. }
+// TfLiteClassificationResultBufferClear(&buffer);
+//
+// `roi` may be NULL to classify the whole frame. Returns a pointer to
+// `buffer->result` in case of success, NULL in case of failure, in which case
+// `error` is set as for the other functions.
+const TfLiteClassificationResult*
+TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+    const TfLiteImageClassifier* classifier,
+    const TfLiteFrameBuffer* frame_buffer, const TfLiteBoundingBox* roi,
+    TfLiteClassificationResultBuffer* buffer, TfLiteSupportError** error);
+
 // Disposes off the image classifier.
 void TfLiteImageClassifierDelete(TfLiteImageClassifier* classifier);
 
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "tensorflow_lite_support/c/task/vision/object_detector.h"
 
+#include <cstring>
 #include <memory>
+#include <string>
 
+#include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/c/common_utils.h"
 #include "tensorflow_lite_support/c/task/core/utils/base_options_utils.h"
 #include "tensorflow_lite_support/c/task/processor/utils/classification_options_utils.h"
@@ -89,6 +92,15 @@ StatusOr<ObjectDetectorOptionsCpp> CreateObjectDetectorCppOptionsFromCOptions(
 
   return cpp_options;
 }
+
+// Copies `value` with its terminator at `*cursor`, which is advanced past the
+// copy, and returns the copy.
+char* CopyString(const std::string& value, char** cursor) {
+  char* copy = *cursor;
+  std::memcpy(copy, value.c_str(), value.size() + 1);
+  *cursor += value.size() + 1;
+  return copy;
+}
 }  // namespace
 
 #ifdef __cplusplus
@@ -97,6 +109,9 @@ extern "C" {
 
 struct TfLiteObjectDetector {
   std::unique_ptr<ObjectDetectorCpp> impl;
+  // Scratch results of TfLiteObjectDetectorDetectIntoBuffer(), kept across
+  // calls so that their sub-messages and strings are recycled.
+  mutable DetectionResultCpp detection_result;
 };
 
 TfLiteObjectDetectorOptions TfLiteObjectDetectorOptionsCreate() {
@@ -201,6 +216,82 @@ TfLiteDetectionResult* TfLiteObjectDetectorDetect(
   return GetDetectionResultCStruct(cpp_detection_result_status.value());
 }
 
+const TfLiteDetectionResult* TfLiteObjectDetectorDetectIntoBuffer(
+    const TfLiteObjectDetector* detector, const TfLiteFrameBuffer* frame_buffer,
+    TfLiteDetectionResultBuffer* buffer, TfLiteSupportError** error) {
+  if (detector == nullptr) {
+    tflite::support::CreateTfLiteSupportError(
+        kInvalidArgumentError, "Expected non null object detector.", error);
+    return nullptr;
+  }
+  if (buffer == nullptr) {
+    tflite::support::CreateTfLiteSupportError(
+        kInvalidArgumentError, "Expected non null result buffer.", error);
+    return nullptr;
+  }
+
+  StatusOr<std::unique_ptr<FrameBufferCpp>> cpp_frame_buffer_status =
+      ::tflite::task::vision::CreateCppFrameBuffer(frame_buffer);
+  if (!cpp_frame_buffer_status.ok()) {
+    tflite::support::CreateTfLiteSupportErrorWithStatus(
+        cpp_frame_buffer_status.status(), error);
+    return nullptr;
+  }
+
+  DetectionResultCpp& detection_result = detector->detection_result;
+  absl::Status status = detector->impl->DetectInto(
+      *(cpp_frame_buffer_status.value()), &detection_result);
+  if (!status.ok()) {
+    tflite::support::CreateTfLiteSupportErrorWithStatus(status, error);
+    return nullptr;
+  }
+
+  // Sizes the storage before filling it, as growing it discards its contents.
+  int num_categories = 0;
+  int strings_size = 0;
+  for (const DetectionCpp& detection : detection_result.detections()) {
+    num_categories += detection.classes_size();
+    for (const ClassCpp& classification : detection.classes()) {
+      if (classification.has_class_name()) {
+        strings_size += classification.class_name().size() + 1;
+      }
+      if (classification.has_display_name()) {
+        strings_size += classification.display_name().size() + 1;
+      }
+    }
+  }
+  TfLiteDetectionResultBufferReserve(buffer,
+                                     detection_result.detections_size(),
+                                     num_categories, strings_size);
+
+  TfLiteCategory* category = buffer->categories;
+  char* strings = buffer->strings;
+  for (int i = 0; i < detection_result.detections_size(); ++i) {
+    const DetectionCpp& detection = detection_result.detections(i);
+    TfLiteDetection& c_detection = buffer->detections[i];
+    c_detection.bounding_box.origin_x = detection.bounding_box().origin_x();
+    c_detection.bounding_box.origin_y = detection.bounding_box().origin_y();
+    c_detection.bounding_box.width = detection.bounding_box().width();
+    c_detection.bounding_box.height = detection.bounding_box().height();
+    c_detection.categories = category;
+    c_detection.size = detection.classes_size();
+    for (const ClassCpp& classification : detection.classes()) {
+      category->index = classification.index();
+      category->score = classification.score();
+      category->label = classification.has_class_name()
+                            ? CopyString(classification.class_name(), &strings)
+                            : nullptr;
+      category->display_name =
+          classification.has_display_name()
+              ? CopyString(classification.display_name(), &strings)
+              : nullptr;
+      ++category;
+    }
+  }
+  buffer->result.size = detection_result.detections_size();
+  return &buffer->result;
+}
+
 void TfLiteObjectDetectorDelete(TfLiteObjectDetector* detector) {
   delete detector;
 }
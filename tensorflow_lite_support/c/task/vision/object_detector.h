@@ -188,6 +188,25 @@ TfLiteDetectionResult* TfLiteObjectDetectorDetect(
     const TfLiteObjectDetector* detector, const TfLiteFrameBuffer* frame_buffer,
     TfLiteSupportError** error);
 
+// Same as TfLiteObjectDetectorDetect(), except that the results are written
+// into the caller-owned `buffer` instead of being allocated: see
+// TfLiteDetectionResultBuffer. This avoids the per-call allocations of the
+// results, e.g. for callers running detection on many frames in a row:
+//
+// TfLiteDetectionResultBuffer buffer = TfLiteDetectionResultBufferCreate();
+// For each frame:
+//   const TfLiteDetectionResult* detection_result =
+//       TfLiteObjectDetectorDetectIntoBuffer(object_detector, &frame_buffer,
+//                                            &buffer, NULL);
+//   if (detection_result) { Use the results. }
+// TfLiteDetectionResultBufferClear(&buffer);
+//
+// Returns a pointer to `buffer->result` in case of success, NULL in case of
+// failure, in which case `error` is set as for the other functions.
+const TfLiteDetectionResult* TfLiteObjectDetectorDetectIntoBuffer(
+    const TfLiteObjectDetector* detector, const TfLiteFrameBuffer* frame_buffer,
+    TfLiteDetectionResultBuffer* buffer, TfLiteSupportError** error);
+
 // Disposes off the object detector.
 void TfLiteObjectDetectorDelete(TfLiteObjectDetector* detector);
 
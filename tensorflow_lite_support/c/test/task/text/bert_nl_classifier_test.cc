@@ -0,0 +1,99 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/c/task/text/bert_nl_classifier.h"
+
+#include <string>
+
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow_lite_support/c/task/text/nl_classifier_common.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace text {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::StrEq;
+using ::tflite::task::JoinPath;
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/text/";
+constexpr char kTestModelPath[] = "bert_nl_classifier.tflite";
+constexpr char kNegativeInput[] = "unflinchingly bleak and desperate";
+constexpr char kPositiveInput[] = "it's a charming and often affecting journey";
+
+class BertNLClassifierClassifyTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string model_path =
+        JoinPath("./" /*test src dir*/, kTestDataDirectory, kTestModelPath);
+    classifier = TfLiteBertNLClassifierCreate(model_path.c_str());
+    ASSERT_NE(classifier, nullptr);
+  }
+
+  void TearDown() override { TfLiteBertNLClassifierDelete(classifier); }
+  TfLiteBertNLClassifier* classifier;
+};
+
+TEST_F(BertNLClassifierClassifyTest, SucceedsWithResultBuffer) {
+  NLClassifierCategoriesBuffer buffer = NLClassifierCategoriesBufferCreate();
+  const Category* storage = nullptr;
+  const char* strings = nullptr;
+
+  for (const char* text : {kNegativeInput, kPositiveInput}) {
+    SCOPED_TRACE(text);
+    Categories* expected = TfLiteBertNLClassifierClassify(classifier, text);
+    ASSERT_NE(expected, nullptr);
+
+    const Categories* categories =
+        TfLiteBertNLClassifierClassifyIntoBuffer(classifier, text, &buffer);
+
+    ASSERT_EQ(categories, &buffer.result);
+    ASSERT_EQ(categories->size, expected->size);
+    for (int i = 0; i < expected->size; ++i) {
+      EXPECT_THAT(categories->categories[i].text,
+                  StrEq(expected->categories[i].text));
+      EXPECT_THAT(categories->categories[i].score,
+                  DoubleNear(expected->categories[i].score, 1e-6));
+    }
+    NLClassifierCategoriesDelete(expected);
+    // The second call reuses the storage of the first one.
+    if (storage != nullptr) {
+      EXPECT_EQ(buffer.categories, storage);
+      EXPECT_EQ(buffer.strings, strings);
+    }
+    storage = buffer.categories;
+    strings = buffer.strings;
+  }
+
+  NLClassifierCategoriesBufferClear(&buffer);
+  EXPECT_EQ(buffer.categories, nullptr);
+  EXPECT_EQ(buffer.result.size, 0);
+}
+
+TEST_F(BertNLClassifierClassifyTest, FailsWithNullResultBuffer) {
+  EXPECT_EQ(TfLiteBertNLClassifierClassifyIntoBuffer(classifier,
+                                                     kPositiveInput, nullptr),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
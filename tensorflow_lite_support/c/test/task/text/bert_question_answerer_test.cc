@@ -0,0 +1,117 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/c/task/text/bert_question_answerer.h"
+
+#include <string>
+
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace text {
+namespace {
+
+using ::testing::FloatEq;
+using ::testing::StrEq;
+using ::tflite::task::JoinPath;
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/text/";
+constexpr char kTestMobileBertWithMetadataModelPath[] =
+    "mobilebert_with_metadata.tflite";
+
+constexpr char kQuestion[] = "What is a course of study called?";
+constexpr char kAnswer[] = "the curriculum.";
+constexpr char kContext[] =
+    "The role of teacher is often formal and ongoing, carried out at a school "
+    "or other place of formal education. In many countries, a person who "
+    "wishes to become a teacher must first obtain specified professional "
+    "qualifications or credentials from a university or college. These "
+    "professional qualifications may include the study of pedagogy, the "
+    "science of teaching. Teachers, like other professionals, may have to "
+    "continue their education after they qualify, a process known as "
+    "continuing professional development. Teachers may use a lesson plan to "
+    "facilitate student learning, providing a course of study which is called "
+    "the curriculum.";
+
+class BertQuestionAnswererAnswerTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string model_path =
+        JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                 kTestMobileBertWithMetadataModelPath);
+    question_answerer = TfLiteBertQuestionAnswererCreate(model_path.c_str());
+    ASSERT_NE(question_answerer, nullptr);
+  }
+
+  void TearDown() override {
+    TfLiteBertQuestionAnswererDelete(question_answerer);
+  }
+  TfLiteBertQuestionAnswerer* question_answerer;
+};
+
+TEST_F(BertQuestionAnswererAnswerTest, SucceedsWithResultBuffer) {
+  TfLiteQaAnswers* expected =
+      TfLiteBertQuestionAnswererAnswer(question_answerer, kContext, kQuestion);
+  ASSERT_NE(expected, nullptr);
+  ASSERT_GE(expected->size, 1);
+  EXPECT_THAT(expected->answers[0].text, StrEq(kAnswer));
+
+  TfLiteQaAnswersBuffer buffer = TfLiteQaAnswersBufferCreate();
+  const TfLiteQaAnswers* answers = TfLiteBertQuestionAnswererAnswerIntoBuffer(
+      question_answerer, kContext, kQuestion, &buffer);
+
+  ASSERT_EQ(answers, &buffer.result);
+  ASSERT_EQ(answers->size, expected->size);
+  for (int i = 0; i < expected->size; ++i) {
+    EXPECT_EQ(answers->answers[i].start, expected->answers[i].start);
+    EXPECT_EQ(answers->answers[i].end, expected->answers[i].end);
+    EXPECT_THAT(answers->answers[i].logit,
+                FloatEq(expected->answers[i].logit));
+    EXPECT_THAT(answers->answers[i].text, StrEq(expected->answers[i].text));
+  }
+  TfLiteQaAnswersDelete(expected);
+
+  // Answering again reuses the storage of the buffer.
+  const TfLiteQaAnswer* storage = buffer.answers;
+  const char* strings = buffer.strings;
+  answers = TfLiteBertQuestionAnswererAnswerIntoBuffer(
+      question_answerer, kContext, kQuestion, &buffer);
+
+  ASSERT_EQ(answers, &buffer.result);
+  EXPECT_EQ(buffer.answers, storage);
+  EXPECT_EQ(buffer.strings, strings);
+  EXPECT_THAT(answers->answers[0].text, StrEq(kAnswer));
+
+  TfLiteQaAnswersBufferClear(&buffer);
+  EXPECT_EQ(buffer.answers, nullptr);
+  EXPECT_EQ(buffer.strings, nullptr);
+  EXPECT_EQ(buffer.result.size, 0);
+}
+
+TEST_F(BertQuestionAnswererAnswerTest, FailsWithNullResultBuffer) {
+  EXPECT_EQ(TfLiteBertQuestionAnswererAnswerIntoBuffer(
+                question_answerer, kContext, kQuestion, nullptr),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,147 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/c/task/text/nl_classifier.h"
+
+#include <string>
+
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow_lite_support/c/task/text/nl_classifier_common.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace text {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::StrEq;
+using ::tflite::task::JoinPath;
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/text/";
+// Model with a regex tokenizer and a label file in its metadata.
+constexpr char kTestModelWithRegexTokenizer[] =
+    "test_model_nl_classifier_with_regex_tokenizer.tflite";
+constexpr char kPositiveInput[] =
+    "This is the best movie I’ve seen in recent years. Strongly recommend "
+    "it!";
+constexpr char kNegativeInput[] = "What a waste of my time.";
+
+class NLClassifierClassifyTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string model_path = JoinPath("./" /*test src dir*/,
+                                      kTestDataDirectory,
+                                      kTestModelWithRegexTokenizer);
+    // The default options of the C++ API.
+    TfLiteNLClassifierOptions options = {
+        .input_tensor_index = 0,
+        .output_score_tensor_index = 0,
+        .output_label_tensor_index = -1,
+        .input_tensor_name = "INPUT",
+        .output_score_tensor_name = "OUTPUT_SCORE",
+        .output_label_tensor_name = "OUTPUT_LABEL"};
+    classifier =
+        TfLiteNLClassifierCreateFromOptions(model_path.c_str(), &options);
+    ASSERT_NE(classifier, nullptr);
+  }
+
+  void TearDown() override { TfLiteNLClassifierDelete(classifier); }
+  TfLiteNLClassifier* classifier;
+};
+
+void ExpectSameCategories(const Categories* actual,
+                          const Categories* expected) {
+  ASSERT_EQ(actual->size, expected->size);
+  for (int i = 0; i < expected->size; ++i) {
+    EXPECT_THAT(actual->categories[i].text,
+                StrEq(expected->categories[i].text));
+    EXPECT_THAT(actual->categories[i].score,
+                DoubleNear(expected->categories[i].score, 1e-6));
+  }
+}
+
+TEST_F(NLClassifierClassifyTest, SucceedsWithResultBuffer) {
+  Categories* expected = TfLiteNLClassifierClassify(classifier, kPositiveInput);
+  ASSERT_NE(expected, nullptr);
+  ASSERT_EQ(expected->size, 2);
+
+  NLClassifierCategoriesBuffer buffer = NLClassifierCategoriesBufferCreate();
+  const Categories* categories =
+      TfLiteNLClassifierClassifyIntoBuffer(classifier, kPositiveInput, &buffer);
+
+  ASSERT_EQ(categories, &buffer.result);
+  ExpectSameCategories(categories, expected);
+  NLClassifierCategoriesDelete(expected);
+
+  // Classifying again reuses the storage of the buffer, and overwrites the
+  // previous categories.
+  expected = TfLiteNLClassifierClassify(classifier, kNegativeInput);
+  const Category* storage = buffer.categories;
+  const char* strings = buffer.strings;
+  categories =
+      TfLiteNLClassifierClassifyIntoBuffer(classifier, kNegativeInput, &buffer);
+
+  ASSERT_EQ(categories, &buffer.result);
+  EXPECT_EQ(buffer.categories, storage);
+  EXPECT_EQ(buffer.strings, strings);
+  ExpectSameCategories(categories, expected);
+  NLClassifierCategoriesDelete(expected);
+
+  NLClassifierCategoriesBufferClear(&buffer);
+  EXPECT_EQ(buffer.categories, nullptr);
+  EXPECT_EQ(buffer.strings, nullptr);
+  EXPECT_EQ(buffer.result.size, 0);
+}
+
+TEST_F(NLClassifierClassifyTest, SucceedsWithReservedResultBuffer) {
+  NLClassifierCategoriesBuffer buffer = NLClassifierCategoriesBufferCreate();
+  NLClassifierCategoriesBufferReserve(&buffer, /*num_categories=*/2,
+                                      /*strings_size=*/64);
+  const Category* storage = buffer.categories;
+  const char* strings = buffer.strings;
+
+  const Categories* categories =
+      TfLiteNLClassifierClassifyIntoBuffer(classifier, kPositiveInput, &buffer);
+
+  ASSERT_NE(categories, nullptr);
+  EXPECT_EQ(categories->size, 2);
+  EXPECT_EQ(buffer.categories, storage);
+  EXPECT_EQ(buffer.strings, strings);
+
+  NLClassifierCategoriesBufferClear(&buffer);
+}
+
+TEST_F(NLClassifierClassifyTest, FailsWithNullResultBuffer) {
+  EXPECT_EQ(
+      TfLiteNLClassifierClassifyIntoBuffer(classifier, kPositiveInput, nullptr),
+      nullptr);
+}
+
+TEST(NLClassifierNullClassifierClassifyTest, FailsWithNullClassifier) {
+  NLClassifierCategoriesBuffer buffer = NLClassifierCategoriesBufferCreate();
+
+  EXPECT_EQ(
+      TfLiteNLClassifierClassifyIntoBuffer(nullptr, kPositiveInput, &buffer),
+      nullptr);
+}
+
+}  // namespace
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
@@ -222,6 +222,69 @@ TEST_F(ImageClassifierClassifyTest, SucceedsWithImageData) {
   TfLiteClassificationResultDelete(classification_result);
 }
 
+TEST_F(ImageClassifierClassifyTest, SucceedsWithResultBuffer) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("burger-224.png"));
+
+  TfLiteFrameBuffer frame_buffer = {
+      .format = kRGB,
+      .orientation = kTopLeft,
+      .dimension = {.width = image_data.width, .height = image_data.height},
+      .buffer = image_data.pixel_data};
+
+  TfLiteClassificationResultBuffer buffer =
+      TfLiteClassificationResultBufferCreate();
+  const TfLiteClassificationResult* classification_result =
+      TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+          image_classifier, &frame_buffer, nullptr, &buffer, nullptr);
+  ASSERT_EQ(classification_result, &buffer.result);
+  ASSERT_EQ(classification_result->size, 1);
+  EXPECT_GE(classification_result->classifications->size, 1);
+  EXPECT_EQ(strcmp(classification_result->classifications->categories[0].label,
+                   "cheeseburger"),
+            0);
+  EXPECT_GE(classification_result->classifications->categories[0].score, 0.90);
+
+  // Classifying again reuses the storage of the buffer.
+  const TfLiteCategory* categories = buffer.categories;
+  classification_result = TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+      image_classifier, &frame_buffer, nullptr, &buffer, nullptr);
+  ImageDataFree(&image_data);
+
+  ASSERT_EQ(classification_result, &buffer.result);
+  EXPECT_EQ(buffer.categories, categories);
+  EXPECT_EQ(strcmp(classification_result->classifications->categories[0].label,
+                   "cheeseburger"),
+            0);
+
+  TfLiteClassificationResultBufferClear(&buffer);
+  EXPECT_EQ(buffer.categories, nullptr);
+  EXPECT_EQ(buffer.result.size, 0);
+}
+
+TEST_F(ImageClassifierClassifyTest, FailsWithNullResultBufferAndError) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("burger-224.png"));
+
+  TfLiteFrameBuffer frame_buffer = {
+      .format = kRGB,
+      .orientation = kTopLeft,
+      .dimension = {.width = image_data.width, .height = image_data.height},
+      .buffer = image_data.pixel_data};
+
+  TfLiteSupportError* error = nullptr;
+  const TfLiteClassificationResult* classification_result =
+      TfLiteImageClassifierClassifyWithRoiIntoBuffer(
+          image_classifier, &frame_buffer, nullptr, nullptr, &error);
+
+  ImageDataFree(&image_data);
+
+  EXPECT_EQ(classification_result, nullptr);
+  ASSERT_NE(error, nullptr);
+  EXPECT_EQ(error->code, kInvalidArgumentError);
+  EXPECT_THAT(error->message, HasSubstr("Expected non null result buffer"));
+
+  TfLiteSupportErrorDelete(error);
+}
+
 TEST_F(ImageClassifierClassifyTest, FailsWithNullFrameBufferAndError) {
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("burger-224.png"));
 
@@ -65,7 +65,7 @@ void VerifyDetection(const TfLiteDetection& detection,
   EXPECT_NEAR(detection.categories[0].score, expected_first_score, 0.001);
 }
 
-void VerifyResults(TfLiteDetectionResult* detection_result) {
+void VerifyResults(const TfLiteDetectionResult* detection_result) {
   ASSERT_NE(detection_result, nullptr);
   EXPECT_GE(detection_result->size, 1);
   EXPECT_NE(detection_result->detections, nullptr);
@@ -250,6 +250,70 @@ TEST_F(ObjectDetectorDetectTest, SucceedsWithImageData) {
   TfLiteDetectionResultDelete(detection_result);
 }
 
+TEST_F(ObjectDetectorDetectTest, SucceedsWithResultBuffer) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("cats_and_dogs.jpg"));
+
+  TfLiteFrameBuffer frame_buffer = {
+      .format = kRGB,
+      .orientation = kTopLeft,
+      .dimension = {.width = image_data.width, .height = image_data.height},
+      .buffer = image_data.pixel_data};
+
+  TfLiteDetectionResultBuffer buffer = TfLiteDetectionResultBufferCreate();
+  const TfLiteDetectionResult* detection_result =
+      TfLiteObjectDetectorDetectIntoBuffer(object_detector, &frame_buffer,
+                                           &buffer, nullptr);
+  ASSERT_EQ(detection_result, &buffer.result);
+  VerifyResults(detection_result);
+
+  // Detecting again reuses the storage of the buffer.
+  const TfLiteDetection* detections = buffer.detections;
+  const TfLiteCategory* categories = buffer.categories;
+  const char* strings = buffer.strings;
+  detection_result = TfLiteObjectDetectorDetectIntoBuffer(
+      object_detector, &frame_buffer, &buffer, nullptr);
+  ImageDataFree(&image_data);
+
+  ASSERT_EQ(detection_result, &buffer.result);
+  EXPECT_EQ(buffer.detections, detections);
+  EXPECT_EQ(buffer.categories, categories);
+  EXPECT_EQ(buffer.strings, strings);
+  VerifyResults(detection_result);
+  // The labels are copied into the buffer.
+  EXPECT_GE(detection_result->detections[0].categories[0].label, strings);
+  EXPECT_LT(detection_result->detections[0].categories[0].label,
+            strings + buffer.strings_capacity);
+
+  TfLiteDetectionResultBufferClear(&buffer);
+  EXPECT_EQ(buffer.detections, nullptr);
+  EXPECT_EQ(buffer.strings, nullptr);
+  EXPECT_EQ(buffer.result.size, 0);
+}
+
+TEST_F(ObjectDetectorDetectTest, FailsWithNullResultBufferAndError) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("cats_and_dogs.jpg"));
+
+  TfLiteFrameBuffer frame_buffer = {
+      .format = kRGB,
+      .orientation = kTopLeft,
+      .dimension = {.width = image_data.width, .height = image_data.height},
+      .buffer = image_data.pixel_data};
+
+  TfLiteSupportError* error = nullptr;
+  const TfLiteDetectionResult* detection_result =
+      TfLiteObjectDetectorDetectIntoBuffer(object_detector, &frame_buffer,
+                                           nullptr, &error);
+
+  ImageDataFree(&image_data);
+
+  EXPECT_EQ(detection_result, nullptr);
+  ASSERT_NE(error, nullptr);
+  EXPECT_EQ(error->code, kInvalidArgumentError);
+  EXPECT_THAT(error->message, HasSubstr("Expected non null result buffer"));
+
+  TfLiteSupportErrorDelete(error);
+}
+
 TEST_F(ObjectDetectorDetectTest, FailsWithNullFrameBufferAndError) {
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image_data, LoadImage("cats_and_dogs.jpg"));
 
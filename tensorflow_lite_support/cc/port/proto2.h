@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_PORT_PROTO_NS_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_PORT_PROTO_NS_H_
 
+#include "google/protobuf/arena.h"
 #include "google/protobuf/message_lite.h"
 #include "google/protobuf/text_format.h"
 
@@ -22,6 +23,7 @@ namespace tflite {
 namespace support {
 namespace proto {
 
+using Arena = ::google::protobuf::Arena;
 using TextFormat = ::google::protobuf::TextFormat;
 using MessageLite = ::google::protobuf::MessageLite;
 
@@ -130,20 +130,35 @@ tflite::support::StatusOr<ClassificationResult> AudioClassifier::Classify(
   return InferWithFallback(audio_buffer);
 }
 
+absl::Status AudioClassifier::ClassifyInto(const AudioBuffer& audio_buffer,
+                                           ClassificationResult* result) {
+  return InferWithFallbackInto(
+      [this, result](
+          const std::vector<const TfLiteTensor*>& /*output_tensors*/) {
+        return PostprocessInto(result);
+      },
+      audio_buffer);
+}
+
 tflite::support::StatusOr<audio::ClassificationResult>
 AudioClassifier::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const AudioBuffer& audio_buffer) {
   audio::ClassificationResult result;
+  RETURN_IF_ERROR(PostprocessInto(&result));
+  return result;
+}
+
+absl::Status AudioClassifier::PostprocessInto(ClassificationResult* result) {
+  result->Clear();
   for (auto& processor : postprocessors_) {
-    auto* classification = result.add_classifications();
+    auto* classification = result->add_classifications();
     // ClassificationPostprocessor doesn't set head name for backward
     // compatibility, so we set it here manually.
     classification->set_head_name(processor->GetHeadName());
     RETURN_IF_ERROR(processor->Postprocess(classification));
   }
-
-  return result;
+  return absl::OkStatus();
 }
 
 }  // namespace audio
@@ -82,6 +82,15 @@ class AudioClassifier
   tflite::support::StatusOr<ClassificationResult> Classify(
       const AudioBuffer& audio_buffer);
 
+  // Same as above, except that the results are written into `result`, which is
+  // cleared first. Reusing the same `result` across calls recycles its
+  // classifications, so that no allocation happens once it has reached its
+  // steady-state size. `result` may also be allocated on a
+  // `google::protobuf::Arena`, in which case all its sub-messages are
+  // allocated on that arena too.
+  absl::Status ClassifyInto(const AudioBuffer& audio_buffer,
+                            ClassificationResult* result);
+
   // Returns the required input audio format if it is set. Otherwise, returns
   // kMetadataNotFoundError.
   // TODO(b/182625132): Add unit test after the format is populated from model
@@ -115,6 +124,10 @@ class AudioClassifier
       const std::vector<const TfLiteTensor*>& output_tensors,
       const AudioBuffer& audio_buffer) override;
 
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(ClassificationResult* result);
+
   // The options used to build this AudioClassifier.
   std::unique_ptr<AudioClassifierOptions> options_;
 
@@ -102,11 +102,18 @@ AudioEmbedder::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const AudioBuffer& audio_buffer) {
   tflite::task::processor::EmbeddingResult result;
+  RETURN_IF_ERROR(PostprocessInto(&result));
+  return result;
+}
+
+absl::Status AudioEmbedder::PostprocessInto(
+    tflite::task::processor::EmbeddingResult* result) {
+  result->Clear();
   for (int i = 0; i < postprocessors_.size(); i++) {
     auto processor = postprocessors_.at(i).get();
-    RETURN_IF_ERROR(processor->Postprocess(result.add_embeddings()));
+    RETURN_IF_ERROR(processor->Postprocess(result->add_embeddings()));
   }
-  return result;
+  return absl::OkStatus();
 }
 
 tflite::support::StatusOr<tflite::task::processor::EmbeddingResult>
@@ -114,6 +121,17 @@ AudioEmbedder::Embed(const AudioBuffer& audio_buffer) {
   return InferWithFallback(audio_buffer);
 }
 
+absl::Status AudioEmbedder::EmbedInto(
+    const AudioBuffer& audio_buffer,
+    tflite::task::processor::EmbeddingResult* result) {
+  return InferWithFallbackInto(
+      [this, result](
+          const std::vector<const TfLiteTensor*>& /*output_tensors*/) {
+        return PostprocessInto(result);
+      },
+      audio_buffer);
+}
+
 }  // namespace audio
 }  // namespace task
 }  // namespace tflite
@@ -47,6 +47,15 @@ class AudioEmbedder
   tflite::support::StatusOr<tflite::task::processor::EmbeddingResult> Embed(
       const AudioBuffer& audio_buffer);
 
+  // Same as above, except that the results are written into `result`, which is
+  // cleared first. Reusing the same `result` across calls recycles its
+  // embeddings, so that no allocation happens once it has reached its
+  // steady-state size. `result` may also be allocated on a
+  // `google::protobuf::Arena`, in which case all its sub-messages are
+  // allocated on that arena too.
+  absl::Status EmbedInto(const AudioBuffer& audio_buffer,
+                         tflite::task::processor::EmbeddingResult* result);
+
   // Returns the required input audio format if it is set. Otherwise, returns
   // kMetadataNotFoundError.
   // TODO(b/182625132): Add unit test after the format is populated from model
@@ -76,6 +85,11 @@ class AudioEmbedder
   Postprocess(const std::vector<const TfLiteTensor*>& output_tensors,
               const AudioBuffer& audio_buffer) override;
 
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(
+      tflite::task::processor::EmbeddingResult* result);
+
   std::unique_ptr<AudioEmbedderOptions> options_ = nullptr;
 
   // Processors
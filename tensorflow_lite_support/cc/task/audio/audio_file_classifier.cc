@@ -0,0 +1,221 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/audio_file_classifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/utils/audio_segments.h"
+#include "tensorflow_lite_support/cc/task/audio/utils/wav_file_reader.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+}  // namespace
+
+/* static */
+StatusOr<std::unique_ptr<AudioFileClassifier>>
+AudioFileClassifier::CreateFromOptions(
+    const AudioFileClassifierOptions& options,
+    OpResolverFactory op_resolver_factory) {
+  RETURN_IF_ERROR(SanityCheckOptions(options));
+
+  // Use absl::WrapUnique() to call private constructor:
+  // https://abseil.io/tips/126.
+  std::unique_ptr<AudioFileClassifier> file_classifier =
+      absl::WrapUnique(new AudioFileClassifier(options));
+  RETURN_IF_ERROR(file_classifier->Init(op_resolver_factory));
+
+  return file_classifier;
+}
+
+/* static */
+absl::Status AudioFileClassifier::SanityCheckOptions(
+    const AudioFileClassifierOptions& options) {
+  if (!options.has_classifier_options()) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Missing mandatory `classifier_options` field",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status AudioFileClassifier::Init(
+    const OpResolverFactory& op_resolver_factory) {
+  int num_workers = options_.num_workers();
+  if (num_workers <= 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  classifiers_.reserve(num_workers);
+  for (int i = 0; i < num_workers; ++i) {
+    ASSIGN_OR_RETURN(auto classifier, AudioClassifier::CreateFromOptions(
+                                          options_.classifier_options(),
+                                          op_resolver_factory()));
+    classifiers_.push_back(std::move(classifier));
+  }
+  return absl::OkStatus();
+}
+
+StatusOr<AudioFileClassificationResult> AudioFileClassifier::ClassifyFile(
+    const std::string& wav_file) {
+  const auto start_time = std::chrono::steady_clock::now();
+
+  ASSIGN_OR_RETURN(std::unique_ptr<WavFileReader> reader,
+                   WavFileReader::Create(wav_file));
+  const AudioBuffer::AudioFormat file_format = reader->GetAudioFormat();
+  ASSIGN_OR_RETURN(const AudioBuffer::AudioFormat model_format,
+                   classifiers_[0]->GetRequiredAudioFormat());
+  if (file_format.channels != model_format.channels ||
+      file_format.sample_rate != model_format.sample_rate) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Audio format of %s (%d channels, %d Hz) does not "
+                        "match the model required audio format (%d channels, "
+                        "%d Hz).",
+                        wav_file, file_format.channels, file_format.sample_rate,
+                        model_format.channels, model_format.sample_rate),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+
+  // Compute the window boundaries.
+  const int window_frames =
+      classifiers_[0]->GetRequiredInputBufferSize() / model_format.channels;
+  int hop_frames = std::lround(options_.window_hop_seconds() *
+                               model_format.sample_rate);
+  if (hop_frames <= 0) {
+    hop_frames = std::max(1, window_frames / 2);
+  }
+  const int64_t frame_count = reader->GetFrameCount();
+  // Windows start every `hop_frames` frames until the whole file is covered,
+  // the last one being zero-padded if needed.
+  std::vector<int64_t> window_starts;
+  for (int64_t start = 0;; start += hop_frames) {
+    window_starts.push_back(start);
+    if (start + window_frames >= frame_count) break;
+  }
+
+  AudioFileClassificationResult result;
+  const double sample_rate = model_format.sample_rate;
+  for (const int64_t window_start : window_starts) {
+    WindowClassification* window = result.add_windows();
+    window->set_start_seconds(window_start / sample_rate);
+    window->set_end_seconds((window_start + window_frames) / sample_rate);
+  }
+
+  result.set_audio_duration_seconds(frame_count / sample_rate);
+
+  RETURN_IF_ERROR(
+      ClassifyWindows(wav_file, window_starts, window_frames, &result));
+  BuildAudioSegments(options_.segment_score_threshold(), &result);
+
+  const std::chrono::duration<double> wall_time =
+      std::chrono::steady_clock::now() - start_time;
+  result.set_wall_time_seconds(wall_time.count());
+  if (wall_time.count() > 0) {
+    result.set_throughput(result.audio_duration_seconds() / wall_time.count());
+  }
+  return result;
+}
+
+StatusOr<std::vector<AudioFileClassificationResult>>
+AudioFileClassifier::ClassifyFiles(const std::vector<std::string>& wav_files) {
+  std::vector<AudioFileClassificationResult> results;
+  results.reserve(wav_files.size());
+  for (const auto& wav_file : wav_files) {
+    ASSIGN_OR_RETURN(AudioFileClassificationResult result,
+                     ClassifyFile(wav_file));
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+absl::Status AudioFileClassifier::ClassifyWindows(
+    const std::string& wav_file, const std::vector<int64_t>& window_starts,
+    int window_frames, AudioFileClassificationResult* result) {
+  const int num_workers =
+      std::min<int>(classifiers_.size(), window_starts.size());
+  std::atomic<int> next_window(0);
+  absl::Mutex mutex;
+  absl::Status status;
+
+  // Each worker pulls windows from the shared counter, reading them through its
+  // own WavFileReader (the underlying pages are shared by the OS).
+  auto worker = [&](AudioClassifier* classifier) {
+    auto record_error = [&](const absl::Status& error) {
+      absl::MutexLock lock(&mutex);
+      if (status.ok()) status = error;
+      // Make the other workers stop early.
+      next_window = window_starts.size();
+    };
+    auto reader = WavFileReader::Create(wav_file);
+    if (!reader.ok()) {
+      record_error(reader.status());
+      return;
+    }
+    for (int i = next_window++; i < window_starts.size(); i = next_window++) {
+      auto buffer = (*reader)->ReadWindow(window_starts[i], window_frames);
+      if (!buffer.ok()) {
+        record_error(buffer.status());
+        return;
+      }
+      // Each window is written by exactly one worker, and `windows` is not
+      // resized while the workers run.
+      absl::Status classify_status = classifier->ClassifyInto(
+          **buffer,
+          result->mutable_windows(i)->mutable_classification_result());
+      if (!classify_status.ok()) {
+        record_error(classify_status);
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers - 1);
+  for (int i = 1; i < num_workers; ++i) {
+    threads.emplace_back(worker, classifiers_[i].get());
+  }
+  // The calling thread acts as the first worker.
+  worker(classifiers_[0].get());
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
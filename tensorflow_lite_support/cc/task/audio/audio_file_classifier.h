@@ -0,0 +1,115 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_AUDIO_FILE_CLASSIFIER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_AUDIO_FILE_CLASSIFIER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/core/shims/cc/kernels/register.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/audio/audio_classifier.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_file_classifications.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_file_classifier_options.pb.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+// Performs offline classification of (possibly very long) LIN16 WAV files.
+//
+// Each file is sliced into fixed-size, possibly overlapping windows matching
+// the input size of the model. Windows are read straight from the memory-mapped
+// file (see WavFileReader) and fanned out across a pool of AudioClassifier
+// instances, each owning its own interpreter, so that memory usage does not
+// grow with the file duration (apart from the per-window results).
+//
+// The per-window results are then aggregated into a per-class timeline of
+// segments, and the throughput of the run is reported in audio-seconds
+// processed per wall-second.
+//
+// The input files must match the audio format (channels and sample rate)
+// required by the model: no resampling is performed.
+//
+// This class is not thread-safe: each call to ClassifyFile() already uses all
+// the AudioClassifier instances of the pool.
+class AudioFileClassifier {
+ public:
+  // Factory for the OpResolver-s used by each AudioClassifier of the pool.
+  using OpResolverFactory =
+      std::function<std::unique_ptr<tflite::OpResolver>()>;
+
+  // Creates an AudioFileClassifier from the provided options. A non-default
+  // OpResolver factory can be specified in order to support custom Ops or
+  // specify a subset of built-in Ops; it is called once per AudioClassifier.
+  static tflite::support::StatusOr<std::unique_ptr<AudioFileClassifier>>
+  CreateFromOptions(
+      const AudioFileClassifierOptions& options,
+      OpResolverFactory op_resolver_factory = []() {
+        return absl::make_unique<
+            tflite_shims::ops::builtin::BuiltinOpResolver>();
+      });
+
+  // Classifies the LIN16 WAV file at `wav_file`.
+  tflite::support::StatusOr<AudioFileClassificationResult> ClassifyFile(
+      const std::string& wav_file);
+
+  // Classifies each of the provided LIN16 WAV files in turn. Fails on the first
+  // file that can't be classified.
+  tflite::support::StatusOr<std::vector<AudioFileClassificationResult>>
+  ClassifyFiles(const std::vector<std::string>& wav_files);
+
+  // Returns the number of AudioClassifier instances in the pool.
+  int GetNumWorkers() const { return classifiers_.size(); }
+
+ private:
+  // Private constructor, called from CreateFromOptions().
+  explicit AudioFileClassifier(const AudioFileClassifierOptions& options)
+      : options_(options) {}
+
+  // Performs sanity checks on the provided AudioFileClassifierOptions.
+  static absl::Status SanityCheckOptions(
+      const AudioFileClassifierOptions& options);
+
+  // Creates the pool of AudioClassifier-s.
+  absl::Status Init(const OpResolverFactory& op_resolver_factory);
+
+  // Classifies the windows of `wav_file` starting at the frames listed in
+  // `window_starts`, each spanning `window_frames` frames, and stores the
+  // results in the corresponding entries of `result->windows`, which must
+  // already be allocated.
+  absl::Status ClassifyWindows(const std::string& wav_file,
+                               const std::vector<int64_t>& window_starts,
+                               int window_frames,
+                               AudioFileClassificationResult* result);
+
+  // The options used to build this AudioFileClassifier.
+  AudioFileClassifierOptions options_;
+
+  // The pool of AudioClassifier-s, all built from the same model.
+  std::vector<std::unique_ptr<AudioClassifier>> classifiers_;
+};
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_AUDIO_FILE_CLASSIFIER_H_
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_CORE_AUDIO_BUFFER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_CORE_AUDIO_BUFFER_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "absl/memory/memory.h"  // from @com_google_absl
@@ -29,7 +30,11 @@ namespace audio {
 
 // Provides a view into the provided backing buffer and the audio format
 // metadata.
-// TODO(b/182675479): Support quantized input format.
+//
+// The backing buffer holds either float samples in [-1, 1] or signed 16-bit
+// PCM samples (e.g. as stored in LIN16 WAV files). In the latter case, the
+// conversion to float is performed by the AudioPreprocessor directly into the
+// model input tensor, so that no intermediate float buffer is needed.
 class AudioBuffer {
  public:
   // Audio format metadata.
@@ -38,6 +43,9 @@ class AudioBuffer {
     int sample_rate;
   };
 
+  // Type of the samples held by the backing buffer.
+  enum class SampleType { kFloat32, kInt16 };
+
   // Factory method for creating an AudioBuffer object. The internal buffer does
   // not take the ownership of the input backing buffer.
   static tflite::support::StatusOr<std::unique_ptr<AudioBuffer>> Create(
@@ -47,6 +55,16 @@ class AudioBuffer {
                                           audio_format);
   }
 
+  // Factory method for creating an AudioBuffer object backed by signed 16-bit
+  // PCM samples. The internal buffer does not take the ownership of the input
+  // backing buffer.
+  static tflite::support::StatusOr<std::unique_ptr<AudioBuffer>> Create(
+      const int16_t* audio_buffer, int buffer_size,
+      const AudioFormat& audio_format) {
+    return absl::make_unique<AudioBuffer>(audio_buffer, buffer_size,
+                                          audio_format);
+  }
+
   // AudioBuffer for internal use only. Uses the factory method to construct
   // AudioBuffer instance. The internal buffer does not take the ownership of
   // the input backing buffer.
@@ -56,13 +74,27 @@ class AudioBuffer {
         buffer_size_(buffer_size),
         audio_format_(audio_format) {}
 
+  // Same as above, for signed 16-bit PCM backing buffers.
+  AudioBuffer(const int16_t* audio_buffer, int buffer_size,
+              const AudioFormat& audio_format)
+      : int16_audio_buffer_(audio_buffer),
+        sample_type_(SampleType::kInt16),
+        buffer_size_(buffer_size),
+        audio_format_(audio_format) {}
+
   // Accessors
   AudioFormat GetAudioFormat() const { return audio_format_; }
   int GetBufferSize() const { return buffer_size_; }
+  SampleType GetSampleType() const { return sample_type_; }
+  // Returns nullptr if the backing buffer doesn't hold float samples.
   const float* GetFloatBuffer() const { return audio_buffer_; }
+  // Returns nullptr if the backing buffer doesn't hold int16 samples.
+  const int16_t* GetInt16Buffer() const { return int16_audio_buffer_; }
 
  private:
-  const float* audio_buffer_;
+  const float* audio_buffer_ = nullptr;
+  const int16_t* int16_audio_buffer_ = nullptr;
+  SampleType sample_type_ = SampleType::kFloat32;
   int buffer_size_;
   AudioFormat audio_format_;
 };
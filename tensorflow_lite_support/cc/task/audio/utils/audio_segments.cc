@@ -0,0 +1,123 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/utils/audio_segments.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/audio/proto/classifications_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+namespace {
+
+// A segment being built from consecutive windows.
+struct OpenSegment {
+  AudioSegment segment;
+  // Index of the last window merged into this segment.
+  int last_window;
+  // Number of windows merged into this segment.
+  int num_windows;
+  // Sum of the scores over the merged windows.
+  double score_sum;
+};
+
+void CloseSegment(OpenSegment* open_segment,
+                  AudioFileClassificationResult* result) {
+  open_segment->segment.set_mean_score(open_segment->score_sum /
+                                       open_segment->num_windows);
+  *result->add_segments() = std::move(open_segment->segment);
+}
+
+}  // namespace
+
+void BuildAudioSegments(float segment_score_threshold,
+                        AudioFileClassificationResult* result) {
+  // Segments currently open, keyed by (head index, class index).
+  absl::flat_hash_map<std::pair<int, int>, OpenSegment> open_segments;
+
+  for (int w = 0; w < result->windows_size(); ++w) {
+    const WindowClassification& window = result->windows(w);
+    const ClassificationResult& classification =
+        window.classification_result();
+    for (int h = 0; h < classification.classifications_size(); ++h) {
+      const Classifications& head = classification.classifications(h);
+      for (const auto& category : head.classes()) {
+        if (category.score() < segment_score_threshold) continue;
+        const auto key = std::make_pair(h, category.index());
+        auto it = open_segments.find(key);
+        if (it != open_segments.end() && it->second.last_window == w - 1) {
+          // Extend the segment open on the previous window.
+          OpenSegment& open_segment = it->second;
+          open_segment.last_window = w;
+          open_segment.num_windows++;
+          open_segment.score_sum += category.score();
+          open_segment.segment.set_end_seconds(window.end_seconds());
+          open_segment.segment.set_max_score(std::max(
+              open_segment.segment.max_score(), category.score()));
+          continue;
+        }
+        if (it != open_segments.end()) {
+          CloseSegment(&it->second, result);
+          open_segments.erase(it);
+        }
+        OpenSegment open_segment;
+        open_segment.last_window = w;
+        open_segment.num_windows = 1;
+        open_segment.score_sum = category.score();
+        AudioSegment& segment = open_segment.segment;
+        segment.set_head_index(h);
+        segment.set_head_name(head.head_name());
+        segment.set_index(category.index());
+        segment.set_class_name(category.class_name());
+        segment.set_display_name(category.display_name());
+        segment.set_start_seconds(window.start_seconds());
+        segment.set_end_seconds(window.end_seconds());
+        segment.set_max_score(category.score());
+        open_segments.emplace(key, std::move(open_segment));
+      }
+    }
+  }
+  for (auto& entry : open_segments) {
+    CloseSegment(&entry.second, result);
+  }
+
+  // The last window may be zero-padded: clamp segments to the file duration.
+  for (auto& segment : *result->mutable_segments()) {
+    segment.set_end_seconds(
+        std::min(segment.end_seconds(), result->audio_duration_seconds()));
+  }
+  // Segments are closed out of order: sort them by start time, then by head and
+  // decreasing max score.
+  std::sort(result->mutable_segments()->begin(),
+            result->mutable_segments()->end(),
+            [](const AudioSegment& a, const AudioSegment& b) {
+              if (a.start_seconds() != b.start_seconds()) {
+                return a.start_seconds() < b.start_seconds();
+              }
+              if (a.head_index() != b.head_index()) {
+                return a.head_index() < b.head_index();
+              }
+              return a.max_score() > b.max_score();
+            });
+}
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
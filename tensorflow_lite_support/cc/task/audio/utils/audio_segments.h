@@ -0,0 +1,38 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_AUDIO_SEGMENTS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_AUDIO_SEGMENTS_H_
+
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_file_classifications.pb.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+// Merges the per-window results of `result` into its per-class `segments`.
+//
+// A class scoring at least `segment_score_threshold` on consecutive windows
+// forms a single segment spanning these windows, clamped to
+// `audio_duration_seconds` as the last window may be zero-padded. The segments
+// are sorted by start time, then by head index and decreasing max score.
+void BuildAudioSegments(float segment_score_threshold,
+                        AudioFileClassificationResult* result);
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_AUDIO_SEGMENTS_H_
@@ -0,0 +1,149 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/utils/wav_file_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+/* static */
+StatusOr<std::unique_ptr<WavFileReader>> WavFileReader::Create(
+    const std::string& file_path) {
+  // Use absl::WrapUnique() to call private constructor:
+  // https://abseil.io/tips/126.
+  std::unique_ptr<WavFileReader> reader = absl::WrapUnique(new WavFileReader());
+  RETURN_IF_ERROR(reader->Init(file_path));
+  return reader;
+}
+
+absl::Status WavFileReader::Init(const std::string& file_path) {
+  fd_ = open(file_path.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    return CreateStatusWithPayload(
+        errno == ENOENT ? StatusCode::kNotFound : StatusCode::kUnknown,
+        absl::StrFormat("Unable to open file at %s, errno=%d", file_path,
+                        errno),
+        errno == ENOENT ? TfLiteSupportStatus::kFileNotFoundError
+                        : TfLiteSupportStatus::kFileReadError);
+  }
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0 || file_stat.st_size <= 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Unable to get size of file %s, errno=%d", file_path,
+                        errno),
+        TfLiteSupportStatus::kFileReadError);
+  }
+  buffer_size_ = file_stat.st_size;
+  buffer_ = mmap(/*addr=*/nullptr, buffer_size_, PROT_READ, MAP_SHARED, fd_,
+                 /*offset=*/0);
+  if (buffer_ == MAP_FAILED) {
+    buffer_ = nullptr;
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Unable to map file to memory buffer, errno=%d", errno),
+        TfLiteSupportStatus::kFileMmapError);
+  }
+  // Samples are read sequentially: let the kernel read ahead aggressively.
+  madvise(buffer_, buffer_size_, MADV_SEQUENTIAL);
+
+  const absl::Status status = DecodeLin16WaveHeader(
+      absl::string_view(static_cast<const char*>(buffer_), buffer_size_),
+      &header_);
+  if (!status.ok()) {
+    return CreateStatusWithPayload(StatusCode::kInvalidArgument,
+                                   status.message(),
+                                   TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+StatusOr<std::unique_ptr<AudioBuffer>> WavFileReader::ReadWindow(
+    int64_t start_frame, int window_frames) {
+  if (start_frame < 0 || window_frames <= 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid window: start_frame=%d, window_frames=%d.",
+                        start_frame, window_frames),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  const int channels = header_.channel_count;
+  const int window_size = window_frames * channels;
+  const int16_t* samples = reinterpret_cast<const int16_t*>(
+      static_cast<const char*>(buffer_) + header_.data_offset);
+
+  const int64_t available_frames =
+      std::max<int64_t>(0, GetFrameCount() - start_frame);
+  const bool is_aligned =
+      reinterpret_cast<uintptr_t>(samples) % alignof(int16_t) == 0;
+  if (port::kLittleEndian && is_aligned && available_frames >= window_frames) {
+    // Fast path: zero-copy view into the mapped file.
+    return AudioBuffer::Create(samples + start_frame * channels, window_size,
+                               GetAudioFormat());
+  }
+
+  scratch_.resize(window_size);
+  const int copied_size =
+      std::min<int64_t>(available_frames, window_frames) * channels;
+  if (copied_size > 0) {
+    const char* src = reinterpret_cast<const char*>(samples) +
+                      start_frame * channels * sizeof(int16_t);
+    if (port::kLittleEndian) {
+      memcpy(scratch_.data(), src, copied_size * sizeof(int16_t));
+    } else {
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+      for (int i = 0; i < copied_size; ++i) {
+        scratch_[i] =
+            static_cast<int16_t>(bytes[2 * i] | (bytes[2 * i + 1] << 8));
+      }
+    }
+  }
+  std::fill(scratch_.begin() + copied_size, scratch_.end(), 0);
+  return AudioBuffer::Create(scratch_.data(), window_size, GetAudioFormat());
+}
+
+WavFileReader::~WavFileReader() {
+  if (buffer_ != nullptr) {
+    munmap(buffer_, buffer_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,115 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_WAV_FILE_READER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_WAV_FILE_READER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/utils/wav_io.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+// Streaming reader for little-endian signed 16-bit PCM WAV files (aka LIN16
+// encoding).
+//
+// The file is mapped in memory at creation time and only its header is parsed:
+// samples are never decoded or copied up front. Windows of interleaved int16
+// samples are then exposed as AudioBuffer-s pointing directly into the mapped
+// file, which the AudioPreprocessor converts to float straight into the model
+// input tensor. This allows classifying arbitrarily long recordings with
+// constant memory usage.
+//
+// Example usage, for a classifier requiring `buffer_size` samples:
+//
+//   ASSIGN_OR_RETURN(auto reader, WavFileReader::Create(path));
+//   const int window_frames = buffer_size / reader->GetAudioFormat().channels;
+//   for (int64_t start = 0; start < reader->GetFrameCount();
+//        start += hop_frames) {
+//     ASSIGN_OR_RETURN(auto buffer, reader->ReadWindow(start, window_frames));
+//     ASSIGN_OR_RETURN(auto result, classifier->Classify(*buffer));
+//   }
+//
+// This class is not thread-safe: concurrent calls to ReadWindow must use
+// distinct WavFileReader instances, or be externally synchronized.
+class WavFileReader {
+ public:
+  // Maps the WAV file at `file_path` in memory and parses its header. Returns
+  // an error if the file can't be opened or mapped, or if it isn't a valid
+  // LIN16 WAV file.
+  static tflite::support::StatusOr<std::unique_ptr<WavFileReader>> Create(
+      const std::string& file_path);
+
+  ~WavFileReader();
+
+  // Disallows copy and assign.
+  WavFileReader(const WavFileReader&) = delete;
+  WavFileReader& operator=(const WavFileReader&) = delete;
+
+  // Returns the audio format (channels and sample rate) of the file.
+  AudioBuffer::AudioFormat GetAudioFormat() const {
+    return {header_.channel_count, static_cast<int>(header_.sample_rate)};
+  }
+
+  // Returns the number of frames in the file, i.e. the number of samples per
+  // channel.
+  int64_t GetFrameCount() const { return header_.sample_count; }
+
+  // Returns an int16 AudioBuffer holding `window_frames` frames (i.e.
+  // `window_frames * channels` interleaved samples) starting at frame
+  // `start_frame`. Frames located past the end of the file are filled with
+  // zeros.
+  //
+  // Whenever possible, the returned AudioBuffer points directly into the mapped
+  // file and no copy is performed. Otherwise (zero-padded last window,
+  // misaligned data chunk or big-endian host) the samples are copied into a
+  // scratch buffer owned by this object and sized after a single window. In
+  // both cases, the returned AudioBuffer is only valid until the next call to
+  // ReadWindow() or the destruction of this object.
+  tflite::support::StatusOr<std::unique_ptr<AudioBuffer>> ReadWindow(
+      int64_t start_frame, int window_frames);
+
+ private:
+  // Private constructor, called from Create().
+  WavFileReader() = default;
+
+  // Opens, maps and parses the header of the file.
+  absl::Status Init(const std::string& file_path);
+
+  // The file descriptor of the WAV file.
+  int fd_{-1};
+  // Points to the memory buffer mapped from the WAV file.
+  void* buffer_{nullptr};
+  // The size in bytes of the mapped memory buffer.
+  size_t buffer_size_{0};
+  // Header of the WAV file.
+  WavHeader header_{};
+  // Scratch buffer used when the samples can't be read in place.
+  std::vector<int16_t> scratch_;
+};
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_AUDIO_UTILS_WAV_FILE_READER_H_
@@ -62,37 +62,29 @@ std::string ReadFile(const std::string filepath) {
 
 // Handles moving the data index forward, validating the arguments, and avoiding
 // overflow or underflow.
-absl::Status IncrementOffset(int old_offset, size_t increment, size_t max_size,
-                             int* new_offset) {
-  if (old_offset < 0) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("Negative offsets are not allowed: %d", old_offset));
-  }
+absl::Status IncrementOffset(size_t old_offset, size_t increment,
+                             size_t max_size, size_t* new_offset) {
   if (old_offset > max_size) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Initial offset is outside data range: %d", old_offset));
   }
-  *new_offset = old_offset + increment;
-  if (*new_offset > max_size) {
+  // Compared against the remaining size rather than the sum, which could
+  // overflow.
+  if (increment > max_size - old_offset) {
     return absl::InvalidArgumentError(
         "Data too short when trying to read string");
   }
-  // See above for the check that the input offset is positive. If it's negative
-  // here then it means that there's been an overflow in the arithmetic.
-  if (*new_offset < 0) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("Offset too large, overflowed: %d", *new_offset));
-  }
+  *new_offset = old_offset + increment;
   return absl::OkStatus();
 }
 
-absl::Status ExpectText(const std::string& data,
-                        const std::string& expected_text, int* offset) {
-  int new_offset;
+absl::Status ExpectText(absl::string_view data, absl::string_view expected_text,
+                        size_t* offset) {
+  size_t new_offset;
   RETURN_IF_ERROR(
       IncrementOffset(*offset, expected_text.size(), data.size(), &new_offset));
-  const std::string found_text(data.begin() + *offset,
-                               data.begin() + new_offset);
+  const absl::string_view found_text =
+      data.substr(*offset, new_offset - *offset);
   if (found_text != expected_text) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Header mismatch: Expected", expected_text, " but found ", found_text));
@@ -101,22 +93,22 @@ absl::Status ExpectText(const std::string& data,
   return absl::OkStatus();
 }
 
-absl::Status ReadString(const std::string& data, int expected_length,
-                        std::string* value, int* offset) {
-  int new_offset;
+absl::Status ReadString(absl::string_view data, int expected_length,
+                        std::string* value, size_t* offset) {
+  size_t new_offset;
   RETURN_IF_ERROR(
       IncrementOffset(*offset, expected_length, data.size(), &new_offset));
-  *value = std::string(data.begin() + *offset, data.begin() + new_offset);
+  *value = std::string(data.substr(*offset, expected_length));
   *offset = new_offset;
   return absl::OkStatus();
 }
 
-absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
-                                          std::vector<float>* float_values,
-                                          uint32_t* sample_count,
-                                          uint16_t* channel_count,
-                                          uint32_t* sample_rate) {
-  int offset = 0;
+absl::Status DecodeLin16WaveHeader(absl::string_view wav_string,
+                                   WavHeader* header) {
+  uint16_t* channel_count = &header->channel_count;
+  uint32_t* sample_rate = &header->sample_rate;
+  uint32_t* sample_count = &header->sample_count;
+  size_t offset = 0;
   RETURN_IF_ERROR(ExpectText(wav_string, kRiffChunkId, &offset));
   uint32_t total_file_size;
   RETURN_IF_ERROR(ReadValue<uint32_t>(wav_string, &total_file_size, &offset));
@@ -186,12 +178,6 @@ absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
     RETURN_IF_ERROR(ReadString(wav_string, 4, &chunk_id, &offset));
     uint32_t chunk_size;
     RETURN_IF_ERROR(ReadValue<uint32_t>(wav_string, &chunk_size, &offset));
-    if (chunk_size > std::numeric_limits<int32_t>::max()) {
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "WAV data chunk '%s' is too large: %" PRIu32
-          " bytes, but the limit is %d",
-          chunk_id.c_str(), chunk_size, std::numeric_limits<int32_t>::max()));
-    }
     if (chunk_id == kDataChunkId) {
       if (was_data_found) {
         return absl::InvalidArgumentError(
@@ -200,18 +186,14 @@ absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
       was_data_found = true;
       *sample_count = chunk_size / bytes_per_sample;
       const uint32_t data_count = *sample_count * *channel_count;
-      int unused_new_offset = 0;
-      // Validate that the data exists before allocating space for it
-      // (prevent easy OOM errors).
+      header->data_offset = offset;
+      // Validate that the data exists before any attempt to read it (prevent
+      // easy OOM errors).
       RETURN_IF_ERROR(IncrementOffset(offset, sizeof(int16_t) * data_count,
-                                      wav_string.size(), &unused_new_offset));
-      float_values->resize(data_count);
-      for (int i = 0; i < data_count; ++i) {
-        int16_t single_channel_value = 0;
-        RETURN_IF_ERROR(
-            ReadValue<int16_t>(wav_string, &single_channel_value, &offset));
-        (*float_values)[i] = Int16SampleToFloat(single_channel_value);
-      }
+                                      wav_string.size(), &offset));
+    } else if (chunk_size > wav_string.size() - offset) {
+      // Trailing chunk truncated by the end of the data.
+      break;
     } else {
       offset += chunk_size;
     }
@@ -222,6 +204,28 @@ absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
   return absl::OkStatus();
 }
 
+absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
+                                          std::vector<float>* float_values,
+                                          uint32_t* sample_count,
+                                          uint16_t* channel_count,
+                                          uint32_t* sample_rate) {
+  WavHeader header;
+  RETURN_IF_ERROR(DecodeLin16WaveHeader(wav_string, &header));
+  *sample_count = header.sample_count;
+  *channel_count = header.channel_count;
+  *sample_rate = header.sample_rate;
+  const uint32_t data_count = header.sample_count * header.channel_count;
+  size_t offset = header.data_offset;
+  float_values->resize(data_count);
+  for (uint32_t i = 0; i < data_count; ++i) {
+    int16_t single_channel_value = 0;
+    RETURN_IF_ERROR(
+        ReadValue<int16_t>(wav_string, &single_channel_value, &offset));
+    (*float_values)[i] = Int16SampleToFloat(single_channel_value);
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace audio
 }  // namespace task
 }  // namespace tflite
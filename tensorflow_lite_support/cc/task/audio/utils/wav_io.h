@@ -25,6 +25,7 @@ limitations under the License.
 #include <cstdint>
 
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 
 namespace tflite {
@@ -60,19 +61,39 @@ absl::Status DecodeLin16WaveAsFloatVector(const std::string& wav_string,
                                           uint16_t* channel_count,
                                           uint32_t* sample_rate);
 
+// Layout of the samples of a LIN16 WAV file, as described by its header.
+struct WavHeader {
+  // Number of interleaved channels.
+  uint16_t channel_count;
+  // Sample rate in Hz.
+  uint32_t sample_rate;
+  // Number of frames, i.e. number of samples per channel.
+  uint32_t sample_count;
+  // Offset in bytes of the first sample of the data chunk, from the beginning
+  // of the file. WAV files may be up to 4 GiB.
+  size_t data_offset;
+};
+
+// Parses the header of a little-endian signed 16-bit PCM WAV file and locates
+// its data chunk, without decoding any sample. Performs the same validation as
+// DecodeLin16WaveAsFloatVector, including checking that the data chunk is
+// fully contained in `wav_data`.
+absl::Status DecodeLin16WaveHeader(absl::string_view wav_data,
+                                   WavHeader* header);
+
 // Everything below here is only exposed publicly for testing purposes.
 
 // Handles moving the data index forward, validating the arguments, and avoiding
 // overflow or underflow.
-absl::Status IncrementOffset(int old_offset, size_t increment, size_t max_size,
-                             int* new_offset);
+absl::Status IncrementOffset(size_t old_offset, size_t increment,
+                             size_t max_size, size_t* new_offset);
 
 // This function is only exposed in the header for testing purposes, as a
 // template that needs to be instantiated. Reads a typed numeric value from a
 // stream of data.
 template <class T>
-absl::Status ReadValue(const std::string& data, T* value, int* offset) {
-  int new_offset;
+absl::Status ReadValue(absl::string_view data, T* value, size_t* offset) {
+  size_t new_offset;
   RETURN_IF_ERROR(
       IncrementOffset(*offset, sizeof(T), data.size(), &new_offset));
   if (port::kLittleEndian) {
@@ -17,14 +17,18 @@ limitations under the License.
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_BASE_TASK_API_H_
 
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/port/tflite_wrapper.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 
 namespace tflite {
@@ -42,6 +46,28 @@ class BaseUntypedTaskApi {
     return engine_->metadata_extractor();
   }
 
+  // Returns the latency statistics of the task: per-stage histograms of the
+  // inferences run so far, and the initialization phases of the model.
+  const TaskStats& GetStats() const { return engine_->stats(); }
+
+  // Discards the inference latencies recorded so far.
+  void ResetStats() { engine_->mutable_stats()->ResetInferenceStats(); }
+
+  // Enables per-op profiling of the inferences, which are then also traced
+  // along with their preprocessing and postprocessing. Disabled by default.
+  void EnableProfiling(
+      int max_trace_events = OpProfiler::kDefaultMaxTraceEvents) {
+    engine_->EnableProfiling(max_trace_events);
+  }
+
+  // Disables per-op profiling, discarding the recorded timings.
+  void DisableProfiling() { engine_->DisableProfiling(); }
+
+  // Returns the profiler, to get the per-op timings as a table
+  // (`ToString()`) or as a Chrome trace (`ToChromeTraceJson()`), or null if
+  // profiling is disabled.
+  OpProfiler* GetProfiler() { return engine_->GetProfiler(); }
+
  protected:
   // TODO(b/200258103): It's a short term solution. In the future we will forbid
   // Tasks exposing the underlying TfLiteEngine. Please try not rely on this
@@ -119,39 +145,78 @@ class BaseTaskApi : public BaseUntypedTaskApi {
   // Performs inference using tflite::support::TfLiteInterpreterWrapper
   // InvokeWithoutFallback().
   tflite::support::StatusOr<OutputType> Infer(InputTypes... args) {
-    tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
-        GetTfLiteEngine()->interpreter_wrapper();
-    // Note: AllocateTensors() is already performed by the interpreter wrapper
-    // at InitInterpreter time (see TfLiteEngine).
-    RETURN_IF_ERROR(Preprocess(GetInputTensors(), args...));
-    absl::Status status = interpreter_wrapper->InvokeWithoutFallback();
-    if (!status.ok()) {
-      return status.GetPayload(tflite::support::kTfLiteSupportPayload)
-                     .has_value()
-                 ? status
-                 : tflite::support::CreateStatusWithPayload(status.code(),
-                                                            status.message());
-    }
-    return Postprocess(GetOutputTensors(), args...);
+    return InferInternal<tflite::support::StatusOr<OutputType>>(
+        /*with_fallback=*/false,
+        [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+          return Postprocess(output_tensors, args...);
+        },
+        args...);
   }
 
   // Performs inference using tflite::support::TfLiteInterpreterWrapper
   // InvokeWithFallback() to benefit from automatic fallback from delegation to
   // CPU where applicable.
   tflite::support::StatusOr<OutputType> InferWithFallback(InputTypes... args) {
-    tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
-        GetTfLiteEngine()->interpreter_wrapper();
+    return InferInternal<tflite::support::StatusOr<OutputType>>(
+        /*with_fallback=*/true,
+        [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+          return Postprocess(output_tensors, args...);
+        },
+        args...);
+  }
+
+  // Same as InferWithFallback(), except that the output tensors are handed to
+  // `postprocess` instead of Postprocess(), for subclasses producing results
+  // in some other form than `OutputType`, e.g. into a caller-owned buffer.
+  // `postprocess` must be callable as:
+  //   absl::Status postprocess(
+  //       const std::vector<const TfLiteTensor*>& output_tensors);
+  template <typename PostprocessFn>
+  absl::Status InferWithFallbackInto(const PostprocessFn& postprocess,
+                                     InputTypes... args) {
+    return InferInternal<absl::Status>(/*with_fallback=*/true, postprocess,
+                                       args...);
+  }
+
+ private:
+  // Runs the inference, recording the latency of each stage in the stats of
+  // the engine. `ResultType` is the type returned by `postprocess`, either a
+  // `StatusOr` or an `absl::Status`.
+  template <typename ResultType, typename PostprocessFn>
+  ResultType InferInternal(bool with_fallback,
+                           const PostprocessFn& postprocess,
+                           InputTypes... args) {
+    TfLiteEngine* engine = GetTfLiteEngine();
+    TaskStats* stats = engine->mutable_stats();
+    OpProfiler* profiler = engine->GetProfiler();
+    Stopwatch stopwatch;
+    absl::Duration total_time = absl::ZeroDuration();
     // Note: AllocateTensors() is already performed by the interpreter wrapper
     // at InitInterpreter time (see TfLiteEngine).
-    RETURN_IF_ERROR(Preprocess(GetInputTensors(), args...));
-    auto set_inputs_nop =
-        [](tflite::task::core::TfLiteEngine::Interpreter* interpreter)
-        -> absl::Status {
-      // NOP since inputs are populated at Preprocess() time.
-      return absl::OkStatus();
-    };
-    absl::Status status =
-        interpreter_wrapper->InvokeWithFallback(set_inputs_nop);
+    uint32_t event = BeginProfilerEvent(profiler, "Preprocess");
+    absl::Status preprocess_status = Preprocess(GetInputTensors(), args...);
+    EndProfilerEvent(profiler, event);
+    RETURN_IF_ERROR(preprocess_status);
+    absl::Duration stage_time = stopwatch.Lap();
+    stats->RecordInference(InferenceStage::kPreprocess, stage_time);
+    total_time += stage_time;
+
+    absl::Status status;
+    if (with_fallback) {
+      auto set_inputs_nop =
+          [](tflite::task::core::TfLiteEngine::Interpreter* interpreter)
+          -> absl::Status {
+        // NOP since inputs are populated at Preprocess() time.
+        return absl::OkStatus();
+      };
+      status =
+          engine->interpreter_wrapper()->InvokeWithFallback(set_inputs_nop);
+    } else {
+      status = engine->interpreter_wrapper()->InvokeWithoutFallback();
+    }
+    stage_time = stopwatch.Lap();
+    stats->RecordInference(InferenceStage::kInvoke, stage_time);
+    total_time += stage_time;
     if (!status.ok()) {
       return status.GetPayload(tflite::support::kTfLiteSupportPayload)
                      .has_value()
@@ -159,7 +224,26 @@ class BaseTaskApi : public BaseUntypedTaskApi {
                  : tflite::support::CreateStatusWithPayload(status.code(),
                                                             status.message());
     }
-    return Postprocess(GetOutputTensors(), args...);
+
+    event = BeginProfilerEvent(profiler, "Postprocess");
+    ResultType result = postprocess(GetOutputTensors());
+    EndProfilerEvent(profiler, event);
+    stage_time = stopwatch.Lap();
+    stats->RecordInference(InferenceStage::kPostprocess, stage_time);
+    if (result.ok()) {
+      stats->RecordInference(InferenceStage::kTotal, total_time + stage_time);
+    }
+    return result;
+  }
+
+  static uint32_t BeginProfilerEvent(OpProfiler* profiler, const char* tag) {
+    if (profiler == nullptr) return 0;
+    return profiler->BeginEvent(tag, tflite::Profiler::EventType::DEFAULT,
+                                /*event_metadata1=*/0, /*event_metadata2=*/0);
+  }
+
+  static void EndProfilerEvent(OpProfiler* profiler, uint32_t event) {
+    if (profiler != nullptr) profiler->EndEvent(event);
   }
 };
 
@@ -15,8 +15,8 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/core/label_map_item.h"
 
 #include "absl/strings/str_format.h"  // from @com_google_absl
-#include "absl/strings/str_split.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/utils/common_utils.h"
 
 namespace tflite {
 namespace task {
@@ -34,15 +34,11 @@ StatusOr<std::vector<LabelMapItem>> BuildLabelMapFromFiles(
                                    "Expected non-empty labels file.",
                                    TfLiteSupportStatus::kInvalidArgumentError);
   }
-  std::vector<absl::string_view> labels = absl::StrSplit(labels_file, '\n');
-  // In most cases, there is an empty line (i.e. newline character) at the end
-  // of the file that needs to be ignored. In such a situation, StrSplit() will
-  // produce a vector with an empty string as final element. Also note that in
-  // case `labels_file` is entirely empty, StrSplit() will produce a vector with
-  // one single empty substring, so there's no out-of-range risk here.
-  if (labels[labels.size() - 1].empty()) {
-    labels.pop_back();
-  }
+  // Lines are split with memchr and kept as views into `labels_file`: the only
+  // copies made are the final LabelMapItem strings. A trailing newline at the
+  // end of the file does not produce an extra empty label.
+  const std::vector<absl::string_view> labels =
+      ::tflite::support::utils::SplitLines(labels_file);
 
   std::vector<LabelMapItem> label_map_items;
   label_map_items.reserve(labels.size());
@@ -51,13 +47,8 @@ StatusOr<std::vector<LabelMapItem>> BuildLabelMapFromFiles(
   }
 
   if (!display_names_file.empty()) {
-    std::vector<std::string> display_names =
-        absl::StrSplit(display_names_file, '\n');
-    // In most cases, there is an empty line (i.e. newline character) at the end
-    // of the file that needs to be ignored. See above.
-    if (display_names[display_names.size() - 1].empty()) {
-      display_names.pop_back();
-    }
+    const std::vector<absl::string_view> display_names =
+        ::tflite::support::utils::SplitLines(display_names_file);
     if (display_names.size() != labels.size()) {
       return CreateStatusWithPayload(
           StatusCode::kInvalidArgument,
@@ -67,7 +58,7 @@ StatusOr<std::vector<LabelMapItem>> BuildLabelMapFromFiles(
           TfLiteSupportStatus::kMetadataNumLabelsMismatchError);
     }
     for (int i = 0; i < display_names.size(); ++i) {
-      label_map_items[i].display_name = display_names[i];
+      label_map_items[i].display_name = std::string(display_names[i]);
     }
   }
   return label_map_items;
@@ -0,0 +1,226 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_format.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using EventType = ::tflite::Profiler::EventType;
+
+const char* GetCategory(EventType type) {
+  switch (type) {
+    case EventType::OPERATOR_INVOKE_EVENT:
+      return "op";
+    case EventType::DELEGATE_OPERATOR_INVOKE_EVENT:
+      return "delegate_op";
+    default:
+      return "runtime";
+  }
+}
+
+// Appends `value` to `output` as a JSON string.
+void AppendJsonString(const char* value, std::string* output) {
+  output->push_back('"');
+  for (const char* c = value; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      output->push_back('\\');
+      output->push_back(*c);
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      absl::StrAppendFormat(output, "\\u%04x", *c);
+    } else {
+      output->push_back(*c);
+    }
+  }
+  output->push_back('"');
+}
+
+}  // namespace
+
+constexpr int OpProfiler::kDefaultMaxTraceEvents;
+
+OpProfiler::OpProfiler(int max_trace_events)
+    : origin_(std::chrono::steady_clock::now()),
+      max_trace_events_(std::max(0, max_trace_events)) {}
+
+int64_t OpProfiler::NowNanos() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - origin_)
+      .count();
+}
+
+uint32_t OpProfiler::BeginEvent(const char* tag, EventType event_type,
+                                int64_t event_metadata1,
+                                int64_t event_metadata2) {
+  Event event;
+  event.tag = tag != nullptr ? tag : "";
+  event.type = event_type;
+  event.metadata1 = event_metadata1;
+  event.metadata2 = event_metadata2;
+  absl::MutexLock lock(&mutex_);
+  event.begin_nanos = NowNanos();
+  open_events_.push_back(event);
+  return open_events_.size();
+}
+
+void OpProfiler::EndEvent(uint32_t event_handle) {
+  const int64_t end_nanos = NowNanos();
+  absl::MutexLock lock(&mutex_);
+  if (event_handle == 0 || event_handle > open_events_.size()) return;
+  Event event = open_events_[event_handle - 1];
+  // Events are properly nested: any event begun after this one has already
+  // ended, or never will.
+  open_events_.resize(event_handle - 1);
+  event.end_nanos = end_nanos;
+  const int64_t duration = end_nanos - event.begin_nanos;
+
+  if (event.type == EventType::OPERATOR_INVOKE_EVENT) {
+    OpStats& stats = op_stats_[{event.metadata2, event.metadata1}];
+    if (stats.count == 0) {
+      stats.tag = event.tag;
+      stats.min_nanos = duration;
+    }
+    ++stats.count;
+    stats.total_nanos += duration;
+    stats.min_nanos = std::min(stats.min_nanos, duration);
+    stats.max_nanos = std::max(stats.max_nanos, duration);
+  }
+
+  if (max_trace_events_ == 0) return;
+  if (trace_.size() < static_cast<size_t>(max_trace_events_)) {
+    trace_.push_back(event);
+  } else {
+    trace_[num_trace_events_ % max_trace_events_] = event;
+  }
+  ++num_trace_events_;
+}
+
+bool OpProfiler::IsDelegatePartition(int64_t subgraph_index,
+                                     int64_t node_index) const {
+  return subgraph_index == 0 &&
+         std::find(delegate_partitions_.begin(), delegate_partitions_.end(),
+                   node_index) != delegate_partitions_.end();
+}
+
+bool OpProfiler::IsDelegatePartition(const Event& event) const {
+  return event.type == EventType::OPERATOR_INVOKE_EVENT &&
+         IsDelegatePartition(event.metadata2, event.metadata1);
+}
+
+void OpProfiler::SetDelegatePartitions(const std::vector<int>& node_indices) {
+  absl::MutexLock lock(&mutex_);
+  delegate_partitions_ = node_indices;
+}
+
+std::vector<OpSummary> OpProfiler::GetOpSummaries() const {
+  std::vector<OpSummary> summaries;
+  absl::MutexLock lock(&mutex_);
+  summaries.reserve(op_stats_.size());
+  for (const auto& entry : op_stats_) {
+    const OpStats& stats = entry.second;
+    OpSummary summary;
+    summary.name = stats.tag;
+    summary.subgraph_index = entry.first.first;
+    summary.node_index = entry.first.second;
+    summary.is_delegate_partition =
+        IsDelegatePartition(entry.first.first, entry.first.second);
+    summary.count = stats.count;
+    summary.total = absl::Nanoseconds(stats.total_nanos);
+    summary.min = absl::Nanoseconds(stats.min_nanos);
+    summary.max = absl::Nanoseconds(stats.max_nanos);
+    summaries.push_back(std::move(summary));
+  }
+  std::stable_sort(summaries.begin(), summaries.end(),
+                   [](const OpSummary& a, const OpSummary& b) {
+                     return a.total > b.total;
+                   });
+  return summaries;
+}
+
+std::string OpProfiler::ToString() const {
+  const std::vector<OpSummary> summaries = GetOpSummaries();
+  absl::Duration total = absl::ZeroDuration();
+  for (const OpSummary& summary : summaries) {
+    total += summary.total;
+  }
+  std::string output = absl::StrFormat(
+      "%-28s %8s %8s %8s %12s %12s %12s %7s\n", "Op", "Subgraph", "Node",
+      "Count", "Avg", "Min", "Max", "%");
+  for (const OpSummary& summary : summaries) {
+    const std::string name =
+        summary.is_delegate_partition
+            ? absl::StrFormat("%s (delegate)", summary.name)
+            : summary.name;
+    absl::StrAppendFormat(
+        &output, "%-28s %8d %8d %8d %12s %12s %12s %6.2f%%\n", name,
+        summary.subgraph_index, summary.node_index, summary.count,
+        absl::FormatDuration(summary.total / summary.count),
+        absl::FormatDuration(summary.min), absl::FormatDuration(summary.max),
+        total > absl::ZeroDuration()
+            ? 100 * absl::FDivDuration(summary.total, total)
+            : 0.0);
+  }
+  return output;
+}
+
+std::string OpProfiler::ToChromeTraceJson() const {
+  std::string output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  absl::MutexLock lock(&mutex_);
+  // Oldest events first.
+  const size_t first =
+      trace_.size() < static_cast<size_t>(max_trace_events_)
+          ? 0
+          : num_trace_events_ % std::max(1, max_trace_events_);
+  for (size_t i = 0; i < trace_.size(); ++i) {
+    const Event& event = trace_[(first + i) % trace_.size()];
+    if (i > 0) output.push_back(',');
+    output += "{\"name\":";
+    AppendJsonString(event.tag, &output);
+    absl::StrAppendFormat(
+        &output, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+                 "\"ts\":%.3f,\"dur\":%.3f",
+        IsDelegatePartition(event) ? "delegate_partition"
+                                   : GetCategory(event.type),
+        event.begin_nanos / 1e3,
+        (event.end_nanos - event.begin_nanos) / 1e3);
+    if (event.type == EventType::OPERATOR_INVOKE_EVENT ||
+        event.type == EventType::DELEGATE_OPERATOR_INVOKE_EVENT) {
+      absl::StrAppendFormat(
+          &output, ",\"args\":{\"node_index\":%d,\"subgraph_index\":%d}",
+          event.metadata1, event.metadata2);
+    }
+    output.push_back('}');
+  }
+  output += "]}";
+  return output;
+}
+
+void OpProfiler::Reset() {
+  absl::MutexLock lock(&mutex_);
+  trace_.clear();
+  num_trace_events_ = 0;
+  op_stats_.clear();
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
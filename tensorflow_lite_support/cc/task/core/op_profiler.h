@@ -0,0 +1,138 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow/lite/core/api/profiler.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Timings of one node of the model, aggregated over all the profiled
+// inferences.
+struct OpSummary {
+  // Name of the op, e.g. "CONV_2D", or of the delegate kernel for the nodes
+  // replacing a partition of the graph delegated to an accelerator.
+  std::string name;
+  int node_index = -1;
+  int subgraph_index = 0;
+  // Whether the node is a delegate kernel, i.e. runs a whole partition of the
+  // graph on the delegate.
+  bool is_delegate_partition = false;
+  int64_t count = 0;
+  absl::Duration total = absl::ZeroDuration();
+  absl::Duration min = absl::ZeroDuration();
+  absl::Duration max = absl::ZeroDuration();
+};
+
+// TF Lite profiler aggregating the per-op timings reported by the interpreter,
+// and keeping a bounded trace of the most recent events for export in the
+// Chrome trace-event format (chrome://tracing, https://ui.perfetto.dev).
+//
+// Only the op invocations are aggregated in the summaries. The other events,
+// e.g. "Invoke" or the "Preprocess" and "Postprocess" spans added by
+// `BaseTaskApi`, only show up in the trace.
+class OpProfiler : public tflite::Profiler {
+ public:
+  static constexpr int kDefaultMaxTraceEvents = 10000;
+
+  // Keeps at most `max_trace_events` events in the trace: once full, the
+  // oldest events are overwritten. 0 disables the trace.
+  explicit OpProfiler(int max_trace_events = kDefaultMaxTraceEvents);
+  OpProfiler(const OpProfiler&) = delete;
+  OpProfiler& operator=(const OpProfiler&) = delete;
+
+  // tflite::Profiler implementation. `tag` must outlive the profiler, which
+  // holds for the op names reported by the interpreter as long as its model
+  // is alive.
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+  void EndEvent(uint32_t event_handle) override;
+
+  // Sets the nodes of subgraph 0 that are delegate kernels, as the events do
+  // not tell them apart from regular custom ops.
+  void SetDelegatePartitions(const std::vector<int>& node_indices);
+
+  // Returns the per-node timings, the most expensive nodes first.
+  std::vector<OpSummary> GetOpSummaries() const;
+
+  // Returns a human-readable table of the per-node timings.
+  std::string ToString() const;
+
+  // Returns the trace as a JSON object in the Chrome trace-event format.
+  std::string ToChromeTraceJson() const;
+
+  // Discards all the recorded timings and events.
+  void Reset();
+
+ private:
+  struct Event {
+    const char* tag = nullptr;
+    EventType type = EventType::DEFAULT;
+    int64_t metadata1 = 0;
+    int64_t metadata2 = 0;
+    int64_t begin_nanos = 0;
+    int64_t end_nanos = -1;
+  };
+
+  struct OpStats {
+    const char* tag = nullptr;
+    int64_t count = 0;
+    int64_t total_nanos = 0;
+    int64_t min_nanos = 0;
+    int64_t max_nanos = 0;
+  };
+
+  // Returns the current time, relative to the creation of the profiler.
+  int64_t NowNanos() const;
+
+  bool IsDelegatePartition(int64_t subgraph_index, int64_t node_index) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool IsDelegatePartition(const Event& event) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::chrono::steady_clock::time_point origin_;
+  const int max_trace_events_;
+
+  mutable absl::Mutex mutex_;
+  // Events begun but not ended yet, indexed by their handle minus one: events
+  // are nested, so this is used as a stack.
+  std::vector<Event> open_events_ ABSL_GUARDED_BY(mutex_);
+  // Ring buffer of the most recent ended events.
+  std::vector<Event> trace_ ABSL_GUARDED_BY(mutex_);
+  int64_t num_trace_events_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Keyed by (subgraph index, node index).
+  std::map<std::pair<int64_t, int64_t>, OpStats> op_stats_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<int> delegate_partitions_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
@@ -0,0 +1,144 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+constexpr const char* kInferenceStageNames[] = {"Preprocess", "Invoke",
+                                                "Postprocess", "Total"};
+constexpr const char* kInitStageNames[] = {
+    "LoadModel", "VerifyAndBuildModel", "ExtractMetadata", "BuildInterpreter",
+    "AllocateTensors"};
+
+void AppendSummary(const char* name, const LatencySummary& summary,
+                   std::string* output) {
+  if (summary.count == 0) return;
+  absl::StrAppendFormat(
+      output, "%-20s %8d %12s %12s %12s %12s %12s\n", name, summary.count,
+      absl::FormatDuration(summary.mean), absl::FormatDuration(summary.p50),
+      absl::FormatDuration(summary.p90), absl::FormatDuration(summary.p99),
+      absl::FormatDuration(summary.max));
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+int LatencyHistogram::GetBucketIndex(uint64_t nanos) {
+  if (nanos < kSubBuckets) return static_cast<int>(nanos);
+  const int exponent = 63 - absl::countl_zero(nanos);
+  if (exponent > kMaxExponent) return kNumBuckets - 1;
+  // The bits following the leading one select the sub-bucket.
+  const int sub_bucket = (nanos >> (exponent - kSubBucketBits)) - kSubBuckets;
+  return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketMidpoint(int index) {
+  if (index < kSubBuckets) return index;
+  const int exponent = index / kSubBuckets + kSubBucketBits - 1;
+  const int shift = exponent - kSubBucketBits;
+  const uint64_t lower_bound =
+      static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  return lower_bound + ((uint64_t{1} << shift) >> 1);
+}
+
+void LatencyHistogram::Record(absl::Duration latency) {
+  const uint64_t nanos =
+      latency > absl::ZeroDuration() ? absl::ToInt64Nanoseconds(latency) : 0;
+  buckets_[GetBucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  sum_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+  uint64_t max_nanos = max_nanos_.load(std::memory_order_relaxed);
+  while (nanos > max_nanos &&
+         !max_nanos_.compare_exchange_weak(max_nanos, nanos,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+LatencySummary LatencyHistogram::GetSummary() const {
+  LatencySummary summary;
+  std::array<uint64_t, kNumBuckets> buckets;
+  uint64_t count = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+  if (count == 0) return summary;
+  const uint64_t max_nanos = max_nanos_.load(std::memory_order_relaxed);
+  summary.count = count;
+  summary.mean = absl::Nanoseconds(
+      sum_nanos_.load(std::memory_order_relaxed) / count);
+  summary.max = absl::Nanoseconds(max_nanos);
+
+  // Returns the (approximate) value with `rank` values below or equal to it,
+  // never above the actual maximum.
+  auto percentile = [&](double fraction) {
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(fraction * count + 0.5));
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return absl::Nanoseconds(std::min(GetBucketMidpoint(i), max_nanos));
+      }
+    }
+    return summary.max;
+  };
+  summary.p50 = percentile(0.5);
+  summary.p90 = percentile(0.9);
+  summary.p99 = percentile(0.99);
+  return summary;
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  sum_nanos_.store(0, std::memory_order_relaxed);
+  max_nanos_.store(0, std::memory_order_relaxed);
+}
+
+void TaskStats::ResetInferenceStats() {
+  for (auto& histogram : inference_) {
+    histogram.Reset();
+  }
+}
+
+std::string TaskStats::ToString() const {
+  std::string output = absl::StrFormat("%-20s %8s %12s %12s %12s %12s %12s\n",
+                                       "Stage", "Count", "Mean", "p50", "p90",
+                                       "p99", "Max");
+  for (int i = 0; i < static_cast<int>(InitStage::kNumStages); ++i) {
+    AppendSummary(kInitStageNames[i], init_[i].GetSummary(), &output);
+  }
+  for (int i = 0; i < static_cast<int>(InferenceStage::kNumStages); ++i) {
+    AppendSummary(kInferenceStageNames[i], inference_[i].GetSummary(),
+                  &output);
+  }
+  return output;
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,167 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_STATS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Stages of an inference, as run by `BaseTaskApi`.
+enum class InferenceStage {
+  // Conversion of the inputs of the task into input tensors.
+  kPreprocess = 0,
+  // TF Lite inference, including the fallback to CPU if any.
+  kInvoke,
+  // Conversion of the output tensors into the result of the task.
+  kPostprocess,
+  // The three stages above, for successful inferences only.
+  kTotal,
+  kNumStages,
+};
+
+// Initialization phases of a `TfLiteEngine`.
+enum class InitStage {
+  // Reading or memory-mapping the model file.
+  kLoadModel = 0,
+  // Verifying the FlatBuffer model and building the TF Lite model from it.
+  kVerifyAndBuildModel,
+  // Extracting the TF Lite Metadata.
+  kExtractMetadata,
+  // Building the TF Lite interpreter, i.e. resolving the ops.
+  kBuildInterpreter,
+  // Applying the delegate, if any, and allocating the tensors.
+  kAllocateTensors,
+  kNumStages,
+};
+
+// Summary of the latencies recorded by a `LatencyHistogram`. Percentiles are
+// approximated by the middle of the histogram bucket they fall in, i.e. with a
+// relative error of at most ~6%.
+struct LatencySummary {
+  int64_t count = 0;
+  absl::Duration mean = absl::ZeroDuration();
+  absl::Duration p50 = absl::ZeroDuration();
+  absl::Duration p90 = absl::ZeroDuration();
+  absl::Duration p99 = absl::ZeroDuration();
+  absl::Duration max = absl::ZeroDuration();
+};
+
+// Histogram of latencies with log-linear buckets: 8 buckets per power of two
+// nanoseconds, up to ~36 minutes.
+//
+// Recording is lock-free and wait-free: it only updates a handful of relaxed
+// atomic counters, so that it can be left enabled on the inference path.
+// Summaries read concurrently with recordings may be slightly inconsistent
+// (e.g. the count may include a latency not yet reflected in the mean).
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Record(absl::Duration latency);
+
+  LatencySummary GetSummary() const;
+
+  // Discards all the recorded latencies.
+  void Reset();
+
+ private:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Nanosecond values are bucketed up to 2^41 ns (~36 minutes), larger ones
+  // are counted in the last bucket.
+  static constexpr int kMaxExponent = 40;
+  static constexpr int kNumBuckets =
+      (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+  static int GetBucketIndex(uint64_t nanos);
+  // Returns the middle of the range of values in the bucket.
+  static uint64_t GetBucketMidpoint(int index);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+  std::atomic<uint64_t> sum_nanos_;
+  std::atomic<uint64_t> max_nanos_;
+};
+
+// Latency statistics of a task: per-stage histograms of its inferences, and of
+// the initialization phases of its `TfLiteEngine`.
+class TaskStats {
+ public:
+  TaskStats() = default;
+  TaskStats(const TaskStats&) = delete;
+  TaskStats& operator=(const TaskStats&) = delete;
+
+  void RecordInference(InferenceStage stage, absl::Duration latency) {
+    inference_[static_cast<int>(stage)].Record(latency);
+  }
+  void RecordInit(InitStage stage, absl::Duration latency) {
+    init_[static_cast<int>(stage)].Record(latency);
+  }
+
+  LatencySummary GetInferenceSummary(InferenceStage stage) const {
+    return inference_[static_cast<int>(stage)].GetSummary();
+  }
+  LatencySummary GetInitSummary(InitStage stage) const {
+    return init_[static_cast<int>(stage)].GetSummary();
+  }
+
+  // Discards the recorded inference latencies. Initialization latencies are
+  // kept, as they are only recorded once.
+  void ResetInferenceStats();
+
+  // Returns a human-readable table of all the non-empty statistics.
+  std::string ToString() const;
+
+ private:
+  std::array<LatencyHistogram, static_cast<int>(InferenceStage::kNumStages)>
+      inference_;
+  std::array<LatencyHistogram, static_cast<int>(InitStage::kNumStages)> init_;
+};
+
+// Measures elapsed time with a monotonic clock.
+class Stopwatch {
+ public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  // Returns the time elapsed since the creation of the stopwatch or the
+  // previous call to `Lap`.
+  absl::Duration Lap() {
+    const auto now = std::chrono::steady_clock::now();
+    const absl::Duration elapsed = absl::FromChrono(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_));
+    start_ = now;
+    return elapsed;
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_STATS_H_
@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "absl/strings/match.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/core/shims/cc/kernels/register.h"
 #include "tensorflow/lite/core/shims/cc/tools/verifier.h"
@@ -92,11 +93,21 @@ void TfLiteEngine::VerifyAndBuildModelFromBuffer(
       buffer_data, buffer_size, extra_verifier, &error_reporter_);
 }
 
+absl::Status TfLiteEngine::LoadModelFile(const ExternalFile* external_file) {
+  Stopwatch stopwatch;
+  ASSIGN_OR_RETURN(model_file_handler_,
+                   ExternalFileHandler::CreateFromExternalFile(external_file));
+  stats_.RecordInit(InitStage::kLoadModel, stopwatch.Lap());
+  return absl::OkStatus();
+}
+
 absl::Status TfLiteEngine::InitializeFromModelFileHandler(
     const tflite::proto::ComputeSettings& compute_settings) {
   const char* buffer_data = model_file_handler_->GetFileContent().data();
   size_t buffer_size = model_file_handler_->GetFileContent().size();
+  Stopwatch stopwatch;
   VerifyAndBuildModelFromBuffer(buffer_data, buffer_size, &verifier_);
+  stats_.RecordInit(InitStage::kVerifyAndBuildModel, stopwatch.Lap());
   if (model_ == nullptr) {
     static constexpr char kInvalidFlatbufferMessage[] =
         "The model is not a valid Flatbuffer";
@@ -128,6 +139,7 @@ absl::Status TfLiteEngine::InitializeFromModelFileHandler(
       model_metadata_extractor_,
       tflite::metadata::ModelMetadataExtractor::CreateFromModelBuffer(
           buffer_data, buffer_size));
+  stats_.RecordInit(InitStage::kExtractMetadata, stopwatch.Lap());
 
   return absl::OkStatus();
 }
@@ -141,9 +153,7 @@ absl::Status TfLiteEngine::BuildModelFromFlatBuffer(
   }
   external_file_ = std::make_unique<ExternalFile>();
   external_file_->set_file_content(std::string(buffer_data, buffer_size));
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
+  RETURN_IF_ERROR(LoadModelFile(external_file_.get()));
   return InitializeFromModelFileHandler(compute_settings);
 }
 
@@ -158,9 +168,7 @@ absl::Status TfLiteEngine::BuildModelFromFile(
     external_file_ = std::make_unique<ExternalFile>();
   }
   external_file_->set_file_name(file_name);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
+  RETURN_IF_ERROR(LoadModelFile(external_file_.get()));
   return InitializeFromModelFileHandler(compute_settings);
 }
 
@@ -175,9 +183,7 @@ absl::Status TfLiteEngine::BuildModelFromFileDescriptor(
     external_file_ = std::make_unique<ExternalFile>();
   }
   external_file_->mutable_file_descriptor_meta()->set_fd(file_descriptor);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
+  RETURN_IF_ERROR(LoadModelFile(external_file_.get()));
   return InitializeFromModelFileHandler(compute_settings);
 }
 
@@ -188,8 +194,7 @@ absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
     return CreateStatusWithPayload(StatusCode::kInternal,
                                    "Model already built");
   }
-  ASSIGN_OR_RETURN(model_file_handler_,
-                   ExternalFileHandler::CreateFromExternalFile(external_file));
+  RETURN_IF_ERROR(LoadModelFile(external_file));
   return InitializeFromModelFileHandler(compute_settings);
 }
 
@@ -200,9 +205,7 @@ absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
                                    "Model already built");
   }
   external_file_ = std::move(external_file);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
+  RETURN_IF_ERROR(LoadModelFile(external_file_.get()));
   // Dummy proto. InitializeFromModelFileHandler doesn't use this proto.
   tflite::proto::ComputeSettings compute_settings;
   return InitializeFromModelFileHandler(compute_settings);
@@ -238,13 +241,21 @@ absl::Status TfLiteEngine::InitInterpreter(
         "TF Lite FlatBufferModel is null. Please make sure to call one of the "
         "BuildModelFrom methods before calling InitInterpreter.");
   }
+  // The interpreter is built by `initializer`, which may run several times if
+  // falling back to CPU: the rest of the initialization is accounted as tensor
+  // allocation.
+  absl::Duration build_interpreter_time = absl::ZeroDuration();
   auto initializer =
-      [this](const InterpreterCreationResources& resources,
-             std::unique_ptr<Interpreter, InterpreterDeleter>* interpreter_out)
+      [this, &build_interpreter_time](
+          const InterpreterCreationResources& resources,
+          std::unique_ptr<Interpreter, InterpreterDeleter>* interpreter_out)
       -> absl::Status {
+    Stopwatch stopwatch;
     tflite_shims::InterpreterBuilder interpreter_builder(*model_, *resolver_);
     resources.ApplyTo(&interpreter_builder);
-    if (interpreter_builder(interpreter_out) != kTfLiteOk) {
+    const TfLiteStatus build_status = interpreter_builder(interpreter_out);
+    build_interpreter_time += stopwatch.Lap();
+    if (build_status != kTfLiteOk) {
       return CreateStatusWithPayload(
           StatusCode::kUnknown,
           absl::StrCat("Could not build the TF Lite interpreter: ",
@@ -257,9 +268,15 @@ absl::Status TfLiteEngine::InitInterpreter(
     return absl::OkStatus();
   };
 
+  Stopwatch stopwatch;
   absl::Status status =
       interpreter_.InitializeWithFallback(initializer, compute_settings);
-  if (!status.ok()) {
+  const absl::Duration init_time = stopwatch.Lap();
+  if (status.ok()) {
+    stats_.RecordInit(InitStage::kBuildInterpreter, build_interpreter_time);
+    stats_.RecordInit(InitStage::kAllocateTensors,
+                      init_time - build_interpreter_time);
+  } else {
     if (absl::StrContains(error_reporter_.previous_message(),
                           "Encountered unresolved custom op")) {
       return CreateStatusWithPayload(StatusCode::kInvalidArgument,
@@ -278,6 +295,44 @@ absl::Status TfLiteEngine::InitInterpreter(
   return status;
 }
 
+void TfLiteEngine::EnableProfiling(int max_trace_events) {
+  DisableProfiling();
+  profiler_ = absl::make_unique<OpProfiler>(max_trace_events);
+  GetProfiler();
+}
+
+void TfLiteEngine::DisableProfiling() {
+  if (profiled_interpreter_ != nullptr &&
+      profiled_interpreter_ == interpreter()) {
+    profiled_interpreter_->SetProfiler(nullptr);
+  }
+  profiled_interpreter_ = nullptr;
+  profiler_.reset();
+}
+
+OpProfiler* TfLiteEngine::GetProfiler() {
+  if (profiler_ == nullptr) return nullptr;
+  Interpreter* interpreter = this->interpreter();
+  // Falling back to CPU rebuilds the interpreter, possibly at the same
+  // address: also check whether it happened since the last installation.
+  if (interpreter != nullptr &&
+      (interpreter != profiled_interpreter_ ||
+       interpreter_.HasDelegateError() != profiled_with_delegate_error_)) {
+    interpreter->SetProfiler(profiler_.get());
+    std::vector<int> delegate_partitions;
+    for (int node_index : interpreter->execution_plan()) {
+      if (interpreter->node_and_registration(node_index)->first.delegate !=
+          nullptr) {
+        delegate_partitions.push_back(node_index);
+      }
+    }
+    profiler_->SetDelegatePartitions(delegate_partitions);
+    profiled_interpreter_ = interpreter;
+    profiled_with_delegate_error_ = interpreter_.HasDelegateError();
+  }
+  return profiler_.get();
+}
+
 }  // namespace core
 }  // namespace task
 }  // namespace tflite
@@ -32,7 +32,9 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/tflite_wrapper.h"
 #include "tensorflow_lite_support/cc/task/core/error_reporter.h"
 #include "tensorflow_lite_support/cc/task/core/external_file_handler.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
 #include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
 #include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
 
 namespace tflite {
@@ -92,6 +94,24 @@ class TfLiteEngine {
   const tflite::metadata::ModelMetadataExtractor* metadata_extractor() const {
     return model_metadata_extractor_.get();
   }
+  // Latency statistics of the initialization of the engine, and of the
+  // inferences run by the task owning it (see `BaseTaskApi`).
+  const TaskStats& stats() const { return stats_; }
+  TaskStats* mutable_stats() { return &stats_; }
+
+  // Enables per-op profiling of the inferences: installs an `OpProfiler` on
+  // the interpreter, replacing the previous one if any. Profiling adds a small
+  // overhead to each op invocation, so it is disabled by default.
+  void EnableProfiling(
+      int max_trace_events = OpProfiler::kDefaultMaxTraceEvents);
+
+  // Disables per-op profiling, discarding the recorded timings.
+  void DisableProfiling();
+
+  // Returns the profiler if profiling is enabled, null otherwise. If the
+  // interpreter was rebuilt since profiling was enabled (e.g. on fallback from
+  // a delegate to CPU), installs the profiler on the new interpreter first.
+  OpProfiler* GetProfiler();
 
   // Builds the TF Lite FlatBufferModel (model_) from the raw FlatBuffer data
   // whose ownership remains with the caller, and which must outlive the current
@@ -169,6 +189,10 @@ class TfLiteEngine {
                                      size_t buffer_size,
                                      TfLiteVerifier* extra_verifier = nullptr);
 
+  // Creates the file handler (reading or memory-mapping the file) for the
+  // provided ExternalFile proto, which must outlive the current object.
+  absl::Status LoadModelFile(const ExternalFile* external_file);
+
   // Gets the buffer from the file handler; verifies and builds the model
   // from the buffer; if successful, sets 'model_metadata_extractor_' to be
   // a TF Lite Metadata extractor for the model; and calculates an appropriate
@@ -187,6 +211,12 @@ class TfLiteEngine {
   // TF Lite model and interpreter for actual inference.
   std::unique_ptr<Model, ModelDeleter> model_;
 
+  // Profiler installed on `profiled_interpreter_`, if profiling is enabled.
+  // Declared before the interpreter, which points to it, so as to outlive it.
+  std::unique_ptr<OpProfiler> profiler_;
+  Interpreter* profiled_interpreter_ = nullptr;
+  bool profiled_with_delegate_error_ = false;
+
   // Interpreter wrapper built from the model.
   InterpreterWrapper interpreter_;
 
@@ -200,6 +230,8 @@ class TfLiteEngine {
 
   // Extra verifier for FlatBuffer input data.
   Verifier verifier_;
+
+  TaskStats stats_;
 };
 
 }  // namespace core
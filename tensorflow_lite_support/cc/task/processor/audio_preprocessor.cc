@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow_lite_support/cc/task/processor/audio_preprocessor.h"
 
+#include <cstdint>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/common.h"
@@ -26,6 +28,18 @@ namespace task {
 namespace processor {
 
 namespace {
+
+// Converts signed 16-bit PCM samples into floats in [-1, 1). Kept as a plain
+// indexed loop over non-aliasing pointers so that it gets auto-vectorized
+// (SSE/AVX on x86, NEON on ARM) without platform-specific code.
+void ConvertInt16ToFloat(const int16_t* __restrict src, int num_samples,
+                         float* __restrict dst) {
+  constexpr float kMultiplier = 1.0f / (1 << 15);
+  for (int i = 0; i < num_samples; ++i) {
+    dst[i] = src[i] * kMultiplier;
+  }
+}
+
 // Looks up AudioProperty from metadata. If no error occurs, the returned value
 // is guaranteed to be valid (not null).
 tflite::support::StatusOr<const AudioProperties*> GetAudioPropertiesSafe(
@@ -157,6 +171,17 @@ absl::Status AudioPreprocessor::Preprocess(
             audio_buffer.GetBufferSize(), input_buffer_size_),
         tflite::support::TfLiteSupportStatus::kInvalidArgumentError);
   }
+  if (audio_buffer.GetSampleType() ==
+      ::tflite::task::audio::AudioBuffer::SampleType::kInt16) {
+    // Convert straight into the input tensor to avoid an intermediate float
+    // buffer.
+    ASSIGN_OR_RETURN(
+        float* input_data,
+        tflite::task::core::AssertAndReturnTypedTensor<float>(GetTensor()));
+    ConvertInt16ToFloat(audio_buffer.GetInt16Buffer(), input_buffer_size_,
+                        input_data);
+    return absl::OkStatus();
+  }
   return tflite::task::core::PopulateTensor(audio_buffer.GetFloatBuffer(),
                                             input_buffer_size_, GetTensor());
 }
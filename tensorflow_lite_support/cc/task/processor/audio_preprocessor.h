@@ -45,7 +45,9 @@ class AudioPreprocessor : public Preprocessor {
   // Processes the provided AudioBuffer and populates tensor values.
   //
   // The input `audio_buffer` are the raw buffer captured by the required format
-  // which can retrieved by GetRequiredAudioFormat().
+  // which can retrieved by GetRequiredAudioFormat(). Both float and int16
+  // backing buffers are supported; int16 samples are converted to float
+  // directly into the input tensor.
   ::absl::Status Preprocess(
       const tflite::task::audio::AudioBuffer& audio_buffer);
 
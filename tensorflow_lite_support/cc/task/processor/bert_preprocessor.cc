@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow_lite_support/cc/task/processor/bert_preprocessor.h"
 
+#include <algorithm>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/ascii.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/common.h"
@@ -31,7 +34,6 @@ using ::tflite::support::CreateStatusWithPayload;
 using ::tflite::support::StatusOr;
 using ::tflite::support::TfLiteSupportStatus;
 using ::tflite::support::text::tokenizer::CreateTokenizerFromProcessUnit;
-using ::tflite::support::text::tokenizer::TokenizerResult;
 using ::tflite::task::core::FindIndexByMetadataTensorName;
 using ::tflite::task::core::PopulateTensor;
 
@@ -41,20 +43,156 @@ constexpr char kMaskTensorName[] = "mask";
 constexpr char kSegmentIdsTensorName[] = "segment_ids";
 constexpr char kClassificationToken[] = "[CLS]";
 constexpr char kSeparator[] = "[SEP]";
+// Number of special tokens, i.e. [CLS] and [SEP].
+constexpr int kNumSpecialTokens = 2;
+
+namespace {
+
+// Returns true if the last dimension of the shape signature of `tensor` is
+// dynamic.
+bool HasDynamicSeqLen(const TfLiteTensor* tensor) {
+  const TfLiteIntArray* signature = tensor->dims_signature;
+  return signature != nullptr && signature->size > 0 &&
+         signature->data[signature->size - 1] == -1;
+}
+
+}  // namespace
+
+/* static */
+StatusOr<BertSeqLenResizer> BertSeqLenResizer::Create(
+    tflite::task::core::TfLiteEngine* engine,
+    const std::vector<int>& input_tensor_indices,
+    const BertPreprocessorOptions& options, int default_max_seq_len) {
+  BertSeqLenResizer resizer(engine, input_tensor_indices);
+  resizer.max_seq_len_ = default_max_seq_len;
+  bool has_dynamic_seq_len = true;
+  for (int index : input_tensor_indices) {
+    if (!HasDynamicSeqLen(engine->GetInput(engine->interpreter(), index))) {
+      has_dynamic_seq_len = false;
+    }
+  }
+  if (!has_dynamic_seq_len) {
+    // Static sequence dimension: dynamic sequence lengths can't be used, and
+    // inputs are always padded to `default_max_seq_len`.
+    resizer.current_seq_len_ = default_max_seq_len;
+    return resizer;
+  }
+  const TfLiteIntArray* dims =
+      engine->GetInput(engine->interpreter(), input_tensor_indices[0])->dims;
+  resizer.current_seq_len_ = dims->data[dims->size - 1];
+
+  if (options.dynamic_seq_len()) {
+    resizer.seq_len_buckets_.assign(options.seq_len_buckets().begin(),
+                                    options.seq_len_buckets().end());
+    std::sort(resizer.seq_len_buckets_.begin(),
+              resizer.seq_len_buckets_.end());
+    if (!resizer.seq_len_buckets_.empty() &&
+        resizer.seq_len_buckets_.front() <= kNumSpecialTokens) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Expected sequence length buckets greater than %d, "
+                          "found %d.",
+                          kNumSpecialTokens, resizer.seq_len_buckets_.front()),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    if (options.has_max_seq_len()) {
+      resizer.max_seq_len_ = options.max_seq_len();
+    } else if (!resizer.seq_len_buckets_.empty()) {
+      resizer.max_seq_len_ = resizer.seq_len_buckets_.back();
+    }
+  }
+  if (resizer.max_seq_len_ <= kNumSpecialTokens) {
+    if (!options.has_max_seq_len()) {
+      // Typically a model converted with a placeholder sequence dimension of
+      // 1: the actual maximum sequence length can't be deduced from it.
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat(
+              "The model input tensors have a dynamic sequence dimension "
+              "created with size %d, which can't fit any token. Set "
+              "`dynamic_seq_len` and `max_seq_len` (or `seq_len_buckets`) in "
+              "the BertPreprocessorOptions.",
+              default_max_seq_len),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected a maximum sequence length greater than %d, "
+                        "found %d.",
+                        kNumSpecialTokens, resizer.max_seq_len_),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+
+  if (options.dynamic_seq_len()) {
+    resizer.is_dynamic_ = true;
+  } else if (resizer.current_seq_len_ != resizer.max_seq_len_) {
+    // Inputs are padded to the maximum sequence length, which the tensors may
+    // not have been created with: allocate them for it once and for all.
+    RETURN_IF_ERROR(resizer.Resize(resizer.max_seq_len_));
+  }
+  return resizer;
+}
+
+StatusOr<int> BertSeqLenResizer::ResizeForNumTokens(int num_tokens) {
+  if (!is_dynamic_) {
+    return max_seq_len_;
+  }
+  int seq_len = num_tokens;
+  auto bucket = std::lower_bound(seq_len_buckets_.begin(),
+                                 seq_len_buckets_.end(), num_tokens);
+  if (bucket != seq_len_buckets_.end()) {
+    seq_len = *bucket;
+  }
+  seq_len = std::min(seq_len, max_seq_len_);
+  if (seq_len != current_seq_len_) {
+    RETURN_IF_ERROR(Resize(seq_len));
+  }
+  return seq_len;
+}
+
+absl::Status BertSeqLenResizer::Resize(int seq_len) {
+  auto* interpreter = engine_->interpreter();
+  for (int index : input_tensor_indices_) {
+    const TfLiteIntArray* dims = engine_->GetInput(interpreter, index)->dims;
+    std::vector<int> new_dims(dims->data, dims->data + dims->size);
+    new_dims.back() = seq_len;
+    if (interpreter->ResizeInputTensor(interpreter->inputs()[index],
+                                       new_dims) != kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrFormat("Failed to resize input tensor %d to sequence "
+                          "length %d.",
+                          index, seq_len),
+          TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
+    }
+  }
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    // Force a resize on the next call.
+    current_seq_len_ = 0;
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Failed to allocate tensors for sequence length %d.",
+                        seq_len),
+        TfLiteSupportStatus::kError);
+  }
+  current_seq_len_ = seq_len;
+  return absl::OkStatus();
+}
 
 /* static */
 StatusOr<std::unique_ptr<BertPreprocessor>> BertPreprocessor::Create(
     tflite::task::core::TfLiteEngine* engine,
-    const std::initializer_list<int> input_tensor_indices) {
+    const std::initializer_list<int> input_tensor_indices,
+    const BertPreprocessorOptions& options) {
   ASSIGN_OR_RETURN(auto processor, Processor::Create<BertPreprocessor>(
                                        /* num_expected_tensors = */ 3, engine,
                                        input_tensor_indices,
                                        /* requires_metadata = */ false));
-  RETURN_IF_ERROR(processor->Init());
+  RETURN_IF_ERROR(processor->Init(options));
   return processor;
 }
 
-absl::Status BertPreprocessor::Init() {
+absl::Status BertPreprocessor::Init(const BertPreprocessorOptions& options) {
   // Try if RegexTokenzier can be found.
   // BertTokenzier is packed in the processing unit of the InputTensors in
   // SubgraphMetadata.
@@ -89,7 +227,14 @@ absl::Status BertPreprocessor::Init() {
                         GetLastDimSize(segment_ids_tensor_index_)),
         TfLiteSupportStatus::kInvalidNumOutputTensorsError);
   }
-  bert_max_seq_len_ = GetLastDimSize(ids_tensor_index_);
+  ASSIGN_OR_RETURN(
+      BertSeqLenResizer seq_len_resizer,
+      BertSeqLenResizer::Create(
+          engine_,
+          {ids_tensor_index_, mask_tensor_index_, segment_ids_tensor_index_},
+          options, GetLastDimSize(ids_tensor_index_)));
+  seq_len_resizer_ =
+      absl::make_unique<BertSeqLenResizer>(std::move(seq_len_resizer));
 
   ASSIGN_OR_RETURN(tokenizer_, CreateTokenizerFromProcessUnit(
                                    tokenzier_metadata, GetMetadataExtractor()));
@@ -97,56 +242,83 @@ absl::Status BertPreprocessor::Init() {
 }
 
 absl::Status BertPreprocessor::Preprocess(const std::string& input_text) {
-  auto* ids_tensor =
-      engine_->GetInput(engine_->interpreter(), ids_tensor_index_);
-  auto* mask_tensor =
-      engine_->GetInput(engine_->interpreter(), mask_tensor_index_);
-  auto* segment_ids_tensor =
-      engine_->GetInput(engine_->interpreter(), segment_ids_tensor_index_);
+  const std::vector<int> ids = Tokenize(input_text);
+  // Resizing the input tensors (if needed) must happen before getting them.
+  ASSIGN_OR_RETURN(const int seq_len,
+                   seq_len_resizer_->ResizeForNumTokens(ids.size()));
+  return PreprocessBatch({&ids}, seq_len);
+}
 
-  std::string processed_input = input_text;
+std::vector<int> BertPreprocessor::Tokenize(const std::string& text) const {
+  std::string processed_input = text;
   absl::AsciiStrToLower(&processed_input);
 
-  TokenizerResult input_tokenize_results;
-  input_tokenize_results = tokenizer_->Tokenize(processed_input);
+  // Tokens missing from the vocabulary map to 0.
+  const std::vector<int> query_ids = tokenizer_->TokenizeToIds(processed_input);
 
   // 2 accounts for [CLS], [SEP]
-  absl::Span<const std::string> query_tokens =
-      absl::MakeSpan(input_tokenize_results.subwords.data(),
-                     input_tokenize_results.subwords.data() +
-                         std::min(static_cast<size_t>(bert_max_seq_len_ - 2),
-                                  input_tokenize_results.subwords.size()));
-
-  std::vector<std::string> tokens;
-  tokens.reserve(2 + query_tokens.size());
+  const size_t num_query_ids =
+      std::min(static_cast<size_t>(GetMaxSeqLen() - kNumSpecialTokens),
+               query_ids.size());
+
+  std::vector<int> ids(num_query_ids + kNumSpecialTokens, 0);
   // Start of generating the features.
-  tokens.push_back(kClassificationToken);
+  tokenizer_->LookupId(kClassificationToken, &ids[0]);
   // For query input.
-  for (const auto& query_token : query_tokens) {
-    tokens.push_back(query_token);
-  }
+  std::copy(query_ids.begin(), query_ids.begin() + num_query_ids,
+            ids.begin() + 1);
   // For Separation.
-  tokens.push_back(kSeparator);
-
-  std::vector<int> input_ids(bert_max_seq_len_, 0);
-  std::vector<int> input_mask(bert_max_seq_len_, 0);
-  // Convert tokens back into ids and set mask
-  for (int i = 0; i < tokens.size(); ++i) {
-    tokenizer_->LookupId(tokens[i], &input_ids[i]);
-    input_mask[i] = 1;
-  }
-  //                           |<--------bert_max_seq_len_--------->|
+  tokenizer_->LookupId(kSeparator, &ids.back());
+  return ids;
+}
+
+absl::Status BertPreprocessor::PreprocessBatch(
+    const std::vector<const std::vector<int>*>& batch, int seq_len) {
+  //                           |<-----------seq_len------------>|
   // input_ids                 [CLS] s1  s2...  sn [SEP]  0  0...  0
   // input_masks                 1    1   1...  1    1    0  0...  0
   // segment_ids                 0    0   0...  0    0    0  0...  0
+  //
+  // where seq_len is the maximum sequence length, unless dynamic sequence
+  // lengths are enabled. Each row of the batch is laid out the same way.
+  std::vector<int> input_ids(batch.size() * seq_len, 0);
+  std::vector<int> input_mask(batch.size() * seq_len, 0);
+  for (int row = 0; row < batch.size(); ++row) {
+    const std::vector<int>& ids = *batch[row];
+    const int num_ids = std::min<size_t>(ids.size(), seq_len);
+    std::copy(ids.begin(), ids.begin() + num_ids,
+              input_ids.begin() + row * seq_len);
+    std::fill_n(input_mask.begin() + row * seq_len, num_ids, 1);
+  }
 
+  auto* ids_tensor =
+      engine_->GetInput(engine_->interpreter(), ids_tensor_index_);
+  auto* mask_tensor =
+      engine_->GetInput(engine_->interpreter(), mask_tensor_index_);
+  auto* segment_ids_tensor =
+      engine_->GetInput(engine_->interpreter(), segment_ids_tensor_index_);
   RETURN_IF_ERROR(PopulateTensor(input_ids, ids_tensor));
   RETURN_IF_ERROR(PopulateTensor(input_mask, mask_tensor));
-  RETURN_IF_ERROR(PopulateTensor(std::vector<int>(bert_max_seq_len_, 0),
-                                 segment_ids_tensor));
+  RETURN_IF_ERROR(PopulateTensor(
+      std::vector<int>(batch.size() * seq_len, 0), segment_ids_tensor));
   return absl::OkStatus();
 }
 
+absl::Status BertPreprocessor::PreprocessBatch(
+    const std::vector<const std::string*>& texts) {
+  std::vector<std::vector<int>> ids;
+  ids.reserve(texts.size());
+  for (const std::string* text : texts) {
+    ids.push_back(Tokenize(*text));
+  }
+  std::vector<const std::vector<int>*> batch;
+  batch.reserve(ids.size());
+  for (const auto& text_ids : ids) {
+    batch.push_back(&text_ids);
+  }
+  return PreprocessBatch(batch, GetMaxSeqLen());
+}
+
 int BertPreprocessor::GetLastDimSize(int tensor_index) {
   auto tensor = engine_->GetInput(engine_->interpreter(), tensor_index);
   return tensor->dims->data[tensor->dims->size - 1];
@@ -15,8 +15,13 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_BERT_PREPROCESOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_BERT_PREPROCESOR_H_
 
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/bert_preprocessor_options.pb.h"
 #include "tensorflow_lite_support/cc/task/processor/text_preprocessor.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/tokenizer.h"
 
@@ -24,24 +29,95 @@ namespace tflite {
 namespace task {
 namespace processor {
 
+// Computes the sequence length of the BERT input tensors ("ids", "mask" and
+// "segment_ids") for each input, and resizes them accordingly if the model
+// supports it. See BertPreprocessorOptions.
+//
+// The interpreter only holds one tensor allocation plan at a time: tensors are
+// resized and re-allocated only when the sequence length differs from the one
+// of the previous input, and buckets keep the number of distinct lengths low.
+class BertSeqLenResizer {
+ public:
+  // Creates a resizer for the input tensors of `engine` at
+  // `input_tensor_indices`. Dynamic sequence lengths are disabled if
+  // `options.dynamic_seq_len()` is false or if any of the tensors has a static
+  // sequence dimension, in which case inputs are always padded to
+  // `default_max_seq_len` (and tensors with a dynamic sequence dimension are
+  // resized to it).
+  //
+  // Returns an error if the maximum sequence length resolved from `options`
+  // and `default_max_seq_len` can't fit any token, e.g. for a model whose
+  // dynamic sequence dimension was created with size 1 and no `max_seq_len`.
+  static tflite::support::StatusOr<BertSeqLenResizer> Create(
+      tflite::task::core::TfLiteEngine* engine,
+      const std::vector<int>& input_tensor_indices,
+      const BertPreprocessorOptions& options, int default_max_seq_len);
+
+  // Returns the sequence length to use for an input of `num_tokens` tokens,
+  // special tokens included, and resizes the input tensors to it if needed.
+  // `num_tokens` must have been truncated to `max_seq_len()` beforehand.
+  tflite::support::StatusOr<int> ResizeForNumTokens(int num_tokens);
+
+  // Returns true if the input tensors are resized for each input.
+  bool is_dynamic() const { return is_dynamic_; }
+
+  // Returns the maximum number of tokens, special tokens included.
+  int max_seq_len() const { return max_seq_len_; }
+
+ private:
+  BertSeqLenResizer(tflite::task::core::TfLiteEngine* engine,
+                    const std::vector<int>& input_tensor_indices)
+      : engine_(engine), input_tensor_indices_(input_tensor_indices) {}
+
+  // Resizes the input tensors to `seq_len` and re-allocates them.
+  absl::Status Resize(int seq_len);
+
+  tflite::task::core::TfLiteEngine* engine_;
+  std::vector<int> input_tensor_indices_;
+  bool is_dynamic_ = false;
+  int max_seq_len_ = 0;
+  // Sorted in increasing order.
+  std::vector<int> seq_len_buckets_;
+  // Sequence length the input tensors are currently allocated for.
+  int current_seq_len_ = 0;
+};
+
 // Processes input text and populates the associated bert input tensors.
 // Requirements for the input tensors:
 //   - The 3 input tensors should be populated with the metadata tensor names,
 //   "ids", "mask", and "segment_ids", respectively.
 //   - The input_process_units metadata should contain WordPiece or
 //   Sentencepiece Tokenizer metadata.
+//
+// By default, the input tensors are padded to their last dimension. If the
+// model has a dynamic sequence dimension, they can instead be resized for each
+// input by setting `dynamic_seq_len` in the provided BertPreprocessorOptions.
 class BertPreprocessor : public TextPreprocessor {
  public:
   static tflite::support::StatusOr<std::unique_ptr<BertPreprocessor>> Create(
       tflite::task::core::TfLiteEngine* engine,
-      const std::initializer_list<int> input_tensor_indices);
+      const std::initializer_list<int> input_tensor_indices,
+      const BertPreprocessorOptions& options = BertPreprocessorOptions());
 
   absl::Status Preprocess(const std::string& text);
 
+  // Batch support. Tokenized inputs are made of the ids of [CLS], the tokens of
+  // the lowercased text and [SEP]; masks and segment ids are set accordingly.
+  bool RequiresTokenization() const override { return true; }
+  std::vector<int> Tokenize(const std::string& text) const override;
+  int GetMaxSeqLen() const override { return seq_len_resizer_->max_seq_len(); }
+  bool HasDynamicSeqLen() const override {
+    return seq_len_resizer_->is_dynamic();
+  }
+  absl::Status PreprocessBatch(
+      const std::vector<const std::vector<int>*>& batch, int seq_len) override;
+  absl::Status PreprocessBatch(
+      const std::vector<const std::string*>& texts) override;
+
  private:
   using TextPreprocessor::TextPreprocessor;
 
-  absl::Status Init();
+  absl::Status Init(const BertPreprocessorOptions& options);
 
   int GetLastDimSize(int tensor_index);
 
@@ -49,7 +125,9 @@ class BertPreprocessor : public TextPreprocessor {
   int ids_tensor_index_;
   int mask_tensor_index_;
   int segment_ids_tensor_index_;
-  int bert_max_seq_len_;
+  // Pads or resizes the input tensors. Its max_seq_len() is the maximum number
+  // of tokens passed to the model.
+  std::unique_ptr<BertSeqLenResizer> seq_len_resizer_;
 };
 
 }  // namespace processor
@@ -15,11 +15,22 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/processor/image_preprocessor.h"
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "tensorflow/lite/util.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/pixel_lookup_tables.h"
 
 namespace tflite {
 namespace task {
@@ -31,6 +42,7 @@ static constexpr int kRgbPixelBytes = 3;
 
 using ::tflite::task::vision::BoundingBox;
 using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::FrameConversionKey;
 }  // namespace
 
 /* static */
@@ -91,9 +103,80 @@ absl::Status ImagePreprocessor::Init(
     is_height_mutable_ = dims_signature->data[1] == -1;
     is_width_mutable_ = dims_signature->data[2] == -1;
   }
+
+  if (input_specs_.tensor_type == kTfLiteInt8 ||
+      input_specs_.tensor_type == kTfLiteFloat16) {
+    RETURN_IF_ERROR(InitLookupTables());
+  }
   return absl::OkStatus();
 }
 
+absl::Status ImagePreprocessor::InitLookupTables() {
+  if (input_specs_.tensor_type == kTfLiteInt8) {
+    // Normalization is optional for int8 inputs, which are then directly
+    // quantized from the pixel values.
+    const TfLiteQuantizationParams& quantization = GetTensor()->params;
+    ASSIGN_OR_RETURN(int8_lookup_tables_,
+                     vision::BuildInt8LookupTables(
+                         input_specs_.normalization_options,
+                         quantization.scale, quantization.zero_point));
+  } else {
+    ASSIGN_OR_RETURN(float16_lookup_tables_,
+                     vision::BuildFloat16LookupTables(
+                         input_specs_.normalization_options.value()));
+  }
+  return absl::OkStatus();
+}
+
+bool ImagePreprocessor::CanBindInputBuffer(const uint8* data) const {
+  // Resizing the input tensor of dynamic models reallocates it anyway.
+  return zero_copy_input_ && !is_height_mutable_ && !is_width_mutable_ &&
+         reinterpret_cast<uintptr_t>(data) % tflite::kDefaultTensorAlignment ==
+             0;
+}
+
+absl::Status ImagePreprocessor::BindInputBuffer(const uint8* data,
+                                                size_t size) {
+  if (GetTensor()->data.raw == reinterpret_cast<const char*>(data)) {
+    // Already bound, e.g. to a camera buffer reused across frames.
+    return absl::OkStatus();
+  }
+  // The interpreter only reads from input tensors, so the buffer is never
+  // written to.
+  TfLiteCustomAllocation allocation = {const_cast<uint8*>(data), size};
+  if (engine_->interpreter()->SetCustomAllocationForTensor(
+          engine_->interpreter()->inputs()[tensor_indices_.at(0)],
+          allocation) != kTfLiteOk ||
+      engine_->interpreter()->AllocateTensors() != kTfLiteOk) {
+    return tflite::support::CreateStatusWithPayload(
+        absl::StatusCode::kInternal,
+        "Failed to bind the frame buffer data to the input tensor.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ImagePreprocessor::UnbindInputBuffer() {
+  const TfLiteTensor* tensor = GetTensor();
+  if (tensor->allocation_type != kTfLiteCustom ||
+      tensor->data.raw == reinterpret_cast<char*>(owned_input_data_)) {
+    return absl::OkStatus();
+  }
+  // The input tensor still points to the data of a previous frame buffer,
+  // which may be gone: bind it to a buffer owned by the preprocessor instead,
+  // as custom allocations can't be reverted to the arena.
+  if (owned_input_storage_ == nullptr) {
+    owned_input_storage_ = absl::make_unique<uint8[]>(
+        tensor->bytes + tflite::kDefaultTensorAlignment);
+    const uintptr_t address =
+        reinterpret_cast<uintptr_t>(owned_input_storage_.get());
+    owned_input_data_ = owned_input_storage_.get() +
+                        (tflite::kDefaultTensorAlignment -
+                         address % tflite::kDefaultTensorAlignment) %
+                            tflite::kDefaultTensorAlignment;
+  }
+  return BindInputBuffer(owned_input_data_, tensor->bytes);
+}
+
 absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer) {
   BoundingBox roi;
   roi.set_width(frame_buffer.dimension().width);
@@ -106,13 +189,14 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
   // Input data to be normalized (if needed) and used for inference. In most
   // cases, this is the result of image preprocessing. In case no image
   // preprocessing is needed (see below), this points to the input frame
-  // buffer raw data.
+  // buffer raw data, whose rows may be padded.
   const uint8* input_data;
   size_t input_data_byte_size;
+  int input_row_stride_bytes;
 
-  // Optional buffers in case image preprocessing is needed.
-  std::unique_ptr<FrameBuffer> preprocessed_frame_buffer;
-  std::vector<uint8> preprocessed_data;
+  // Optional buffer in case image preprocessing is needed, possibly shared
+  // with the frame conversion cache.
+  std::shared_ptr<const std::vector<uint8>> preprocessed_data;
 
   if (IsImagePreprocessingNeeded(frame_buffer, roi)) {
     // Preprocess input image to fit model requirements.
@@ -122,30 +206,53 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
         is_width_mutable_ ? roi.width() : input_specs_.image_width;
     input_specs_.image_height =
         is_height_mutable_ ? roi.height() : input_specs_.image_height;
+    input_row_stride_bytes = input_specs_.image_width * kRgbPixelBytes;
 
     FrameBuffer::Dimension to_buffer_dimension = {input_specs_.image_width,
                                                   input_specs_.image_height};
     input_data_byte_size =
         GetBufferByteSize(to_buffer_dimension, FrameBuffer::Format::kRGB);
-    preprocessed_data.resize(input_data_byte_size / sizeof(uint8), 0);
-    input_data = preprocessed_data.data();
-
-    FrameBuffer::Plane preprocessed_plane = {
-        /*buffer=*/preprocessed_data.data(),
-        /*stride=*/{input_specs_.image_width * kRgbPixelBytes, kRgbPixelBytes}};
-    preprocessed_frame_buffer = FrameBuffer::Create(
-        {preprocessed_plane}, to_buffer_dimension, FrameBuffer::Format::kRGB,
-        FrameBuffer::Orientation::kTopLeft);
-
-    RETURN_IF_ERROR(frame_buffer_utils_->Preprocess(
-        frame_buffer, roi, preprocessed_frame_buffer.get()));
+
+    FrameConversionKey cache_key;
+    if (frame_conversion_cache_ != nullptr) {
+      cache_key = FrameConversionKey::Create(
+          frame_buffer, roi, to_buffer_dimension, FrameBuffer::Format::kRGB,
+          FrameBuffer::Orientation::kTopLeft);
+      preprocessed_data = frame_conversion_cache_->Lookup(cache_key);
+    }
+    if (preprocessed_data == nullptr) {
+      auto data = std::make_shared<std::vector<uint8>>(
+          input_data_byte_size / sizeof(uint8), 0);
+      FrameBuffer::Plane preprocessed_plane = {
+          /*buffer=*/data->data(),
+          /*stride=*/{input_specs_.image_width * kRgbPixelBytes,
+                      kRgbPixelBytes}};
+      std::unique_ptr<FrameBuffer> preprocessed_frame_buffer =
+          FrameBuffer::Create({preprocessed_plane}, to_buffer_dimension,
+                              FrameBuffer::Format::kRGB,
+                              FrameBuffer::Orientation::kTopLeft);
+
+      RETURN_IF_ERROR(frame_buffer_utils_->Preprocess(
+          frame_buffer, roi, preprocessed_frame_buffer.get()));
+      preprocessed_data = std::move(data);
+      if (frame_conversion_cache_ != nullptr) {
+        frame_conversion_cache_->Insert(cache_key, preprocessed_data);
+      }
+    }
+    input_data = preprocessed_data->data();
   } else {
     // Input frame buffer already targets model requirements: skip image
-    // preprocessing. For RGB, the data is always stored in a single plane.
+    // preprocessing. For RGB, the data is always stored in a single plane,
+    // possibly with padding bytes at the end of each row, which are skipped
+    // when populating the input tensor.
     input_data = frame_buffer.plane(0).buffer;
-    input_data_byte_size = frame_buffer.plane(0).stride.row_stride_bytes *
-                           frame_buffer.dimension().height;
+    input_row_stride_bytes = frame_buffer.plane(0).stride.row_stride_bytes;
+    input_data_byte_size = input_specs_.image_width * kRgbPixelBytes *
+                           input_specs_.image_height;
   }
+  const int input_row_bytes = input_specs_.image_width * kRgbPixelBytes;
+  const bool is_input_data_contiguous =
+      input_row_stride_bytes == input_row_bytes;
 
   // If dynamic, it will re-dim the entire graph as per the input.
   if (is_height_mutable_ || is_width_mutable_) {
@@ -157,17 +264,38 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
   }
   // Then normalize pixel data (if needed) and populate the input tensor.
   switch (input_specs_.tensor_type) {
-    case kTfLiteUInt8:
+    case kTfLiteUInt8: {
       if (GetTensor()->bytes != input_data_byte_size) {
         return tflite::support::CreateStatusWithPayload(
             absl::StatusCode::kInternal,
             "Size mismatch or unsupported padding bytes between pixel data "
             "and input tensor.");
       }
-      // No normalization required: directly populate data.
-      RETURN_IF_ERROR(tflite::task::core::PopulateTensor(
-          input_data, input_data_byte_size / sizeof(uint8), GetTensor()));
+      if (is_input_data_contiguous && preprocessed_data == nullptr &&
+          CanBindInputBuffer(input_data)) {
+        // No normalization required: use the frame buffer data in place.
+        RETURN_IF_ERROR(BindInputBuffer(input_data, input_data_byte_size));
+        break;
+      }
+      RETURN_IF_ERROR(UnbindInputBuffer());
+      if (is_input_data_contiguous) {
+        // No normalization required: directly populate data.
+        RETURN_IF_ERROR(tflite::task::core::PopulateTensor(
+            input_data, input_data_byte_size / sizeof(uint8), GetTensor()));
+      } else {
+        // No normalization required: copy the rows without their padding.
+        ASSIGN_OR_RETURN(
+            uint8* tensor_data,
+            tflite::task::core::AssertAndReturnTypedTensor<uint8>(
+                GetTensor()));
+        for (int row = 0; row < input_specs_.image_height; ++row) {
+          std::memcpy(tensor_data + row * input_row_bytes,
+                      input_data + row * input_row_stride_bytes,
+                      input_row_bytes);
+        }
+      }
       break;
+    }
     case kTfLiteFloat32: {
       if (GetTensor()->bytes / sizeof(float) !=
           input_data_byte_size / sizeof(uint8)) {
@@ -176,6 +304,7 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
             "Size mismatch or unsupported padding bytes between pixel data "
             "and input tensor.");
       }
+      RETURN_IF_ERROR(UnbindInputBuffer());
       // Normalize and populate.
       ASSIGN_OR_RETURN(
           float* normalized_input_data,
@@ -191,32 +320,73 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
               "tensor metadata has been populated correctly.");
         }
       }
-      if (normalization_options.num_values == 1) {
-        float mean_value = normalization_options.mean_values[0];
-        float inv_std_value = (1.0f / normalization_options.std_values[0]);
-        for (size_t i = 0; i < input_data_byte_size / sizeof(uint8);
-             i++, input_data++, normalized_input_data++) {
-          *normalized_input_data =
-              inv_std_value * (static_cast<float>(*input_data) - mean_value);
-        }
-      } else {
-        std::array<float, 3> inv_std_values = {
-            1.0f / normalization_options.std_values[0],
-            1.0f / normalization_options.std_values[1],
-            1.0f / normalization_options.std_values[2]};
-        for (size_t i = 0; i < input_data_byte_size / sizeof(uint8);
-             i++, input_data++, normalized_input_data++) {
-          *normalized_input_data = inv_std_values[i % 3] *
-                                   (static_cast<float>(*input_data) -
-                                    normalization_options.mean_values[i % 3]);
+      // Contiguous data is normalized as a single row.
+      const int num_rows =
+          is_input_data_contiguous ? 1 : input_specs_.image_height;
+      const size_t row_size = is_input_data_contiguous
+                                  ? input_data_byte_size / sizeof(uint8)
+                                  : input_row_bytes;
+      for (int row = 0; row < num_rows; ++row) {
+        const uint8* row_data = input_data + row * input_row_stride_bytes;
+        if (normalization_options.num_values == 1) {
+          float mean_value = normalization_options.mean_values[0];
+          float inv_std_value = (1.0f / normalization_options.std_values[0]);
+          for (size_t i = 0; i < row_size;
+               i++, row_data++, normalized_input_data++) {
+            *normalized_input_data =
+                inv_std_value * (static_cast<float>(*row_data) - mean_value);
+          }
+        } else {
+          std::array<float, 3> inv_std_values = {
+              1.0f / normalization_options.std_values[0],
+              1.0f / normalization_options.std_values[1],
+              1.0f / normalization_options.std_values[2]};
+          for (size_t i = 0; i < row_size;
+               i++, row_data++, normalized_input_data++) {
+            *normalized_input_data = inv_std_values[i % 3] *
+                                     (static_cast<float>(*row_data) -
+                                      normalization_options.mean_values[i % 3]);
+          }
         }
       }
       break;
     }
-    case kTfLiteInt8:
-      return tflite::support::CreateStatusWithPayload(
-          absl::StatusCode::kUnimplemented,
-          "kTfLiteInt8 input type is not implemented yet.");
+    case kTfLiteInt8: {
+      if (GetTensor()->bytes != input_data_byte_size) {
+        return tflite::support::CreateStatusWithPayload(
+            absl::StatusCode::kInternal,
+            "Size mismatch or unsupported padding bytes between pixel data "
+            "and input tensor.");
+      }
+      RETURN_IF_ERROR(UnbindInputBuffer());
+      // Normalize, quantize and populate.
+      ASSIGN_OR_RETURN(
+          int8* quantized_input_data,
+          tflite::task::core::AssertAndReturnTypedTensor<int8>(GetTensor()));
+      vision::PopulateFromLookupTables(
+          input_data, input_specs_.image_height, input_specs_.image_width,
+          input_row_stride_bytes, int8_lookup_tables_, quantized_input_data);
+      break;
+    }
+    case kTfLiteFloat16: {
+      if (GetTensor()->bytes / sizeof(TfLiteFloat16) !=
+          input_data_byte_size / sizeof(uint8)) {
+        return tflite::support::CreateStatusWithPayload(
+            absl::StatusCode::kInternal,
+            "Size mismatch or unsupported padding bytes between pixel data "
+            "and input tensor.");
+      }
+      RETURN_IF_ERROR(UnbindInputBuffer());
+      // Normalize, convert and populate.
+      ASSIGN_OR_RETURN(TfLiteFloat16 * normalized_input_data,
+                       tflite::task::core::AssertAndReturnTypedTensor<
+                           TfLiteFloat16>(GetTensor()));
+      vision::PopulateFromLookupTables(
+          input_data, input_specs_.image_height, input_specs_.image_width,
+          input_row_stride_bytes, float16_lookup_tables_,
+          normalized_input_data);
+      break;
+    }
     default:
       return tflite::support::CreateStatusWithPayload(
           absl::StatusCode::kInternal, "Unexpected input tensor type.");
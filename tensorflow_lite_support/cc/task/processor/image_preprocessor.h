@@ -16,12 +16,18 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_IMAGE_PREPROCESSOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_IMAGE_PREPROCESSOR_H_
 
+#include <memory>
+#include <utility>
+
+#include "tensorflow_lite_support/cc/port/integral_types.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/task/processor/processor.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_conversion_cache.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/pixel_lookup_tables.h"
 
 namespace tflite {
 namespace task {
@@ -29,12 +35,15 @@ namespace processor {
 
 // Process input image and populate the associate input tensor.
 // Requirement for the input tensor:
-//   (kTfLiteUInt8/kTfLiteFloat32)
+//   (kTfLiteUInt8/kTfLiteInt8/kTfLiteFloat16/kTfLiteFloat32)
 //    - image input of size `[batch x height x width x channels]`.
 //    - batch inference is not supported (`batch` is required to be 1).
 //    - only RGB inputs are supported (`channels` is required to be 3).
-//    - if type is kTfLiteFloat32, NormalizationOptions are required to be
-//      attached to the metadata for input normalization.
+//    - if type is kTfLiteFloat32 or kTfLiteFloat16, NormalizationOptions are
+//      required to be attached to the metadata for input normalization.
+//    - if type is kTfLiteInt8, the pixel values, normalized if
+//      NormalizationOptions are attached to the metadata, are quantized with
+//      the tensor quantization parameters.
 class ImagePreprocessor : public Preprocessor {
  public:
   static tflite::support::StatusOr<std::unique_ptr<ImagePreprocessor>> Create(
@@ -75,6 +84,27 @@ class ImagePreprocessor : public Preprocessor {
   // the inference as it bypasses image cropping and resizing.
   const vision::ImageTensorSpecs& GetInputSpecs() const { return input_specs_; }
 
+  // Sets the cache in which the preprocessed images are looked up before
+  // performing the preprocessing, and stored after it. Sharing a cache between
+  // preprocessors with the same input dimensions lets only the first of them
+  // preprocess a given frame. nullptr (the default) disables caching.
+  void SetFrameConversionCache(
+      std::shared_ptr<vision::FrameConversionCache> cache) {
+    frame_conversion_cache_ = std::move(cache);
+  }
+
+  // Enables binding the frame buffer data directly as the memory of the input
+  // tensor, instead of copying it, when the frame needs no preprocessing (i.e.
+  // is an upright RGB image at the input dimensions, without row padding), the
+  // input tensor is uint8 with a fixed shape, and the data is aligned to
+  // `tflite::kDefaultTensorAlignment` (64) bytes. The data must then remain
+  // valid and unchanged until the inference completes.
+  //
+  // Binding another buffer than the one of the previous inference requires
+  // re-preparing the interpreter, so this only pays off when successive frames
+  // are written to the same buffer. Disabled by default.
+  void SetZeroCopyInput(bool enabled) { zero_copy_input_ = enabled; }
+
  private:
   using Preprocessor::Preprocessor;
 
@@ -85,6 +115,20 @@ class ImagePreprocessor : public Preprocessor {
   absl::Status Init(
       const vision::FrameBufferUtils::ProcessEngine& process_engine);
 
+  // Builds the per-channel lookup tables mapping the pixel values to the
+  // values of int8 or float16 input tensors.
+  absl::Status InitLookupTables();
+
+  // Returns whether `data` can be bound as the memory of the input tensor.
+  bool CanBindInputBuffer(const uint8* data) const;
+
+  // Binds `data`, of `size` bytes, as the memory of the input tensor.
+  absl::Status BindInputBuffer(const uint8* data, size_t size);
+
+  // Binds the input tensor back to memory owned by the preprocessor if it is
+  // bound to the data of a previous frame buffer.
+  absl::Status UnbindInputBuffer();
+
   // Parameters related to the input tensor which represents an image.
   vision::ImageTensorSpecs input_specs_;
 
@@ -94,6 +138,22 @@ class ImagePreprocessor : public Preprocessor {
   // Is true if the model expects dynamic image shape, false otherwise.
   bool is_height_mutable_ = false;
   bool is_width_mutable_ = false;
+
+  // Optional cache of the preprocessed images.
+  std::shared_ptr<vision::FrameConversionCache> frame_conversion_cache_;
+
+  // Per-channel lookup tables mapping the pixel values to their normalized and
+  // quantized (resp. converted) values, for int8 (resp. float16) input tensors.
+  vision::PixelLookupTables<int8> int8_lookup_tables_;
+  vision::PixelLookupTables<TfLiteFloat16> float16_lookup_tables_;
+
+  // Whether to bind the frame buffer data as the input tensor memory.
+  bool zero_copy_input_ = false;
+
+  // Aligned input tensor memory, used once the input tensor has been bound to
+  // frame buffer data.
+  std::unique_ptr<uint8[]> owned_input_storage_;
+  uint8* owned_input_data_ = nullptr;
 };
 
 }  // namespace processor
@@ -14,7 +14,11 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow_lite_support/cc/task/processor/regex_preprocessor.h"
 
+#include <algorithm>
+
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow/lite/string_util.h"
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
@@ -75,6 +79,11 @@ absl::Status RegexPreprocessor::Init() {
 
   ASSIGN_OR_RETURN(tokenizer_, CreateTokenizerFromMetadata(
                                    tokenzier_metadata, GetMetadataExtractor()));
+  // Both tokens are checked in CreateTokenizerFromMetadata().
+  tokenizer_->GetUnknownToken(&unknown_token_id_);
+  tokenizer_->GetPadToken(&pad_token_id_);
+  const TfLiteIntArray* dims = GetTensor()->dims;
+  max_seq_len_ = dims->size == 2 ? dims->data[1] : dims->data[0];
   return absl::OkStatus();
 }
 
@@ -170,44 +179,75 @@ absl::Status RegexPreprocessor::Preprocess(const std::string& input_text) {
 }
 
 absl::Status RegexPreprocessor::RegexPreprocess(const std::string& input_text) {
-  TfLiteTensor* input_tensor = GetTensor();
-
   //                              |<-------sentence_length-------->|
   // input_tensor                 <START>, t1, t2... <PAD>, <PAD>...
   // <START> is optional, t1, t2... will be replaced by <UNKNOWN> if it's
   // not found in tokenizer vocab.
-  TokenizerResult result = tokenizer_->Tokenize(input_text);
-
-  size_t max_sentence_length = input_tensor->dims->size == 2
-                                   ? input_tensor->dims->data[1]
-                                   : input_tensor->dims->data[0];
-
-  int unknown_token_id = 0;
-  tokenizer_->GetUnknownToken(&unknown_token_id);
+  std::vector<int> input_tokens = Tokenize(input_text);
+  input_tokens.resize(max_seq_len_, pad_token_id_);
+  return PopulateTensor(input_tokens, GetTensor());
+}
 
-  int pad_token_id = 0;
-  tokenizer_->GetPadToken(&pad_token_id);
+std::vector<int> RegexPreprocessor::Tokenize(const std::string& text) const {
+  TokenizerResult result = tokenizer_->Tokenize(text);
 
-  std::vector<int> input_tokens(max_sentence_length, pad_token_id);
+  std::vector<int> ids;
+  ids.reserve(std::min<size_t>(result.subwords.size() + 1, max_seq_len_));
   int start_token_id = 0;
-  size_t input_token_index = 0;
-  if (tokenizer_->GetStartToken(&start_token_id)) {
-    input_tokens[0] = start_token_id;
-    input_token_index = 1;
+  if (tokenizer_->GetStartToken(&start_token_id) && max_seq_len_ > 0) {
+    ids.push_back(start_token_id);
   }
-
-  for (size_t i = 0; (i < result.subwords.size()) &&
-                     (input_token_index < max_sentence_length);
-       ++i, ++input_token_index) {
-    const std::string& token = result.subwords[i];
+  for (const std::string& token : result.subwords) {
+    if (ids.size() >= static_cast<size_t>(max_seq_len_)) break;
     int token_id = 0;
-    if (tokenizer_->LookupId(token, &token_id)) {
-      input_tokens[input_token_index] = token_id;
-    } else {
-      input_tokens[input_token_index] = unknown_token_id;
+    ids.push_back(tokenizer_->LookupId(token, &token_id) ? token_id
+                                                         : unknown_token_id_);
+  }
+  return ids;
+}
+
+absl::Status RegexPreprocessor::PreprocessBatch(
+    const std::vector<const std::vector<int>*>& batch, int seq_len) {
+  std::vector<int> input_tokens(batch.size() * seq_len, pad_token_id_);
+  for (int row = 0; row < batch.size(); ++row) {
+    const std::vector<int>& ids = *batch[row];
+    std::copy(ids.begin(),
+              ids.begin() + std::min<size_t>(ids.size(), seq_len),
+              input_tokens.begin() + row * seq_len);
+  }
+  return PopulateTensor(input_tokens, GetTensor());
+}
+
+absl::Status RegexPreprocessor::PreprocessBatch(
+    const std::vector<const std::string*>& texts) {
+  if (tokenizer_ != nullptr) {
+    std::vector<std::vector<int>> ids;
+    ids.reserve(texts.size());
+    std::vector<const std::vector<int>*> batch;
+    batch.reserve(texts.size());
+    for (const std::string* text : texts) {
+      ids.push_back(Tokenize(*text));
     }
+    for (const auto& text_ids : ids) {
+      batch.push_back(&text_ids);
+    }
+    return PreprocessBatch(batch, max_seq_len_);
   }
-  return PopulateTensor(input_tokens, input_tensor);
+  TfLiteTensor* input_tensor = GetTensor();
+  if (input_tensor->type != kTfLiteString) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrCat("Type mismatch for input tensor ", input_tensor->name,
+                     ". Requested STRING, got ",
+                     TfLiteTypeGetName(input_tensor->type), "."),
+        TfLiteSupportStatus::kInvalidInputTensorTypeError);
+  }
+  tflite::DynamicBuffer input_buf;
+  for (const std::string* text : texts) {
+    input_buf.AddString(text->data(), text->length());
+  }
+  input_buf.WriteToTensorAsVector(input_tensor);
+  return absl::OkStatus();
 }
 
 }  // namespace processor
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_REGEX_PREPROCESSOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_REGEX_PREPROCESSOR_H_
 
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/processor/text_preprocessor.h"
@@ -38,6 +41,19 @@ class RegexPreprocessor : public TextPreprocessor {
 
   absl::Status Preprocess(const std::string& text);
 
+  // Batch support. Tokenized inputs are made of the optional <START> token
+  // followed by the ids of the tokens, <UNKNOWN> for the ones missing from the
+  // vocabulary, and are always padded with <PAD> to the sequence length of the
+  // input tensor.
+  bool RequiresTokenization() const override { return tokenizer_ != nullptr; }
+  std::vector<int> Tokenize(const std::string& text) const override;
+  int GetMaxSeqLen() const override { return max_seq_len_; }
+  bool HasDynamicSeqLen() const override { return false; }
+  absl::Status PreprocessBatch(
+      const std::vector<const std::vector<int>*>& batch, int seq_len) override;
+  absl::Status PreprocessBatch(
+      const std::vector<const std::string*>& texts) override;
+
  private:
   using TextPreprocessor::TextPreprocessor;
 
@@ -55,6 +71,10 @@ class RegexPreprocessor : public TextPreprocessor {
       const tflite::metadata::ModelMetadataExtractor* metadata_extractor);
 
   std::unique_ptr<tflite::support::text::tokenizer::RegexTokenizer> tokenizer_;
+  // Special token ids and sequence length, only set if `tokenizer_` is set.
+  int unknown_token_id_ = 0;
+  int pad_token_id_ = 0;
+  int max_seq_len_ = 0;
 };
 
 }  // namespace processor
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_TEXT_PREPROCESSOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_TEXT_PREPROCESSOR_H_
 
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
@@ -45,6 +48,45 @@ class TextPreprocessor : public Preprocessor {
 
   absl::Status Preprocess(const std::string& text);
 
+  // Batch support, used to feed several texts to the model in a single
+  // invocation (see NLClassifier::ClassifyBatch()). The input tensors must
+  // have a leading batch dimension and be resized by the caller before calling
+  // PreprocessBatch(), with the sequence dimension (if any) resized to
+  // `seq_len`.
+
+  // Returns false if the model takes the raw text as input (string tensor),
+  // in which case Tokenize() and GetMaxSeqLen() must not be called.
+  virtual bool RequiresTokenization() const = 0;
+
+  // Returns the ids fed to the model for `text`, special tokens included,
+  // truncated to GetMaxSeqLen() and without padding. Tokenize() doesn't touch
+  // the input tensors and can be called concurrently from several threads.
+  virtual std::vector<int> Tokenize(const std::string& text) const = 0;
+
+  // Returns the maximum number of ids per text, i.e. the size of the sequence
+  // dimension the inputs are padded to unless HasDynamicSeqLen().
+  virtual int GetMaxSeqLen() const = 0;
+
+  // Returns true if the sequence dimension of the input tensors can be resized
+  // to the length of the longest sequence of each batch.
+  virtual bool HasDynamicSeqLen() const = 0;
+
+  // Populates the input tensors with one row of `seq_len` ids per element of
+  // `batch`, as returned by Tokenize() and padded to `seq_len`.
+  virtual absl::Status PreprocessBatch(
+      const std::vector<const std::vector<int>*>& batch, int seq_len) = 0;
+
+  // Populates the input tensors with `texts`, one per row. Tokenized inputs
+  // are padded to GetMaxSeqLen().
+  virtual absl::Status PreprocessBatch(
+      const std::vector<const std::string*>& texts) = 0;
+
+  // Returns the indices of the model input tensors populated by this
+  // preprocessor.
+  const std::vector<int>& GetInputTensorIndices() const {
+    return tensor_indices_;
+  }
+
  protected:
   using Preprocessor::Preprocessor;
 };
@@ -63,6 +63,11 @@ absl::Status BertNLClassifier::Preprocess(
 StatusOr<std::vector<core::Category>> BertNLClassifier::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const std::string& /*input*/) {
+  return PostprocessRow(output_tensors, /*row=*/0);
+}
+
+StatusOr<std::vector<core::Category>> BertNLClassifier::PostprocessRow(
+    const std::vector<const TfLiteTensor*>& output_tensors, int row) {
   if (output_tensors.size() != 1) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
@@ -74,9 +79,17 @@ StatusOr<std::vector<core::Category>> BertNLClassifier::Postprocess(
   const TfLiteTensor* scores = FindTensorByName(
       output_tensors, GetMetadataExtractor()->GetOutputTensorMetadata(),
       kScoreTensorName);
+  if (row > 0 && (scores->dims->size != 2 || scores->dims->data[0] <= row)) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Output tensor %s has no batch dimension, use a batch "
+                        "size of 1.",
+                        kScoreTensorName),
+        TfLiteSupportStatus::kInvalidOutputTensorDimensionsError);
+  }
 
   // optional labels extracted from metadata
-  return BuildResults(scores, /*labels=*/nullptr);
+  return BuildResults(scores, /*labels=*/nullptr, row);
 }
 
 StatusOr<std::unique_ptr<BertNLClassifier>> BertNLClassifier::CreateFromOptions(
@@ -99,8 +112,10 @@ absl::Status BertNLClassifier::Initialize(
   options_ = std::move(options);
 
   // Create preprocessor.
-  ASSIGN_OR_RETURN(preprocessor_, processor::BertPreprocessor::Create(
-                                      GetTfLiteEngine(), {0, 1, 2}));
+  ASSIGN_OR_RETURN(preprocessor_,
+                   processor::BertPreprocessor::Create(
+                       GetTfLiteEngine(), {0, 1, 2},
+                       options_->bert_preprocessor_options()));
 
   // Set up optional label vector from metadata.
   TrySetLabelFromMetadata(
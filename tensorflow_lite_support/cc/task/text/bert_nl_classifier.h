@@ -48,6 +48,10 @@ namespace text {
 //     file. If a label file is attached, the file should be a plain text file
 //     with one label per line, the number of labels should match the number of
 //     categories the model outputs.
+//
+// Inputs are padded to the sequence length of the input tensors. For models
+// with a dynamic sequence dimension, the input tensors can instead be resized
+// to the number of tokens of each input (see `bert_preprocessor_options`).
 
 class BertNLClassifier : public tflite::task::text::nlclassifier::NLClassifier {
  public:
@@ -117,6 +121,15 @@ class BertNLClassifier : public tflite::task::text::nlclassifier::NLClassifier {
       const std::vector<const TfLiteTensor*>& output_tensors,
       const std::string& input) override;
 
+  // Batch support, see NLClassifier::ClassifyBatch().
+  tflite::support::StatusOr<std::vector<core::Category>> PostprocessRow(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      int row) override;
+
+  tflite::task::processor::TextPreprocessor* GetTextPreprocessor() override {
+    return preprocessor_.get();
+  }
+
  private:
   // Initialize the API with the tokenizer and label files set in the metadata.
   absl::Status Initialize(std::unique_ptr<BertNLClassifierOptions> options);
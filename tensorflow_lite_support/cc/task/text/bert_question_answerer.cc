@@ -43,6 +43,7 @@ using ::tflite::support::text::tokenizer::BertTokenizer;
 using ::tflite::support::text::tokenizer::CreateTokenizerFromProcessUnit;
 using ::tflite::support::text::tokenizer::SentencePieceTokenizer;
 using ::tflite::support::text::tokenizer::TokenizerResult;
+using ::tflite::task::core::FindIndexByMetadataTensorName;
 using ::tflite::task::core::FindTensorByName;
 using ::tflite::task::core::PopulateTensor;
 using ::tflite::task::core::PopulateVector;
@@ -237,8 +238,14 @@ absl::Status BertQuestionAnswerer::Preprocess(
     }
   }
 
+  const int max_seq_len =
+      seq_len_resizer_ == nullptr
+          ? kMaxSeqLen
+          : std::min(static_cast<int>(kMaxSeqLen),
+                     seq_len_resizer_->max_seq_len());
   // -3 accounts for [CLS], [SEP] and [SEP].
-  int max_context_len = kMaxSeqLen - query_tokens.size() - 3;
+  int max_context_len =
+      std::max(0, max_seq_len - static_cast<int>(query_tokens.size()) - 3);
   if (all_doc_tokens.size() > max_context_len) {
     all_doc_tokens.resize(max_context_len);
   }
@@ -246,7 +253,7 @@ absl::Status BertQuestionAnswerer::Preprocess(
   std::vector<std::string> tokens;
   tokens.reserve(3 + query_tokens.size() + all_doc_tokens.size());
   std::vector<int> segment_ids;
-  segment_ids.reserve(kMaxSeqLen);
+  segment_ids.reserve(max_seq_len);
 
   // Start of generating the features.
   tokens.emplace_back("[CLS]");
@@ -274,8 +281,16 @@ absl::Status BertQuestionAnswerer::Preprocess(
   tokens.emplace_back("[SEP]");
   segment_ids.emplace_back(1);
 
+  // Length of the input tensors: kMaxSeqLen, unless dynamic sequence lengths
+  // are enabled.
+  int seq_len = kMaxSeqLen;
+  if (seq_len_resizer_ != nullptr) {
+    ASSIGN_OR_RETURN(seq_len,
+                     seq_len_resizer_->ResizeForNumTokens(tokens.size()));
+  }
+
   std::vector<int> input_ids(tokens.size());
-  input_ids.reserve(kMaxSeqLen);
+  input_ids.reserve(seq_len);
   // Convert tokens back into ids
   for (int i = 0; i < tokens.size(); i++) {
     auto& token = tokens[i];
@@ -283,19 +298,19 @@ absl::Status BertQuestionAnswerer::Preprocess(
   }
 
   std::vector<int> input_mask;
-  input_mask.reserve(kMaxSeqLen);
+  input_mask.reserve(seq_len);
   input_mask.insert(input_mask.end(), tokens.size(), 1);
 
-  int zeros_to_pad = kMaxSeqLen - input_ids.size();
+  int zeros_to_pad = seq_len - input_ids.size();
   input_ids.insert(input_ids.end(), zeros_to_pad, 0);
   input_mask.insert(input_mask.end(), zeros_to_pad, 0);
   segment_ids.insert(segment_ids.end(), zeros_to_pad, 0);
 
-  // input_ids INT32[1, 384]
+  // input_ids INT32[1, seq_len]
   RETURN_IF_ERROR(PopulateTensor(input_ids, ids_tensor));
-  // input_mask INT32[1, 384]
+  // input_mask INT32[1, seq_len]
   RETURN_IF_ERROR(PopulateTensor(input_mask, mask_tensor));
-  // segment_ids INT32[1, 384]
+  // segment_ids INT32[1, seq_len]
   RETURN_IF_ERROR(PopulateTensor(segment_ids, segment_ids_tensor));
 
   return absl::OkStatus();
@@ -322,17 +337,26 @@ StatusOr<std::vector<QaAnswer>> BertQuestionAnswerer::Postprocess(
   std::vector<float> end_logits;
   std::vector<float> start_logits;
 
-  // end_logits FLOAT[1, 384]
+  // end_logits FLOAT[1, seq_len]
   RETURN_IF_ERROR(PopulateVector(end_logits_tensor, &end_logits));
-  // start_logits FLOAT[1, 384]
+  // start_logits FLOAT[1, seq_len]
   RETURN_IF_ERROR(PopulateVector(start_logits_tensor, &start_logits));
 
   auto start_indices = ReverseSortIndices(start_logits);
   auto end_indices = ReverseSortIndices(end_logits);
 
   std::vector<QaAnswer::Pos> orig_results;
-  for (int start_index = 0; start_index < kPredictAnsNum; start_index++) {
-    for (int end_index = 0; end_index < kPredictAnsNum; end_index++) {
+  // With dynamic sequence lengths, there may be less than kPredictAnsNum
+  // logits.
+  const int num_start_candidates =
+      std::min(static_cast<int>(kPredictAnsNum),
+               static_cast<int>(start_indices.size()));
+  const int num_end_candidates =
+      std::min(static_cast<int>(kPredictAnsNum),
+               static_cast<int>(end_indices.size()));
+  for (int start_index = 0; start_index < num_start_candidates;
+       start_index++) {
+    for (int end_index = 0; end_index < num_end_candidates; end_index++) {
       int start = start_indices[start_index];
       int end = end_indices[end_index];
 
@@ -383,6 +407,28 @@ absl::Status BertQuestionAnswerer::InitializeFromMetadata(
   ASSIGN_OR_RETURN(tokenizer_,
                    CreateTokenizerFromProcessUnit(tokenizer_process_unit,
                                                   GetMetadataExtractor()));
+
+  // Identify the indices of the three input tensors, falling back to the
+  // model input order if they can't be found by name.
+  auto* input_tensor_metadatas =
+      GetMetadataExtractor()->GetInputTensorMetadata();
+  std::vector<int> input_tensor_indices;
+  const char* const tensor_names[] = {kIdsTensorName, kMaskTensorName,
+                                      kSegmentIdsTensorName};
+  for (int i = 0; i < 3; ++i) {
+    const int index =
+        input_tensor_metadatas == nullptr
+            ? -1
+            : FindIndexByMetadataTensorName(input_tensor_metadatas,
+                                            tensor_names[i]);
+    input_tensor_indices.push_back(index == -1 ? i : index);
+  }
+  ASSIGN_OR_RETURN(processor::BertSeqLenResizer seq_len_resizer,
+                   processor::BertSeqLenResizer::Create(
+                       GetTfLiteEngine(), input_tensor_indices,
+                       options_->bert_preprocessor_options(), kMaxSeqLen));
+  seq_len_resizer_ = absl::make_unique<processor::BertSeqLenResizer>(
+      std::move(seq_len_resizer));
   return absl::OkStatus();
 }
 
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/core/base_task_api.h"
 #include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/cc/task/processor/bert_preprocessor.h"
 #include "tensorflow_lite_support/cc/task/text/proto/bert_question_answerer_options_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/text/question_answerer.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/bert_tokenizer.h"
@@ -150,6 +151,10 @@ class BertQuestionAnswerer : public QuestionAnswerer {
   // Original tokens of context.
   std::vector<std::string> orig_tokens_;
   std::unique_ptr<BertQuestionAnswererOptions> options_;
+  // Resizes the input tensors for each input if dynamic sequence lengths are
+  // enabled in the options. Null if the API was not created from options, in
+  // which case inputs are always padded to kMaxSeqLen.
+  std::unique_ptr<processor::BertSeqLenResizer> seq_len_resizer_;
 };
 
 }  // namespace text
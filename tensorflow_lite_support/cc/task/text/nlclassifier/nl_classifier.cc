@@ -15,16 +15,23 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/text/nlclassifier/nl_classifier.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <numeric>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
@@ -34,6 +41,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/core/category.h"
 #include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/utils/common_utils.h"
 
@@ -53,19 +61,109 @@ using ::tflite::support::utils::LoadVocabFromBuffer;
 using ::tflite::task::core::Category;
 using ::tflite::task::core::Dequantize;
 using ::tflite::task::core::GetStringAtIndex;
+using ::tflite::task::core::InferenceStage;
+using ::tflite::task::core::Stopwatch;
 using ::tflite::task::core::TaskAPIFactory;
+using ::tflite::task::core::TaskStats;
+using ::tflite::task::core::TfLiteEngine;
+using ::tflite::task::processor::TextPreprocessor;
 // To differenciate it with the struct option,
 // tflite::task::text::nl_classifier::NLClassifierOptions.
 using NLClassifierProtoOptions = ::tflite::task::text::NLClassifierOptions;
 
 namespace {
 
+// Texts are handed out to the tokenization threads by chunks of this size.
+constexpr int kTokenizationChunkSize = 16;
+
 absl::Status SanityCheckOptions(const NLClassifierProtoOptions& options) {
   if (!options.has_base_options()) {
     return CreateStatusWithPayload(StatusCode::kInvalidArgument,
                                    "Missing mandatory `base_options` field",
                                    TfLiteSupportStatus::kInvalidArgumentError);
   }
+  if (options.max_results() == 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Invalid `max_results` option: value must be != 0",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+// Returns the number of elements of `tensor`.
+int64_t NumElements(const TfLiteTensor* tensor) {
+  int64_t num_elements = 1;
+  for (int i = 0; i < tensor->dims->size; ++i) {
+    num_elements *= tensor->dims->data[i];
+  }
+  return num_elements;
+}
+
+// Tokenizes each of `texts` into the corresponding entry of `ids`, spreading
+// the work across the available cores.
+void TokenizeAll(const TextPreprocessor& preprocessor,
+                 const std::vector<std::string>& texts,
+                 std::vector<std::vector<int>>* ids) {
+  const int num_threads = std::max<int>(
+      1, std::min<int>(std::thread::hardware_concurrency(),
+                       texts.size() / kTokenizationChunkSize));
+  std::atomic<int> next_chunk(0);
+  auto worker = [&]() {
+    for (int begin = next_chunk.fetch_add(kTokenizationChunkSize);
+         begin < texts.size();
+         begin = next_chunk.fetch_add(kTokenizationChunkSize)) {
+      const int end =
+          std::min<int>(begin + kTokenizationChunkSize, texts.size());
+      for (int i = begin; i < end; ++i) {
+        (*ids)[i] = preprocessor.Tokenize(texts[i]);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  // The calling thread acts as the first worker.
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Resizes the input tensors at `input_indices` to `input_dims` and
+// re-allocates the tensors, unless they already have the requested shapes.
+absl::Status ResizeInputTensors(TfLiteEngine* engine,
+                                const std::vector<int>& input_indices,
+                                const std::vector<std::vector<int>>& input_dims) {
+  auto* interpreter = engine->interpreter();
+  bool resized = false;
+  for (int i = 0; i < input_indices.size(); ++i) {
+    const TfLiteIntArray* dims =
+        engine->GetInput(interpreter, input_indices[i])->dims;
+    if (std::equal(input_dims[i].begin(), input_dims[i].end(), dims->data,
+                   dims->data + dims->size)) {
+      continue;
+    }
+    if (interpreter->ResizeInputTensor(interpreter->inputs()[input_indices[i]],
+                                       input_dims[i]) != kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrFormat("Failed to resize input tensor %d to [%s]. Use a "
+                          "batch size of 1 if the model doesn't support "
+                          "batching.",
+                          input_indices[i], absl::StrJoin(input_dims[i], ", ")),
+          TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
+    }
+    resized = true;
+  }
+  if (resized && interpreter->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(StatusCode::kInternal,
+                                   "Failed to allocate tensors for batch.",
+                                   TfLiteSupportStatus::kError);
+  }
   return absl::OkStatus();
 }
 
@@ -119,6 +217,154 @@ std::vector<Category> NLClassifier::Classify(const std::string& text) {
   return Infer(text).value();
 }
 
+StatusOr<std::vector<std::vector<Category>>> NLClassifier::ClassifyBatch(
+    const std::vector<std::string>& texts, int max_batch_size,
+    BatchStats* stats) {
+  if (max_batch_size <= 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected a positive max_batch_size, found %d.",
+                        max_batch_size),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  BatchStats local_stats;
+  if (stats == nullptr) {
+    stats = &local_stats;
+  }
+  *stats = BatchStats();
+  std::vector<std::vector<Category>> results(texts.size());
+  if (texts.empty()) {
+    return results;
+  }
+
+  TextPreprocessor* preprocessor = GetTextPreprocessor();
+  const bool tokenized = preprocessor->RequiresTokenization();
+  const std::vector<int>& input_indices =
+      preprocessor->GetInputTensorIndices();
+  // Tokenized inputs are expected to have shape [batch, seq_len] and raw text
+  // inputs shape [batch].
+  const int expected_rank = tokenized ? 2 : 1;
+  std::vector<std::vector<int>> original_input_dims;
+  for (int index : input_indices) {
+    const TfLiteIntArray* dims =
+        GetTfLiteEngine()->GetInput(GetTfLiteEngine()->interpreter(), index)
+            ->dims;
+    if (dims->size != expected_rank) {
+      max_batch_size = 1;
+    }
+    original_input_dims.emplace_back(dims->data, dims->data + dims->size);
+  }
+
+  // Sort the texts by number of tokens, so that each batch is padded to the
+  // length of texts of similar lengths.
+  std::vector<std::vector<int>> ids;
+  std::vector<int> order(texts.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (tokenized) {
+    ids.resize(texts.size());
+    TokenizeAll(*preprocessor, texts, &ids);
+    std::stable_sort(order.begin(), order.end(), [&ids](int a, int b) {
+      return ids[a].size() < ids[b].size();
+    });
+  }
+
+  absl::Status status;
+  for (int begin = 0; begin < order.size() && status.ok();
+       begin += max_batch_size) {
+    const std::vector<int> text_indices(
+        order.begin() + begin,
+        order.begin() + std::min<int>(begin + max_batch_size, order.size()));
+    status = ClassifyOneBatch(texts, ids, text_indices, original_input_dims,
+                              &results, stats);
+  }
+  // Restore the input tensors, even on failure, so that Classify() keeps
+  // working.
+  const absl::Status restore_status = ResizeInputTensors(
+      GetTfLiteEngine(), input_indices, original_input_dims);
+  RETURN_IF_ERROR(status);
+  RETURN_IF_ERROR(restore_status);
+  return results;
+}
+
+absl::Status NLClassifier::ClassifyOneBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<int>>& ids,
+    const std::vector<int>& text_indices,
+    const std::vector<std::vector<int>>& original_input_dims,
+    std::vector<std::vector<Category>>* results, BatchStats* stats) {
+  TextPreprocessor* preprocessor = GetTextPreprocessor();
+  const int batch_size = text_indices.size();
+  // Each batch is accounted as one inference in the latency statistics.
+  TaskStats* task_stats = GetTfLiteEngine()->mutable_stats();
+  Stopwatch stopwatch;
+
+  // Texts are sorted by number of tokens: the last one is the longest.
+  int seq_len = 0;
+  if (preprocessor->RequiresTokenization()) {
+    seq_len = preprocessor->HasDynamicSeqLen()
+                  ? std::max<int>(1, ids[text_indices.back()].size())
+                  : preprocessor->GetMaxSeqLen();
+  }
+  // Only resize the dimensions known to be the batch and sequence ones (see
+  // ClassifyBatch()).
+  std::vector<std::vector<int>> input_dims = original_input_dims;
+  for (auto& dims : input_dims) {
+    if (!preprocessor->RequiresTokenization()) {
+      if (dims.size() == 1) dims[0] = batch_size;
+    } else if (!dims.empty()) {
+      dims.back() = seq_len;
+      if (dims.size() == 2) dims[0] = batch_size;
+    }
+  }
+  RETURN_IF_ERROR(ResizeInputTensors(GetTfLiteEngine(),
+                                     preprocessor->GetInputTensorIndices(),
+                                     input_dims));
+
+  if (preprocessor->RequiresTokenization()) {
+    std::vector<const std::vector<int>*> batch;
+    batch.reserve(batch_size);
+    for (int index : text_indices) {
+      batch.push_back(&ids[index]);
+      stats->num_tokens += std::min<int>(ids[index].size(), seq_len);
+    }
+    stats->num_padded_tokens += static_cast<int64_t>(batch_size) * seq_len;
+    RETURN_IF_ERROR(preprocessor->PreprocessBatch(batch, seq_len));
+  } else {
+    std::vector<const std::string*> batch;
+    batch.reserve(batch_size);
+    for (int index : text_indices) {
+      batch.push_back(&texts[index]);
+    }
+    RETURN_IF_ERROR(preprocessor->PreprocessBatch(batch));
+  }
+  const absl::Duration preprocess_time = stopwatch.Lap();
+  task_stats->RecordInference(InferenceStage::kPreprocess, preprocess_time);
+
+  absl::Status status =
+      GetTfLiteEngine()->interpreter_wrapper()->InvokeWithoutFallback();
+  const absl::Duration invoke_time = stopwatch.Lap();
+  task_stats->RecordInference(InferenceStage::kInvoke, invoke_time);
+  if (!status.ok()) {
+    return status.GetPayload(tflite::support::kTfLiteSupportPayload)
+                   .has_value()
+               ? status
+               : CreateStatusWithPayload(status.code(), status.message());
+  }
+  stats->num_invocations++;
+
+  const std::vector<const TfLiteTensor*> output_tensors = GetOutputTensors();
+  for (int row = 0; row < batch_size; ++row) {
+    ASSIGN_OR_RETURN(std::vector<Category> row_results,
+                     PostprocessRow(output_tensors, row));
+    (*results)[text_indices[row]] = std::move(row_results);
+  }
+  const absl::Duration postprocess_time = stopwatch.Lap();
+  task_stats->RecordInference(InferenceStage::kPostprocess, postprocess_time);
+  task_stats->RecordInference(
+      InferenceStage::kTotal, preprocess_time + invoke_time + postprocess_time);
+  return absl::OkStatus();
+}
+
 absl::Status NLClassifier::Preprocess(
     const std::vector<TfLiteTensor*>& input_tensors, const std::string& input) {
   return preprocessor_->Preprocess(input);
@@ -127,53 +373,113 @@ absl::Status NLClassifier::Preprocess(
 StatusOr<std::vector<Category>> NLClassifier::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const std::string& /*input*/) {
+  return PostprocessRow(output_tensors, /*row=*/0);
+}
+
+StatusOr<std::vector<Category>> NLClassifier::PostprocessRow(
+    const std::vector<const TfLiteTensor*>& output_tensors, int row) {
+  const TfLiteTensor* scores = FindTensorWithNameOrIndex(
+      output_tensors, GetMetadataExtractor()->GetOutputTensorMetadata(),
+      struct_options_.output_score_tensor_name,
+      struct_options_.output_score_tensor_index);
+  if (row > 0 && (scores->dims->size != 2 || scores->dims->data[0] <= row)) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Output score tensor %s has no batch dimension, use a "
+                        "batch size of 1.",
+                        scores->name),
+        TfLiteSupportStatus::kInvalidOutputTensorDimensionsError);
+  }
   return BuildResults(
-      FindTensorWithNameOrIndex(
-          output_tensors, GetMetadataExtractor()->GetOutputTensorMetadata(),
-          struct_options_.output_score_tensor_name,
-          struct_options_.output_score_tensor_index),
+      scores,
       FindTensorWithNameOrIndex(
           output_tensors, GetMetadataExtractor()->GetOutputTensorMetadata(),
           struct_options_.output_label_tensor_name,
-          struct_options_.output_label_tensor_index));
+          struct_options_.output_label_tensor_index),
+      row);
 }
 
 std::vector<Category> NLClassifier::BuildResults(const TfLiteTensor* scores,
-                                                 const TfLiteTensor* labels) {
-  bool use_index_as_labels = (labels_vector_ == nullptr) && (labels == nullptr);
+                                                 const TfLiteTensor* labels,
+                                                 int row) {
   // Some models output scores with transposed shape [1, categories]
   int categories =
       scores->dims->size == 2 ? scores->dims->data[1] : scores->dims->data[0];
-
-  std::vector<Category> predictions;
-  predictions.reserve(categories);
+  // Batched scores have shape [batch, categories]. The label tensor may either
+  // be shared by all the rows or have one row per input.
+  const int score_offset = row * categories;
+  const int label_offset =
+      labels != nullptr && NumElements(labels) > categories ? score_offset : 0;
 
   bool should_dequantize = scores->type == kTfLiteUInt8 ||
                            scores->type == kTfLiteInt8 ||
                            scores->type == kTfLiteInt16;
-  for (int index = 0; index < categories; index++) {
-    std::string label;
-    if (use_index_as_labels) {
-      label = std::to_string(index);
-    } else if (labels_vector_ == nullptr) {
-      if (labels->type == kTfLiteString) {
-        label = GetStringAtIndex(labels, index);
-      } else if (labels->type == kTfLiteInt32) {
-        label = std::to_string(GetTensorData<int>(labels)[index]);
-      }
-    } else {
-      label = (*labels_vector_)[index];
-    }
+  auto get_score = [&](int index) -> double {
+    const int score_index = score_offset + index;
     if (should_dequantize) {
-      predictions.push_back(Category(label, Dequantize(*scores, index)));
+      return Dequantize(*scores, score_index);
     } else if (scores->type == kTfLiteBool) {
-      predictions.push_back(
-          Category(label, GetTensorData<bool>(scores)[index] ? 1.0 : 0.0));
+      return GetTensorData<bool>(scores)[score_index] ? 1.0 : 0.0;
+    }
+    return scores->type == kTfLiteFloat32
+               ? GetTensorData<float>(scores)[score_index]
+               : GetTensorData<double>(scores)[score_index];
+  };
+
+  // Select the (index, score) pairs to return in a single pass over the
+  // scores. With `max_results_` set, the best ones are kept in a heap whose
+  // front is the worst of them; ties are broken by lowest index.
+  const auto is_better = [](const std::pair<int, double>& a,
+                            const std::pair<int, double>& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  };
+  std::vector<std::pair<int, double>> selected;
+  selected.reserve(max_results_ > 0 ? std::min(categories, max_results_)
+                                    : categories);
+  for (int index = 0; index < categories; index++) {
+    const double score = get_score(index);
+    if (has_score_threshold_ && score < score_threshold_) {
+      continue;
+    }
+    if (max_results_ < 0) {
+      selected.emplace_back(index, score);
+    } else if (static_cast<int>(selected.size()) < max_results_) {
+      selected.emplace_back(index, score);
+      std::push_heap(selected.begin(), selected.end(), is_better);
+    } else if (is_better({index, score}, selected.front())) {
+      std::pop_heap(selected.begin(), selected.end(), is_better);
+      selected.back() = {index, score};
+      std::push_heap(selected.begin(), selected.end(), is_better);
+    }
+  }
+  if (max_results_ >= 0) {
+    std::sort_heap(selected.begin(), selected.end(), is_better);
+  }
+
+  // Labels only get read for the selected results. Index labels are created
+  // once and reused across calls.
+  if (labels_vector_ == nullptr && labels == nullptr) {
+    for (int index = index_labels_.size(); index < categories; ++index) {
+      index_labels_.push_back(std::to_string(index));
+    }
+  }
+  std::vector<Category> predictions;
+  predictions.reserve(selected.size());
+  for (const auto& entry : selected) {
+    const int index = entry.first;
+    if (labels_vector_ != nullptr) {
+      predictions.emplace_back((*labels_vector_)[index], entry.second);
+    } else if (labels == nullptr) {
+      predictions.emplace_back(index_labels_[index], entry.second);
+    } else if (labels->type == kTfLiteString) {
+      predictions.emplace_back(GetStringAtIndex(labels, label_offset + index),
+                               entry.second);
+    } else if (labels->type == kTfLiteInt32) {
+      predictions.emplace_back(
+          std::to_string(GetTensorData<int>(labels)[label_offset + index]),
+          entry.second);
     } else {
-      predictions.push_back(
-          Category(label, scores->type == kTfLiteFloat32
-                              ? GetTensorData<float>(scores)[index]
-                              : GetTensorData<double>(scores)[index]));
+      predictions.emplace_back(std::string(), entry.second);
     }
   }
 
@@ -183,6 +489,9 @@ std::vector<Category> NLClassifier::BuildResults(const TfLiteTensor* scores,
 absl::Status NLClassifier::Initialize(
     std::unique_ptr<tflite::task::text::NLClassifierOptions> options) {
   proto_options_ = std::move(options);
+  max_results_ = proto_options_->max_results();
+  has_score_threshold_ = proto_options_->has_score_threshold();
+  score_threshold_ = proto_options_->score_threshold();
 
   RETURN_IF_ERROR(Initialize(NLClassifierOptions{
       .input_tensor_index = proto_options_->input_tensor_index(),
@@ -19,6 +19,7 @@ limitations under the License.
 #include <stddef.h>
 #include <string.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -35,6 +36,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/core/base_task_api.h"
 #include "tensorflow_lite_support/cc/task/core/category.h"
 #include "tensorflow_lite_support/cc/task/processor/regex_preprocessor.h"
+#include "tensorflow_lite_support/cc/task/processor/text_preprocessor.h"
 #include "tensorflow_lite_support/cc/task/text/proto/nl_classifier_options_proto_inc.h"
 
 namespace tflite {
@@ -136,6 +138,41 @@ class NLClassifier : public core::BaseTaskApi<std::vector<core::Category>,
   // Performs classification on a string input, returns classified results.
   std::vector<core::Category> Classify(const std::string& text);
 
+  // Statistics about a ClassifyBatch() call.
+  struct BatchStats {
+    // Number of model invocations.
+    int num_invocations = 0;
+    // Number of token ids fed to the model, padding excluded.
+    int64_t num_tokens = 0;
+    // Number of token ids fed to the model, padding included.
+    int64_t num_padded_tokens = 0;
+
+    // Fraction of the token ids fed to the model that are not padding. Always
+    // 1 for models taking raw text as input.
+    double padding_efficiency() const {
+      return num_padded_tokens == 0
+                 ? 1.0
+                 : static_cast<double>(num_tokens) / num_padded_tokens;
+    }
+  };
+
+  // Performs classification on each of `texts`, returns the classified results
+  // in the same order.
+  //
+  // The texts are tokenized in parallel, sorted by number of tokens and packed
+  // into batches of up to `max_batch_size` texts, so that texts of similar
+  // lengths get padded together. The batch dimension of the input tensors is
+  // resized for each batch (as well as their sequence dimension if the model
+  // supports it, see BertPreprocessorOptions) and the model is invoked once
+  // per batch. The input tensors are restored to their original shape
+  // afterwards. Models whose input tensors have no batch dimension are invoked
+  // once per text.
+  //
+  // If `stats` is not null, it is filled with statistics about the call.
+  tflite::support::StatusOr<std::vector<std::vector<core::Category>>>
+  ClassifyBatch(const std::vector<std::string>& texts, int max_batch_size = 32,
+                BatchStats* stats = nullptr);
+
  protected:
   static constexpr int kOutputTensorIndex = 0;
   static constexpr int kOutputTensorLabelFileIndex = 0;
@@ -170,8 +207,23 @@ class NLClassifier : public core::BaseTaskApi<std::vector<core::Category>,
       const std::vector<const TfLiteTensor*>& output_tensors,
       const std::string& input) override;
 
+  // Extracts the results for the `row`-th input of the batch from the model
+  // outputs. Used by Postprocess() (with `row` = 0) and ClassifyBatch().
+  virtual tflite::support::StatusOr<std::vector<core::Category>> PostprocessRow(
+      const std::vector<const TfLiteTensor*>& output_tensors, int row);
+
+  // Returns the preprocessor populating the input tensors. Used by
+  // ClassifyBatch().
+  virtual tflite::task::processor::TextPreprocessor* GetTextPreprocessor() {
+    return preprocessor_.get();
+  }
+
+  // Creates the results from the `row`-th row of `scores` (and `labels`, if it
+  // has one row per input), keeping the top `max_results` ones above
+  // `score_threshold` if these options are set.
   std::vector<core::Category> BuildResults(const TfLiteTensor* scores,
-                                           const TfLiteTensor* labels);
+                                           const TfLiteTensor* labels,
+                                           int row = 0);
 
   // Gets the tensor from a vector of tensors by checking tensor name first and
   // tensor index second, return nullptr if no tensor is found.
@@ -214,6 +266,17 @@ class NLClassifier : public core::BaseTaskApi<std::vector<core::Category>,
   }
 
  private:
+  // Resizes the input tensors to fit the texts at `text_indices` (see
+  // ClassifyBatch()), populates them from `ids` (or `texts` if the model takes
+  // raw text as input), invokes the model and stores the results in the
+  // corresponding entries of `results`.
+  absl::Status ClassifyOneBatch(
+      const std::vector<std::string>& texts,
+      const std::vector<std::vector<int>>& ids,
+      const std::vector<int>& text_indices,
+      const std::vector<std::vector<int>>& original_input_dims,
+      std::vector<std::vector<core::Category>>* results, BatchStats* stats);
+
   std::unique_ptr<tflite::task::processor::RegexPreprocessor> preprocessor_ =
       nullptr;
 
@@ -223,6 +286,16 @@ class NLClassifier : public core::BaseTaskApi<std::vector<core::Category>,
   // exists.
   std::unique_ptr<std::vector<std::string>> labels_vector_;
 
+  // Class names used when there is neither a label file nor an output label
+  // tensor, created on the first use.
+  std::vector<std::string> index_labels_;
+
+  // Options from proto_options_, if any. By default, all the results are
+  // returned.
+  int max_results_ = -1;
+  bool has_score_threshold_ = false;
+  float score_threshold_ = 0;
+
   // Deprecated: using the proto_options_
   // (tflite::task::text::NLClassifierOptions).
   NLClassifierOptions struct_options_;
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_conversion_cache.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
@@ -63,6 +64,33 @@ class BaseVisionTaskApi
     process_engine_ = process_engine;
   }
 
+  // Sets the cache of preprocessed images shared with other tasks consuming
+  // the same frames, e.g. several classifiers with the same input dimensions
+  // running on each camera frame: the first task to process a frame (or a
+  // region of interest of it) performs the resizing, color space conversion
+  // and rotation, the other ones reuse its result. nullptr disables caching.
+  //
+  // Frames are identified by their buffers and timestamp, so a frame buffer
+  // whose pixels are overwritten in place must be given a new timestamp. Can be
+  // called at any time; it takes effect from the next inference.
+  void SetFrameConversionCache(std::shared_ptr<FrameConversionCache> cache) {
+    frame_conversion_cache_ = std::move(cache);
+    if (preprocessor_ != nullptr) {
+      preprocessor_->SetFrameConversionCache(frame_conversion_cache_);
+    }
+  }
+
+  // Enables binding the pixel data of the frame buffers directly as the input
+  // tensor memory instead of copying it, for the frames that need no
+  // preprocessing. See `ImagePreprocessor::SetZeroCopyInput` for the
+  // requirements. Must be called before any inference is performed.
+  void SetZeroCopyInput(bool enabled) {
+    zero_copy_input_ = enabled;
+    if (preprocessor_ != nullptr) {
+      preprocessor_->SetZeroCopyInput(zero_copy_input_);
+    }
+  }
+
  protected:
   FrameBufferUtils::ProcessEngine process_engine_;
 
@@ -76,6 +104,8 @@ class BaseVisionTaskApi
     ASSIGN_OR_RETURN(preprocessor_,
                      ::tflite::task::processor::ImagePreprocessor::Create(
                          this->GetTfLiteEngine(), {0}, process_engine_));
+    preprocessor_->SetFrameConversionCache(frame_conversion_cache_);
+    preprocessor_->SetZeroCopyInput(zero_copy_input_);
     return absl::OkStatus();
   }
 
@@ -122,8 +152,19 @@ class BaseVisionTaskApi
     return preprocessor_->GetInputSpecs();
   }
 
+  // Applies the process engine, frame conversion cache and zero-copy setting of
+  // this task to `other`, e.g. to the other instances of a pool running
+  // inferences on behalf of this task.
+  void CopyPreprocessingSettingsTo(BaseVisionTaskApi* other) const {
+    other->SetProcessEngine(process_engine_);
+    other->SetFrameConversionCache(frame_conversion_cache_);
+    other->SetZeroCopyInput(zero_copy_input_);
+  }
+
  private:
   std::unique_ptr<processor::ImagePreprocessor> preprocessor_ = nullptr;
+  std::shared_ptr<FrameConversionCache> frame_conversion_cache_;
+  bool zero_copy_input_ = false;
 };
 
 }  // namespace vision
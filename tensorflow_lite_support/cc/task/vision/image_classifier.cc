@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
 
+#include <algorithm>
+
 #include "absl/algorithm/container.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
@@ -46,6 +48,9 @@ using ::tflite::task::core::AssertAndReturnTypedTensor;
 using ::tflite::task::core::TaskAPIFactory;
 using ::tflite::task::core::TfLiteEngine;
 
+// Number of bytes required for 8-bit per pixel RGB color space.
+constexpr int kRgbPixelBytes = 3;
+
 }  // namespace
 
 /* static */
@@ -53,7 +58,33 @@ StatusOr<std::unique_ptr<ImageClassifier>> ImageClassifier::CreateFromOptions(
     const ImageClassifierOptions& options,
     std::unique_ptr<tflite::OpResolver> resolver) {
   RETURN_IF_ERROR(SanityCheckOptions(options));
+  if (GetNumTileWorkers(options.num_roi_workers()) > 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "More than one of `num_roi_workers` requires one OpResolver per "
+        "worker: use the CreateFromOptions() overload taking an "
+        "OpResolverFactory instead.",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return CreateFromOptionsInternal(options, std::move(resolver));
+}
+
+/* static */
+StatusOr<std::unique_ptr<ImageClassifier>> ImageClassifier::CreateFromOptions(
+    const ImageClassifierOptions& options,
+    const OpResolverFactory& op_resolver_factory) {
+  RETURN_IF_ERROR(SanityCheckOptions(options));
+  ASSIGN_OR_RETURN(std::unique_ptr<ImageClassifier> image_classifier,
+                   CreateFromOptionsInternal(options, op_resolver_factory()));
+  RETURN_IF_ERROR(image_classifier->InitRoiWorkers(op_resolver_factory));
+  return image_classifier;
+}
 
+/* static */
+StatusOr<std::unique_ptr<ImageClassifier>>
+ImageClassifier::CreateFromOptionsInternal(
+    const ImageClassifierOptions& options,
+    std::unique_ptr<tflite::OpResolver> resolver) {
   // Copy options to ensure the ExternalFile outlives the constructed object.
   auto options_copy = absl::make_unique<ImageClassifierOptions>(options);
 
@@ -384,9 +415,170 @@ StatusOr<ClassificationResult> ImageClassifier::Classify(
   return InferWithFallback(frame_buffer, roi);
 }
 
+StatusOr<std::vector<ClassificationResult>> ImageClassifier::ClassifyRois(
+    const FrameBuffer& frame_buffer, absl::Span<const BoundingBox> rois) {
+  std::vector<ClassificationResult> results;
+
+  // Validate all regions upfront, and find the smallest region covering them.
+  const FrameBuffer::Dimension& dimension = frame_buffer.dimension();
+  int left = dimension.width;
+  int top = dimension.height;
+  int right = 0;
+  int bottom = 0;
+  for (int i = 0; i < rois.size(); ++i) {
+    const BoundingBox& roi = rois[i];
+    if (roi.origin_x() < 0 || roi.origin_y() < 0 || roi.width() <= 0 ||
+        roi.height() <= 0 || roi.origin_x() + roi.width() > dimension.width ||
+        roi.origin_y() + roi.height() > dimension.height) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Region of interest at index %d is empty or out of "
+                          "the bounds of the %dx%d frame buffer.",
+                          i, dimension.width, dimension.height),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    left = std::min(left, roi.origin_x());
+    top = std::min(top, roi.origin_y());
+    right = std::max(right, roi.origin_x() + roi.width());
+    bottom = std::max(bottom, roi.origin_y() + roi.height());
+  }
+
+  // Each region is cropped and resized before being converted, so converting
+  // them separately processes the model input size in pixels per region.
+  // Convert their covering region only once if it is not larger than that.
+  const FrameBuffer::Dimension covering_dimension = {right - left,
+                                                     bottom - top};
+  const int64 input_area = static_cast<int64>(GetInputSpecs().image_width) *
+                           GetInputSpecs().image_height;
+  if (rois.empty() || frame_buffer.format() == FrameBuffer::Format::kRGB ||
+      static_cast<int64>(covering_dimension.width) *
+              covering_dimension.height >
+          input_area * static_cast<int64>(rois.size())) {
+    RETURN_IF_ERROR(ClassifyRoisInto(frame_buffer, rois, &results));
+    return results;
+  }
+
+  BoundingBox covering_roi;
+  covering_roi.set_origin_x(left);
+  covering_roi.set_origin_y(top);
+  covering_roi.set_width(covering_dimension.width);
+  covering_roi.set_height(covering_dimension.height);
+  rois_rgb_data_.resize(
+      GetBufferByteSize(covering_dimension, FrameBuffer::Format::kRGB));
+  FrameBuffer::Plane rgb_plane = {
+      /*buffer=*/rois_rgb_data_.data(),
+      /*stride=*/{covering_dimension.width * kRgbPixelBytes,
+                  kRgbPixelBytes}};
+  // Same orientation as the input frame, so that only cropping and color space
+  // conversion happen here: regions are still expressed in the unrotated frame
+  // of reference, offset by the origin of the covering region.
+  std::unique_ptr<FrameBuffer> rgb_frame_buffer = FrameBuffer::Create(
+      {rgb_plane}, covering_dimension, FrameBuffer::Format::kRGB,
+      frame_buffer.orientation(), frame_buffer.timestamp());
+  if (frame_buffer_utils_ == nullptr) {
+    frame_buffer_utils_ = FrameBufferUtils::Create(process_engine_);
+  }
+  RETURN_IF_ERROR(frame_buffer_utils_->Preprocess(frame_buffer, covering_roi,
+                                                  rgb_frame_buffer.get()));
+
+  std::vector<BoundingBox> rgb_rois(rois.begin(), rois.end());
+  for (BoundingBox& rgb_roi : rgb_rois) {
+    rgb_roi.set_origin_x(rgb_roi.origin_x() - left);
+    rgb_roi.set_origin_y(rgb_roi.origin_y() - top);
+  }
+  RETURN_IF_ERROR(ClassifyRoisInto(*rgb_frame_buffer, rgb_rois, &results));
+  return results;
+}
+
+absl::Status ImageClassifier::InitRoiWorkers(
+    const OpResolverFactory& op_resolver_factory) {
+  const int num_workers = GetNumTileWorkers(options_->num_roi_workers());
+  if (num_workers == 1) {
+    return absl::OkStatus();
+  }
+  ImageClassifierOptions worker_options = *options_;
+  worker_options.set_num_roi_workers(1);
+  roi_workers_.reserve(num_workers - 1);
+  for (int i = 1; i < num_workers; ++i) {
+    ASSIGN_OR_RETURN(
+        std::unique_ptr<ImageClassifier> roi_worker,
+        CreateFromOptionsInternal(worker_options, op_resolver_factory()));
+    roi_workers_.push_back(std::move(roi_worker));
+  }
+  roi_worker_pool_.Start(num_workers);
+  return absl::OkStatus();
+}
+
+absl::Status ImageClassifier::ClassifyRoisInto(
+    const FrameBuffer& frame_buffer, absl::Span<const BoundingBox> rois,
+    std::vector<ClassificationResult>* results) {
+  // Worker 0 is this ImageClassifier, the others run with the same
+  // preprocessing settings.
+  std::vector<ImageClassifier*> workers = {this};
+  for (const auto& roi_worker : roi_workers_) {
+    CopyPreprocessingSettingsTo(roi_worker.get());
+    workers.push_back(roi_worker.get());
+  }
+  results->resize(rois.size());
+  return roi_worker_pool_.ProcessTiles(
+      rois.size(), [&](int worker_index, int roi_index) -> absl::Status {
+        ClassificationResult& result = (*results)[roi_index];
+        ASSIGN_OR_RETURN(result, workers[worker_index]->Classify(
+                                     frame_buffer, rois[roi_index]));
+        return absl::OkStatus();
+      });
+}
+
+absl::Status ImageClassifier::ClassifyInto(const FrameBuffer& frame_buffer,
+                                           const BoundingBox& roi,
+                                           std::vector<ScoredClass>* results) {
+  return InferWithFallbackInto(
+      [this, results](const std::vector<const TfLiteTensor*>& output_tensors) {
+        return SelectClasses(output_tensors, results);
+      },
+      frame_buffer, roi);
+}
+
+absl::Status ImageClassifier::ClassifyInto(const FrameBuffer& frame_buffer,
+                                           const BoundingBox& roi,
+                                           ClassificationResult* result) {
+  return InferWithFallbackInto(
+      [this, result](const std::vector<const TfLiteTensor*>& output_tensors) {
+        return PostprocessInto(output_tensors, result);
+      },
+      frame_buffer, roi);
+}
+
 StatusOr<ClassificationResult> ImageClassifier::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const FrameBuffer& /*frame_buffer*/, const BoundingBox& /*roi*/) {
+  ClassificationResult result;
+  RETURN_IF_ERROR(PostprocessInto(output_tensors, &result));
+  return result;
+}
+
+absl::Status ImageClassifier::PostprocessInto(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    ClassificationResult* result) {
+  RETURN_IF_ERROR(SelectClasses(output_tensors, &scored_classes_));
+
+  result->Clear();
+  for (int i = 0; i < num_outputs_; ++i) {
+    result->add_classifications()->set_head_index(i);
+  }
+  for (const ScoredClass& scored_class : scored_classes_) {
+    auto* cl = result->mutable_classifications(scored_class.head_index)
+                   ->add_classes();
+    cl->set_index(scored_class.index);
+    cl->set_score(scored_class.score);
+  }
+
+  return FillResultsFromLabelMaps(result);
+}
+
+absl::Status ImageClassifier::SelectClasses(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    std::vector<ScoredClass>* results) {
   if (output_tensors.size() != num_outputs_) {
     return CreateStatusWithPayload(
         StatusCode::kInternal,
@@ -394,13 +586,10 @@ StatusOr<ClassificationResult> ImageClassifier::Postprocess(
                         output_tensors.size()));
   }
 
-  ClassificationResult result;
-  std::vector<std::pair<int, float>> score_pairs;
+  results->clear();
+  std::vector<std::pair<int, float>>& score_pairs = score_pairs_;
 
   for (int i = 0; i < num_outputs_; ++i) {
-    auto* classifications = result.add_classifications();
-    classifications->set_head_index(i);
-
     const auto& head = classification_heads_[i];
     score_pairs.clear();
     score_pairs.reserve(head.label_map_items.size());
@@ -466,11 +655,12 @@ StatusOr<ClassificationResult> ImageClassifier::Postprocess(
         if (score < score_threshold) {
           break;
         }
-        auto* cl = classifications->add_classes();
-        cl->set_index(score_pairs[j].first);
-        cl->set_score(score);
+        const int class_index = score_pairs[j].first;
+        results->push_back(
+            {i, class_index, score, &head.label_map_items[class_index]});
       }
     } else {
+      const size_t head_begin = results->size();
       // Sort in descending order (higher score is better).
       absl::c_sort(score_pairs, [](const std::pair<int, float>& a,
                                    const std::pair<int, float>& b) {
@@ -480,7 +670,7 @@ StatusOr<ClassificationResult> ImageClassifier::Postprocess(
       for (int j = 0; j < head.label_map_items.size(); ++j) {
         float score = score_pairs[j].second;
         if (score < score_threshold ||
-            classifications->classes_size() >= num_results) {
+            static_cast<int>(results->size() - head_begin) >= num_results) {
           break;
         }
 
@@ -494,16 +684,13 @@ StatusOr<ClassificationResult> ImageClassifier::Postprocess(
           continue;
         }
 
-        auto* cl = classifications->add_classes();
-        cl->set_index(class_index);
-        cl->set_score(score);
+        results->push_back(
+            {i, class_index, score, &head.label_map_items[class_index]});
       }
     }
   }
 
-  RETURN_IF_ERROR(FillResultsFromLabelMaps(&result));
-
-  return result;
+  return absl::OkStatus();
 }
 
 absl::Status ImageClassifier::FillResultsFromLabelMaps(
@@ -16,11 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_CLASSIFIER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_CLASSIFIER_H_
 
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/core/shims/cc/kernels/register.h"
@@ -30,9 +33,12 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/core/base_vision_task_api.h"
 #include "tensorflow_lite_support/cc/task/vision/core/classification_head.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/core/label_map_item.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/classifications_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/score_calibration.h"
 
 namespace tflite {
@@ -74,14 +80,30 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
  public:
   using BaseVisionTaskApi::BaseVisionTaskApi;
 
+  // Factory for the OpResolver-s used by each interpreter of the task.
+  using OpResolverFactory =
+      std::function<std::unique_ptr<tflite::OpResolver>()>;
+
   // Creates an ImageClassifier from the provided options. A non-default
   // OpResolver can be specified in order to support custom Ops or specify a
   // subset of built-in Ops.
+  //
+  // As each interpreter needs its own OpResolver, this fails if
+  // `num_roi_workers` is not 1: use the overload below.
+  static tflite::support::StatusOr<std::unique_ptr<ImageClassifier>>
+  CreateFromOptions(const ImageClassifierOptions& options,
+                    std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Same as above, except that `op_resolver_factory` is called to create the
+  // OpResolver of each interpreter, i.e. once per worker (see
+  // `ImageClassifierOptions.num_roi_workers`).
   static tflite::support::StatusOr<std::unique_ptr<ImageClassifier>>
   CreateFromOptions(
       const ImageClassifierOptions& options,
-      std::unique_ptr<tflite::OpResolver> resolver =
-          absl::make_unique<tflite_shims::ops::builtin::BuiltinOpResolver>());
+      const OpResolverFactory& op_resolver_factory = []() {
+        return absl::make_unique<
+            tflite_shims::ops::builtin::BuiltinOpResolver>();
+      });
 
   // Performs actual classification on the provided FrameBuffer.
   //
@@ -111,6 +133,49 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
   tflite::support::StatusOr<ClassificationResult> Classify(
       const FrameBuffer& frame_buffer, const BoundingBox& roi);
 
+  // Same as above, for several regions of interest of the same frame, e.g. the
+  // objects found by an `ObjectDetector`. Returns one result per region, in
+  // the same order. All regions are validated before any inference is run.
+  //
+  // For frames that are not RGB, if the regions are large or numerous enough,
+  // the part of the frame covering all of them is converted to RGB once and
+  // shared by all regions, instead of converting each region separately.
+  // Inference still runs once per region, spread over `num_roi_workers`
+  // interpreters.
+  tflite::support::StatusOr<std::vector<ClassificationResult>> ClassifyRois(
+      const FrameBuffer& frame_buffer, absl::Span<const BoundingBox> rois);
+
+  // A class of the results of `ClassifyInto`.
+  struct ScoredClass {
+    // The index of the classification head, i.e. of the output tensor.
+    int head_index;
+    // The index of the class in the label map of the head.
+    int index;
+    float score;
+    // The label map entry of the class, owned by the classifier: empty
+    // `name` or `display_name` mean that they are not available.
+    const LabelMapItem* label_map_item;
+  };
+
+  // Same as above, except that the results are written into `results` (sorted
+  // by head, then by descending score) instead of being returned as a proto.
+  // The labels are not copied, so that no allocation happens once `results`
+  // has reached its steady-state capacity: they remain valid as long as the
+  // classifier is alive.
+  absl::Status ClassifyInto(const FrameBuffer& frame_buffer,
+                            const BoundingBox& roi,
+                            std::vector<ScoredClass>* results);
+
+  // Same as `Classify`, except that the results are written into `result`,
+  // which is cleared first. Reusing the same `result` across calls recycles
+  // its sub-messages and strings, so that no allocation happens once it has
+  // reached its steady-state size. `result` may also be allocated on a
+  // `google::protobuf::Arena`, in which case all its sub-messages are
+  // allocated on that arena too.
+  absl::Status ClassifyInto(const FrameBuffer& frame_buffer,
+                            const BoundingBox& roi,
+                            ClassificationResult* result);
+
  protected:
   // The options used to build this ImageClassifier.
   std::unique_ptr<ImageClassifierOptions> options_;
@@ -132,6 +197,22 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
   // whose ownership is transferred to this object.
   absl::Status Init(std::unique_ptr<ImageClassifierOptions> options);
 
+  // Creates an ImageClassifier from the provided options, which have already
+  // been sanity checked, without any `roi_workers_`.
+  static tflite::support::StatusOr<std::unique_ptr<ImageClassifier>>
+  CreateFromOptionsInternal(const ImageClassifierOptions& options,
+                            std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Creates the `roi_workers_` and starts the `roi_worker_pool_`, if
+  // `num_roi_workers` is not 1.
+  absl::Status InitRoiWorkers(const OpResolverFactory& op_resolver_factory);
+
+  // Classifies each of the `rois` of `frame_buffer` into `results`, spreading
+  // them over this ImageClassifier and the `roi_workers_`.
+  absl::Status ClassifyRoisInto(const FrameBuffer& frame_buffer,
+                                absl::Span<const BoundingBox> rois,
+                                std::vector<ClassificationResult>* results);
+
   // Performs pre-initialization actions.
   virtual absl::Status PreInit();
   // Performs post-initialization actions.
@@ -149,6 +230,18 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
   // Model Metadata, if any.
   absl::Status InitScoreCalibrations();
 
+  // Computes the scores of the classes from the output tensors, then selects
+  // the classes to return according to the options, into `results`.
+  absl::Status SelectClasses(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      std::vector<ScoredClass>* results);
+
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      ClassificationResult* result);
+
   // Given a ClassificationResult object containing class indices, fills the
   // name and display name from the label map(s).
   absl::Status FillResultsFromLabelMaps(ClassificationResult* result);
@@ -174,6 +267,25 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
   // List of score calibration parameters, if any. Built from TFLite Model
   // Metadata.
   std::vector<std::unique_ptr<ScoreCalibration>> score_calibrations_;
+
+  // Scratch (index, score) pairs of a head, kept across calls to avoid
+  // reallocating them.
+  std::vector<std::pair<int, float>> score_pairs_;
+  // Scratch classes selected by PostprocessInto(), kept across calls for the
+  // same reason.
+  std::vector<ScoredClass> scored_classes_;
+
+  // Utils and RGB buffer for the frame conversions of `ClassifyRois`, created
+  // on first use.
+  std::unique_ptr<FrameBufferUtils> frame_buffer_utils_;
+  std::vector<uint8> rois_rgb_data_;
+
+  // Other ImageClassifier instances classifying the regions of interest of
+  // `ClassifyRois` in parallel with this one. Empty unless `num_roi_workers`
+  // is not 1.
+  std::vector<std::unique_ptr<ImageClassifier>> roi_workers_;
+  // Threads running the `roi_workers_`, started once by InitRoiWorkers().
+  TileWorkerPool roi_worker_pool_;
 };
 
 }  // namespace vision
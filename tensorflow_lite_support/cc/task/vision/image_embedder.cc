@@ -122,16 +122,33 @@ tflite::support::StatusOr<EmbeddingResult> ImageEmbedder::Embed(
   return InferWithFallback(frame_buffer, roi);
 }
 
+absl::Status ImageEmbedder::EmbedInto(const FrameBuffer& frame_buffer,
+                                      const BoundingBox& roi,
+                                      EmbeddingResult* result) {
+  return InferWithFallbackInto(
+      [this, result](
+          const std::vector<const TfLiteTensor*>& /*output_tensors*/) {
+        return PostprocessInto(result);
+      },
+      frame_buffer, roi);
+}
+
 tflite::support::StatusOr<EmbeddingResult> ImageEmbedder::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const FrameBuffer& /*frame_buffer*/, const BoundingBox& /*roi*/) {
   EmbeddingResult result;
+  RETURN_IF_ERROR(PostprocessInto(&result));
+  return result;
+}
+
+absl::Status ImageEmbedder::PostprocessInto(EmbeddingResult* result) {
+  result->Clear();
   for (int i = 0; i < postprocessors_.size(); ++i) {
     RETURN_IF_ERROR(
-        postprocessors_.at(i)->Postprocess(result.add_embeddings()));
+        postprocessors_.at(i)->Postprocess(result->add_embeddings()));
   }
 
-  return result;
+  return absl::OkStatus();
 }
 
 Embedding ImageEmbedder::GetEmbeddingByIndex(const EmbeddingResult& result,
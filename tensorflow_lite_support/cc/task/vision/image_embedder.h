@@ -92,6 +92,15 @@ class ImageEmbedder
   tflite::support::StatusOr<EmbeddingResult> Embed(
       const FrameBuffer& frame_buffer, const BoundingBox& roi);
 
+  // Same as above, except that the results are written into `result`, which is
+  // cleared first. Reusing the same `result` across calls recycles its
+  // embeddings, so that no allocation happens once it has reached its
+  // steady-state size. `result` may also be allocated on a
+  // `google::protobuf::Arena`, in which case all its sub-messages are
+  // allocated on that arena too.
+  absl::Status EmbedInto(const FrameBuffer& frame_buffer,
+                         const BoundingBox& roi, EmbeddingResult* result);
+
   // Returns the Embedding output by the output_index'th layer. In (the most
   // common) case where a single embedding is produced, you can just call
   // GetEmbeddingByIndex(result, 0).
@@ -124,6 +133,10 @@ class ImageEmbedder
       const std::vector<const TfLiteTensor*>& output_tensors,
       const FrameBuffer& frame_buffer, const BoundingBox& roi) override;
 
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(EmbeddingResult* result);
+
   // Performs pre-initialization actions.
   virtual absl::Status PreInit();
   // Performs post-initialization actions.
@@ -16,8 +16,10 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/image_segmenter.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
@@ -29,6 +31,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
 #include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
@@ -131,6 +134,60 @@ StatusOr<std::vector<LabelMapItem>> GetLabelMapIfAny(
   return BuildLabelMapFromFiles(labels_file, display_names_file);
 }
 
+// Returns the single segmentation of `result`, with all its fields cleared but
+// the mask and with `colored_labels` as labels. Unlike Clear(), this keeps the
+// mask of a reused `result`, which is part of a oneof and would otherwise be
+// freed, so that it is overwritten in place: the caller must overwrite it
+// entirely.
+Segmentation* ResetSegmentation(
+    const std::vector<Segmentation::ColoredLabel>& colored_labels,
+    SegmentationResult* result) {
+  if (result->segmentation_size() != 1) {
+    result->Clear();
+    result->add_segmentation();
+  }
+  Segmentation* segmentation = result->mutable_segmentation(0);
+  segmentation->clear_width();
+  segmentation->clear_height();
+  // Cleared elements are kept by the repeated field, and recycled by the
+  // subsequent add_colored_labels() calls.
+  segmentation->clear_colored_labels();
+  for (const Segmentation::ColoredLabel& colored_label : colored_labels) {
+    *segmentation->add_colored_labels() = colored_label;
+  }
+  return segmentation;
+}
+
+// Adds the `tile_confidences` of a tile, weighted according to their distance
+// to the borders of the tile, to the `confidences` of a band of the stitched
+// mask with rows of `mask_width` pixels, and their weights to `weights`. The
+// mask of the tile has dimension `tile_mask_dimension` and starts at
+// (`offset_x`, `offset_y`) in the band. Both have `depth` confidences per
+// pixel.
+void AccumulateTileConfidences(const std::vector<float>& tile_confidences,
+                               FrameBuffer::Dimension tile_mask_dimension,
+                               int depth, int offset_x, int offset_y,
+                               int mask_width, std::vector<float>* confidences,
+                               std::vector<float>* weights) {
+  const float* tile_confidence = tile_confidences.data();
+  for (int tile_y = 0; tile_y < tile_mask_dimension.height; ++tile_y) {
+    const float weight_y =
+        GetTileBlendingWeight(tile_y, tile_mask_dimension.height);
+    for (int tile_x = 0; tile_x < tile_mask_dimension.width; ++tile_x) {
+      const float weight =
+          weight_y * GetTileBlendingWeight(tile_x, tile_mask_dimension.width);
+      const int pixel_index =
+          (offset_y + tile_y) * mask_width + offset_x + tile_x;
+      (*weights)[pixel_index] += weight;
+      float* pixel_confidences = &(*confidences)[pixel_index * depth];
+      for (int d = 0; d < depth; ++d) {
+        pixel_confidences[d] += weight * tile_confidence[d];
+      }
+      tile_confidence += depth;
+    }
+  }
+}
+
 }  // namespace
 
 /* static */
@@ -158,6 +215,9 @@ absl::Status ImageSegmenter::SanityCheckOptions(
         "`num_threads` must be greater than 0 or equal to -1.",
         TfLiteSupportStatus::kInvalidArgumentError);
   }
+  if (options.has_tiling_options()) {
+    RETURN_IF_ERROR(SanityCheckTilingOptions(options.tiling_options()));
+  }
   return absl::OkStatus();
 }
 
@@ -165,7 +225,32 @@ StatusOr<std::unique_ptr<ImageSegmenter>> ImageSegmenter::CreateFromOptions(
     const ImageSegmenterOptions& options,
     std::unique_ptr<tflite::OpResolver> resolver) {
   RETURN_IF_ERROR(SanityCheckOptions(options));
+  if (options.has_tiling_options() &&
+      GetNumTileWorkers(options.tiling_options()) > 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Several `tiling_options.num_workers` require one OpResolver per "
+        "worker: use the CreateFromOptions() overload taking an "
+        "OpResolverFactory instead.",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return CreateFromOptionsInternal(options, std::move(resolver));
+}
+
+StatusOr<std::unique_ptr<ImageSegmenter>> ImageSegmenter::CreateFromOptions(
+    const ImageSegmenterOptions& options,
+    const OpResolverFactory& op_resolver_factory) {
+  RETURN_IF_ERROR(SanityCheckOptions(options));
+  ASSIGN_OR_RETURN(std::unique_ptr<ImageSegmenter> image_segmenter,
+                   CreateFromOptionsInternal(options, op_resolver_factory()));
+  RETURN_IF_ERROR(image_segmenter->InitTileWorkers(op_resolver_factory));
+  return image_segmenter;
+}
 
+StatusOr<std::unique_ptr<ImageSegmenter>>
+ImageSegmenter::CreateFromOptionsInternal(
+    const ImageSegmenterOptions& options,
+    std::unique_ptr<tflite::OpResolver> resolver) {
   // Copy options to ensure the ExternalFile outlives the constructed object.
   auto options_copy = absl::make_unique<ImageSegmenterOptions>(options);
 
@@ -322,17 +407,288 @@ absl::Status ImageSegmenter::InitColoredLabels() {
   return absl::OkStatus();
 }
 
+absl::Status ImageSegmenter::InitTileWorkers(
+    const OpResolverFactory& op_resolver_factory) {
+  if (!options_->has_tiling_options()) {
+    return absl::OkStatus();
+  }
+  const int num_workers = GetNumTileWorkers(options_->tiling_options());
+  ImageSegmenterOptions worker_options = *options_;
+  worker_options.clear_tiling_options();
+  tile_workers_.reserve(num_workers - 1);
+  for (int i = 1; i < num_workers; ++i) {
+    ASSIGN_OR_RETURN(
+        std::unique_ptr<ImageSegmenter> tile_worker,
+        CreateFromOptionsInternal(worker_options, op_resolver_factory()));
+    tile_workers_.push_back(std::move(tile_worker));
+  }
+  tile_worker_pool_.Start(num_workers);
+  return absl::OkStatus();
+}
+
 StatusOr<SegmentationResult> ImageSegmenter::Segment(
     const FrameBuffer& frame_buffer) {
   BoundingBox roi;
   roi.set_width(frame_buffer.dimension().width);
   roi.set_height(frame_buffer.dimension().height);
+  if (options_->has_tiling_options()) {
+    SegmentationResult result;
+    RETURN_IF_ERROR(SegmentTiled(frame_buffer, &result));
+    return result;
+  }
   return InferWithFallback(frame_buffer, roi);
 }
 
+absl::Status ImageSegmenter::SegmentInto(const FrameBuffer& frame_buffer,
+                                         SegmentationResult* result) {
+  BoundingBox roi;
+  roi.set_width(frame_buffer.dimension().width);
+  roi.set_height(frame_buffer.dimension().height);
+  if (options_->has_tiling_options()) {
+    return SegmentTiled(frame_buffer, result);
+  }
+  return InferWithFallbackInto(
+      [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+        return PostprocessInto(output_tensors, frame_buffer, result);
+      },
+      frame_buffer, roi);
+}
+
+absl::Status ImageSegmenter::SegmentTiled(const FrameBuffer& frame_buffer,
+                                          SegmentationResult* result) {
+  const TilingOptions& tiling_options = options_->tiling_options();
+  const std::vector<BoundingBox> tiles = ComputeTiles(
+      frame_buffer.dimension(),
+      GetTileDimension(tiling_options, frame_buffer,
+                       {GetInputSpecs().image_width,
+                        GetInputSpecs().image_height}),
+      tiling_options.min_overlap_ratio());
+
+  // The mask of each tile, re-oriented in the unrotated frame of reference
+  // coordinates system, may have swapped dimensions compared to the tensor if
+  // the rotation is 90° or 270°. All the tiles have the same dimensions.
+  FrameBuffer::Dimension tile_mask_dimension = {output_width_, output_height_};
+  if (RequireDimensionSwap(frame_buffer.orientation(),
+                           FrameBuffer::Orientation::kTopLeft)) {
+    tile_mask_dimension.Swap();
+  }
+  const float scale_x =
+      static_cast<float>(tile_mask_dimension.width) / tiles[0].width();
+  const float scale_y =
+      static_cast<float>(tile_mask_dimension.height) / tiles[0].height();
+  const FrameBuffer::Dimension mask_dimension = {
+      std::max(tile_mask_dimension.width,
+               static_cast<int>(
+                   std::round(frame_buffer.dimension().width * scale_x))),
+      std::max(tile_mask_dimension.height,
+               static_cast<int>(
+                   std::round(frame_buffer.dimension().height * scale_y)))};
+
+  // Positions of the tile masks in the stitched mask. Tiles touching the right
+  // or bottom border of the frame are aligned with the border of the mask,
+  // whatever the rounding, so that all its pixels are covered.
+  const int max_offset_x = mask_dimension.width - tile_mask_dimension.width;
+  const int max_offset_y = mask_dimension.height - tile_mask_dimension.height;
+  std::vector<int> offsets_x(tiles.size());
+  std::vector<int> offsets_y(tiles.size());
+  for (int i = 0; i < tiles.size(); ++i) {
+    const BoundingBox& tile = tiles[i];
+    offsets_x[i] =
+        tile.origin_x() + tile.width() == frame_buffer.dimension().width
+            ? max_offset_x
+            : std::min(static_cast<int>(std::round(tile.origin_x() * scale_x)),
+                       max_offset_x);
+    offsets_y[i] =
+        tile.origin_y() + tile.height() == frame_buffer.dimension().height
+            ? max_offset_y
+            : std::min(static_cast<int>(std::round(tile.origin_y() * scale_y)),
+                       max_offset_y);
+  }
+
+  Segmentation* segmentation = ResetSegmentation(colored_labels_, result);
+  segmentation->set_width(mask_dimension.width);
+  segmentation->set_height(mask_dimension.height);
+  const int num_pixels = mask_dimension.width * mask_dimension.height;
+  if (options_->output_type() == ImageSegmenterOptions::CATEGORY_MASK) {
+    segmentation->mutable_category_mask()->resize(num_pixels);
+  } else if (options_->output_type() ==
+             ImageSegmenterOptions::CONFIDENCE_MASK) {
+    auto* confidence_masks = segmentation->mutable_confidence_masks();
+    confidence_masks->clear_confidence_mask();
+    for (int d = 0; d < output_depth_; ++d) {
+      confidence_masks->add_confidence_mask()->mutable_value()->Resize(
+          num_pixels, 0.0f);
+    }
+  }
+
+  // Weighted sums of the confidences predicted by the tiles covering each pixel
+  // of a band of the mask, and sums of the weights. The band spans the
+  // `tile_mask_dimension.height` rows starting at `band_y`, i.e. the rows
+  // covered by the current row of tiles: only the rows above the next row of
+  // tiles are final, so that the whole mask never needs to be held at once.
+  const int band_size = tile_mask_dimension.height * mask_dimension.width;
+  std::vector<float> band_confidences(band_size * output_depth_, 0.0f);
+  std::vector<float> band_weights(band_size, 0.0f);
+  int band_y = 0;
+  absl::Mutex mutex;
+
+  // Worker 0 is this ImageSegmenter, the others run with the same
+  // preprocessing settings. Each worker copies the confidences of its current
+  // tile into its own buffer, before adding them to the band.
+  std::vector<ImageSegmenter*> workers = {this};
+  for (const auto& tile_worker : tile_workers_) {
+    CopyPreprocessingSettingsTo(tile_worker.get());
+    workers.push_back(tile_worker.get());
+  }
+  std::vector<std::vector<float>> tile_confidences(workers.size());
+
+  // Tiles are in row-major order: each row of tiles is run in parallel, then
+  // the band is moved down to the next row.
+  for (int row_begin = 0; row_begin < tiles.size();) {
+    int row_end = row_begin + 1;
+    while (row_end < tiles.size() &&
+           tiles[row_end].origin_y() == tiles[row_begin].origin_y()) {
+      ++row_end;
+    }
+    const int row_y = offsets_y[row_begin];
+    if (row_y > band_y) {
+      const int num_final_rows = row_y - band_y;
+      WriteMaskRows(band_confidences, band_weights, band_y, num_final_rows,
+                    mask_dimension.width, segmentation);
+      // Move the rows shared with the next row of tiles to the top of the
+      // band, and reset the others.
+      const int num_moved_values =
+          band_size - num_final_rows * mask_dimension.width;
+      std::copy(band_confidences.end() - num_moved_values * output_depth_,
+                band_confidences.end(), band_confidences.begin());
+      std::fill(band_confidences.begin() + num_moved_values * output_depth_,
+                band_confidences.end(), 0.0f);
+      std::copy(band_weights.end() - num_moved_values, band_weights.end(),
+                band_weights.begin());
+      std::fill(band_weights.begin() + num_moved_values, band_weights.end(),
+                0.0f);
+      band_y = row_y;
+    }
+
+    RETURN_IF_ERROR(tile_worker_pool_.ProcessTiles(
+        row_end - row_begin,
+        [&](int worker_index, int index_in_row) -> absl::Status {
+          ImageSegmenter* worker = workers[worker_index];
+          const int tile_index = row_begin + index_in_row;
+          std::vector<float>* worker_confidences =
+              &tile_confidences[worker_index];
+          RETURN_IF_ERROR(worker->InferWithFallbackInto(
+              [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+                return worker->GetTileConfidences(
+                    output_tensors, frame_buffer.orientation(),
+                    tile_mask_dimension, worker_confidences);
+              },
+              frame_buffer, tiles[tile_index]));
+          absl::MutexLock lock(&mutex);
+          AccumulateTileConfidences(
+              *worker_confidences, tile_mask_dimension, output_depth_,
+              offsets_x[tile_index], offsets_y[tile_index] - band_y,
+              mask_dimension.width, &band_confidences, &band_weights);
+          return absl::OkStatus();
+        }));
+    row_begin = row_end;
+  }
+  // The last row of tiles is aligned with the bottom of the mask.
+  WriteMaskRows(band_confidences, band_weights, band_y,
+                tile_mask_dimension.height, mask_dimension.width,
+                segmentation);
+
+  return absl::OkStatus();
+}
+
+void ImageSegmenter::WriteMaskRows(const std::vector<float>& band_confidences,
+                                   const std::vector<float>& band_weights,
+                                   int mask_y, int num_rows, int mask_width,
+                                   Segmentation* segmentation) {
+  const int num_band_pixels = num_rows * mask_width;
+  const int mask_offset = mask_y * mask_width;
+  if (options_->output_type() == ImageSegmenterOptions::CATEGORY_MASK) {
+    char* category_mask = &(*segmentation->mutable_category_mask())[0];
+    for (int i = 0; i < num_band_pixels; ++i) {
+      // The weights are the same for all classes, so there is no need to
+      // normalize the confidences to find the highest one.
+      const float* pixel_confidences = &band_confidences[i * output_depth_];
+      int class_index = 0;
+      float max_confidence = 0.0f;
+      for (int d = 0; d < output_depth_; ++d) {
+        if (pixel_confidences[d] > max_confidence) {
+          class_index = d;
+          max_confidence = pixel_confidences[d];
+        }
+      }
+      category_mask[mask_offset + i] = static_cast<char>(class_index);
+    }
+  } else if (options_->output_type() ==
+             ImageSegmenterOptions::CONFIDENCE_MASK) {
+    auto* confidence_masks = segmentation->mutable_confidence_masks();
+    for (int d = 0; d < output_depth_; ++d) {
+      float* confidence_mask = confidence_masks->mutable_confidence_mask(d)
+                                   ->mutable_value()
+                                   ->mutable_data();
+      for (int i = 0; i < num_band_pixels; ++i) {
+        confidence_mask[mask_offset + i] =
+            band_confidences[i * output_depth_ + d] / band_weights[i];
+      }
+    }
+  }
+}
+
+absl::Status ImageSegmenter::GetTileConfidences(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    FrameBuffer::Orientation tensor_orientation,
+    FrameBuffer::Dimension tile_mask_dimension,
+    std::vector<float>* tile_confidences) {
+  if (output_tensors.size() != 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Expected 1 output tensors, found %d",
+                        output_tensors.size()));
+  }
+  const TfLiteTensor* output_tensor = output_tensors[0];
+
+  tile_confidences->resize(tile_mask_dimension.width *
+                           tile_mask_dimension.height * output_depth_);
+  float* confidence = tile_confidences->data();
+  // XY coordinates in the tensor, to be computed from tile_x and tile_y below.
+  int tensor_x;
+  int tensor_y;
+  for (int tile_y = 0; tile_y < tile_mask_dimension.height; ++tile_y) {
+    for (int tile_x = 0; tile_x < tile_mask_dimension.width; ++tile_x) {
+      // See Postprocess().
+      OrientCoordinates(/*from_x=*/tile_x,
+                        /*from_y=*/tile_y,
+                        /*from_orientation=*/FrameBuffer::Orientation::kTopLeft,
+                        /*to_orientation=*/tensor_orientation,
+                        /*from_dimension=*/tile_mask_dimension,
+                        /*to_x=*/&tensor_x,
+                        /*to_y=*/&tensor_y);
+      for (int d = 0; d < output_depth_; ++d) {
+        ASSIGN_OR_RETURN(
+            confidence[d],
+            GetOutputConfidence(*output_tensor, tensor_x, tensor_y, d));
+      }
+      confidence += output_depth_;
+    }
+  }
+  return absl::OkStatus();
+}
+
 StatusOr<SegmentationResult> ImageSegmenter::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const FrameBuffer& frame_buffer, const BoundingBox& /*roi*/) {
+  SegmentationResult result;
+  RETURN_IF_ERROR(PostprocessInto(output_tensors, frame_buffer, &result));
+  return result;
+}
+
+absl::Status ImageSegmenter::PostprocessInto(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    const FrameBuffer& frame_buffer, SegmentationResult* result) {
   if (output_tensors.size() != 1) {
     return CreateStatusWithPayload(
         StatusCode::kInternal,
@@ -341,10 +697,7 @@ StatusOr<SegmentationResult> ImageSegmenter::Postprocess(
   }
   const TfLiteTensor* output_tensor = output_tensors[0];
 
-  SegmentationResult result;
-  Segmentation* segmentation = result.add_segmentation();
-  *segmentation->mutable_colored_labels() = {colored_labels_.begin(),
-                                             colored_labels_.end()};
+  Segmentation* segmentation = ResetSegmentation(colored_labels_, result);
 
   // The output tensor has orientation `frame_buffer.orientation()`, as it has
   // been produced from the pre-processed frame.
@@ -405,8 +758,10 @@ StatusOr<SegmentationResult> ImageSegmenter::Postprocess(
   } else if (options_->output_type() ==
              ImageSegmenterOptions::CONFIDENCE_MASK) {
     auto* confidence_masks = segmentation->mutable_confidence_masks();
+    confidence_masks->clear_confidence_mask();
     for (int d = 0; d < output_depth_; ++d) {
-      confidence_masks->add_confidence_mask();
+      confidence_masks->add_confidence_mask()->mutable_value()->Reserve(
+          mask_dimension.width * mask_dimension.height);
     }
     for (int mask_y = 0; mask_y < segmentation->height(); ++mask_y) {
       for (int mask_x = 0; mask_x < segmentation->width(); ++mask_x) {
@@ -428,7 +783,7 @@ StatusOr<SegmentationResult> ImageSegmenter::Postprocess(
     }
   }
 
-  return result;
+  return absl::OkStatus();
 }
 
 StatusOr<float> ImageSegmenter::GetOutputConfidence(
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_SEGMENTER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_SEGMENTER_H_
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -30,6 +31,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/image_segmenter_options_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/segmentations_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
 
 namespace tflite {
 namespace task {
@@ -72,14 +74,30 @@ class ImageSegmenter : public BaseVisionTaskApi<SegmentationResult> {
  public:
   using BaseVisionTaskApi::BaseVisionTaskApi;
 
+  // Factory for the OpResolver-s used by each interpreter of the task.
+  using OpResolverFactory =
+      std::function<std::unique_ptr<tflite::OpResolver>()>;
+
   // Creates an ImageSegmenter from the provided options. A non-default
   // OpResolver can be specified in order to support custom Ops or specify a
   // subset of built-in Ops.
+  //
+  // As each interpreter needs its own OpResolver, this fails if the
+  // `tiling_options` require more than one worker: use the overload below.
+  static tflite::support::StatusOr<std::unique_ptr<ImageSegmenter>>
+  CreateFromOptions(const ImageSegmenterOptions& options,
+                    std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Same as above, except that `op_resolver_factory` is called to create the
+  // OpResolver of each interpreter, i.e. once per worker if `tiling_options`
+  // are set (see `TilingOptions.num_workers`), or once otherwise.
   static tflite::support::StatusOr<std::unique_ptr<ImageSegmenter>>
   CreateFromOptions(
       const ImageSegmenterOptions& options,
-      std::unique_ptr<tflite::OpResolver> resolver =
-          absl::make_unique<tflite_shims::ops::builtin::BuiltinOpResolver>());
+      const OpResolverFactory& op_resolver_factory = []() {
+        return absl::make_unique<
+            tflite_shims::ops::builtin::BuiltinOpResolver>();
+      });
 
   // Performs actual segmentation on the provided FrameBuffer.
   //
@@ -111,9 +129,25 @@ class ImageSegmenter : public BaseVisionTaskApi<SegmentationResult> {
   // masks need to be:
   // * re-scaled to 640 x 480,
   // * then rotated 90° clockwise.
+  //
+  // If `tiling_options` are set, the frame is instead split into overlapping
+  // tiles which are segmented, in parallel if several workers are configured
+  // (see TilingOptions), and the tile masks are blended into a single mask covering the whole frame. Its
+  // dimensions are then those of the input FrameBuffer scaled by the ratio
+  // between the model output and tile sizes, e.g. 1280x720 for a 1280x720
+  // frame split into 257x257 tiles for a model outputting 257x257 masks.
   tflite::support::StatusOr<SegmentationResult> Segment(
       const FrameBuffer& frame_buffer);
 
+  // Same as above, except that the results are written into `result`, which is
+  // cleared first. Reusing the same `result` across calls recycles its masks,
+  // so that no allocation happens once it has reached its steady-state size
+  // (except with `tiling_options`, whose blending buffers are allocated on
+  // each call). `result` may also be allocated on a `google::protobuf::Arena`,
+  // in which case all its sub-messages are allocated on that arena too.
+  absl::Status SegmentInto(const FrameBuffer& frame_buffer,
+                           SegmentationResult* result);
+
  protected:
   // Post-processing to transform the raw model outputs into segmentation
   // results.
@@ -145,6 +179,47 @@ class ImageSegmenter : public BaseVisionTaskApi<SegmentationResult> {
   // `colored_labels_`.
   absl::Status InitColoredLabels();
 
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      const FrameBuffer& frame_buffer, SegmentationResult* result);
+
+  // Creates an ImageSegmenter from the provided options, which have already
+  // been sanity checked, without any `tile_workers_`.
+  static tflite::support::StatusOr<std::unique_ptr<ImageSegmenter>>
+  CreateFromOptionsInternal(const ImageSegmenterOptions& options,
+                            std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Creates the `tile_workers_` and starts the `tile_worker_pool_`, if the
+  // `tiling_options` require more than one worker.
+  absl::Status InitTileWorkers(const OpResolverFactory& op_resolver_factory);
+
+  // Performs segmentation on each tile of `frame_buffer` as configured by the
+  // `tiling_options`, and stitches the masks together into `result`. The tiles
+  // of each row are spread over this ImageSegmenter and the `tile_workers_`,
+  // and blended into a band of the mask as high as a tile mask, whose rows are
+  // written to `result` as soon as no other tile covers them.
+  absl::Status SegmentTiled(const FrameBuffer& frame_buffer,
+                            SegmentationResult* result);
+
+  // Writes the `num_rows` rows of the stitched mask starting at row `mask_y`
+  // into `segmentation`, from the weighted sums of confidences and of weights
+  // at the top of the band of rows of `mask_width` pixels they come from.
+  void WriteMaskRows(const std::vector<float>& band_confidences,
+                     const std::vector<float>& band_weights, int mask_y,
+                     int num_rows, int mask_width, Segmentation* segmentation);
+
+  // Copies the confidences output by the model for a tile into
+  // `tile_confidences`, re-oriented in the unrotated frame of reference
+  // coordinates system in which the mask of the tile has dimension
+  // `tile_mask_dimension`, and dequantized if needed.
+  absl::Status GetTileConfidences(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      FrameBuffer::Orientation tensor_orientation,
+      FrameBuffer::Dimension tile_mask_dimension,
+      std::vector<float>* tile_confidences);
+
   // Returns the output confidence at coordinates {x, y, depth}, dequantizing
   // on-the-fly if needed (i.e. if `has_uint8_outputs_` is true).
   tflite::support::StatusOr<float> GetOutputConfidence(
@@ -164,6 +239,13 @@ class ImageSegmenter : public BaseVisionTaskApi<SegmentationResult> {
   int output_height_;
   // Expected output depth. This corresponds to the number of supported classes.
   int output_depth_;
+
+  // The other ImageSegmenter-s, built from the same options but without
+  // `tiling_options`, running tiles in parallel with this one. Empty unless
+  // `tiling_options.num_workers` is not 1.
+  std::vector<std::unique_ptr<ImageSegmenter>> tile_workers_;
+  // Threads running the `tile_workers_`, started once by InitTileWorkers().
+  TileWorkerPool tile_worker_pool_;
 };
 
 }  // namespace vision
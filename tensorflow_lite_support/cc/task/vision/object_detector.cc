@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/object_detector.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -33,7 +34,9 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/core/label_map_item.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/class_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/detection_decoder.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/score_calibration.h"
 #include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
@@ -141,19 +144,20 @@ StatusOr<const BoundingBoxProperties*> GetBoundingBoxProperties(
 
 StatusOr<std::vector<LabelMapItem>> GetLabelMapIfAny(
     const ModelMetadataExtractor& metadata_extractor,
-    const TensorMetadata& tensor_metadata, absl::string_view locale) {
+    const TensorMetadata& tensor_metadata, absl::string_view locale,
+    tflite::AssociatedFileType file_type =
+        tflite::AssociatedFileType_TENSOR_VALUE_LABELS) {
   const std::string labels_filename =
-      ModelMetadataExtractor::FindFirstAssociatedFileName(
-          tensor_metadata, tflite::AssociatedFileType_TENSOR_VALUE_LABELS);
+      ModelMetadataExtractor::FindFirstAssociatedFileName(tensor_metadata,
+                                                          file_type);
   if (labels_filename.empty()) {
     return std::vector<LabelMapItem>();
   }
   ASSIGN_OR_RETURN(absl::string_view labels_file,
                    metadata_extractor.GetAssociatedFile(labels_filename));
   const std::string display_names_filename =
-      ModelMetadataExtractor::FindFirstAssociatedFileName(
-          tensor_metadata, tflite::AssociatedFileType_TENSOR_VALUE_LABELS,
-          locale);
+      ModelMetadataExtractor::FindFirstAssociatedFileName(tensor_metadata,
+                                                          file_type, locale);
   absl::string_view display_names_file;
   if (!display_names_filename.empty()) {
     ASSIGN_OR_RETURN(display_names_file, metadata_extractor.GetAssociatedFile(
@@ -270,6 +274,13 @@ absl::Status SanityCheckOutputTensors(
   return absl::OkStatus();
 }
 
+// Translates `box`, expressed relatively to the region of interest `roi`, into
+// the frame coordinates system.
+void OffsetBoundingBox(const BoundingBox& roi, BoundingBox* box) {
+  box->set_origin_x(box->origin_x() + roi.origin_x());
+  box->set_origin_y(box->origin_y() + roi.origin_y());
+}
+
 }  // namespace
 
 /* static */
@@ -305,6 +316,9 @@ absl::Status ObjectDetector::SanityCheckOptions(
         "`num_threads` must be greater than 0 or equal to -1.",
         TfLiteSupportStatus::kInvalidArgumentError);
   }
+  if (options.has_tiling_options()) {
+    RETURN_IF_ERROR(SanityCheckTilingOptions(options.tiling_options()));
+  }
   return absl::OkStatus();
 }
 
@@ -313,7 +327,34 @@ StatusOr<std::unique_ptr<ObjectDetector>> ObjectDetector::CreateFromOptions(
     const ObjectDetectorOptions& options,
     std::unique_ptr<tflite::OpResolver> resolver) {
   RETURN_IF_ERROR(SanityCheckOptions(options));
+  if (options.has_tiling_options() &&
+      GetNumTileWorkers(options.tiling_options()) > 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Several `tiling_options.num_workers` require one OpResolver per "
+        "worker: use the CreateFromOptions() overload taking an "
+        "OpResolverFactory instead.",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return CreateFromOptionsInternal(options, std::move(resolver));
+}
 
+/* static */
+StatusOr<std::unique_ptr<ObjectDetector>> ObjectDetector::CreateFromOptions(
+    const ObjectDetectorOptions& options,
+    const OpResolverFactory& op_resolver_factory) {
+  RETURN_IF_ERROR(SanityCheckOptions(options));
+  ASSIGN_OR_RETURN(std::unique_ptr<ObjectDetector> object_detector,
+                   CreateFromOptionsInternal(options, op_resolver_factory()));
+  RETURN_IF_ERROR(object_detector->InitTileWorkers(op_resolver_factory));
+  return object_detector;
+}
+
+/* static */
+StatusOr<std::unique_ptr<ObjectDetector>>
+ObjectDetector::CreateFromOptionsInternal(
+    const ObjectDetectorOptions& options,
+    std::unique_ptr<tflite::OpResolver> resolver) {
   // Copy options to ensure the ExternalFile outlives the constructed object.
   auto options_copy = absl::make_unique<ObjectDetectorOptions>(options);
 
@@ -411,6 +452,11 @@ StatusOr<SigmoidCalibrationParameters> BuildCalibrationParametersIfAny(
 }
 
 absl::Status ObjectDetector::InitScoreCalibrations() {
+  // Not supported for models with raw outputs.
+  if (detection_decoder_ != nullptr) {
+    return absl::OkStatus();
+  }
+
   StatusOr<SigmoidCalibrationParameters> calibration_params_status;
   bool has_score_calibration = false;
 
@@ -442,6 +488,10 @@ absl::Status ObjectDetector::InitScoreCalibrations() {
 }
 
 absl::Status ObjectDetector::CheckAndSetOutputs() {
+  if (options_->has_raw_detection_options()) {
+    return CheckAndSetRawOutputs();
+  }
+
   // First, sanity checks on the model itself.
   const TfLiteEngine::Interpreter* interpreter =
       GetTfLiteEngine()->interpreter();
@@ -541,6 +591,147 @@ absl::Status ObjectDetector::CheckAndSetOutputs() {
   return absl::OkStatus();
 }
 
+absl::Status ObjectDetector::CheckAndSetRawOutputs() {
+  const RawDetectionOptions& raw_options = options_->raw_detection_options();
+  const TfLiteEngine::Interpreter* interpreter =
+      GetTfLiteEngine()->interpreter();
+  const int num_outputs = TfLiteEngine::OutputCount(interpreter);
+  const bool single_output = num_outputs == 1;
+  if (single_output) {
+    output_indices_ = {0, 0};
+  } else {
+    output_indices_ = {raw_options.boxes_output_index(),
+                       raw_options.scores_output_index()};
+    if (output_indices_[0] < 0 || output_indices_[0] >= num_outputs ||
+        output_indices_[1] < 0 || output_indices_[1] >= num_outputs ||
+        output_indices_[0] == output_indices_[1]) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Expected `boxes_output_index` and "
+                          "`scores_output_index` to be distinct indices in "
+                          "[0, %d), found %d and %d.",
+                          num_outputs, output_indices_[0], output_indices_[1]),
+          TfLiteSupportStatus::kInvalidNumOutputTensorsError);
+    }
+  }
+
+  // Check tensor types and dimensions.
+  for (int index : output_indices_) {
+    const TfLiteTensor* tensor = TfLiteEngine::GetOutput(interpreter, index);
+    if (tensor->type != kTfLiteFloat32) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Expected output tensor at index %d to have type "
+                          "kTfLiteFloat32, found %s.",
+                          index, TfLiteTypeGetName(tensor->type)),
+          TfLiteSupportStatus::kInvalidOutputTensorTypeError);
+    }
+    if (tensor->dims->size != 3 || tensor->dims->data[0] != 1) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Expected output tensor at index %d to have "
+                          "dimensions [1 x num_boxes x N].",
+                          index),
+          TfLiteSupportStatus::kInvalidOutputTensorDimensionsError);
+    }
+  }
+  const TfLiteTensor* boxes_tensor =
+      TfLiteEngine::GetOutput(interpreter, output_indices_[0]);
+  const TfLiteTensor* scores_tensor =
+      TfLiteEngine::GetOutput(interpreter, output_indices_[1]);
+  const int num_boxes = boxes_tensor->dims->data[1];
+  int num_classes = scores_tensor->dims->data[2];
+  if (single_output) {
+    num_classes -= 4 + (raw_options.has_objectness_score() ? 1 : 0);
+  } else if (boxes_tensor->dims->data[2] != 4 ||
+             scores_tensor->dims->data[1] != num_boxes) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat(
+            "Expected boxes and scores tensors with dimensions [1 x num_boxes "
+            "x 4] and [1 x num_boxes x num_classes], found [1 x %d x %d] and "
+            "[1 x %d x %d].",
+            num_boxes, boxes_tensor->dims->data[2],
+            scores_tensor->dims->data[1], num_classes),
+        TfLiteSupportStatus::kInvalidOutputTensorDimensionsError);
+  }
+
+  // Metadata is optional for models with raw outputs.
+  const ModelMetadataExtractor* metadata_extractor =
+      GetTfLiteEngine()->metadata_extractor();
+  const auto* output_tensors_metadata =
+      metadata_extractor->GetOutputTensorMetadata();
+  const TensorMetadata* scores_metadata = nullptr;
+  if (output_tensors_metadata != nullptr &&
+      static_cast<int>(output_tensors_metadata->size()) == num_outputs) {
+    scores_metadata = output_tensors_metadata->Get(output_indices_[1]);
+  }
+
+  std::vector<Anchor> anchors;
+  if (raw_options.box_coding() ==
+      RawDetectionOptions::CENTER_SIZE_WITH_ANCHORS) {
+    if (raw_options.has_ssd_anchors()) {
+      ASSIGN_OR_RETURN(anchors, GenerateSsdAnchors(raw_options.ssd_anchors()));
+    } else if (raw_options.has_anchors_file_name()) {
+      ASSIGN_OR_RETURN(absl::string_view anchors_file,
+                       metadata_extractor->GetAssociatedFile(
+                           raw_options.anchors_file_name()));
+      ASSIGN_OR_RETURN(anchors, ParseAnchors(anchors_file));
+    } else {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          "Box coding CENTER_SIZE_WITH_ANCHORS requires either `ssd_anchors` "
+          "or `anchors_file_name` to be provided.",
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+  }
+  ASSIGN_OR_RETURN(detection_decoder_,
+                   DetectionDecoder::Create(raw_options, std::move(anchors),
+                                            num_boxes, num_classes,
+                                            single_output));
+
+  // Build label map (if available) from metadata, with one label per class.
+  if (scores_metadata != nullptr) {
+    ASSIGN_OR_RETURN(
+        label_map_,
+        GetLabelMapIfAny(*metadata_extractor, *scores_metadata,
+                         options_->display_names_locale(),
+                         tflite::AssociatedFileType_TENSOR_AXIS_LABELS));
+    if (label_map_.empty()) {
+      ASSIGN_OR_RETURN(label_map_, GetLabelMapIfAny(
+                                       *metadata_extractor, *scores_metadata,
+                                       options_->display_names_locale()));
+    }
+  }
+  // Class indices don't count the background class: check that each of them
+  // has a label now rather than failing on the first detection.
+  const int num_labeled_classes =
+      num_classes - (raw_options.has_background_class() ? 1 : 0);
+  if (!label_map_.empty() &&
+      static_cast<int>(label_map_.size()) < num_labeled_classes) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat(
+            "Label map does not contain enough elements: model has %d classes "
+            "(not counting the background class, if any) but label map only "
+            "contains %d elements.",
+            num_labeled_classes, label_map_.size()),
+        TfLiteSupportStatus::kMetadataInconsistencyError);
+  }
+
+  // Set score threshold.
+  if (options_->has_score_threshold()) {
+    score_threshold_ = options_->score_threshold();
+  } else if (scores_metadata != nullptr) {
+    ASSIGN_OR_RETURN(score_threshold_,
+                     GetScoreThreshold(*metadata_extractor, *scores_metadata));
+  } else {
+    score_threshold_ = kDefaultScoreThreshold;
+  }
+
+  return absl::OkStatus();
+}
+
 absl::Status ObjectDetector::CheckAndSetClassIndexSet() {
   // Exit early if no blacklist/whitelist.
   if (options_->class_name_blacklist_size() == 0 &&
@@ -586,6 +777,34 @@ absl::Status ObjectDetector::CheckAndSetClassIndexSet() {
         TfLiteSupportStatus::kInvalidArgumentError);
   }
 
+  // Filter classes before decoding for models with raw outputs.
+  if (detection_decoder_ != nullptr) {
+    std::vector<bool> allowed_classes(label_map_.size());
+    for (int i = 0; i < label_map_.size(); ++i) {
+      allowed_classes[i] = IsClassIndexAllowed(i);
+    }
+    detection_decoder_->SetAllowedClasses(std::move(allowed_classes));
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status ObjectDetector::InitTileWorkers(
+    const OpResolverFactory& op_resolver_factory) {
+  if (!options_->has_tiling_options()) {
+    return absl::OkStatus();
+  }
+  const int num_workers = GetNumTileWorkers(options_->tiling_options());
+  ObjectDetectorOptions worker_options = *options_;
+  worker_options.clear_tiling_options();
+  tile_workers_.reserve(num_workers - 1);
+  for (int i = 1; i < num_workers; ++i) {
+    ASSIGN_OR_RETURN(
+        std::unique_ptr<ObjectDetector> tile_worker,
+        CreateFromOptionsInternal(worker_options, op_resolver_factory()));
+    tile_workers_.push_back(std::move(tile_worker));
+  }
+  tile_worker_pool_.Start(num_workers);
   return absl::OkStatus();
 }
 
@@ -594,12 +813,97 @@ StatusOr<DetectionResult> ObjectDetector::Detect(
   BoundingBox roi;
   roi.set_width(frame_buffer.dimension().width);
   roi.set_height(frame_buffer.dimension().height);
+  if (options_->has_tiling_options()) {
+    DetectionResult result;
+    RETURN_IF_ERROR(DetectTiled(frame_buffer, roi, &result));
+    return result;
+  }
   return InferWithFallback(frame_buffer, roi);
 }
 
+absl::Status ObjectDetector::DetectInto(const FrameBuffer& frame_buffer,
+                                        DetectionResult* result) {
+  BoundingBox roi;
+  roi.set_width(frame_buffer.dimension().width);
+  roi.set_height(frame_buffer.dimension().height);
+  if (options_->has_tiling_options()) {
+    return DetectTiled(frame_buffer, roi, result);
+  }
+  return InferWithFallbackInto(
+      [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+        return PostprocessInto(output_tensors, frame_buffer, roi, result);
+      },
+      frame_buffer, roi);
+}
+
+absl::Status ObjectDetector::DetectTiled(const FrameBuffer& frame_buffer,
+                                         const BoundingBox& frame_roi,
+                                         DetectionResult* result) {
+  const TilingOptions& tiling_options = options_->tiling_options();
+  const std::vector<BoundingBox> tiles = ComputeTiles(
+      frame_buffer.dimension(),
+      GetTileDimension(tiling_options, frame_buffer,
+                       {GetInputSpecs().image_width,
+                        GetInputSpecs().image_height}),
+      tiling_options.min_overlap_ratio());
+
+  // The whole frame is processed as an extra tile.
+  std::vector<const BoundingBox*> rois;
+  rois.reserve(tiles.size() + 1);
+  for (const BoundingBox& tile : tiles) {
+    rois.push_back(&tile);
+  }
+  if (tiles.size() > 1 && tiling_options.include_full_frame()) {
+    rois.push_back(&frame_roi);
+  }
+
+  // Worker 0 is this ObjectDetector, the others run with the same
+  // preprocessing settings.
+  std::vector<ObjectDetector*> workers = {this};
+  for (const auto& tile_worker : tile_workers_) {
+    CopyPreprocessingSettingsTo(tile_worker.get());
+    workers.push_back(tile_worker.get());
+  }
+  std::vector<DetectionResult> roi_results(rois.size());
+  RETURN_IF_ERROR(tile_worker_pool_.ProcessTiles(
+      rois.size(),
+      [&](int worker_index, int roi_index) -> absl::Status {
+        ObjectDetector* worker = workers[worker_index];
+        const BoundingBox& roi = *rois[roi_index];
+        return worker->InferWithFallbackInto(
+            [&](const std::vector<const TfLiteTensor*>& output_tensors) {
+              return worker->PostprocessInto(output_tensors, frame_buffer, roi,
+                                             &roi_results[roi_index]);
+            },
+            frame_buffer, roi);
+      }));
+
+  DetectionResult results;
+  for (DetectionResult& roi_result : roi_results) {
+    results.mutable_detections()->MergeFrom(roi_result.detections());
+  }
+
+  MergeOverlappingDetections(results, tiling_options.nms_overlap_threshold(),
+                             options_->max_results(), result);
+  return absl::OkStatus();
+}
+
 StatusOr<DetectionResult> ObjectDetector::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
-    const FrameBuffer& frame_buffer, const BoundingBox& /*roi*/) {
+    const FrameBuffer& frame_buffer, const BoundingBox& roi) {
+  DetectionResult result;
+  RETURN_IF_ERROR(PostprocessInto(output_tensors, frame_buffer, roi, &result));
+  return result;
+}
+
+absl::Status ObjectDetector::PostprocessInto(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    const FrameBuffer& frame_buffer, const BoundingBox& roi,
+    DetectionResult* result) {
+  if (detection_decoder_ != nullptr) {
+    return PostprocessRawOutputs(output_tensors, frame_buffer, roi, result);
+  }
+
   // Most of the checks here should never happen, as outputs have been validated
   // at construction time. Checking nonetheless and returning internal errors if
   // something bad happens.
@@ -615,12 +919,11 @@ StatusOr<DetectionResult> ObjectDetector::Postprocess(
                               ? std::min(options_->max_results(), num_results)
                               : num_results;
   // The dimensions of the upright (i.e. rotated according to its orientation)
-  // input frame.
-  FrameBuffer::Dimension upright_input_frame_dimensions =
-      frame_buffer.dimension();
+  // region of interest of the input frame.
+  FrameBuffer::Dimension upright_roi_dimensions = {roi.width(), roi.height()};
   if (RequireDimensionSwap(frame_buffer.orientation(),
                            FrameBuffer::Orientation::kTopLeft)) {
-    upright_input_frame_dimensions.Swap();
+    upright_roi_dimensions.Swap();
   }
 
   ASSIGN_OR_RETURN(
@@ -632,7 +935,7 @@ StatusOr<DetectionResult> ObjectDetector::Postprocess(
   ASSIGN_OR_RETURN(
       const float* scores,
       AssertAndReturnTypedTensor<float>(output_tensors[output_indices_[2]]));
-  DetectionResult results;
+  result->Clear();
   for (int i = 0; i < num_results; ++i) {
     const int class_index = static_cast<int>(classes[i]);
     if (!IsClassIndexAllowed(class_index)) {
@@ -649,11 +952,11 @@ StatusOr<DetectionResult> ObjectDetector::Postprocess(
       continue;
     }
 
-    Detection* detection = results.add_detections();
-    // Denormalize the bounding box cooordinates in the upright frame
-    // coordinates system, then rotate back from frame_buffer.orientation() to
-    // the unrotated frame of reference coordinates system (i.e. with
-    // orientation = kTopLeft).
+    Detection* detection = result->add_detections();
+    // Denormalize the bounding box cooordinates in the upright region of
+    // interest coordinates system, then rotate back from
+    // frame_buffer.orientation() to the unrotated frame of reference
+    // coordinates system (i.e. with orientation = kTopLeft).
     *detection->mutable_bounding_box() = OrientAndDenormalizeBoundingBox(
         /*from_left=*/locations[4 * i + bounding_box_corners_order_[0]],
         /*from_top=*/locations[4 * i + bounding_box_corners_order_[1]],
@@ -661,20 +964,75 @@ StatusOr<DetectionResult> ObjectDetector::Postprocess(
         /*from_bottom=*/locations[4 * i + bounding_box_corners_order_[3]],
         /*from_orientation=*/frame_buffer.orientation(),
         /*to_orientation=*/FrameBuffer::Orientation::kTopLeft,
-        /*from_dimension=*/upright_input_frame_dimensions);
+        /*from_dimension=*/upright_roi_dimensions);
+    OffsetBoundingBox(roi, detection->mutable_bounding_box());
     Class* detection_class = detection->add_classes();
     detection_class->set_index(class_index);
     detection_class->set_score(score);
-    if (results.detections_size() == max_results) {
+    if (result->detections_size() == max_results) {
       break;
     }
   }
 
   if (!label_map_.empty()) {
-    RETURN_IF_ERROR(FillResultsFromLabelMap(&results));
+    RETURN_IF_ERROR(FillResultsFromLabelMap(result));
   }
 
-  return results;
+  return absl::OkStatus();
+}
+
+absl::Status ObjectDetector::PostprocessRawOutputs(
+    const std::vector<const TfLiteTensor*>& output_tensors,
+    const FrameBuffer& frame_buffer, const BoundingBox& roi,
+    DetectionResult* result) {
+  if (static_cast<int>(output_tensors.size()) <=
+      std::max(output_indices_[0], output_indices_[1])) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Expected at least %d output tensors, found %d",
+                        std::max(output_indices_[0], output_indices_[1]) + 1,
+                        output_tensors.size()));
+  }
+  ASSIGN_OR_RETURN(
+      const float* boxes,
+      AssertAndReturnTypedTensor<float>(output_tensors[output_indices_[0]]));
+  ASSIGN_OR_RETURN(
+      const float* scores,
+      AssertAndReturnTypedTensor<float>(output_tensors[output_indices_[1]]));
+  RETURN_IF_ERROR(detection_decoder_->Decode(boxes, scores, score_threshold_,
+                                             options_->max_results(),
+                                             &raw_detections_));
+
+  // The dimensions of the upright (i.e. rotated according to its orientation)
+  // region of interest of the input frame.
+  FrameBuffer::Dimension upright_roi_dimensions = {roi.width(), roi.height()};
+  if (RequireDimensionSwap(frame_buffer.orientation(),
+                           FrameBuffer::Orientation::kTopLeft)) {
+    upright_roi_dimensions.Swap();
+  }
+
+  result->Clear();
+  for (const RawDetection& raw_detection : raw_detections_) {
+    Detection* detection = result->add_detections();
+    *detection->mutable_bounding_box() = OrientAndDenormalizeBoundingBox(
+        /*from_left=*/raw_detection.xmin,
+        /*from_top=*/raw_detection.ymin,
+        /*from_right=*/raw_detection.xmax,
+        /*from_bottom=*/raw_detection.ymax,
+        /*from_orientation=*/frame_buffer.orientation(),
+        /*to_orientation=*/FrameBuffer::Orientation::kTopLeft,
+        /*from_dimension=*/upright_roi_dimensions);
+    OffsetBoundingBox(roi, detection->mutable_bounding_box());
+    Class* detection_class = detection->add_classes();
+    detection_class->set_index(raw_detection.class_index);
+    detection_class->set_score(raw_detection.score);
+  }
+
+  if (!label_map_.empty()) {
+    RETURN_IF_ERROR(FillResultsFromLabelMap(result));
+  }
+
+  return absl::OkStatus();
 }
 
 bool ObjectDetector::IsClassIndexAllowed(int class_index) {
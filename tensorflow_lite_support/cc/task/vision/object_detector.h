@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_OBJECT_DETECTOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_OBJECT_DETECTOR_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
@@ -29,6 +31,8 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/core/label_map_item.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/object_detector_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/detection_decoder.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/score_calibration.h"
 
 namespace tflite {
@@ -72,6 +76,13 @@ namespace vision {
 // An example of such model can be found at:
 // https://tfhub.dev/google/lite-model/object_detection/mobile_object_localizer_v1/1/metadata/1
 //
+// Alternatively, if `raw_detection_options` are provided, the model outputs raw
+// boxes and scores instead, which are decoded and filtered by non-maximum
+// suppression in C++ (see `RawDetectionOptions` for the supported output
+// layouts). TFLite Model Metadata is then optional: if present, the label map
+// is read from the scores tensor metadata, preferably from an AssociatedFile
+// with type TENSOR_AXIS_LABELS.
+//
 // A CLI demo tool is available for easily trying out this API, and provides
 // example usage. See:
 // examples/task/vision/desktop/object_detector_demo.cc
@@ -79,14 +90,30 @@ class ObjectDetector : public BaseVisionTaskApi<DetectionResult> {
  public:
   using BaseVisionTaskApi::BaseVisionTaskApi;
 
+  // Factory for the OpResolver-s used by each interpreter of the task.
+  using OpResolverFactory =
+      std::function<std::unique_ptr<tflite::OpResolver>()>;
+
   // Creates an ObjectDetector from the provided options. A non-default
   // OpResolver can be specified in order to support custom Ops or specify a
   // subset of built-in Ops.
+  //
+  // As each interpreter needs its own OpResolver, this fails if the
+  // `tiling_options` require more than one worker: use the overload below.
+  static tflite::support::StatusOr<std::unique_ptr<ObjectDetector>>
+  CreateFromOptions(const ObjectDetectorOptions& options,
+                    std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Same as above, except that `op_resolver_factory` is called to create the
+  // OpResolver of each interpreter, i.e. once per worker if `tiling_options`
+  // are set (see `TilingOptions.num_workers`), or once otherwise.
   static tflite::support::StatusOr<std::unique_ptr<ObjectDetector>>
   CreateFromOptions(
       const ObjectDetectorOptions& options,
-      std::unique_ptr<tflite::OpResolver> resolver =
-          absl::make_unique<tflite_shims::ops::builtin::BuiltinOpResolver>());
+      const OpResolverFactory& op_resolver_factory = []() {
+        return absl::make_unique<
+            tflite_shims::ops::builtin::BuiltinOpResolver>();
+      });
 
   // Performs actual detection on the provided FrameBuffer.
   //
@@ -116,9 +143,24 @@ class ObjectDetector : public BaseVisionTaskApi<DetectionResult> {
   // `kLeftBottom` (i.e. the image will be rotated 90° clockwise during
   // preprocessing to make it "upright"), then the same 90° clockwise rotation
   // needs to be applied to the bounding box for display.
+  //
+  // If `tiling_options` are set, the frame is split into overlapping tiles
+  // which are run through the model, in parallel if several workers are
+  // configured (see TilingOptions), and the detections are merged in the frame
+  // coordinates system described above.
   tflite::support::StatusOr<DetectionResult> Detect(
       const FrameBuffer& frame_buffer);
 
+  // Same as above, except that the results are written into `result`, which is
+  // cleared first. Reusing the same `result` across calls recycles its
+  // sub-messages, so that no allocation happens once it has reached its
+  // steady-state size (except with `tiling_options`, whose intermediate
+  // results are allocated on each call). `result` may also be allocated on a
+  // `google::protobuf::Arena`, in which case all its sub-messages are
+  // allocated on that arena too.
+  absl::Status DetectInto(const FrameBuffer& frame_buffer,
+                          DetectionResult* result);
+
  protected:
   // Post-processing to transform the raw model outputs into detection results.
   tflite::support::StatusOr<DetectionResult> Postprocess(
@@ -142,6 +184,41 @@ class ObjectDetector : public BaseVisionTaskApi<DetectionResult> {
   // Performs sanity checks on the model outputs and extracts their metadata.
   absl::Status CheckAndSetOutputs();
 
+  // Same as above, for models with raw outputs, i.e. created with
+  // `raw_detection_options`. Also creates the `detection_decoder_`.
+  absl::Status CheckAndSetRawOutputs();
+
+  // Same as Postprocess(), except that the results are written into `result`,
+  // which is cleared first.
+  absl::Status PostprocessInto(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      const FrameBuffer& frame_buffer, const BoundingBox& roi,
+      DetectionResult* result);
+
+  // Post-processing for models with raw outputs.
+  absl::Status PostprocessRawOutputs(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      const FrameBuffer& frame_buffer, const BoundingBox& roi,
+      DetectionResult* result);
+
+  // Creates an ObjectDetector from the provided options, which have already
+  // been sanity checked, without any `tile_workers_`.
+  static tflite::support::StatusOr<std::unique_ptr<ObjectDetector>>
+  CreateFromOptionsInternal(const ObjectDetectorOptions& options,
+                            std::unique_ptr<tflite::OpResolver> resolver);
+
+  // Creates the `tile_workers_` and starts the `tile_worker_pool_`, if the
+  // `tiling_options` require more than one worker.
+  absl::Status InitTileWorkers(const OpResolverFactory& op_resolver_factory);
+
+  // Performs detection on each tile of `frame_buffer` as configured by the
+  // `tiling_options`, plus on `frame_roi` if `include_full_frame` is set, and
+  // merges the results into `result`. The tiles are spread over this
+  // ObjectDetector and the `tile_workers_`.
+  absl::Status DetectTiled(const FrameBuffer& frame_buffer,
+                           const BoundingBox& frame_roi,
+                           DetectionResult* result);
+
   // Performs sanity checks on the class whitelist/blacklist and forms the class
   // index set.
   absl::Status CheckAndSetClassIndexSet();
@@ -193,8 +270,20 @@ class ObjectDetector : public BaseVisionTaskApi<DetectionResult> {
 
   // Indices of the output tensors to match the output tensors to the correct
   // index order of the output tensors: [location, categories, scores,
-  // num_detections].
+  // num_detections], or [boxes, scores] for models with raw outputs.
   std::vector<int> output_indices_;
+
+  // Decoder of the raw outputs, only set for models with raw outputs.
+  std::unique_ptr<DetectionDecoder> detection_decoder_;
+  // Reused across inferences to avoid allocations.
+  std::vector<RawDetection> raw_detections_;
+
+  // The other ObjectDetector-s, built from the same options but without
+  // `tiling_options`, running tiles in parallel with this one. Empty unless
+  // `tiling_options.num_workers` is not 1.
+  std::vector<std::unique_ptr<ObjectDetector>> tile_workers_;
+  // Threads running the `tile_workers_`, started once by InitTileWorkers().
+  TileWorkerPool tile_worker_pool_;
 };
 
 }  // namespace vision
@@ -0,0 +1,451 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/detection_decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+constexpr float kDefaultAspectRatios[] = {1.0f, 2.0f, 0.5f, 3.0f, 1.0f / 3.0f};
+
+// Scale of the smallest anchor of the first layer when
+// `reduce_boxes_in_lowest_layer` is set.
+constexpr float kLowestLayerSmallestScale = 0.1f;
+
+absl::Status CreateInvalidArgumentError(const std::string& message) {
+  return CreateStatusWithPayload(StatusCode::kInvalidArgument, message,
+                                 TfLiteSupportStatus::kInvalidArgumentError);
+}
+
+inline float Sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+// Returns the threshold to compare the raw scores to, such that raw scores
+// below or equal to it are guaranteed to give scores below or equal to
+// `score_threshold` after a sigmoid (if `sigmoid`) or no activation.
+float GetRawScoreThreshold(float score_threshold, bool sigmoid) {
+  if (!sigmoid) return score_threshold;
+  if (score_threshold <= 0.0f) return -std::numeric_limits<float>::infinity();
+  if (score_threshold >= 1.0f) return std::numeric_limits<float>::infinity();
+  return std::log(score_threshold / (1.0f - score_threshold));
+}
+
+}  // namespace
+
+StatusOr<std::vector<Anchor>> GenerateSsdAnchors(
+    const SsdAnchorsOptions& options) {
+  const int num_layers = options.feature_map_sizes_size();
+  if (num_layers == 0) {
+    return CreateInvalidArgumentError(
+        "Expected at least one value in `feature_map_sizes`, found none.");
+  }
+  if (options.min_scale() <= 0 || options.max_scale() < options.min_scale()) {
+    return CreateInvalidArgumentError(absl::StrFormat(
+        "Expected 0 < `min_scale` <= `max_scale`, found %f and %f.",
+        options.min_scale(), options.max_scale()));
+  }
+  std::vector<float> aspect_ratios(options.aspect_ratios().begin(),
+                                   options.aspect_ratios().end());
+  if (aspect_ratios.empty()) {
+    aspect_ratios.assign(std::begin(kDefaultAspectRatios),
+                         std::end(kDefaultAspectRatios));
+  }
+  for (float aspect_ratio : aspect_ratios) {
+    if (aspect_ratio <= 0) {
+      return CreateInvalidArgumentError(absl::StrFormat(
+          "Expected strictly positive `aspect_ratios`, found %f.",
+          aspect_ratio));
+    }
+  }
+
+  // The scales of the layers, plus 1 for the interpolated scale of the last
+  // layer.
+  std::vector<float> scales;
+  for (int layer = 0; layer < num_layers; ++layer) {
+    scales.push_back(num_layers == 1
+                         ? options.min_scale()
+                         : options.min_scale() +
+                               (options.max_scale() - options.min_scale()) *
+                                   layer / (num_layers - 1));
+  }
+  scales.push_back(1.0f);
+
+  std::vector<Anchor> anchors;
+  for (int layer = 0; layer < num_layers; ++layer) {
+    const int feature_map_size = options.feature_map_sizes(layer);
+    if (feature_map_size <= 0) {
+      return CreateInvalidArgumentError(absl::StrFormat(
+          "Expected strictly positive `feature_map_sizes`, found %d.",
+          feature_map_size));
+    }
+    // The (scale, aspect ratio) of the anchors generated at each location.
+    std::vector<std::pair<float, float>> box_specs;
+    if (layer == 0 && options.reduce_boxes_in_lowest_layer()) {
+      box_specs = {{kLowestLayerSmallestScale, 1.0f},
+                   {scales[layer], 2.0f},
+                   {scales[layer], 0.5f}};
+    } else {
+      for (float aspect_ratio : aspect_ratios) {
+        box_specs.emplace_back(scales[layer], aspect_ratio);
+      }
+      if (options.interpolated_scale_aspect_ratio() > 0) {
+        box_specs.emplace_back(std::sqrt(scales[layer] * scales[layer + 1]),
+                               options.interpolated_scale_aspect_ratio());
+      }
+    }
+    for (int y = 0; y < feature_map_size; ++y) {
+      for (int x = 0; x < feature_map_size; ++x) {
+        for (const auto& box_spec : box_specs) {
+          const float ratio_sqrt = std::sqrt(box_spec.second);
+          Anchor anchor;
+          anchor.y_center = (y + 0.5f) / feature_map_size;
+          anchor.x_center = (x + 0.5f) / feature_map_size;
+          anchor.height = box_spec.first / ratio_sqrt;
+          anchor.width = box_spec.first * ratio_sqrt;
+          anchors.push_back(anchor);
+        }
+      }
+    }
+  }
+  return anchors;
+}
+
+StatusOr<std::vector<Anchor>> ParseAnchors(absl::string_view anchors_file) {
+  std::vector<Anchor> anchors;
+  int line_number = 0;
+  for (absl::string_view line : absl::StrSplit(anchors_file, '\n')) {
+    ++line_number;
+    std::vector<absl::string_view> values = absl::StrSplit(
+        line, absl::ByAnyChar(", \t\r"), absl::SkipWhitespace());
+    if (values.empty()) continue;
+    float parsed[4];
+    bool valid = values.size() == 4;
+    for (int i = 0; valid && i < 4; ++i) {
+      valid = absl::SimpleAtof(values[i], &parsed[i]);
+    }
+    if (!valid) {
+      return CreateInvalidArgumentError(absl::StrFormat(
+          "Invalid anchor at line %d: expected 4 numbers, found \"%s\".",
+          line_number, line));
+    }
+    anchors.push_back({parsed[0], parsed[1], parsed[2], parsed[3]});
+  }
+  return anchors;
+}
+
+/* static */
+StatusOr<std::unique_ptr<DetectionDecoder>> DetectionDecoder::Create(
+    const RawDetectionOptions& options, std::vector<Anchor> anchors,
+    int num_boxes, int num_classes, bool single_output) {
+  const int first_class = options.has_background_class() ? 1 : 0;
+  if (num_boxes <= 0 || num_classes <= first_class) {
+    return CreateInvalidArgumentError(absl::StrFormat(
+        "Expected at least one box and one non-background class, found %d "
+        "boxes and %d classes.",
+        num_boxes, num_classes));
+  }
+  if (options.box_index_size() != 0 && options.box_index_size() != 4) {
+    return CreateInvalidArgumentError(
+        absl::StrFormat("Expected `box_index` to contain 4 values, found %d.",
+                        options.box_index_size()));
+  }
+  auto decoder = absl::WrapUnique(new DetectionDecoder());
+  if (options.box_index_size() == 4) {
+    bool seen[4] = {false, false, false, false};
+    for (int i = 0; i < 4; ++i) {
+      const int index = options.box_index(i);
+      if (index < 0 || index > 3 || seen[index]) {
+        return CreateInvalidArgumentError(
+            "Expected `box_index` to be a permutation of [0, 1, 2, 3].");
+      }
+      seen[index] = true;
+      decoder->box_index_[i] = index;
+    }
+  }
+  if (options.box_coding() == RawDetectionOptions::CENTER_SIZE_WITH_ANCHORS) {
+    if (anchors.size() != static_cast<size_t>(num_boxes)) {
+      return CreateInvalidArgumentError(absl::StrFormat(
+          "Expected one anchor per box, found %d anchors for %d boxes.",
+          anchors.size(), num_boxes));
+    }
+    if (options.y_scale() == 0 || options.x_scale() == 0 ||
+        options.h_scale() == 0 || options.w_scale() == 0) {
+      return CreateInvalidArgumentError(
+          "Expected non-zero `y_scale`, `x_scale`, `h_scale` and `w_scale`.");
+    }
+  }
+  if (options.iou_threshold() < 0 || options.iou_threshold() > 1) {
+    return CreateInvalidArgumentError(
+        absl::StrFormat("Expected `iou_threshold` in [0, 1], found %f.",
+                        options.iou_threshold()));
+  }
+  if (options.max_candidates() <= 0) {
+    return CreateInvalidArgumentError(
+        absl::StrFormat("Expected strictly positive `max_candidates`, found %d.",
+                        options.max_candidates()));
+  }
+  if (options.has_objectness_score() && !single_output) {
+    return CreateInvalidArgumentError(
+        "`has_objectness_score` is only supported for models with a single "
+        "output.");
+  }
+
+  decoder->options_ = options;
+  decoder->anchors_ = std::move(anchors);
+  decoder->num_boxes_ = num_boxes;
+  decoder->num_classes_ = num_classes;
+  decoder->first_class_ = first_class;
+  if (single_output) {
+    const int num_objectness = options.has_objectness_score() ? 1 : 0;
+    decoder->boxes_stride_ = 4 + num_objectness + num_classes;
+    decoder->scores_stride_ = decoder->boxes_stride_;
+    decoder->scores_offset_ = 4 + num_objectness;
+    decoder->objectness_offset_ = options.has_objectness_score() ? 4 : -1;
+  } else {
+    decoder->boxes_stride_ = 4;
+    decoder->scores_stride_ = num_classes;
+  }
+  return decoder;
+}
+
+absl::Status DetectionDecoder::Decode(const float* boxes, const float* scores,
+                                      float score_threshold,
+                                      int max_detections,
+                                      std::vector<RawDetection>* detections) {
+  if (boxes == nullptr || scores == nullptr || detections == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Expected non-null boxes, scores and detections.");
+  }
+  SelectCandidates(scores, score_threshold);
+
+  // Sort by decreasing score, breaking ties by box then class for
+  // reproducibility.
+  auto before = [](const Candidate& a, const Candidate& b) {
+    if (a.score != b.score) return a.score > b.score;
+    if (a.box_index != b.box_index) return a.box_index < b.box_index;
+    return a.class_index < b.class_index;
+  };
+  const size_t max_candidates = options_.max_candidates();
+  if (candidates_.size() > max_candidates) {
+    std::nth_element(candidates_.begin(), candidates_.begin() + max_candidates,
+                     candidates_.end(), before);
+    candidates_.resize(max_candidates);
+  }
+  std::sort(candidates_.begin(), candidates_.end(), before);
+
+  // Only the candidates' boxes are decoded.
+  decoded_.resize(candidates_.size());
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    DecodeBox(boxes, candidates_[i], &decoded_[i]);
+  }
+  NonMaxSuppression(max_detections, detections);
+  return absl::OkStatus();
+}
+
+void DetectionDecoder::SelectCandidates(const float* scores,
+                                        float score_threshold) {
+  candidates_.clear();
+  const RawDetectionOptions::ScoreActivation activation =
+      options_.score_activation();
+  const bool sigmoid = activation == RawDetectionOptions::SIGMOID;
+  const bool softmax = activation == RawDetectionOptions::SOFTMAX;
+  const bool class_agnostic = options_.class_agnostic_nms();
+  // The objectness score goes through a sigmoid, unless there is no
+  // activation at all.
+  const float objectness_threshold = GetRawScoreThreshold(
+      score_threshold, activation != RawDetectionOptions::NONE);
+  const float raw_threshold = GetRawScoreThreshold(score_threshold, sigmoid);
+  // Softmax scores are below `exp(raw_score - max_raw_score)`.
+  const float log_threshold = score_threshold > 0
+                                  ? std::log(score_threshold)
+                                  : -std::numeric_limits<float>::infinity();
+
+  for (int i = 0; i < num_boxes_; ++i) {
+    const float* row = scores + static_cast<size_t>(i) * scores_stride_;
+    float objectness = 1.0f;
+    if (objectness_offset_ >= 0) {
+      // Class scores are probabilities, so the final scores can't be above
+      // the objectness.
+      const float raw_objectness = row[objectness_offset_];
+      if (raw_objectness <= objectness_threshold) continue;
+      objectness = activation == RawDetectionOptions::NONE
+                       ? raw_objectness
+                       : Sigmoid(raw_objectness);
+    }
+    const float* class_scores = row + scores_offset_;
+    float cutoff = raw_threshold;
+    float max_raw_score = 0;
+    float softmax_sum = -1;
+    if (softmax) {
+      max_raw_score =
+          *std::max_element(class_scores, class_scores + num_classes_);
+      cutoff = max_raw_score + log_threshold;
+    }
+    Candidate best = {i, -1, 0};
+    for (int c = first_class_; c < num_classes_; ++c) {
+      const float raw_score = class_scores[c];
+      if (raw_score <= cutoff) continue;
+      const int class_index = c - first_class_;
+      if (!IsClassAllowed(class_index)) continue;
+      float score = raw_score;
+      if (sigmoid) {
+        score = Sigmoid(raw_score);
+      } else if (softmax) {
+        // Only computed for the boxes with candidates.
+        if (softmax_sum < 0) {
+          softmax_sum = 0;
+          for (int k = 0; k < num_classes_; ++k) {
+            softmax_sum += std::exp(class_scores[k] - max_raw_score);
+          }
+        }
+        score = std::exp(raw_score - max_raw_score) / softmax_sum;
+      }
+      score *= objectness;
+      if (score <= score_threshold) continue;
+      if (!class_agnostic) {
+        candidates_.push_back({i, class_index, score});
+      } else if (best.class_index < 0 || score > best.score) {
+        best = {i, class_index, score};
+      }
+    }
+    if (best.class_index >= 0) {
+      candidates_.push_back(best);
+    }
+  }
+}
+
+void DetectionDecoder::DecodeBox(const float* boxes,
+                                 const Candidate& candidate,
+                                 RawDetection* detection) const {
+  const float* box =
+      boxes + static_cast<size_t>(candidate.box_index) * boxes_stride_;
+  const float v0 = box[box_index_[0]];
+  const float v1 = box[box_index_[1]];
+  const float v2 = box[box_index_[2]];
+  const float v3 = box[box_index_[3]];
+  detection->class_index = candidate.class_index;
+  detection->score = candidate.score;
+
+  float y_center, x_center, height, width;
+  switch (options_.box_coding()) {
+    case RawDetectionOptions::BOUNDARIES:
+      detection->ymin = v0;
+      detection->xmin = v1;
+      detection->ymax = v2;
+      detection->xmax = v3;
+      return;
+    case RawDetectionOptions::CENTER_SIZE:
+      y_center = v0;
+      x_center = v1;
+      height = v2;
+      width = v3;
+      break;
+    case RawDetectionOptions::CENTER_SIZE_WITH_ANCHORS:
+    default: {
+      const Anchor& anchor = anchors_[candidate.box_index];
+      y_center = v0 / options_.y_scale() * anchor.height + anchor.y_center;
+      x_center = v1 / options_.x_scale() * anchor.width + anchor.x_center;
+      height = std::exp(v2 / options_.h_scale()) * anchor.height;
+      width = std::exp(v3 / options_.w_scale()) * anchor.width;
+      break;
+    }
+  }
+  detection->ymin = y_center - height / 2;
+  detection->xmin = x_center - width / 2;
+  detection->ymax = y_center + height / 2;
+  detection->xmax = x_center + width / 2;
+}
+
+void DetectionDecoder::NonMaxSuppression(
+    int max_detections, std::vector<RawDetection>* detections) {
+  detections->clear();
+  const int num_candidates = decoded_.size();
+  ymin_.resize(num_candidates);
+  xmin_.resize(num_candidates);
+  ymax_.resize(num_candidates);
+  xmax_.resize(num_candidates);
+  area_.resize(num_candidates);
+  class_.resize(num_candidates);
+  suppressed_.assign(num_candidates, 0);
+  const bool class_agnostic = options_.class_agnostic_nms();
+  for (int i = 0; i < num_candidates; ++i) {
+    const RawDetection& detection = decoded_[i];
+    ymin_[i] = std::min(detection.ymin, detection.ymax);
+    xmin_[i] = std::min(detection.xmin, detection.xmax);
+    ymax_[i] = std::max(detection.ymin, detection.ymax);
+    xmax_[i] = std::max(detection.xmin, detection.xmax);
+    area_[i] = (ymax_[i] - ymin_[i]) * (xmax_[i] - xmin_[i]);
+    // All candidates are in the same class for class-agnostic NMS.
+    class_[i] = class_agnostic ? 0 : detection.class_index;
+  }
+
+  const float iou_threshold = options_.iou_threshold();
+  const float* ymin = ymin_.data();
+  const float* xmin = xmin_.data();
+  const float* ymax = ymax_.data();
+  const float* xmax = xmax_.data();
+  const float* area = area_.data();
+  const int* classes = class_.data();
+  uint8_t* suppressed = suppressed_.data();
+  for (int i = 0; i < num_candidates; ++i) {
+    if (suppressed[i]) continue;
+    detections->push_back(decoded_[i]);
+    if (max_detections >= 0 &&
+        detections->size() >= static_cast<size_t>(max_detections)) {
+      break;
+    }
+    const float box_ymin = ymin[i];
+    const float box_xmin = xmin[i];
+    const float box_ymax = ymax[i];
+    const float box_xmax = xmax[i];
+    const float box_area = area[i];
+    const int box_class = classes[i];
+    // Branch-free, so that it gets vectorized. `iou > iou_threshold` is
+    // computed without division, the union being >= 0.
+    for (int j = i + 1; j < num_candidates; ++j) {
+      const float intersection_height = std::max(
+          0.0f, std::min(box_ymax, ymax[j]) - std::max(box_ymin, ymin[j]));
+      const float intersection_width = std::max(
+          0.0f, std::min(box_xmax, xmax[j]) - std::max(box_xmin, xmin[j]));
+      const float intersection = intersection_height * intersection_width;
+      const float union_area = box_area + area[j] - intersection;
+      suppressed[j] |= static_cast<uint8_t>(
+          (intersection > iou_threshold * union_area) &
+          (classes[j] == box_class));
+    }
+  }
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
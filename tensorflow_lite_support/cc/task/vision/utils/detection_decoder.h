@@ -0,0 +1,164 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_DETECTION_DECODER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_DETECTION_DECODER_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/raw_detection_options_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// An anchor box, in normalized coordinates.
+struct Anchor {
+  float y_center;
+  float x_center;
+  float height;
+  float width;
+};
+
+// Generates the anchors of an SSD model, in the order used by the model
+// outputs: layer by layer, then row by row and column by column within each
+// layer, then anchor by anchor at each location.
+tflite::support::StatusOr<std::vector<Anchor>> GenerateSsdAnchors(
+    const SsdAnchorsOptions& options);
+
+// Parses the anchors listed in `anchors_file`, one per line as 4 comma- or
+// space-separated values: `y_center x_center height width`. Empty lines are
+// ignored.
+tflite::support::StatusOr<std::vector<Anchor>> ParseAnchors(
+    absl::string_view anchors_file);
+
+// A detection decoded from the raw model outputs, in normalized coordinates.
+struct RawDetection {
+  float ymin;
+  float xmin;
+  float ymax;
+  float xmax;
+  // Index of the class, not counting the background class if any.
+  int class_index;
+  float score;
+};
+
+// Decodes the raw boxes and scores output by detection models that don't end
+// with the TFLite_Detection_PostProcess custom op, and filters them by
+// non-maximum suppression (NMS). See `RawDetectionOptions` for the supported
+// output layouts.
+//
+// This is much cheaper than the in-graph op on large numbers of anchors:
+// - the score threshold is first applied to the raw scores (e.g. compared to
+//   the logit of the threshold for sigmoid activations), so that activations
+//   and box decoding only run for the few candidates above the threshold,
+// - NMS works on a structure of arrays of the candidate boxes, so that the
+//   intersection-over-union of a selected box with all remaining candidates is
+//   a branch-free loop the compiler vectorizes.
+//
+// Scratch buffers are reused across calls: this class is not thread-safe.
+class DetectionDecoder {
+ public:
+  // Creates a decoder for outputs holding `num_boxes` boxes and scores for
+  // `num_classes` classes, including the background class if any. `anchors`
+  // are mandatory for CENTER_SIZE_WITH_ANCHORS, and must then hold `num_boxes`
+  // anchors. If `single_output` is true, boxes and scores are read from a
+  // single tensor of size `[1 x num_boxes x (4 + num_classes)]` (plus one for
+  // the objectness score, if any).
+  static tflite::support::StatusOr<std::unique_ptr<DetectionDecoder>> Create(
+      const RawDetectionOptions& options, std::vector<Anchor> anchors,
+      int num_boxes, int num_classes, bool single_output);
+
+  // Restricts the decoded detections to the classes `c` such that
+  // `allowed_classes[c]` is true, `c` not counting the background class if
+  // any. An empty vector (default) allows all classes.
+  void SetAllowedClasses(std::vector<bool> allowed_classes) {
+    allowed_classes_ = std::move(allowed_classes);
+  }
+
+  // Decodes the detections scored strictly above `score_threshold`, and
+  // returns at most `max_detections` of them (all if < 0) after NMS, sorted
+  // by decreasing score, in `detections`. For single-output models, `boxes`
+  // and `scores` must both point to the data of the output tensor.
+  absl::Status Decode(const float* boxes, const float* scores,
+                      float score_threshold, int max_detections,
+                      std::vector<RawDetection>* detections);
+
+ private:
+  struct Candidate {
+    int box_index;
+    int class_index;
+    float score;
+  };
+
+  DetectionDecoder() = default;
+
+  // Fills `candidates_` with the detections above `score_threshold`.
+  void SelectCandidates(const float* scores, float score_threshold);
+  // Decodes the box of `candidate` into `detection`.
+  void DecodeBox(const float* boxes, const Candidate& candidate,
+                 RawDetection* detection) const;
+  // Runs NMS on `decoded_`, sorted by decreasing score.
+  void NonMaxSuppression(int max_detections,
+                         std::vector<RawDetection>* detections);
+
+  bool IsClassAllowed(int class_index) const {
+    return allowed_classes_.empty() ||
+           (class_index < static_cast<int>(allowed_classes_.size()) &&
+            allowed_classes_[class_index]);
+  }
+
+  RawDetectionOptions options_;
+  std::vector<Anchor> anchors_;
+  int num_boxes_ = 0;
+  // Number of classes in the scores, including the background class if any.
+  int num_classes_ = 0;
+  // 1 if the first class is the background class, 0 otherwise.
+  int first_class_ = 0;
+  // Distance between consecutive boxes (resp. scores), in floats.
+  int boxes_stride_ = 4;
+  int scores_stride_ = 0;
+  // Offsets of the scores and objectness score (-1 if none) within each row
+  // of `scores`.
+  int scores_offset_ = 0;
+  int objectness_offset_ = -1;
+  // Positions of the 4 box coordinates, see `RawDetectionOptions.box_index`.
+  std::array<int, 4> box_index_ = {{0, 1, 2, 3}};
+  std::vector<bool> allowed_classes_;
+
+  // Scratch buffers.
+  std::vector<Candidate> candidates_;
+  std::vector<RawDetection> decoded_;
+  std::vector<float> ymin_;
+  std::vector<float> xmin_;
+  std::vector<float> ymax_;
+  std::vector<float> xmax_;
+  std::vector<float> area_;
+  std::vector<int> class_;
+  std::vector<uint8_t> suppressed_;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_DETECTION_DECODER_H_
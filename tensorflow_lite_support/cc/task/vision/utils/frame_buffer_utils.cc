@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -153,6 +154,179 @@ static void RotateCoordinates(int from_x, int from_y, int angle,
   }
 }
 
+// Returns whether `format` is one of the YUV 4:2:0 formats.
+bool IsYuvFormat(FrameBuffer::Format format) {
+  return format == FrameBuffer::Format::kNV12 ||
+         format == FrameBuffer::Format::kNV21 ||
+         format == FrameBuffer::Format::kYV12 ||
+         format == FrameBuffer::Format::kYV21;
+}
+
+// Returns the crop / resize operation of `operations` if they crop / resize
+// (optionally), orient and convert a YUV `buffer` to RGB or RGBA, i.e. can be
+// performed in a single pass by `CropResizeOrientConvertYuv`.
+absl::optional<CropResizeOperation> GetFusableYuvCropResize(
+    const FrameBuffer& buffer,
+    const std::vector<FrameBufferOperation>& operations) {
+  if (!IsYuvFormat(buffer.format()) || operations.size() < 2) {
+    return absl::nullopt;
+  }
+  int index = 0;
+  CropResizeOperation crop_resize(0, 0, buffer.dimension(), buffer.dimension());
+  if (absl::holds_alternative<CropResizeOperation>(operations[0])) {
+    crop_resize = absl::get<CropResizeOperation>(operations[0]);
+    ++index;
+  }
+  if (operations.size() != static_cast<size_t>(index + 2) ||
+      !absl::holds_alternative<OrientOperation>(operations[index]) ||
+      !absl::holds_alternative<ConvertOperation>(operations[index + 1])) {
+    return absl::nullopt;
+  }
+  const FrameBuffer::Format to_format =
+      absl::get<ConvertOperation>(operations[index + 1]).to_format;
+  if (to_format != FrameBuffer::Format::kRGB &&
+      to_format != FrameBuffer::Format::kRGBA) {
+    return absl::nullopt;
+  }
+  return crop_resize;
+}
+
+// Fixed-point precision of the sampling coordinates.
+constexpr int kFixedPointBits = 16;
+constexpr int kFixedPointOne = 1 << kFixedPointBits;
+
+// Converts BT.601 limited range YUV to RGB, as libyuv does.
+inline void YuvToRgb(int y, int u, int v, uint8* rgb) {
+  const int c = 298 * (y - 16) + 128;
+  const int d = u - 128;
+  const int e = v - 128;
+  rgb[0] = static_cast<uint8>(std::min(std::max((c + 409 * e) >> 8, 0), 255));
+  rgb[1] = static_cast<uint8>(
+      std::min(std::max((c - 100 * d - 208 * e) >> 8, 0), 255));
+  rgb[2] = static_cast<uint8>(std::min(std::max((c + 516 * d) >> 8, 0), 255));
+}
+
+// Crops and resizes (with bilinear interpolation) YUV `buffer` as described by
+// `crop_resize`, orients it to the orientation of `output_buffer` and converts
+// it to RGB or RGBA, in a single pass: each output pixel is sampled from the
+// source at the coordinates obtained by applying the inverse orientation and
+// scaling, so that no intermediate frame is produced.
+//
+// Luma is interpolated bilinearly, while chroma is sampled from the nearest
+// chroma sample, as libyuv does when upsampling the 4:2:0 chroma planes. The
+// result may thus differ from the chained operations by a few intensity levels
+// when resizing.
+absl::Status CropResizeOrientConvertYuv(const FrameBuffer& buffer,
+                                        const CropResizeOperation& crop_resize,
+                                        FrameBuffer* output_buffer) {
+  const int crop_x = crop_resize.crop_origin_x;
+  const int crop_y = crop_resize.crop_origin_y;
+  const FrameBuffer::Dimension crop_dimension = crop_resize.crop_dimension;
+  const FrameBuffer::Dimension resize_dimension = crop_resize.resize_dimension;
+  if (crop_x < 0 || crop_y < 0 || crop_dimension.width <= 0 ||
+      crop_dimension.height <= 0 ||
+      crop_x + crop_dimension.width > buffer.dimension().width ||
+      crop_y + crop_dimension.height > buffer.dimension().height) {
+    return absl::InvalidArgumentError("Invalid crop coordinates.");
+  }
+  const FrameBuffer::Dimension output_dimension = output_buffer->dimension();
+  FrameBuffer::Dimension pre_orient_dimension = output_dimension;
+  if (RequireDimensionSwap(buffer.orientation(),
+                           output_buffer->orientation())) {
+    pre_orient_dimension.Swap();
+  }
+  if (resize_dimension != pre_orient_dimension) {
+    return absl::InvalidArgumentError(
+        "The output metadata does not match pipeline result metadata.");
+  }
+  ASSIGN_OR_RETURN(FrameBuffer::YuvData yuv_data,
+                   FrameBuffer::GetYuvDataFromFrameBuffer(buffer));
+
+  // Output coordinates map to pre-orientation coordinates through an affine
+  // transform, derived from the images of (0, 0), (1, 0) and (0, 1).
+  int x00, y00, x10, y10, x01, y01;
+  OrientCoordinates(0, 0, output_buffer->orientation(), buffer.orientation(),
+                    output_dimension, &x00, &y00);
+  OrientCoordinates(1, 0, output_buffer->orientation(), buffer.orientation(),
+                    output_dimension, &x10, &y10);
+  OrientCoordinates(0, 1, output_buffer->orientation(), buffer.orientation(),
+                    output_dimension, &x01, &y01);
+
+  // Pre-orientation pixel `p` is sampled at source coordinate
+  // `crop + (p + 0.5) * scale - 0.5`, i.e. pixel centers are aligned.
+  const int64_t scale_x = static_cast<int64_t>(crop_dimension.width) *
+                          kFixedPointOne / resize_dimension.width;
+  const int64_t scale_y = static_cast<int64_t>(crop_dimension.height) *
+                          kFixedPointOne / resize_dimension.height;
+  auto source_x = [&](int64_t pre_orient_x) {
+    return static_cast<int64_t>(crop_x) * kFixedPointOne +
+           ((2 * pre_orient_x + 1) * scale_x - kFixedPointOne) / 2;
+  };
+  auto source_y = [&](int64_t pre_orient_y) {
+    return static_cast<int64_t>(crop_y) * kFixedPointOne +
+           ((2 * pre_orient_y + 1) * scale_y - kFixedPointOne) / 2;
+  };
+  // Source coordinate steps along an output row.
+  const int64_t step_x = (x10 - x00) * scale_x;
+  const int64_t step_y = (y10 - y00) * scale_y;
+
+  const int64_t min_x = static_cast<int64_t>(crop_x) * kFixedPointOne;
+  const int64_t max_x =
+      static_cast<int64_t>(crop_x + crop_dimension.width - 1) * kFixedPointOne;
+  const int64_t min_y = static_cast<int64_t>(crop_y) * kFixedPointOne;
+  const int64_t max_y =
+      static_cast<int64_t>(crop_y + crop_dimension.height - 1) * kFixedPointOne;
+  const int last_x = crop_x + crop_dimension.width - 1;
+  const int last_y = crop_y + crop_dimension.height - 1;
+
+  const bool has_alpha =
+      output_buffer->format() == FrameBuffer::Format::kRGBA;
+  const int output_pixel_stride =
+      output_buffer->plane(0).stride.pixel_stride_bytes;
+  const int output_row_stride = output_buffer->plane(0).stride.row_stride_bytes;
+  uint8* output_data = const_cast<uint8*>(output_buffer->plane(0).buffer);
+
+  for (int oy = 0; oy < output_dimension.height; ++oy) {
+    int64_t sx = source_x(x00 + oy * (x01 - x00));
+    int64_t sy = source_y(y00 + oy * (y01 - y00));
+    uint8* output_row = output_data + oy * output_row_stride;
+    for (int ox = 0; ox < output_dimension.width;
+         ++ox, sx += step_x, sy += step_y) {
+      const int64_t cx = std::min(std::max(sx, min_x), max_x);
+      const int64_t cy = std::min(std::max(sy, min_y), max_y);
+      const int x0 = static_cast<int>(cx >> kFixedPointBits);
+      const int y0 = static_cast<int>(cy >> kFixedPointBits);
+      const int x1 = std::min(x0 + 1, last_x);
+      const int y1 = std::min(y0 + 1, last_y);
+      // 8-bit interpolation weights.
+      const int fx = static_cast<int>(cx & (kFixedPointOne - 1)) >> 8;
+      const int fy = static_cast<int>(cy & (kFixedPointOne - 1)) >> 8;
+
+      const uint8* y_row0 = yuv_data.y_buffer + y0 * yuv_data.y_row_stride;
+      const uint8* y_row1 = yuv_data.y_buffer + y1 * yuv_data.y_row_stride;
+      const int top = y_row0[x0] * (256 - fx) + y_row0[x1] * fx;
+      const int bottom = y_row1[x0] * (256 - fx) + y_row1[x1] * fx;
+      const int luma = (top * (256 - fy) + bottom * fy + (1 << 15)) >> 16;
+
+      // Chroma sample covering the nearest luma sample.
+      const int nearest_x = std::min(
+          static_cast<int>((cx + kFixedPointOne / 2) >> kFixedPointBits),
+          last_x);
+      const int nearest_y = std::min(
+          static_cast<int>((cy + kFixedPointOne / 2) >> kFixedPointBits),
+          last_y);
+      const int uv_offset = (nearest_y / 2) * yuv_data.uv_row_stride +
+                            (nearest_x / 2) * yuv_data.uv_pixel_stride;
+
+      uint8* rgb = output_row + ox * output_pixel_stride;
+      YuvToRgb(luma, yuv_data.u_buffer[uv_offset],
+               yuv_data.v_buffer[uv_offset], rgb);
+      if (has_alpha) rgb[3] = 255;
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 int GetBufferByteSize(FrameBuffer::Dimension dimension,
@@ -643,6 +817,15 @@ absl::Status FrameBufferUtils::Preprocess(
     }
   }
 
+  // Rotated YUV camera frames are cropped, resized, oriented and converted in
+  // a single pass, instead of going through intermediate frames.
+  absl::optional<CropResizeOperation> fusable_crop_resize =
+      GetFusableYuvCropResize(buffer, frame_buffer_operations);
+  if (fusable_crop_resize.has_value()) {
+    return CropResizeOrientConvertYuv(buffer, *fusable_crop_resize,
+                                      output_buffer);
+  }
+
   // Execute the processing pipeline.
   if (frame_buffer_operations.empty()) {
     // Using resize to perform copy.
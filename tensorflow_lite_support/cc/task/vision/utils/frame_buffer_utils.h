@@ -276,7 +276,10 @@ class FrameBufferUtils {
   //
   // Internally, a chain of operations is constructed. For performance
   // optimization, operations are performed in the following order: crop,
-  // resize, convert color space format, and rotate.
+  // resize, convert color space format, and rotate. Rotated YUV frames
+  // converted to RGB or RGBA (e.g. camera frames fed to a model) are processed
+  // in a single pass instead, sampling the source at the inversely rotated and
+  // scaled coordinates of each output pixel.
   //
   // The `output_buffer` should have metadata populated and its backing buffer
   // should be big enough to store the operation result. Insufficient backing
@@ -0,0 +1,120 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_conversion_cache.h"
+
+#include <utility>
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+/* static */
+FrameConversionKey FrameConversionKey::Create(
+    const FrameBuffer& frame_buffer, const BoundingBox& roi,
+    FrameBuffer::Dimension output_dimension, FrameBuffer::Format output_format,
+    FrameBuffer::Orientation output_orientation) {
+  FrameConversionKey key;
+  for (int i = 0; i < frame_buffer.plane_count() && i < 3; ++i) {
+    key.plane_buffers[i] = frame_buffer.plane(i).buffer;
+  }
+  key.timestamp = frame_buffer.timestamp();
+  key.dimension = frame_buffer.dimension();
+  key.format = frame_buffer.format();
+  key.orientation = frame_buffer.orientation();
+  key.roi_x = roi.origin_x();
+  key.roi_y = roi.origin_y();
+  key.roi_width = roi.width();
+  key.roi_height = roi.height();
+  key.output_dimension = output_dimension;
+  key.output_format = output_format;
+  key.output_orientation = output_orientation;
+  return key;
+}
+
+bool FrameConversionKey::operator==(const FrameConversionKey& other) const {
+  return plane_buffers == other.plane_buffers &&
+         timestamp == other.timestamp && dimension == other.dimension &&
+         format == other.format && orientation == other.orientation &&
+         roi_x == other.roi_x && roi_y == other.roi_y &&
+         roi_width == other.roi_width && roi_height == other.roi_height &&
+         output_dimension == other.output_dimension &&
+         output_format == other.output_format &&
+         output_orientation == other.output_orientation;
+}
+
+constexpr size_t FrameConversionCache::kDefaultMaxBytes;
+
+FrameConversionCache::FrameConversionCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+std::shared_ptr<const std::vector<uint8>> FrameConversionCache::Lookup(
+    const FrameConversionKey& key) {
+  absl::MutexLock lock(&mutex_);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->key == key) {
+      // Move to the front, as the most recently used.
+      entries_.splice(entries_.begin(), entries_, it);
+      ++hits_;
+      return entries_.front().data;
+    }
+  }
+  ++misses_;
+  return nullptr;
+}
+
+void FrameConversionCache::Insert(
+    const FrameConversionKey& key,
+    std::shared_ptr<const std::vector<uint8>> data) {
+  if (data == nullptr || data->size() > max_bytes_) return;
+  absl::MutexLock lock(&mutex_);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->key == key) {
+      num_bytes_ -= it->data->size();
+      entries_.erase(it);
+      break;
+    }
+  }
+  num_bytes_ += data->size();
+  entries_.push_front({key, std::move(data)});
+  EvictIfNeeded();
+}
+
+void FrameConversionCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  entries_.clear();
+  num_bytes_ = 0;
+}
+
+int64 FrameConversionCache::hits() const {
+  absl::MutexLock lock(&mutex_);
+  return hits_;
+}
+
+int64 FrameConversionCache::misses() const {
+  absl::MutexLock lock(&mutex_);
+  return misses_;
+}
+
+void FrameConversionCache::EvictIfNeeded() {
+  while (num_bytes_ > max_bytes_ && !entries_.empty()) {
+    num_bytes_ -= entries_.back().data->size();
+    entries_.pop_back();
+  }
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,128 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FRAME_CONVERSION_CACHE_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FRAME_CONVERSION_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/integral_types.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Identifies the conversion of a region of a frame into a given format,
+// dimension and orientation.
+struct FrameConversionKey {
+  // Identity of the source frame: its planes and metadata.
+  std::array<const uint8*, 3> plane_buffers = {{nullptr, nullptr, nullptr}};
+  absl::Time timestamp;
+  FrameBuffer::Dimension dimension;
+  FrameBuffer::Format format = FrameBuffer::Format::kRGB;
+  FrameBuffer::Orientation orientation = FrameBuffer::Orientation::kTopLeft;
+  // Region of the source frame, in its unrotated coordinates.
+  int roi_x = 0;
+  int roi_y = 0;
+  int roi_width = 0;
+  int roi_height = 0;
+  // Output of the conversion.
+  FrameBuffer::Dimension output_dimension;
+  FrameBuffer::Format output_format = FrameBuffer::Format::kRGB;
+  FrameBuffer::Orientation output_orientation =
+      FrameBuffer::Orientation::kTopLeft;
+
+  static FrameConversionKey Create(const FrameBuffer& frame_buffer,
+                                   const BoundingBox& roi,
+                                   FrameBuffer::Dimension output_dimension,
+                                   FrameBuffer::Format output_format,
+                                   FrameBuffer::Orientation output_orientation);
+
+  bool operator==(const FrameConversionKey& other) const;
+};
+
+// Size-bounded cache of frame conversions (cropping, resizing, color space
+// conversion and rotation), which tasks consuming the same frames can share so
+// that only the first one performs a given conversion. See
+// `BaseVisionTaskApi::SetFrameConversionCache`.
+//
+// Frames are identified by their plane buffers and metadata, including their
+// timestamp: a frame must not be modified in place while keeping the same
+// buffers and timestamp, as stale conversions would then be returned.
+// `FrameBuffer::Create` sets the timestamp to the current time by default.
+//
+// The least recently used conversions are evicted first. This class is
+// thread-safe.
+class FrameConversionCache {
+ public:
+  // 4 MiB, i.e. about 25 conversions to 224x224 RGB.
+  static constexpr size_t kDefaultMaxBytes = 4 << 20;
+
+  // Keeps the total size of the cached conversions below `max_bytes`.
+  explicit FrameConversionCache(size_t max_bytes = kDefaultMaxBytes);
+  FrameConversionCache(const FrameConversionCache&) = delete;
+  FrameConversionCache& operator=(const FrameConversionCache&) = delete;
+
+  // Returns the cached conversion for `key`, or nullptr if there is none. The
+  // returned data remains valid after it is evicted.
+  std::shared_ptr<const std::vector<uint8>> Lookup(
+      const FrameConversionKey& key);
+
+  // Caches the conversion `data` for `key`, replacing the previous one if any.
+  // Conversions larger than the cache are not cached.
+  void Insert(const FrameConversionKey& key,
+              std::shared_ptr<const std::vector<uint8>> data);
+
+  // Evicts all the cached conversions.
+  void Clear();
+
+  int64 hits() const;
+  int64 misses() const;
+
+ private:
+  struct Entry {
+    FrameConversionKey key;
+    std::shared_ptr<const std::vector<uint8>> data;
+  };
+
+  // Evicts the least recently used conversions until the total size is below
+  // `max_bytes_`.
+  void EvictIfNeeded() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_bytes_;
+
+  mutable absl::Mutex mutex_;
+  // Most recently used first. Only a handful of conversions are cached, so
+  // lookups are linear.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  size_t num_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64 hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64 misses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FRAME_CONVERSION_CACHE_H_
@@ -163,15 +163,17 @@ StatusOr<ImageTensorSpecs> BuildInputImageTensorSpecs(
         "Only 4D tensors in BHWD layout are supported.",
         TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
   }
-  static constexpr TfLiteType valid_types[] = {kTfLiteUInt8, kTfLiteFloat32};
+  static constexpr TfLiteType valid_types[] = {kTfLiteUInt8, kTfLiteInt8,
+                                               kTfLiteFloat16, kTfLiteFloat32};
   TfLiteType input_type = input_tensor->type;
   if (!absl::c_linear_search(valid_types, input_type)) {
     return CreateStatusWithPayload(
         StatusCode::kInvalidArgument,
-        absl::StrCat(
-            "Type mismatch for input tensor ", input_tensor->name,
-            ". Requested one of these types: kTfLiteUint8/kTfLiteFloat32, got ",
-            TfLiteTypeGetName(input_type), "."),
+        absl::StrCat("Type mismatch for input tensor ", input_tensor->name,
+                     ". Requested one of these types: "
+                     "kTfLiteUint8/kTfLiteInt8/kTfLiteFloat16/kTfLiteFloat32, "
+                     "got ",
+                     TfLiteTypeGetName(input_type), "."),
         TfLiteSupportStatus::kInvalidInputTensorTypeError);
   }
 
@@ -196,18 +198,28 @@ StatusOr<ImageTensorSpecs> BuildInputImageTensorSpecs(
         TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
   }
   int bytes_size = input_tensor->bytes;
-  size_t byte_depth =
-      input_type == kTfLiteFloat32 ? sizeof(float) : sizeof(uint8);
+  size_t byte_depth;
+  switch (input_type) {
+    case kTfLiteFloat32:
+      byte_depth = sizeof(float);
+      break;
+    case kTfLiteFloat16:
+      byte_depth = sizeof(TfLiteFloat16);
+      break;
+    default:
+      byte_depth = sizeof(uint8);
+  }
 
   // Sanity checks.
-  if (input_type == kTfLiteFloat32) {
+  if (input_type == kTfLiteFloat32 || input_type == kTfLiteFloat16) {
     if (!normalization_options.has_value()) {
       return CreateStatusWithPayload(
           absl::StatusCode::kNotFound,
-          "Input tensor has type kTfLiteFloat32: it requires specifying "
-          "NormalizationOptions metadata to preprocess input images.",
+          absl::StrCat("Input tensor has type ", TfLiteTypeGetName(input_type),
+                       ": it requires specifying NormalizationOptions "
+                       "metadata to preprocess input images."),
           TfLiteSupportStatus::kMetadataMissingNormalizationOptionsError);
-    } else if (bytes_size / sizeof(float) %
+    } else if (bytes_size / byte_depth %
                    normalization_options.value().num_values !=
                0) {
       return CreateStatusWithPayload(
@@ -217,6 +229,15 @@ StatusOr<ImageTensorSpecs> BuildInputImageTensorSpecs(
           TfLiteSupportStatus::kInvalidArgumentError);
     }
   }
+  if (input_type == kTfLiteInt8 && input_tensor->params.scale <= 0) {
+    // The pixel values (normalized with the NormalizationOptions, if any) are
+    // quantized with the tensor quantization parameters.
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Input tensor has type kTfLiteInt8: it requires quantization "
+        "parameters with a positive scale.",
+        TfLiteSupportStatus::kInvalidInputTensorTypeError);
+  }
   if (width <= 0) {
     return CreateStatusWithPayload(
         StatusCode::kInvalidArgument, "The input width should be positive.",
@@ -66,10 +66,12 @@ struct ImageTensorSpecs {
   // floats (see NormalizationOptions in TF Lite Metadata for more details).
   TfLiteType tensor_type;
   // Optional normalization parameters read from TF Lite Metadata. Those are
-  // mandatory when tensor_type=kTfLiteFloat32 in order to convert the input
-  // image data into the expected range of floating point values, an error is
-  // returned otherwise (see sanity checks below). They should be ignored for
-  // other tensor input types, e.g. kTfLiteUInt8.
+  // mandatory when tensor_type=kTfLiteFloat32 or kTfLiteFloat16 in order to
+  // convert the input image data into the expected range of floating point
+  // values, an error is returned otherwise (see sanity checks below). When
+  // tensor_type=kTfLiteInt8, they are optional and applied before quantizing
+  // with the tensor quantization parameters. They should be ignored for
+  // kTfLiteUInt8.
   absl::optional<NormalizationOptions> normalization_options;
 };
 
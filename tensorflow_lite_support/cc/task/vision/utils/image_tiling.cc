@@ -0,0 +1,285 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::TfLiteSupportStatus;
+
+// Returns the positions of the tiles along an axis of `frame_size` pixels.
+std::vector<int> ComputeTilePositions(int frame_size, int tile_size,
+                                      float min_overlap_ratio) {
+  if (frame_size <= tile_size) {
+    return {0};
+  }
+  // Rounded down, so that the stride is always positive.
+  const int min_overlap = static_cast<int>(min_overlap_ratio * tile_size);
+  // Smallest number of tiles such that consecutive tiles overlap by at least
+  // `min_overlap`, i.e. (num_tiles - 1) * (tile_size - min_overlap) +
+  // tile_size >= frame_size.
+  const int stride = tile_size - min_overlap;
+  const int num_tiles = (frame_size - min_overlap + stride - 1) / stride;
+  std::vector<int> positions(num_tiles);
+  const int range = frame_size - tile_size;
+  for (int i = 0; i < num_tiles; ++i) {
+    positions[i] = (2 * i * range + num_tiles - 1) / (2 * (num_tiles - 1));
+  }
+  return positions;
+}
+
+// Returns the area of the intersection of `a` and `b` divided by the area of
+// the smallest of the two.
+float IntersectionOverMinArea(const BoundingBox& a, const BoundingBox& b) {
+  const int64_t intersection_width =
+      std::min(a.origin_x() + a.width(), b.origin_x() + b.width()) -
+      std::max(a.origin_x(), b.origin_x());
+  const int64_t intersection_height =
+      std::min(a.origin_y() + a.height(), b.origin_y() + b.height()) -
+      std::max(a.origin_y(), b.origin_y());
+  if (intersection_width <= 0 || intersection_height <= 0) {
+    return 0;
+  }
+  const int64_t min_area =
+      std::min(static_cast<int64_t>(a.width()) * a.height(),
+               static_cast<int64_t>(b.width()) * b.height());
+  return static_cast<float>(intersection_width * intersection_height) /
+         min_area;
+}
+
+}  // namespace
+
+absl::Status SanityCheckTilingOptions(const TilingOptions& options) {
+  if (options.tile_width() < 0 || options.tile_height() < 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid tile size %dx%d: values must be >= 0.",
+                        options.tile_width(), options.tile_height()),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (options.min_overlap_ratio() < 0 || options.min_overlap_ratio() >= 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid `min_overlap_ratio` %f: value must be in "
+                        "[0, 1).",
+                        options.min_overlap_ratio()),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+FrameBuffer::Dimension GetTileDimension(
+    const TilingOptions& options, const FrameBuffer& frame_buffer,
+    FrameBuffer::Dimension model_input_dimension) {
+  const bool require_swap = RequireDimensionSwap(
+      frame_buffer.orientation(), FrameBuffer::Orientation::kTopLeft);
+  // The dimensions of the upright input frame.
+  FrameBuffer::Dimension frame_dimension = frame_buffer.dimension();
+  if (require_swap) {
+    frame_dimension.Swap();
+  }
+  FrameBuffer::Dimension tile_dimension = {options.tile_width(),
+                                           options.tile_height()};
+  if (tile_dimension.width == 0) {
+    tile_dimension.width = model_input_dimension.width > 0
+                               ? model_input_dimension.width
+                               : frame_dimension.width;
+  }
+  if (tile_dimension.height == 0) {
+    tile_dimension.height = model_input_dimension.height > 0
+                                ? model_input_dimension.height
+                                : frame_dimension.height;
+  }
+  if (require_swap) {
+    tile_dimension.Swap();
+  }
+  return tile_dimension;
+}
+
+int GetNumTileWorkers(const TilingOptions& options) {
+  return GetNumTileWorkers(options.num_workers());
+}
+
+int GetNumTileWorkers(int num_workers) {
+  if (num_workers <= 0) {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+  return num_workers;
+}
+
+TileWorkerPool::~TileWorkerPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+    cond_var_.SignalAll();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TileWorkerPool::Start(int num_workers) {
+  threads_.reserve(num_workers - 1);
+  for (int i = 1; i < num_workers; ++i) {
+    threads_.emplace_back(&TileWorkerPool::RunWorker, this, i);
+  }
+}
+
+absl::Status TileWorkerPool::ProcessTiles(
+    int num_tiles,
+    const std::function<absl::Status(int worker_index, int tile_index)>&
+        process_tile) {
+  if (threads_.empty() || num_tiles <= 1) {
+    for (int i = 0; i < num_tiles; ++i) {
+      absl::Status status = process_tile(/*worker_index=*/0, i);
+      if (!status.ok()) return status;
+    }
+    return absl::OkStatus();
+  }
+
+  {
+    absl::MutexLock lock(&mutex_);
+    process_tile_ = &process_tile;
+    num_tiles_ = num_tiles;
+    next_tile_ = 0;
+    status_ = absl::OkStatus();
+    num_busy_threads_ = static_cast<int>(threads_.size());
+    ++generation_;
+    cond_var_.SignalAll();
+  }
+  // The calling thread acts as the first worker.
+  ProcessPendingTiles(/*worker_index=*/0);
+
+  absl::MutexLock lock(&mutex_);
+  while (num_busy_threads_ > 0) {
+    cond_var_.Wait(&mutex_);
+  }
+  process_tile_ = nullptr;
+  return status_;
+}
+
+void TileWorkerPool::RunWorker(int worker_index) {
+  int64_t last_generation = 0;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      while (!stopping_ && generation_ == last_generation) {
+        cond_var_.Wait(&mutex_);
+      }
+      if (stopping_) return;
+      last_generation = generation_;
+    }
+    // Workers past the number of tiles stay idle, as with one thread per tile.
+    if (worker_index < num_tiles_) {
+      ProcessPendingTiles(worker_index);
+    }
+    absl::MutexLock lock(&mutex_);
+    if (--num_busy_threads_ == 0) {
+      cond_var_.SignalAll();
+    }
+  }
+}
+
+void TileWorkerPool::ProcessPendingTiles(int worker_index) {
+  // Each worker pulls tiles from the shared counter until there are none left.
+  for (int i = next_tile_++; i < num_tiles_; i = next_tile_++) {
+    absl::Status tile_status = (*process_tile_)(worker_index, i);
+    if (!tile_status.ok()) {
+      absl::MutexLock lock(&mutex_);
+      if (status_.ok()) status_ = tile_status;
+      // Make the other workers stop early.
+      next_tile_ = num_tiles_;
+      return;
+    }
+  }
+}
+
+void MergeOverlappingDetections(const DetectionResult& results,
+                                float overlap_threshold, int max_results,
+                                DetectionResult* merged_results) {
+  std::vector<const Detection*> sorted_detections;
+  sorted_detections.reserve(results.detections_size());
+  for (const Detection& detection : results.detections()) {
+    sorted_detections.push_back(&detection);
+  }
+  std::stable_sort(sorted_detections.begin(), sorted_detections.end(),
+                   [](const Detection* a, const Detection* b) {
+                     return a->classes(0).score() > b->classes(0).score();
+                   });
+
+  merged_results->Clear();
+  for (const Detection* detection : sorted_detections) {
+    if (max_results > 0 && merged_results->detections_size() >= max_results) {
+      break;
+    }
+    bool is_duplicate = false;
+    for (const Detection& kept : merged_results->detections()) {
+      if (kept.classes(0).index() == detection->classes(0).index() &&
+          IntersectionOverMinArea(kept.bounding_box(),
+                                  detection->bounding_box()) >
+              overlap_threshold) {
+        is_duplicate = true;
+        break;
+      }
+    }
+    if (!is_duplicate) {
+      *merged_results->add_detections() = *detection;
+    }
+  }
+}
+
+std::vector<BoundingBox> ComputeTiles(FrameBuffer::Dimension frame_dimension,
+                                      FrameBuffer::Dimension tile_dimension,
+                                      float min_overlap_ratio) {
+  const int tile_width = std::min(tile_dimension.width, frame_dimension.width);
+  const int tile_height =
+      std::min(tile_dimension.height, frame_dimension.height);
+  const std::vector<int> xs = ComputeTilePositions(
+      frame_dimension.width, tile_dimension.width, min_overlap_ratio);
+  const std::vector<int> ys = ComputeTilePositions(
+      frame_dimension.height, tile_dimension.height, min_overlap_ratio);
+  std::vector<BoundingBox> tiles;
+  tiles.reserve(xs.size() * ys.size());
+  for (int y : ys) {
+    for (int x : xs) {
+      BoundingBox tile;
+      tile.set_origin_x(x);
+      tile.set_origin_y(y);
+      tile.set_width(tile_width);
+      tile.set_height(tile_height);
+      tiles.push_back(tile);
+    }
+  }
+  return tiles;
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
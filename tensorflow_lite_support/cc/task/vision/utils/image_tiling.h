@@ -0,0 +1,153 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_TILING_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_TILING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/tiling_options_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Performs sanity checks on the provided TilingOptions.
+absl::Status SanityCheckTilingOptions(const TilingOptions& options);
+
+// Returns the dimension of the tiles to split `frame_buffer` into, expressed
+// in its unrotated coordinates system like the region of interest passed to
+// the vision tasks. Unset tile sizes default to `model_input_dimension`, which
+// is the dimension of the (upright) input tensor of the model, or to the frame
+// size for models accepting inputs of any size.
+FrameBuffer::Dimension GetTileDimension(
+    const TilingOptions& options, const FrameBuffer& frame_buffer,
+    FrameBuffer::Dimension model_input_dimension);
+
+// Splits a frame of dimension `frame_dimension` into a grid of tiles of
+// dimension `tile_dimension` covering it entirely, with adjacent tiles
+// overlapping by at least `min_overlap_ratio` times the tile size along each
+// axis. Tiles are
+// spread evenly, the first and last ones of each row and column touching the
+// borders of the frame. Along an axis where the frame is no larger than a tile,
+// a single tile spanning the whole frame is used instead.
+//
+// Tiles are returned in row-major order. `tile_dimension` must be positive and
+// `min_overlap_ratio` must be in [0, 1).
+std::vector<BoundingBox> ComputeTiles(FrameBuffer::Dimension frame_dimension,
+                                      FrameBuffer::Dimension tile_dimension,
+                                      float min_overlap_ratio);
+
+// Returns the number of interpreters to spread the tiles over, as configured
+// by `num_workers`.
+int GetNumTileWorkers(const TilingOptions& options);
+
+// Same as above, for any `num_workers` value with the same semantics, e.g.
+// `ImageClassifierOptions.num_roi_workers`.
+int GetNumTileWorkers(int num_workers);
+
+// Spreads the tiles of a frame over worker threads which, unlike threads
+// started for each frame, are created once and reused across frames.
+//
+// Not thread-safe: ProcessTiles() must not be called concurrently.
+class TileWorkerPool {
+ public:
+  TileWorkerPool() = default;
+  // Stops and joins the worker threads.
+  ~TileWorkerPool();
+
+  TileWorkerPool(const TileWorkerPool&) = delete;
+  TileWorkerPool& operator=(const TileWorkerPool&) = delete;
+
+  // Starts `num_workers - 1` worker threads, the calling thread of
+  // ProcessTiles() being worker 0. Must be called at most once. Without it,
+  // all tiles are processed by the calling thread.
+  void Start(int num_workers);
+
+  // Returns the number of workers, including the calling thread.
+  int num_workers() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Calls `process_tile(worker_index, tile_index)` for each tile index in
+  // [0, `num_tiles`), spreading the tiles over the first `num_tiles` workers.
+  // Each worker processes one tile at a time, so that `worker_index` can be
+  // used to pick the interpreter to run the tile on. Returns once all tiles
+  // are processed.
+  //
+  // Returns the first error returned by `process_tile`, if any, in which case
+  // the tiles that were not started yet are skipped.
+  absl::Status ProcessTiles(
+      int num_tiles,
+      const std::function<absl::Status(int worker_index, int tile_index)>&
+          process_tile);
+
+ private:
+  // Main loop of the worker threads, waiting for the tiles of each frame.
+  void RunWorker(int worker_index);
+  // Processes the tiles of the current frame until there are none left.
+  void ProcessPendingTiles(int worker_index);
+
+  std::vector<std::thread> threads_;
+
+  absl::Mutex mutex_;
+  absl::CondVar cond_var_;
+  // Incremented by ProcessTiles() to hand a new frame to the workers.
+  int64_t generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of worker threads which haven't finished the current frame yet.
+  int num_busy_threads_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  // First error of the current frame.
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+
+  // The current frame. Written by ProcessTiles() before `generation_` is
+  // incremented, and only read by the workers afterwards.
+  const std::function<absl::Status(int, int)>* process_tile_ = nullptr;
+  int num_tiles_ = 0;
+  std::atomic<int> next_tile_{0};
+};
+
+// Merges the detections of the same class found in several tiles into
+// `merged_results`: detections are visited by decreasing score, and dropped if
+// their intersection with an already kept detection covers more than
+// `overlap_threshold` of the area of the smallest of the two boxes, so that an
+// object cut by a tile border is merged with its whole detection from another
+// tile. At most `max_results` detections are kept if it is positive.
+void MergeOverlappingDetections(const DetectionResult& results,
+                                float overlap_threshold, int max_results,
+                                DetectionResult* merged_results);
+
+// Returns the weight of the pixel at `position` in a tile of `size` pixels when
+// blending overlapping tiles: it increases linearly from the borders to the
+// center of the tile, so that each tile prevails where its predictions are the
+// most reliable, i.e. away from its borders.
+inline float GetTileBlendingWeight(int position, int size) {
+  const int distance_to_border =
+      position < size - 1 - position ? position : size - 1 - position;
+  return static_cast<float>(distance_to_border + 1);
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_TILING_H_
@@ -0,0 +1,131 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/pixel_lookup_tables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+namespace {
+
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+
+// Sets the per-channel inverse standard deviations and means of
+// `normalization_options`, or of the identity normalization if absent.
+absl::Status GetNormalizationValues(
+    const absl::optional<NormalizationOptions>& normalization_options,
+    std::array<float, 3>* inv_std_values, std::array<float, 3>* mean_values) {
+  for (int c = 0; c < 3; ++c) {
+    (*inv_std_values)[c] = 1.0f;
+    (*mean_values)[c] = 0.0f;
+    if (!normalization_options.has_value()) {
+      continue;
+    }
+    const int i = normalization_options->num_values == 1 ? 0 : c;
+    const float std_value = normalization_options->std_values[i];
+    if (std::abs(std_value) < std::numeric_limits<float>::epsilon()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInternal,
+          "NormalizationOptions.std_values can't be 0. Please check if the "
+          "tensor metadata has been populated correctly.");
+    }
+    (*inv_std_values)[c] = 1.0f / std_value;
+    (*mean_values)[c] = normalization_options->mean_values[i];
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+TfLiteFloat16 FloatToHalf(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  bits &= 0x7fffffff;
+  uint16_t half;
+  if (bits > 0x7f800000) {
+    // NaN.
+    half = 0x7e00;
+  } else if (bits >= 0x477ff000) {
+    // Infinity, or too large: rounds to infinity.
+    half = 0x7c00;
+  } else if (bits < 0x38800000) {
+    // Below the smallest normal half (2^-14): subnormal or zero, in units of
+    // 2^-24.
+    float magnitude;
+    std::memcpy(&magnitude, &bits, sizeof(magnitude));
+    half = static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f));
+  } else {
+    // Rebias the exponent from 127 to 15, and round the mantissa from 23 to 10
+    // bits.
+    const uint32_t rebiased = bits - 0x38000000;
+    half = static_cast<uint16_t>(
+        (rebiased + 0x0fff + ((rebiased >> 13) & 1)) >> 13);
+  }
+  return {static_cast<uint16_t>(sign | half)};
+}
+
+StatusOr<PixelLookupTables<int8>> BuildInt8LookupTables(
+    const absl::optional<NormalizationOptions>& normalization_options,
+    float scale, int zero_point) {
+  std::array<float, 3> inv_std_values;
+  std::array<float, 3> mean_values;
+  RETURN_IF_ERROR(GetNormalizationValues(normalization_options,
+                                         &inv_std_values, &mean_values));
+  PixelLookupTables<int8> lookup_tables;
+  for (int c = 0; c < 3; ++c) {
+    for (int pixel = 0; pixel < 256; ++pixel) {
+      const float normalized_value =
+          inv_std_values[c] * (static_cast<float>(pixel) - mean_values[c]);
+      const float quantized_value =
+          std::round(normalized_value / scale) + zero_point;
+      lookup_tables[c][pixel] = static_cast<int8>(
+          std::min(std::max(quantized_value, -128.0f), 127.0f));
+    }
+  }
+  return lookup_tables;
+}
+
+StatusOr<PixelLookupTables<TfLiteFloat16>> BuildFloat16LookupTables(
+    const NormalizationOptions& normalization_options) {
+  std::array<float, 3> inv_std_values;
+  std::array<float, 3> mean_values;
+  RETURN_IF_ERROR(GetNormalizationValues(normalization_options,
+                                         &inv_std_values, &mean_values));
+  PixelLookupTables<TfLiteFloat16> lookup_tables;
+  for (int c = 0; c < 3; ++c) {
+    for (int pixel = 0; pixel < 256; ++pixel) {
+      lookup_tables[c][pixel] = FloatToHalf(
+          inv_std_values[c] * (static_cast<float>(pixel) - mean_values[c]));
+    }
+  }
+  return lookup_tables;
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,76 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PIXEL_LOOKUP_TABLES_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PIXEL_LOOKUP_TABLES_H_
+
+#include <array>
+
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow_lite_support/cc/port/integral_types.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Per-channel lookup tables, mapping each value of the R, G and B channels of
+// 8-bit RGB pixels to the corresponding input tensor value.
+template <typename T>
+using PixelLookupTables = std::array<std::array<T, 256>, 3>;
+
+// Converts `value` to IEEE 754 half precision, rounding to nearest even.
+// Values too large to be represented are converted to infinity, and values too
+// small to subnormal values or zero.
+TfLiteFloat16 FloatToHalf(float value);
+
+// Builds the lookup tables of int8 input tensors: pixel values are normalized
+// with `normalization_options`, if any, then quantized with `scale` and
+// `zero_point` and clamped to [-128, 127].
+tflite::support::StatusOr<PixelLookupTables<int8>> BuildInt8LookupTables(
+    const absl::optional<NormalizationOptions>& normalization_options,
+    float scale, int zero_point);
+
+// Builds the lookup tables of float16 input tensors: pixel values are
+// normalized with `normalization_options`, then converted to half precision.
+tflite::support::StatusOr<PixelLookupTables<TfLiteFloat16>>
+BuildFloat16LookupTables(const NormalizationOptions& normalization_options);
+
+// Populates `output` with the RGB pixels of `num_rows` rows of `row_pixels`
+// pixels, `input_row_stride_bytes` apart in `input_data`, mapped through the
+// lookup table of their channel. Padding bytes at the end of the input rows are
+// skipped.
+template <typename T>
+void PopulateFromLookupTables(const uint8* input_data, int num_rows,
+                              int row_pixels, int input_row_stride_bytes,
+                              const PixelLookupTables<T>& lookup_tables,
+                              T* output) {
+  for (int row = 0; row < num_rows; ++row) {
+    const uint8* pixel = input_data + row * input_row_stride_bytes;
+    for (int x = 0; x < row_pixels; ++x, pixel += 3, output += 3) {
+      output[0] = lookup_tables[0][pixel[0]];
+      output[1] = lookup_tables[1][pixel[1]];
+      output[2] = lookup_tables[2][pixel[2]];
+    }
+  }
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PIXEL_LOOKUP_TABLES_H_
@@ -0,0 +1,103 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/audio_classifier.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/proto2.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_classifier_options.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/class_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/test/message_matchers.h"
+#include "tensorflow_lite_support/cc/test/task/audio/audio_test_model.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::tflite::support::EqualsProto;
+
+// The test model scores each of its 4 input samples as a class, with a score
+// equal to twice the sample.
+constexpr int kSampleRate = 4;
+constexpr int kNumClasses = 4;
+
+class ClassifyIntoTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    AudioClassifierOptions options;
+    options.mutable_base_options()->mutable_model_file()->set_file_content(
+        BuildAudioModel(kSampleRate, kNumClasses));
+    options.set_max_results(2);
+    SUPPORT_ASSERT_OK_AND_ASSIGN(classifier_,
+                                 AudioClassifier::CreateFromOptions(options));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        audio_buffer_,
+        AudioBuffer::Create(samples_.data(), samples_.size(),
+                            {/*channels=*/1, kSampleRate}));
+  }
+
+  const std::vector<float> samples_ = {0.1f, 0.4f, -0.2f, 0.3f};
+  std::unique_ptr<AudioClassifier> classifier_;
+  std::unique_ptr<AudioBuffer> audio_buffer_;
+};
+
+TEST_F(ClassifyIntoTest, RecyclesResult) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const ClassificationResult expected,
+                               classifier_->Classify(*audio_buffer_));
+  ASSERT_EQ(expected.classifications_size(), 1);
+  ASSERT_EQ(expected.classifications(0).classes_size(), 2);
+  EXPECT_EQ(expected.classifications(0).classes(0).index(), 1);
+
+  // Stale results are cleared.
+  ClassificationResult result;
+  auto* stale_class = result.add_classifications()->add_classes();
+  stale_class->set_index(3);
+  stale_class->set_display_name("stale");
+  result.add_classifications()->set_head_index(4);
+  SUPPORT_ASSERT_OK(classifier_->ClassifyInto(*audio_buffer_, &result));
+  EXPECT_THAT(result, EqualsProto(expected));
+  const Class* first_class = &result.classifications(0).classes(0);
+  SUPPORT_ASSERT_OK(classifier_->ClassifyInto(*audio_buffer_, &result));
+  EXPECT_THAT(result, EqualsProto(expected));
+  EXPECT_EQ(&result.classifications(0).classes(0), first_class);
+}
+
+TEST_F(ClassifyIntoTest, SucceedsWithArenaResult) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const ClassificationResult expected,
+                               classifier_->Classify(*audio_buffer_));
+
+  tflite::support::proto::Arena arena;
+  ClassificationResult* result =
+      tflite::support::proto::Arena::CreateMessage<ClassificationResult>(
+          &arena);
+  SUPPORT_ASSERT_OK(classifier_->ClassifyInto(*audio_buffer_, result));
+
+  EXPECT_THAT(*result, EqualsProto(expected));
+  EXPECT_EQ(result->classifications(0).classes(0).GetArena(), &arena);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
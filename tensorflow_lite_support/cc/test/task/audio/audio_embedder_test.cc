@@ -0,0 +1,99 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/audio_embedder.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/proto2.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_embedder_options.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
+#include "tensorflow_lite_support/cc/test/message_matchers.h"
+#include "tensorflow_lite_support/cc/test/task/audio/audio_test_model.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+using ::tflite::support::EqualsProto;
+using ::tflite::task::processor::Embedding;
+using ::tflite::task::processor::EmbeddingResult;
+
+// The test model outputs an embedding equal to twice its 4 input samples.
+constexpr int kSampleRate = 4;
+constexpr int kEmbeddingDimension = 4;
+
+class EmbedIntoTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    AudioEmbedderOptions options;
+    options.mutable_base_options()->mutable_model_file()->set_file_content(
+        BuildAudioModel(kSampleRate, kEmbeddingDimension));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(embedder_,
+                                 AudioEmbedder::CreateFromOptions(options));
+  }
+
+  std::unique_ptr<AudioBuffer> CreateAudioBuffer(
+      const std::vector<float>& samples) {
+    auto audio_buffer = AudioBuffer::Create(samples.data(), samples.size(),
+                                            {/*channels=*/1, kSampleRate});
+    EXPECT_TRUE(audio_buffer.ok());
+    return std::move(audio_buffer).value();
+  }
+
+  std::unique_ptr<AudioEmbedder> embedder_;
+};
+
+TEST_F(EmbedIntoTest, RecyclesArenaResult) {
+  const std::vector<float> first_samples = {0.1f, 0.4f, -0.2f, 0.3f};
+  const std::vector<float> second_samples = {-0.5f, 0.0f, 0.25f, 0.125f};
+  std::unique_ptr<AudioBuffer> first_buffer = CreateAudioBuffer(first_samples);
+  std::unique_ptr<AudioBuffer> second_buffer =
+      CreateAudioBuffer(second_samples);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const EmbeddingResult first_expected,
+                               embedder_->Embed(*first_buffer));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const EmbeddingResult second_expected,
+                               embedder_->Embed(*second_buffer));
+  ASSERT_EQ(first_expected.embeddings_size(), 1);
+  EXPECT_THAT(first_expected.embeddings(0).feature_vector().value_float(),
+              ElementsAre(FloatEq(0.2f), FloatEq(0.8f), FloatEq(-0.4f),
+                          FloatEq(0.6f)));
+
+  tflite::support::proto::Arena arena;
+  EmbeddingResult* result =
+      tflite::support::proto::Arena::CreateMessage<EmbeddingResult>(&arena);
+  SUPPORT_ASSERT_OK(embedder_->EmbedInto(*first_buffer, result));
+  EXPECT_THAT(*result, EqualsProto(first_expected));
+  ASSERT_EQ(result->embeddings_size(), 1);
+  EXPECT_EQ(result->embeddings(0).GetArena(), &arena);
+  const Embedding* embedding = &result->embeddings(0);
+  SUPPORT_ASSERT_OK(embedder_->EmbedInto(*second_buffer, result));
+  EXPECT_THAT(*result, EqualsProto(second_expected));
+  EXPECT_EQ(&result->embeddings(0), embedding);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,253 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/audio_file_classifier.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/mutable_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/test/message_matchers.h"
+#include "tensorflow_lite_support/cc/test/task/audio/audio_test_model.h"
+#include "tensorflow_lite_support/cc/test/task/audio/wav_test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::tflite::support::EqualsProto;
+
+// The test model takes windows of 4 mono frames at 4 Hz, i.e. 1 second, and
+// outputs one score per frame, equal to twice the frame value: for class `i`,
+// the score of a window is 2 * sample[i] / 32768.
+constexpr int kSampleRate = 4;
+constexpr int kWindowFrames = 4;
+
+// Returns the int16 sample giving a score of `score` to its class.
+int16_t SampleForScore(float score) {
+  return static_cast<int16_t>(score * 32768 / 2);
+}
+
+// Kernel standing for ADD in StopsWorkersOnError: it doubles its input like the
+// builtin op, but slowly, and fails on windows starting with -32768.
+namespace failing_add {
+
+std::atomic<int> num_invocations(0);
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteTensor* input = GetInput(context, node, 0);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* output = GetOutput(context, node, 0);
+  TF_LITE_ENSURE(context, output != nullptr);
+  return context->ResizeTensor(context, output,
+                               TfLiteIntArrayCopy(input->dims));
+}
+
+TfLiteStatus Invoke(TfLiteContext* context, TfLiteNode* node) {
+  ++num_invocations;
+  const TfLiteTensor* input = GetInput(context, node, 0);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* output = GetOutput(context, node, 0);
+  TF_LITE_ENSURE(context, output != nullptr);
+  if (input->data.f[0] == -1.0f) {
+    TF_LITE_KERNEL_LOG(context, "Poisoned window.");
+    return kTfLiteError;
+  }
+  // Leaves the failing worker ample time to stop the others.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  for (int i = 0; i < NumElements(input); ++i) {
+    output->data.f[i] = 2 * input->data.f[i];
+  }
+  return kTfLiteOk;
+}
+
+TfLiteRegistration* Register() {
+  static TfLiteRegistration r = {
+      .init = nullptr, .free = nullptr, .prepare = Prepare, .invoke = Invoke};
+  return &r;
+}
+
+}  // namespace failing_add
+
+class AudioFileClassifierTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    model_buffer_ = BuildAudioModel(kSampleRate, kWindowFrames);
+  }
+
+  AudioFileClassifierOptions GetOptions(int num_workers) {
+    AudioFileClassifierOptions options;
+    options.mutable_classifier_options()
+        ->mutable_base_options()
+        ->mutable_model_file()
+        ->set_file_content(model_buffer_);
+    options.set_window_hop_seconds(1);
+    options.set_num_workers(num_workers);
+    return options;
+  }
+
+  std::string model_buffer_;
+};
+
+TEST_F(AudioFileClassifierTest, FailsWithMissingClassifierOptions) {
+  AudioFileClassifierOptions options;
+
+  EXPECT_EQ(AudioFileClassifier::CreateFromOptions(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(AudioFileClassifierTest, FailsWithMissingBaseOptions) {
+  AudioFileClassifierOptions options;
+  options.mutable_classifier_options()->set_max_results(1);
+
+  EXPECT_EQ(AudioFileClassifier::CreateFromOptions(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(AudioFileClassifierTest, FailsWithInvalidClassifierOptions) {
+  AudioFileClassifierOptions options = GetOptions(/*num_workers=*/2);
+  options.mutable_classifier_options()->set_max_results(0);
+
+  EXPECT_EQ(AudioFileClassifier::CreateFromOptions(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(AudioFileClassifierTest, FailsWithMismatchedAudioFormat) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioFileClassifier> classifier,
+      AudioFileClassifier::CreateFromOptions(GetOptions(/*num_workers=*/1)));
+  const std::string path = WriteTempFile(
+      "mismatched.wav", BuildLin16Wav(std::vector<int16_t>(16),
+                                      /*channels=*/1, /*sample_rate=*/8));
+
+  EXPECT_EQ(classifier->ClassifyFile(path).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(AudioFileClassifierTest, CallsOpResolverFactoryOncePerWorker) {
+  int num_calls = 0;
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioFileClassifier> classifier,
+      AudioFileClassifier::CreateFromOptions(
+          GetOptions(/*num_workers=*/3), [&num_calls]() {
+            ++num_calls;
+            return absl::make_unique<
+                tflite_shims::ops::builtin::BuiltinOpResolver>();
+          }));
+
+  EXPECT_EQ(classifier->GetNumWorkers(), 3);
+  EXPECT_EQ(num_calls, 3);
+}
+
+TEST_F(AudioFileClassifierTest, ClassifiesWindowsAndBuildsSegments) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioFileClassifier> classifier,
+      AudioFileClassifier::CreateFromOptions(GetOptions(/*num_workers=*/2)));
+  const int16_t high = SampleForScore(0.75f);
+  // 2.5 seconds of class 1: the last window is zero-padded.
+  const std::string path = WriteTempFile(
+      "segments.wav",
+      BuildLin16Wav({0, high, 0, 0, 0, high, 0, 0, 0, high}, /*channels=*/1,
+                    kSampleRate));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const AudioFileClassificationResult result,
+                               classifier->ClassifyFile(path));
+
+  EXPECT_DOUBLE_EQ(result.audio_duration_seconds(), 2.5);
+  ASSERT_EQ(result.windows_size(), 3);
+  for (int i = 0; i < result.windows_size(); ++i) {
+    EXPECT_DOUBLE_EQ(result.windows(i).start_seconds(), i);
+    EXPECT_DOUBLE_EQ(result.windows(i).end_seconds(), i + 1);
+    ASSERT_EQ(result.windows(i).classification_result().classifications_size(),
+              1);
+  }
+  EXPECT_EQ(
+      result.windows(0).classification_result().classifications(0).classes(0)
+          .index(),
+      1);
+  ASSERT_EQ(result.segments_size(), 1);
+  EXPECT_EQ(result.segments(0).index(), 1);
+  EXPECT_DOUBLE_EQ(result.segments(0).start_seconds(), 0);
+  EXPECT_DOUBLE_EQ(result.segments(0).end_seconds(), 2.5);
+  EXPECT_NEAR(result.segments(0).max_score(), 0.75f, 1e-4);
+}
+
+TEST_F(AudioFileClassifierTest, SeveralWorkersMatchOneWorker) {
+  // 200 windows with varying top classes, so that segments start and end all
+  // along the file.
+  std::vector<int16_t> samples(200 * kWindowFrames);
+  for (int i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<int16_t>((i * 7919 + (i / 12) * 104729) % 32768);
+  }
+  const std::string path = WriteTempFile(
+      "workers.wav", BuildLin16Wav(samples, /*channels=*/1, kSampleRate));
+  AudioFileClassificationResult results[2];
+  for (int i : {0, 1}) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<AudioFileClassifier> classifier,
+        AudioFileClassifier::CreateFromOptions(
+            GetOptions(/*num_workers=*/i == 0 ? 1 : 4)));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(results[i], classifier->ClassifyFile(path));
+    // Timings differ from run to run.
+    results[i].clear_wall_time_seconds();
+    results[i].clear_throughput();
+  }
+
+  EXPECT_GT(results[0].segments_size(), 1);
+  EXPECT_THAT(results[1], EqualsProto(results[0]));
+}
+
+TEST_F(AudioFileClassifierTest, StopsWorkersOnError) {
+  constexpr int kNumWindows = 1000;
+  std::vector<int16_t> samples(kNumWindows * kWindowFrames);
+  // Poisons the second window.
+  samples[kWindowFrames] = -32768;
+  const std::string path = WriteTempFile(
+      "poisoned.wav", BuildLin16Wav(samples, /*channels=*/1, kSampleRate));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioFileClassifier> classifier,
+      AudioFileClassifier::CreateFromOptions(
+          GetOptions(/*num_workers=*/4), []() {
+            auto resolver = absl::make_unique<::tflite::MutableOpResolver>();
+            resolver->AddBuiltin(::tflite::BuiltinOperator_ADD,
+                                 failing_add::Register());
+            return resolver;
+          }));
+  failing_add::num_invocations = 0;
+
+  EXPECT_FALSE(classifier->ClassifyFile(path).ok());
+  // Without early stopping, all the windows would be classified, which takes
+  // about kNumWindows / 4 milliseconds.
+  EXPECT_LT(failing_add::num_invocations.load(), kNumWindows / 2);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,185 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/utils/audio_segments.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+constexpr float kThreshold = 0.5f;
+
+// Appends a window spanning [`start_seconds`, `end_seconds`) to `result`, with
+// one head per entry of `heads`, each listing (class index, score) pairs.
+void AddWindow(double start_seconds, double end_seconds,
+               const std::vector<std::vector<std::pair<int, float>>>& heads,
+               AudioFileClassificationResult* result) {
+  WindowClassification* window = result->add_windows();
+  window->set_start_seconds(start_seconds);
+  window->set_end_seconds(end_seconds);
+  for (int h = 0; h < heads.size(); ++h) {
+    auto* head = window->mutable_classification_result()->add_classifications();
+    head->set_head_index(h);
+    head->set_head_name(h == 0 ? "first" : "second");
+    for (const auto& index_and_score : heads[h]) {
+      auto* category = head->add_classes();
+      category->set_index(index_and_score.first);
+      category->set_score(index_and_score.second);
+      category->set_class_name(absl::StrCat("class", index_and_score.first));
+    }
+  }
+}
+
+void ExpectSegment(const AudioSegment& segment, int head_index, int index,
+                   double start_seconds, double end_seconds, float max_score,
+                   float mean_score) {
+  EXPECT_EQ(segment.head_index(), head_index);
+  EXPECT_EQ(segment.index(), index);
+  EXPECT_DOUBLE_EQ(segment.start_seconds(), start_seconds);
+  EXPECT_DOUBLE_EQ(segment.end_seconds(), end_seconds);
+  EXPECT_FLOAT_EQ(segment.max_score(), max_score);
+  EXPECT_FLOAT_EQ(segment.mean_score(), mean_score);
+}
+
+TEST(BuildAudioSegmentsTest, MergesConsecutiveWindows) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(3);
+  AddWindow(0, 1, {{{1, 0.6f}, {0, 0.1f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.9f}, {0, 0.1f}}}, &result);
+  AddWindow(2, 3, {{{1, 0.6f}, {0, 0.1f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 1);
+  ExpectSegment(result.segments(0), /*head_index=*/0, /*index=*/1,
+                /*start_seconds=*/0, /*end_seconds=*/3, /*max_score=*/0.9f,
+                /*mean_score=*/0.7f);
+  EXPECT_EQ(result.segments(0).head_name(), "first");
+  EXPECT_EQ(result.segments(0).class_name(), "class1");
+}
+
+TEST(BuildAudioSegmentsTest, MergesOverlappingWindows) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(2);
+  AddWindow(0, 1, {{{1, 0.6f}}}, &result);
+  AddWindow(0.5, 1.5, {{{1, 0.6f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.6f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 1);
+  ExpectSegment(result.segments(0), 0, 1, 0, 2, 0.6f, 0.6f);
+}
+
+TEST(BuildAudioSegmentsTest, SplitsOnWindowBelowThreshold) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(4);
+  AddWindow(0, 1, {{{1, 0.6f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.4f}}}, &result);
+  // Scores equal to the threshold are kept.
+  AddWindow(2, 3, {{{1, kThreshold}}}, &result);
+  AddWindow(3, 4, {{{1, 0.7f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 2);
+  ExpectSegment(result.segments(0), 0, 1, 0, 1, 0.6f, 0.6f);
+  ExpectSegment(result.segments(1), 0, 1, 2, 4, 0.7f, 0.6f);
+}
+
+TEST(BuildAudioSegmentsTest, SplitsOnMissingClass) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(3);
+  // The class is cut from the middle window, e.g. by `max_results`.
+  AddWindow(0, 1, {{{1, 0.6f}}}, &result);
+  AddWindow(1, 2, {{{2, 0.8f}}}, &result);
+  AddWindow(2, 3, {{{1, 0.6f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 3);
+  ExpectSegment(result.segments(0), 0, 1, 0, 1, 0.6f, 0.6f);
+  ExpectSegment(result.segments(1), 0, 2, 1, 2, 0.8f, 0.8f);
+  ExpectSegment(result.segments(2), 0, 1, 2, 3, 0.6f, 0.6f);
+}
+
+TEST(BuildAudioSegmentsTest, KeepsClassesAndHeadsApart) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(2);
+  AddWindow(0, 1, {{{1, 0.6f}, {2, 0.9f}}, {{1, 0.8f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.6f}, {2, 0.7f}}, {{1, 0.8f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  // Sorted by head, then by decreasing max score.
+  ASSERT_EQ(result.segments_size(), 3);
+  ExpectSegment(result.segments(0), 0, 2, 0, 2, 0.9f, 0.8f);
+  ExpectSegment(result.segments(1), 0, 1, 0, 2, 0.6f, 0.6f);
+  ExpectSegment(result.segments(2), 1, 1, 0, 2, 0.8f, 0.8f);
+  EXPECT_EQ(result.segments(2).head_name(), "second");
+}
+
+TEST(BuildAudioSegmentsTest, ClampsTailWindowToAudioDuration) {
+  AudioFileClassificationResult result;
+  // The last window is zero-padded past the end of the audio.
+  result.set_audio_duration_seconds(2.5);
+  AddWindow(0, 1, {{{1, 0.2f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.6f}}}, &result);
+  AddWindow(2, 3, {{{1, 0.6f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 1);
+  ExpectSegment(result.segments(0), 0, 1, 1, 2.5, 0.6f, 0.6f);
+}
+
+TEST(BuildAudioSegmentsTest, SortsSegmentsByStartTime) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(3);
+  // Both segments are still open after the last window, and closed in no
+  // particular order.
+  AddWindow(0, 1, {{{1, 0.6f}}}, &result);
+  AddWindow(1, 2, {{{1, 0.6f}, {2, 0.7f}}}, &result);
+  AddWindow(2, 3, {{{1, 0.6f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  ASSERT_EQ(result.segments_size(), 2);
+  ExpectSegment(result.segments(0), 0, 1, 0, 3, 0.6f, 0.6f);
+  ExpectSegment(result.segments(1), 0, 2, 1, 2, 0.7f, 0.7f);
+}
+
+TEST(BuildAudioSegmentsTest, SucceedsWithoutSegments) {
+  AudioFileClassificationResult result;
+  result.set_audio_duration_seconds(1);
+  AddWindow(0, 1, {{{1, 0.2f}}}, &result);
+
+  BuildAudioSegments(kThreshold, &result);
+
+  EXPECT_EQ(result.segments_size(), 0);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,109 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/test/task/audio/audio_test_model.h"
+
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+// Returns a metadata buffer with the AudioProperties of the input tensor, and
+// an empty TensorMetadata for the output tensor.
+std::string BuildAudioMetadata(int sample_rate) {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto audio_properties = tflite::CreateAudioProperties(
+      builder, sample_rate, /*channels=*/1);
+  const auto content = tflite::CreateContent(
+      builder, tflite::ContentProperties_AudioProperties,
+      audio_properties.Union());
+  tflite::TensorMetadataBuilder input_metadata_builder(builder);
+  input_metadata_builder.add_content(content);
+  const auto input_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{
+          input_metadata_builder.Finish()});
+  const auto output_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{
+          tflite::TensorMetadataBuilder(builder).Finish()});
+  tflite::SubGraphMetadataBuilder subgraph_metadata_builder(builder);
+  subgraph_metadata_builder.add_input_tensor_metadata(input_tensor_metadata);
+  subgraph_metadata_builder.add_output_tensor_metadata(output_tensor_metadata);
+  const auto subgraph_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::SubGraphMetadata>>{
+          subgraph_metadata_builder.Finish()});
+  tflite::ModelMetadataBuilder model_metadata_builder(builder);
+  model_metadata_builder.add_subgraph_metadata(subgraph_metadata);
+  tflite::FinishModelMetadataBuffer(builder, model_metadata_builder.Finish());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+}  // namespace
+
+std::string BuildAudioModel(int sample_rate, int window_frames) {
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  auto add_code = absl::make_unique<tflite::OperatorCodeT>();
+  add_code->builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->deprecated_builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->version = 1;
+  model.operator_codes.push_back(std::move(add_code));
+
+  auto subgraph = absl::make_unique<tflite::SubGraphT>();
+  for (const char* name : {"audio", "scores"}) {
+    auto tensor = absl::make_unique<tflite::TensorT>();
+    tensor->name = name;
+    tensor->type = tflite::TensorType_FLOAT32;
+    tensor->buffer = 0;
+    tensor->shape = {1, window_frames};
+    subgraph->tensors.push_back(std::move(tensor));
+  }
+  subgraph->inputs = {0};
+  subgraph->outputs = {1};
+  auto add = absl::make_unique<tflite::OperatorT>();
+  add->opcode_index = 0;
+  add->inputs = {0, 0};
+  add->outputs = {1};
+  add->builtin_options.Set(tflite::AddOptionsT());
+  subgraph->operators.push_back(std::move(add));
+  model.subgraphs.push_back(std::move(subgraph));
+
+  const std::string metadata = BuildAudioMetadata(sample_rate);
+  auto metadata_buffer = absl::make_unique<tflite::BufferT>();
+  metadata_buffer->data.assign(metadata.begin(), metadata.end());
+  model.buffers.push_back(std::move(metadata_buffer));
+  auto model_metadata = absl::make_unique<tflite::MetadataT>();
+  model_metadata->name = "TFLITE_METADATA";
+  model_metadata->buffer = 1;
+  model.metadata.push_back(std::move(model_metadata));
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
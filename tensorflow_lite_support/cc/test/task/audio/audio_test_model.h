@@ -0,0 +1,35 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_AUDIO_TEST_MODEL_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_AUDIO_TEST_MODEL_H_
+
+#include <string>
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+// Returns a model adding a float32 input tensor of shape [1, window_frames] to
+// itself, with metadata describing its input as mono audio at `sample_rate` Hz.
+// Its output is a [1, window_frames] tensor, which can be read either as the
+// scores of `window_frames` classes or as an embedding.
+std::string BuildAudioModel(int sample_rate, int window_frames);
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_AUDIO_TEST_MODEL_H_
@@ -0,0 +1,177 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/utils/wav_file_reader.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/test/task/audio/wav_test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+// Returns the samples held by the int16 `buffer`.
+std::vector<int16_t> GetSamples(const AudioBuffer& buffer) {
+  EXPECT_EQ(buffer.GetSampleType(), AudioBuffer::SampleType::kInt16);
+  return std::vector<int16_t>(
+      buffer.GetInt16Buffer(),
+      buffer.GetInt16Buffer() + buffer.GetBufferSize());
+}
+
+// 5 stereo frames.
+const std::vector<int16_t>& GetStereoSamples() {
+  static const auto* const kSamples =
+      new std::vector<int16_t>{1, -1, 2, -2, 3, -3, 4, -4, 5, -5};
+  return *kSamples;
+}
+
+TEST(WavFileReaderTest, ReadsHeader) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<WavFileReader> reader,
+      WavFileReader::Create(WriteTempFile(
+          "header.wav", BuildLin16Wav(GetStereoSamples(), /*channels=*/2,
+                                      /*sample_rate=*/16000))));
+
+  EXPECT_EQ(reader->GetAudioFormat().channels, 2);
+  EXPECT_EQ(reader->GetAudioFormat().sample_rate, 16000);
+  EXPECT_EQ(reader->GetFrameCount(), 5);
+}
+
+TEST(WavFileReaderTest, ReadsFullWindowsWithoutCopy) {
+  const std::string path = WriteTempFile(
+      "zero_copy.wav",
+      BuildLin16Wav(GetStereoSamples(), /*channels=*/2, /*sample_rate=*/16000));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<WavFileReader> reader,
+                               WavFileReader::Create(path));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> first,
+                               reader->ReadWindow(/*start_frame=*/0,
+                                                  /*window_frames=*/2));
+  EXPECT_THAT(GetSamples(*first), ElementsAre(1, -1, 2, -2));
+  EXPECT_EQ(first->GetAudioFormat().channels, 2);
+  const int16_t* first_samples = first->GetInt16Buffer();
+
+  // The window ending on the last frame is still read in place, right after
+  // the first one in the mapped file.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> last,
+                               reader->ReadWindow(/*start_frame=*/2,
+                                                  /*window_frames=*/3));
+  EXPECT_THAT(GetSamples(*last), ElementsAre(3, -3, 4, -4, 5, -5));
+  EXPECT_EQ(last->GetInt16Buffer(), first_samples + 4);
+}
+
+TEST(WavFileReaderTest, PadsLastPartialWindow) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<WavFileReader> reader,
+      WavFileReader::Create(WriteTempFile(
+          "partial.wav", BuildLin16Wav(GetStereoSamples(), /*channels=*/2,
+                                       /*sample_rate=*/16000))));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> first,
+                               reader->ReadWindow(/*start_frame=*/0,
+                                                  /*window_frames=*/3));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> last,
+                               reader->ReadWindow(/*start_frame=*/3,
+                                                  /*window_frames=*/3));
+
+  EXPECT_THAT(GetSamples(*last), ElementsAre(4, -4, 5, -5, 0, 0));
+  EXPECT_NE(last->GetInt16Buffer(), first->GetInt16Buffer() + 6);
+}
+
+TEST(WavFileReaderTest, PadsWindowsPastTheEnd) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<WavFileReader> reader,
+      WavFileReader::Create(WriteTempFile(
+          "past_end.wav", BuildLin16Wav(GetStereoSamples(), /*channels=*/2,
+                                        /*sample_rate=*/16000))));
+
+  for (int64_t start_frame : {5, 6, 1000}) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> buffer,
+                                 reader->ReadWindow(start_frame,
+                                                    /*window_frames=*/2));
+    EXPECT_THAT(GetSamples(*buffer), ElementsAre(0, 0, 0, 0));
+  }
+}
+
+TEST(WavFileReaderTest, CopiesMisalignedSamples) {
+  // An odd-sized chunk before the data chunk misaligns the samples.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<WavFileReader> reader,
+      WavFileReader::Create(WriteTempFile(
+          "misaligned.wav",
+          BuildLin16Wav(GetStereoSamples(), /*channels=*/2,
+                        /*sample_rate=*/16000, /*padding_size=*/3))));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioBuffer> buffer,
+                               reader->ReadWindow(/*start_frame=*/1,
+                                                  /*window_frames=*/4));
+
+  EXPECT_THAT(GetSamples(*buffer), ElementsAreArray(std::vector<int16_t>{
+                                       2, -2, 3, -3, 4, -4, 5, -5}));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->GetInt16Buffer()) %
+                alignof(int16_t),
+            0);
+}
+
+TEST(WavFileReaderTest, FailsWithInvalidWindow) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<WavFileReader> reader,
+      WavFileReader::Create(WriteTempFile(
+          "invalid_window.wav",
+          BuildLin16Wav(GetStereoSamples(), /*channels=*/2,
+                        /*sample_rate=*/16000))));
+
+  EXPECT_EQ(reader->ReadWindow(/*start_frame=*/-1, /*window_frames=*/2)
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(reader->ReadWindow(/*start_frame=*/0, /*window_frames=*/0)
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(WavFileReaderTest, FailsWithMissingFile) {
+  EXPECT_EQ(WavFileReader::Create(::testing::TempDir() + "missing.wav")
+                .status()
+                .code(),
+            absl::StatusCode::kNotFound);
+}
+
+TEST(WavFileReaderTest, FailsWithInvalidFile) {
+  EXPECT_EQ(WavFileReader::Create(
+                WriteTempFile("invalid.wav", "RIFF0000WAVE"))
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,190 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/audio/utils/wav_io.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/test/task/audio/wav_test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+// Size of the header of a WAV file built by BuildLin16Wav without padding.
+constexpr int kHeaderSize = 44;
+
+TEST(DecodeLin16WaveHeaderTest, Succeeds) {
+  const std::string wav = BuildLin16Wav({1, 2, 3, 4, 5, 6}, /*channels=*/2,
+                                        /*sample_rate=*/16000);
+  WavHeader header;
+
+  SUPPORT_ASSERT_OK(DecodeLin16WaveHeader(wav, &header));
+
+  EXPECT_EQ(header.channel_count, 2);
+  EXPECT_EQ(header.sample_rate, 16000);
+  EXPECT_EQ(header.sample_count, 3);
+  EXPECT_EQ(header.data_offset, kHeaderSize);
+}
+
+TEST(DecodeLin16WaveHeaderTest, SkipsChunksBeforeData) {
+  const std::string wav = BuildLin16Wav({1, 2}, /*channels=*/1,
+                                        /*sample_rate=*/8000,
+                                        /*padding_size=*/5);
+  WavHeader header;
+
+  SUPPORT_ASSERT_OK(DecodeLin16WaveHeader(wav, &header));
+
+  EXPECT_EQ(header.sample_count, 2);
+  EXPECT_EQ(header.data_offset, kHeaderSize + 8 + 5);
+}
+
+TEST(DecodeLin16WaveHeaderTest, FailsWithTruncatedHeader) {
+  const std::string wav = BuildLin16Wav({1, 2}, /*channels=*/1,
+                                        /*sample_rate=*/8000);
+  // Every strict prefix of the header misses a field or the data chunk.
+  for (int size = 0; size < kHeaderSize; ++size) {
+    WavHeader header;
+    const absl::Status status =
+        DecodeLin16WaveHeader(absl::string_view(wav.data(), size), &header);
+    EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument)
+        << "for size " << size;
+  }
+}
+
+TEST(DecodeLin16WaveHeaderTest, FailsWithTruncatedData) {
+  std::string wav = BuildLin16Wav({1, 2, 3}, /*channels=*/1,
+                                  /*sample_rate=*/8000);
+  wav.pop_back();
+  WavHeader header;
+
+  const absl::Status status = DecodeLin16WaveHeader(wav, &header);
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(), HasSubstr("Data too short"));
+}
+
+TEST(DecodeLin16WaveHeaderTest, FailsWithMalformedHeader) {
+  const std::string wav = BuildLin16Wav({1, 2}, /*channels=*/1,
+                                        /*sample_rate=*/8000);
+  struct Corruption {
+    int offset;
+    char value;
+    const char* message;
+  };
+  for (const Corruption& corruption : std::vector<Corruption>{
+           {0, 'X', "Header mismatch"},
+           {8, 'X', "Header mismatch"},
+           {16, 17, "Bad format chunk size"},
+           {20, 3, "Bad audio format"},
+           {22, 0, "Bad number of channels"},
+           {28, 1, "Bad bytes per second"},
+           {32, 4, "Bad bytes per sample"},
+           {34, 8, "Can only read 16-bit"},
+           {36, 'X', "No data chunk"},
+       }) {
+    std::string corrupted_wav = wav;
+    corrupted_wav[corruption.offset] = corruption.value;
+    WavHeader header;
+
+    const absl::Status status = DecodeLin16WaveHeader(corrupted_wav, &header);
+
+    EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument)
+        << "for offset " << corruption.offset;
+    EXPECT_THAT(status.message(), HasSubstr(corruption.message));
+  }
+}
+
+TEST(DecodeLin16WaveHeaderTest, FailsWithSeveralDataChunks) {
+  std::string wav = BuildLin16Wav({1, 2}, /*channels=*/1,
+                                  /*sample_rate=*/8000);
+  wav += wav.substr(kHeaderSize - 8);
+  WavHeader header;
+
+  const absl::Status status = DecodeLin16WaveHeader(wav, &header);
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(), HasSubstr("More than one data chunk"));
+}
+
+TEST(DecodeLin16WaveHeaderTest, IgnoresTruncatedTrailingChunk) {
+  std::string wav = BuildLin16Wav({1, 2}, /*channels=*/1,
+                                  /*sample_rate=*/8000);
+  // A chunk claiming close to 4 GiB.
+  wav += std::string("LIST\xf0\xff\xff\xff", 8);
+  WavHeader header;
+
+  SUPPORT_ASSERT_OK(DecodeLin16WaveHeader(wav, &header));
+
+  EXPECT_EQ(header.sample_count, 2);
+}
+
+TEST(DecodeLin16WaveAsFloatVectorTest, Succeeds) {
+  const std::string wav = BuildLin16Wav({0, 16384, -32768, 32767},
+                                        /*channels=*/2, /*sample_rate=*/16000);
+  std::vector<float> float_values;
+  uint32_t sample_count;
+  uint16_t channel_count;
+  uint32_t sample_rate;
+
+  SUPPORT_ASSERT_OK(DecodeLin16WaveAsFloatVector(
+      wav, &float_values, &sample_count, &channel_count, &sample_rate));
+
+  EXPECT_EQ(sample_count, 2);
+  EXPECT_EQ(channel_count, 2);
+  EXPECT_EQ(sample_rate, 16000);
+  EXPECT_THAT(float_values,
+              ElementsAre(0.0f, 0.5f, -1.0f, 32767.0f / 32768.0f));
+}
+
+TEST(IncrementOffsetTest, FailsPastMaxSize) {
+  size_t new_offset;
+  SUPPORT_ASSERT_OK(IncrementOffset(2, 3, 5, &new_offset));
+  EXPECT_EQ(new_offset, 5);
+
+  EXPECT_EQ(IncrementOffset(2, 4, 5, &new_offset).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(IncrementOffset(6, 0, 5, &new_offset).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(IncrementOffset(2, std::numeric_limits<size_t>::max(), 5,
+                            &new_offset)
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(IncrementOffsetTest, SucceedsPast2GiB) {
+  constexpr size_t kOffset = size_t{3} << 30;
+  size_t new_offset;
+
+  SUPPORT_ASSERT_OK(IncrementOffset(kOffset, 2, kOffset + 2, &new_offset));
+
+  EXPECT_EQ(new_offset, kOffset + 2);
+}
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
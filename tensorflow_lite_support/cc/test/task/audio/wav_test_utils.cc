@@ -0,0 +1,76 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/test/task/audio/wav_test_utils.h"
+
+#include <fstream>
+
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+void AppendUint16(uint16_t value, std::string* data) {
+  data->push_back(static_cast<char>(value & 0xff));
+  data->push_back(static_cast<char>(value >> 8));
+}
+
+void AppendUint32(uint32_t value, std::string* data) {
+  AppendUint16(value & 0xffff, data);
+  AppendUint16(value >> 16, data);
+}
+
+}  // namespace
+
+std::string BuildLin16Wav(const std::vector<int16_t>& samples, int channels,
+                          int sample_rate, int padding_size) {
+  const uint32_t data_size = samples.size() * sizeof(int16_t);
+  std::string wav = "RIFF";
+  AppendUint32(0, &wav);  // Total file size, which the readers ignore.
+  wav += "WAVEfmt ";
+  AppendUint32(16, &wav);
+  AppendUint16(1, &wav);  // PCM.
+  AppendUint16(channels, &wav);
+  AppendUint32(sample_rate, &wav);
+  AppendUint32(sample_rate * channels * 2, &wav);
+  AppendUint16(channels * 2, &wav);
+  AppendUint16(16, &wav);
+  if (padding_size > 0) {
+    wav += "LIST";
+    AppendUint32(padding_size, &wav);
+    wav.append(padding_size, '\0');
+  }
+  wav += "data";
+  AppendUint32(data_size, &wav);
+  for (int16_t sample : samples) {
+    AppendUint16(static_cast<uint16_t>(sample), &wav);
+  }
+  return wav;
+}
+
+std::string WriteTempFile(const std::string& name,
+                          const std::string& contents) {
+  // TempDir() ends with a path separator.
+  const std::string path = ::testing::TempDir() + name;
+  std::ofstream file(path, std::ios::binary);
+  file << contents;
+  return path;
+}
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,41 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_WAV_TEST_UTILS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_WAV_TEST_UTILS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tflite {
+namespace task {
+namespace audio {
+
+// Returns a LIN16 WAV file holding the interleaved `samples` of `channels`
+// channels at `sample_rate` Hz. A chunk of `padding_size` bytes is inserted
+// before the data chunk: an odd size misaligns the samples.
+std::string BuildLin16Wav(const std::vector<int16_t>& samples, int channels,
+                          int sample_rate, int padding_size = 0);
+
+// Writes `contents` to a new file named `name` in the test temporary directory
+// and returns its path.
+std::string WriteTempFile(const std::string& name, const std::string& contents);
+
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TEST_TASK_AUDIO_WAV_TEST_UTILS_H_
@@ -0,0 +1,216 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+// Returns the p50 of a histogram holding `nanos` and a larger latency, so that
+// the percentile is not capped by the maximum.
+absl::Duration GetMedianOf(int64_t nanos) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Nanoseconds(nanos));
+  histogram.Record(absl::Nanoseconds(4 * nanos + 100));
+  return histogram.GetSummary().p50;
+}
+
+TEST(LatencyHistogramTest, SummaryIsEmptyWithoutRecords) {
+  LatencyHistogram histogram;
+
+  const LatencySummary summary = histogram.GetSummary();
+
+  EXPECT_EQ(summary.count, 0);
+  EXPECT_EQ(summary.mean, absl::ZeroDuration());
+  EXPECT_EQ(summary.p50, absl::ZeroDuration());
+  EXPECT_EQ(summary.max, absl::ZeroDuration());
+}
+
+TEST(LatencyHistogramTest, SmallLatenciesAreExact) {
+  // Buckets are one nanosecond wide below 16 ns.
+  for (int64_t nanos = 0; nanos < 16; ++nanos) {
+    EXPECT_EQ(GetMedianOf(nanos), absl::Nanoseconds(nanos)) << nanos;
+  }
+}
+
+TEST(LatencyHistogramTest, BucketsAreLogLinear) {
+  // [16, 32) ns is split in 8 buckets of 2 ns.
+  EXPECT_EQ(GetMedianOf(16), absl::Nanoseconds(17));
+  EXPECT_EQ(GetMedianOf(17), absl::Nanoseconds(17));
+  EXPECT_EQ(GetMedianOf(18), absl::Nanoseconds(19));
+  EXPECT_EQ(GetMedianOf(31), absl::Nanoseconds(31));
+  // [960, 1024) ns is the last bucket below 2^10 ns, [1024, 1152) the first
+  // one above.
+  EXPECT_EQ(GetMedianOf(959), absl::Nanoseconds(928));
+  EXPECT_EQ(GetMedianOf(960), absl::Nanoseconds(992));
+  EXPECT_EQ(GetMedianOf(1023), absl::Nanoseconds(992));
+  EXPECT_EQ(GetMedianOf(1024), absl::Nanoseconds(1088));
+  EXPECT_EQ(GetMedianOf(1151), absl::Nanoseconds(1088));
+  EXPECT_EQ(GetMedianOf(1152), absl::Nanoseconds(1216));
+}
+
+TEST(LatencyHistogramTest, PercentilesHaveBoundedRelativeError) {
+  for (int64_t nanos = 16; nanos < int64_t{1} << 40; nanos = nanos * 5 / 3) {
+    const double p50 = absl::ToDoubleNanoseconds(GetMedianOf(nanos));
+    EXPECT_NEAR(p50, nanos, nanos / 16.0) << nanos;
+  }
+}
+
+TEST(LatencyHistogramTest, PercentilesSelectByRank) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 89; ++i) {
+    histogram.Record(absl::Nanoseconds(10));
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.Record(absl::Nanoseconds(1000));
+  }
+  histogram.Record(absl::Microseconds(100));
+
+  const LatencySummary summary = histogram.GetSummary();
+
+  EXPECT_EQ(summary.count, 100);
+  EXPECT_EQ(summary.mean, absl::Nanoseconds((89 * 10 + 10 * 1000 + 100000) /
+                                            100));
+  // Ranks 50 and 89 fall in the 10 ns bucket, ranks 90 and 99 in the one of
+  // 1000 ns, whose midpoint is 992 ns.
+  EXPECT_EQ(summary.p50, absl::Nanoseconds(10));
+  EXPECT_EQ(summary.p90, absl::Nanoseconds(992));
+  EXPECT_EQ(summary.p99, absl::Nanoseconds(992));
+  EXPECT_EQ(summary.max, absl::Microseconds(100));
+}
+
+TEST(LatencyHistogramTest, PercentilesDoNotExceedMax) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Nanoseconds(1024));
+
+  const LatencySummary summary = histogram.GetSummary();
+
+  // The midpoint of the bucket is 1088 ns.
+  EXPECT_EQ(summary.p50, absl::Nanoseconds(1024));
+  EXPECT_EQ(summary.p99, absl::Nanoseconds(1024));
+  EXPECT_EQ(summary.max, absl::Nanoseconds(1024));
+}
+
+TEST(LatencyHistogramTest, CountsLatenciesPastLastBucketInOverflowBucket) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Hours(1));
+  histogram.Record(absl::Hours(2));
+
+  const LatencySummary summary = histogram.GetSummary();
+
+  EXPECT_EQ(summary.count, 2);
+  EXPECT_EQ(summary.mean, absl::Minutes(90));
+  EXPECT_EQ(summary.max, absl::Hours(2));
+  // Percentiles saturate at the midpoint of the last bucket, which starts at
+  // 15 * 2^37 ns and ends at 2^41 ns (~36 minutes).
+  const absl::Duration last_bucket_midpoint =
+      absl::Nanoseconds((int64_t{15} << 37) + (int64_t{1} << 36));
+  EXPECT_EQ(summary.p50, last_bucket_midpoint);
+  EXPECT_EQ(summary.p99, last_bucket_midpoint);
+}
+
+TEST(LatencyHistogramTest, RecordsNegativeLatenciesAsZero) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Nanoseconds(-5));
+
+  const LatencySummary summary = histogram.GetSummary();
+
+  EXPECT_EQ(summary.count, 1);
+  EXPECT_EQ(summary.mean, absl::ZeroDuration());
+  EXPECT_EQ(summary.max, absl::ZeroDuration());
+}
+
+TEST(LatencyHistogramTest, ResetDiscardsRecords) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Milliseconds(5));
+  histogram.Record(absl::Milliseconds(7));
+
+  histogram.Reset();
+
+  EXPECT_EQ(histogram.GetSummary().count, 0);
+  EXPECT_EQ(histogram.GetSummary().max, absl::ZeroDuration());
+  histogram.Record(absl::Nanoseconds(3));
+  const LatencySummary summary = histogram.GetSummary();
+  EXPECT_EQ(summary.count, 1);
+  EXPECT_EQ(summary.mean, absl::Nanoseconds(3));
+  EXPECT_EQ(summary.max, absl::Nanoseconds(3));
+}
+
+TEST(LatencyHistogramTest, RecordsFromSeveralThreads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kRecordsPerThread = 10000;
+  LatencyHistogram histogram;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&histogram, t] {
+      for (int i = 0; i < kRecordsPerThread; ++i) {
+        histogram.Record(absl::Nanoseconds(t + 1));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const LatencySummary summary = histogram.GetSummary();
+  EXPECT_EQ(summary.count, kNumThreads * kRecordsPerThread);
+  // The mean of 1, 2, 3 and 4 ns, truncated.
+  EXPECT_EQ(summary.mean, absl::Nanoseconds(2));
+  EXPECT_EQ(summary.max, absl::Nanoseconds(kNumThreads));
+}
+
+TEST(TaskStatsTest, ResetInferenceStatsKeepsInitStats) {
+  TaskStats stats;
+  stats.RecordInit(InitStage::kLoadModel, absl::Milliseconds(3));
+  stats.RecordInference(InferenceStage::kInvoke, absl::Milliseconds(1));
+
+  stats.ResetInferenceStats();
+
+  EXPECT_EQ(stats.GetInitSummary(InitStage::kLoadModel).count, 1);
+  EXPECT_EQ(stats.GetInferenceSummary(InferenceStage::kInvoke).count, 0);
+}
+
+TEST(TaskStatsTest, ToStringListsNonEmptyStages) {
+  TaskStats stats;
+  stats.RecordInit(InitStage::kBuildInterpreter, absl::Milliseconds(2));
+  stats.RecordInference(InferenceStage::kInvoke, absl::Milliseconds(1));
+
+  const std::string output = stats.ToString();
+
+  EXPECT_THAT(output, HasSubstr("BuildInterpreter"));
+  EXPECT_THAT(output, HasSubstr("Invoke"));
+  EXPECT_THAT(output, Not(HasSubstr("LoadModel")));
+  EXPECT_THAT(output, Not(HasSubstr("Postprocess")));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,200 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/processor/audio_preprocessor.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+
+namespace tflite {
+namespace task {
+namespace processor {
+namespace {
+
+using ::testing::ElementsAre;
+using ::tflite::task::audio::AudioBuffer;
+using ::tflite::task::core::TfLiteEngine;
+
+constexpr int kChannels = 2;
+constexpr int kSampleRate = 16000;
+// Number of float elements of the input tensor, i.e. 3 stereo frames.
+constexpr int kInputSize = 6;
+
+// Returns a metadata buffer with the AudioProperties of the input tensor.
+std::string BuildAudioMetadata() {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto audio_properties =
+      tflite::CreateAudioProperties(builder, kSampleRate, kChannels);
+  const auto content = tflite::CreateContent(
+      builder, tflite::ContentProperties_AudioProperties,
+      audio_properties.Union());
+  tflite::TensorMetadataBuilder tensor_metadata_builder(builder);
+  tensor_metadata_builder.add_content(content);
+  const auto input_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{
+          tensor_metadata_builder.Finish()});
+  tflite::SubGraphMetadataBuilder subgraph_metadata_builder(builder);
+  subgraph_metadata_builder.add_input_tensor_metadata(input_tensor_metadata);
+  const auto subgraph_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::SubGraphMetadata>>{
+          subgraph_metadata_builder.Finish()});
+  tflite::ModelMetadataBuilder model_metadata_builder(builder);
+  model_metadata_builder.add_subgraph_metadata(subgraph_metadata);
+  tflite::FinishModelMetadataBuffer(builder, model_metadata_builder.Finish());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Builds a model doubling a float32 input tensor of shape [1, kInputSize],
+// with the audio metadata above.
+std::string BuildAudioModel() {
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  auto add_code = absl::make_unique<tflite::OperatorCodeT>();
+  add_code->builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->deprecated_builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->version = 1;
+  model.operator_codes.push_back(std::move(add_code));
+
+  auto subgraph = absl::make_unique<tflite::SubGraphT>();
+  for (const char* name : {"audio", "output"}) {
+    auto tensor = absl::make_unique<tflite::TensorT>();
+    tensor->name = name;
+    tensor->type = tflite::TensorType_FLOAT32;
+    tensor->buffer = 0;
+    tensor->shape = {1, kInputSize};
+    subgraph->tensors.push_back(std::move(tensor));
+  }
+  subgraph->inputs = {0};
+  subgraph->outputs = {1};
+  auto add = absl::make_unique<tflite::OperatorT>();
+  add->opcode_index = 0;
+  add->inputs = {0, 0};
+  add->outputs = {1};
+  add->builtin_options.Set(tflite::AddOptionsT());
+  subgraph->operators.push_back(std::move(add));
+  model.subgraphs.push_back(std::move(subgraph));
+
+  const std::string metadata = BuildAudioMetadata();
+  auto metadata_buffer = absl::make_unique<tflite::BufferT>();
+  metadata_buffer->data.assign(metadata.begin(), metadata.end());
+  model.buffers.push_back(std::move(metadata_buffer));
+  auto model_metadata = absl::make_unique<tflite::MetadataT>();
+  model_metadata->name = "TFLITE_METADATA";
+  model_metadata->buffer = 1;
+  model.metadata.push_back(std::move(model_metadata));
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+class AudioPreprocessorTest : public tflite_shims::testing::Test {
+ protected:
+  void SetUp() override {
+    model_buffer_ = BuildAudioModel();
+    engine_ = absl::make_unique<TfLiteEngine>();
+    SUPPORT_ASSERT_OK(engine_->BuildModelFromFlatBuffer(model_buffer_.data(),
+                                                        model_buffer_.size()));
+    SUPPORT_ASSERT_OK(engine_->InitInterpreter());
+    SUPPORT_ASSERT_OK_AND_ASSIGN(preprocessor_,
+                                 AudioPreprocessor::Create(engine_.get(), {0}));
+  }
+
+  std::vector<float> GetInputValues() {
+    const float* data = engine_->GetInputs()[0]->data.f;
+    return std::vector<float>(data, data + kInputSize);
+  }
+
+  std::string model_buffer_;
+  std::unique_ptr<TfLiteEngine> engine_;
+  std::unique_ptr<AudioPreprocessor> preprocessor_;
+};
+
+TEST_F(AudioPreprocessorTest, ReadsFormatFromMetadata) {
+  EXPECT_EQ(preprocessor_->GetRequiredAudioFormat().channels, kChannels);
+  EXPECT_EQ(preprocessor_->GetRequiredAudioFormat().sample_rate, kSampleRate);
+  EXPECT_EQ(preprocessor_->GetRequiredInputBufferSize(), kInputSize);
+}
+
+TEST_F(AudioPreprocessorTest, SucceedsWithInt16Samples) {
+  const std::vector<int16_t> samples = {0, 16384, -16384, -32768, 32767, 1};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioBuffer> audio_buffer,
+      AudioBuffer::Create(samples.data(), samples.size(),
+                          {kChannels, kSampleRate}));
+
+  SUPPORT_ASSERT_OK(preprocessor_->Preprocess(*audio_buffer));
+
+  EXPECT_THAT(GetInputValues(),
+              ElementsAre(0.0f, 0.5f, -0.5f, -1.0f, 32767.0f / 32768.0f,
+                          1.0f / 32768.0f));
+}
+
+TEST_F(AudioPreprocessorTest, Int16AndFloatSamplesMatch) {
+  std::vector<int16_t> int16_samples(kInputSize);
+  std::vector<float> float_samples(kInputSize);
+  for (int i = 0; i < kInputSize; ++i) {
+    int16_samples[i] = static_cast<int16_t>(i * 9000 - 25000);
+    float_samples[i] = int16_samples[i] / 32768.0f;
+  }
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioBuffer> float_buffer,
+      AudioBuffer::Create(float_samples.data(), kInputSize,
+                          {kChannels, kSampleRate}));
+  SUPPORT_ASSERT_OK(preprocessor_->Preprocess(*float_buffer));
+  const std::vector<float> float_input = GetInputValues();
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioBuffer> int16_buffer,
+      AudioBuffer::Create(int16_samples.data(), kInputSize,
+                          {kChannels, kSampleRate}));
+  SUPPORT_ASSERT_OK(preprocessor_->Preprocess(*int16_buffer));
+
+  EXPECT_EQ(GetInputValues(), float_input);
+}
+
+TEST_F(AudioPreprocessorTest, FailsWithInt16BufferOfWrongSize) {
+  const std::vector<int16_t> samples(kInputSize + kChannels);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AudioBuffer> audio_buffer,
+      AudioBuffer::Create(samples.data(), samples.size(),
+                          {kChannels, kSampleRate}));
+
+  EXPECT_EQ(preprocessor_->Preprocess(*audio_buffer).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace processor
+}  // namespace task
+}  // namespace tflite
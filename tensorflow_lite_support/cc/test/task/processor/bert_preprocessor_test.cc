@@ -0,0 +1,218 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/processor/bert_preprocessor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+
+namespace tflite {
+namespace task {
+namespace processor {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::TfLiteEngine;
+
+constexpr int kMaxSeqLen = 16;
+
+// Builds a model with three INT32 inputs ("ids", "mask" and "segment_ids") of
+// shape [1, created_seq_len] and shape signature [1, -1] (or [1,
+// created_seq_len] if `dynamic` is false), whose output is the sum of the
+// first two inputs.
+std::string BuildBertLikeModel(int created_seq_len, bool dynamic) {
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  auto add_code = absl::make_unique<tflite::OperatorCodeT>();
+  add_code->builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->deprecated_builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->version = 1;
+  model.operator_codes.push_back(std::move(add_code));
+
+  auto subgraph = absl::make_unique<tflite::SubGraphT>();
+  for (const char* name : {"ids", "mask", "segment_ids", "output"}) {
+    auto tensor = absl::make_unique<tflite::TensorT>();
+    tensor->name = name;
+    tensor->type = tflite::TensorType_INT32;
+    tensor->buffer = 0;
+    tensor->shape = {1, created_seq_len};
+    tensor->shape_signature = {1, dynamic ? -1 : created_seq_len};
+    subgraph->tensors.push_back(std::move(tensor));
+  }
+  subgraph->inputs = {0, 1, 2};
+  subgraph->outputs = {3};
+  auto add = absl::make_unique<tflite::OperatorT>();
+  add->opcode_index = 0;
+  add->inputs = {0, 1};
+  add->outputs = {3};
+  add->builtin_options.Set(tflite::AddOptionsT());
+  subgraph->operators.push_back(std::move(add));
+  model.subgraphs.push_back(std::move(subgraph));
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+class BertSeqLenResizerTest : public tflite_shims::testing::Test {
+ protected:
+  void BuildEngine(int created_seq_len, bool dynamic) {
+    model_buffer_ = BuildBertLikeModel(created_seq_len, dynamic);
+    engine_ = absl::make_unique<TfLiteEngine>();
+    SUPPORT_ASSERT_OK(engine_->BuildModelFromFlatBuffer(model_buffer_.data(),
+                                                        model_buffer_.size()));
+    SUPPORT_ASSERT_OK(engine_->InitInterpreter());
+  }
+
+  StatusOr<BertSeqLenResizer> CreateResizer(
+      const BertPreprocessorOptions& options, int default_max_seq_len) {
+    return BertSeqLenResizer::Create(engine_.get(), {0, 1, 2}, options,
+                                     default_max_seq_len);
+  }
+
+  // Returns the sequence dimension of each input tensor, and of the output
+  // tensor after running inference.
+  std::vector<int> GetSeqLens() {
+    std::vector<int> seq_lens;
+    for (const TfLiteTensor* tensor : engine_->GetInputs()) {
+      seq_lens.push_back(tensor->dims->data[1]);
+    }
+    EXPECT_EQ(engine_->interpreter()->Invoke(), kTfLiteOk);
+    seq_lens.push_back(engine_->GetOutputs()[0]->dims->data[1]);
+    return seq_lens;
+  }
+
+  std::string model_buffer_;
+  std::unique_ptr<TfLiteEngine> engine_;
+};
+
+TEST_F(BertSeqLenResizerTest, ResizesToNumTokensAndBack) {
+  BuildEngine(/*created_seq_len=*/1, /*dynamic=*/true);
+  BertPreprocessorOptions options;
+  options.set_dynamic_seq_len(true);
+  options.set_max_seq_len(kMaxSeqLen);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(BertSeqLenResizer resizer,
+                               CreateResizer(options, /*default=*/1));
+  EXPECT_TRUE(resizer.is_dynamic());
+  EXPECT_EQ(resizer.max_seq_len(), kMaxSeqLen);
+
+  // Short input.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(int seq_len, resizer.ResizeForNumTokens(5));
+  EXPECT_EQ(seq_len, 5);
+  EXPECT_THAT(GetSeqLens(), ElementsAre(5, 5, 5, 5));
+
+  // Input at the maximum sequence length.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(seq_len,
+                               resizer.ResizeForNumTokens(kMaxSeqLen));
+  EXPECT_EQ(seq_len, kMaxSeqLen);
+  EXPECT_THAT(GetSeqLens(),
+              ElementsAre(kMaxSeqLen, kMaxSeqLen, kMaxSeqLen, kMaxSeqLen));
+
+  // Resize back to the short input.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(seq_len, resizer.ResizeForNumTokens(5));
+  EXPECT_EQ(seq_len, 5);
+  EXPECT_THAT(GetSeqLens(), ElementsAre(5, 5, 5, 5));
+}
+
+TEST_F(BertSeqLenResizerTest, PadsToSmallestFittingBucket) {
+  BuildEngine(/*created_seq_len=*/1, /*dynamic=*/true);
+  BertPreprocessorOptions options;
+  options.set_dynamic_seq_len(true);
+  options.add_seq_len_buckets(kMaxSeqLen);
+  options.add_seq_len_buckets(8);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(BertSeqLenResizer resizer,
+                               CreateResizer(options, /*default=*/1));
+  EXPECT_EQ(resizer.max_seq_len(), kMaxSeqLen);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(int seq_len, resizer.ResizeForNumTokens(5));
+  EXPECT_EQ(seq_len, 8);
+  EXPECT_THAT(GetSeqLens(), ElementsAre(8, 8, 8, 8));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(seq_len, resizer.ResizeForNumTokens(9));
+  EXPECT_EQ(seq_len, kMaxSeqLen);
+  EXPECT_THAT(GetSeqLens(),
+              ElementsAre(kMaxSeqLen, kMaxSeqLen, kMaxSeqLen, kMaxSeqLen));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(seq_len, resizer.ResizeForNumTokens(3));
+  EXPECT_EQ(seq_len, 8);
+  EXPECT_THAT(GetSeqLens(), ElementsAre(8, 8, 8, 8));
+}
+
+TEST_F(BertSeqLenResizerTest, PadsToDefaultMaxSeqLenWithoutDynamicSeqLen) {
+  BuildEngine(/*created_seq_len=*/1, /*dynamic=*/true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      BertSeqLenResizer resizer,
+      CreateResizer(BertPreprocessorOptions(), /*default=*/kMaxSeqLen));
+  EXPECT_FALSE(resizer.is_dynamic());
+
+  // The tensors are resized once, at creation.
+  EXPECT_THAT(GetSeqLens(),
+              ElementsAre(kMaxSeqLen, kMaxSeqLen, kMaxSeqLen, kMaxSeqLen));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(int seq_len, resizer.ResizeForNumTokens(5));
+  EXPECT_EQ(seq_len, kMaxSeqLen);
+  EXPECT_THAT(GetSeqLens(),
+              ElementsAre(kMaxSeqLen, kMaxSeqLen, kMaxSeqLen, kMaxSeqLen));
+}
+
+TEST_F(BertSeqLenResizerTest, IgnoresDynamicSeqLenWithStaticModel) {
+  BuildEngine(/*created_seq_len=*/kMaxSeqLen, /*dynamic=*/false);
+  BertPreprocessorOptions options;
+  options.set_dynamic_seq_len(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(BertSeqLenResizer resizer,
+                               CreateResizer(options, kMaxSeqLen));
+  EXPECT_FALSE(resizer.is_dynamic());
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(int seq_len, resizer.ResizeForNumTokens(5));
+  EXPECT_EQ(seq_len, kMaxSeqLen);
+  EXPECT_THAT(GetSeqLens(),
+              ElementsAre(kMaxSeqLen, kMaxSeqLen, kMaxSeqLen, kMaxSeqLen));
+}
+
+TEST_F(BertSeqLenResizerTest, FailsWithUnitSeqLenAndNoMaxSeqLen) {
+  BuildEngine(/*created_seq_len=*/1, /*dynamic=*/true);
+  BertPreprocessorOptions options;
+  options.set_dynamic_seq_len(true);
+
+  StatusOr<BertSeqLenResizer> resizer_or =
+      CreateResizer(options, /*default=*/1);
+
+  EXPECT_EQ(resizer_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(resizer_or.status().message(), HasSubstr("max_seq_len"));
+
+  // Padding to the created sequence length isn't possible either.
+  resizer_or = CreateResizer(BertPreprocessorOptions(), /*default=*/1);
+
+  EXPECT_EQ(resizer_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(resizer_or.status().message(), HasSubstr("dynamic_seq_len"));
+}
+
+}  // namespace
+}  // namespace processor
+}  // namespace task
+}  // namespace tflite
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/processor/image_preprocessor.h"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow/lite/core/shims/cc/shims_test_util.h"
@@ -24,6 +27,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/status_matchers.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_conversion_cache.h"
 #include "tensorflow_lite_support/cc/test/test_utils.h"
 #include "tensorflow_lite_support/examples/task/vision/desktop/utils/image_utils.h"
 
@@ -37,6 +41,7 @@ using ::tflite::task::JoinPath;
 using ::tflite::task::core::TfLiteEngine;
 using ::tflite::task::vision::DecodeImageFromFile;
 using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::FrameConversionCache;
 using ::tflite::task::vision::ImageData;
 
 constexpr char kTestDataDirectory[] =
@@ -44,6 +49,8 @@ constexpr char kTestDataDirectory[] =
     "vision/";
 
 constexpr char kDilatedConvolutionModelWithMetaData[] = "dilated_conv.tflite";
+constexpr char kMobileNetQuantizedWithMetadata[] =
+    "mobilenet_v1_0.25_224_quant.tflite";
 
 StatusOr<ImageData> LoadImage(std::string image_name) {
   return DecodeImageFromFile(JoinPath("./" /*test src dir*/,
@@ -109,6 +116,97 @@ TEST_F(DynamicInputTest, GoldenImageComparison) {
   ImageDataFree(&image);
 }
 
+class FrameConversionCacheTest : public tflite_shims::testing::Test {
+ protected:
+  std::unique_ptr<TfLiteEngine> CreateEngine() {
+    auto engine = absl::make_unique<TfLiteEngine>();
+    SUPPORT_EXPECT_OK(engine->BuildModelFromFile(JoinPath(
+        "./" /*test src dir*/, kTestDataDirectory,
+        kMobileNetQuantizedWithMetadata)));
+    SUPPORT_EXPECT_OK(engine->InitInterpreter());
+    return engine;
+  }
+};
+
+TEST_F(FrameConversionCacheTest, SharesPreprocessedImages) {
+  std::unique_ptr<TfLiteEngine> engine1 = CreateEngine();
+  std::unique_ptr<TfLiteEngine> engine2 = CreateEngine();
+  SUPPORT_ASSERT_OK_AND_ASSIGN(auto preprocessor1,
+                               ImagePreprocessor::Create(engine1.get(), {0}));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(auto preprocessor2,
+                               ImagePreprocessor::Create(engine2.get(), {0}));
+  auto cache = std::make_shared<FrameConversionCache>();
+  preprocessor1->SetFrameConversionCache(cache);
+  preprocessor2->SetFrameConversionCache(cache);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      image.pixel_data, FrameBuffer::Dimension{image.width, image.height});
+
+  SUPPORT_ASSERT_OK(preprocessor1->Preprocess(*frame_buffer));
+  SUPPORT_ASSERT_OK(preprocessor2->Preprocess(*frame_buffer));
+
+  EXPECT_EQ(cache->misses(), 1);
+  EXPECT_EQ(cache->hits(), 1);
+  const TfLiteTensor* input1 = engine1->GetInputs()[0];
+  const TfLiteTensor* input2 = engine2->GetInputs()[0];
+  ASSERT_EQ(input1->bytes, input2->bytes);
+  EXPECT_EQ(std::memcmp(input1->data.raw, input2->data.raw, input1->bytes), 0);
+
+  ImageDataFree(&image);
+}
+
+class ZeroCopyInputTest : public tflite_shims::testing::Test {};
+
+TEST_F(ZeroCopyInputTest, BindsAlignedFramesAndCopiesPaddedFrames) {
+  auto engine = absl::make_unique<TfLiteEngine>();
+  SUPPORT_ASSERT_OK(engine->BuildModelFromFile(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory,
+      kMobileNetQuantizedWithMetadata)));
+  SUPPORT_ASSERT_OK(engine->InitInterpreter());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(auto preprocessor,
+                               ImagePreprocessor::Create(engine.get(), {0}));
+  preprocessor->SetZeroCopyInput(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger-224.png"));
+  ASSERT_EQ(image.width, 224);
+  ASSERT_EQ(image.height, 224);
+  ASSERT_EQ(image.channels, 3);
+  const int row_bytes = image.width * 3;
+
+  // Copies the image into a 64-byte aligned buffer, and into a buffer with
+  // padded rows.
+  std::vector<uint8> storage(row_bytes * image.height + 64);
+  uint8* aligned_data =
+      storage.data() + (64 - reinterpret_cast<uintptr_t>(storage.data()) % 64) %
+                           64;
+  std::memcpy(aligned_data, image.pixel_data, row_bytes * image.height);
+  const int padded_row_bytes = row_bytes + 16;
+  std::vector<uint8> padded_data(padded_row_bytes * image.height);
+  for (int row = 0; row < image.height; ++row) {
+    std::memcpy(padded_data.data() + row * padded_row_bytes,
+                image.pixel_data + row * row_bytes, row_bytes);
+  }
+
+  std::unique_ptr<FrameBuffer> aligned_frame_buffer = CreateFromRgbRawBuffer(
+      aligned_data, FrameBuffer::Dimension{image.width, image.height});
+  SUPPORT_ASSERT_OK(preprocessor->Preprocess(*aligned_frame_buffer));
+  EXPECT_EQ(engine->GetInputs()[0]->data.raw,
+            reinterpret_cast<char*>(aligned_data));
+  SUPPORT_EXPECT_OK(engine->interpreter_wrapper()->InvokeWithoutFallback());
+
+  std::unique_ptr<FrameBuffer> padded_frame_buffer = FrameBuffer::Create(
+      {{padded_data.data(), /*stride=*/{padded_row_bytes, 3}}},
+      FrameBuffer::Dimension{image.width, image.height},
+      FrameBuffer::Format::kRGB, FrameBuffer::Orientation::kTopLeft);
+  SUPPORT_ASSERT_OK(preprocessor->Preprocess(*padded_frame_buffer));
+  const TfLiteTensor* input = engine->GetInputs()[0];
+  EXPECT_NE(input->data.raw, reinterpret_cast<char*>(aligned_data));
+  ASSERT_EQ(input->bytes, static_cast<size_t>(row_bytes * image.height));
+  EXPECT_EQ(std::memcmp(input->data.raw, image.pixel_data, input->bytes), 0);
+  SUPPORT_EXPECT_OK(engine->interpreter_wrapper()->InvokeWithoutFallback());
+
+  ImageDataFree(&image);
+}
+
 }  // namespace
 }  // namespace processor
 }  // namespace task
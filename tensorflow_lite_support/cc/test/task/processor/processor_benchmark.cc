@@ -0,0 +1,210 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the processors on their own, i.e. without inference:
+// ImagePreprocessor on the quantized and float MobileNet test models, then
+// ClassificationPostprocessor and EmbeddingPostprocessor on the output
+// tensors of these models.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/cc/test/task/processor:processor_benchmark
+//
+// Append `-- --benchmark_out=<file> --benchmark_out_format=json` to write the
+// results in a machine-readable form, e.g. to track regressions over time.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/cc/task/processor/classification_postprocessor.h"
+#include "tensorflow_lite_support/cc/task/processor/embedding_postprocessor.h"
+#include "tensorflow_lite_support/cc/task/processor/image_preprocessor.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/classification_options.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/classifications.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding_options.pb.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/examples/task/vision/desktop/utils/image_utils.h"
+
+namespace tflite {
+namespace task {
+namespace processor {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::TfLiteEngine;
+using ::tflite::task::vision::DecodeImageFromFile;
+using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::ImageData;
+
+constexpr char kTestDataDirectory[] =
+    "./tensorflow_lite_support/cc/test/testdata/task/vision/";
+constexpr char kMobileNetQuantized[] = "mobilenet_v1_0.25_224_quant.tflite";
+constexpr char kMobileNetFloat[] = "mobilenet_v1_0.25_224_1_default_1.tflite";
+constexpr char kImage[] = "burger.jpg";
+
+// Returns the model selected by the first argument: 0 for the quantized
+// model, 1 for the float one.
+std::string GetModelPath(const benchmark::State& state) {
+  return absl::StrCat(kTestDataDirectory,
+                      state.range(0) ? kMobileNetFloat : kMobileNetQuantized);
+}
+
+StatusOr<std::unique_ptr<TfLiteEngine>> CreateEngine(
+    const std::string& model_path) {
+  auto engine = absl::make_unique<TfLiteEngine>();
+  RETURN_IF_ERROR(engine->BuildModelFromFile(model_path));
+  RETURN_IF_ERROR(engine->InitInterpreter());
+  return engine;
+}
+
+// Creates an engine and runs inference once on the test image, so that the
+// output tensors hold the results to postprocess.
+StatusOr<std::unique_ptr<TfLiteEngine>> CreateEngineWithOutputs(
+    const std::string& model_path) {
+  ASSIGN_OR_RETURN(std::unique_ptr<TfLiteEngine> engine,
+                   CreateEngine(model_path));
+  ASSIGN_OR_RETURN(auto preprocessor,
+                   ImagePreprocessor::Create(engine.get(), {0}));
+  ASSIGN_OR_RETURN(
+      ImageData image,
+      DecodeImageFromFile(absl::StrCat(kTestDataDirectory, kImage)));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      image.pixel_data, FrameBuffer::Dimension{image.width, image.height});
+  absl::Status status = preprocessor->Preprocess(*frame_buffer);
+  ImageDataFree(&image);
+  RETURN_IF_ERROR(status);
+  RETURN_IF_ERROR(engine->interpreter_wrapper()->InvokeWithoutFallback());
+  return engine;
+}
+
+// Arguments are the model (see `GetModelPath`) and the edge size of the
+// square input image, resized to the 224x224 input of the model.
+void BM_ImagePreprocessor(benchmark::State& state) {
+  auto engine = CreateEngine(GetModelPath(state));
+  if (!engine.ok()) {
+    state.SkipWithError("Failed to create the engine.");
+    return;
+  }
+  auto preprocessor = ImagePreprocessor::Create(engine->get(), {0});
+  if (!preprocessor.ok()) {
+    state.SkipWithError("Failed to create the preprocessor.");
+    return;
+  }
+  const int size = state.range(1);
+  std::vector<uint8> pixels(size * size * 3);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<uint8>(i * 7 + i / size);
+  }
+  std::unique_ptr<FrameBuffer> frame_buffer =
+      CreateFromRgbRawBuffer(pixels.data(), {size, size});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize((*preprocessor)->Preprocess(*frame_buffer));
+  }
+  state.SetBytesProcessed(state.iterations() * pixels.size());
+}
+
+void ImagePreprocessorArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int model : {0, 1}) {
+    for (int size : {224, 640, 1280}) {
+      benchmark->Args({model, size});
+    }
+  }
+}
+BENCHMARK(BM_ImagePreprocessor)->Apply(ImagePreprocessorArgs);
+
+// Arguments are the model (see `GetModelPath`) and the maximum number of
+// results, -1 meaning all of them.
+void BM_ClassificationPostprocessor(benchmark::State& state) {
+  auto engine = CreateEngineWithOutputs(GetModelPath(state));
+  if (!engine.ok()) {
+    state.SkipWithError("Failed to create the engine.");
+    return;
+  }
+  auto options = absl::make_unique<ClassificationOptions>();
+  options->set_max_results(state.range(1));
+  auto postprocessor =
+      ClassificationPostprocessor::Create(engine->get(), {0},
+                                          std::move(options));
+  if (!postprocessor.ok()) {
+    state.SkipWithError("Failed to create the postprocessor.");
+    return;
+  }
+  for (auto _ : state) {
+    Classifications classifications;
+    benchmark::DoNotOptimize((*postprocessor)->Postprocess(&classifications));
+  }
+}
+
+void ClassificationPostprocessorArgs(
+    benchmark::internal::Benchmark* benchmark) {
+  for (int model : {0, 1}) {
+    for (int max_results : {-1, 5}) {
+      benchmark->Args({model, max_results});
+    }
+  }
+}
+BENCHMARK(BM_ClassificationPostprocessor)
+    ->Apply(ClassificationPostprocessorArgs);
+
+// Arguments are the model (see `GetModelPath`), whether to L2-normalize the
+// feature vector and whether to quantize it.
+void BM_EmbeddingPostprocessor(benchmark::State& state) {
+  auto engine = CreateEngineWithOutputs(GetModelPath(state));
+  if (!engine.ok()) {
+    state.SkipWithError("Failed to create the engine.");
+    return;
+  }
+  auto options = absl::make_unique<EmbeddingOptions>();
+  options->set_l2_normalize(state.range(1));
+  options->set_quantize(state.range(2));
+  auto postprocessor =
+      EmbeddingPostprocessor::Create(engine->get(), {0}, std::move(options));
+  if (!postprocessor.ok()) {
+    state.SkipWithError("Failed to create the postprocessor.");
+    return;
+  }
+  for (auto _ : state) {
+    Embedding embedding;
+    benchmark::DoNotOptimize((*postprocessor)->Postprocess(&embedding));
+  }
+}
+
+void EmbeddingPostprocessorArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int model : {0, 1}) {
+    for (int l2_normalize : {0, 1}) {
+      for (int quantize : {0, 1}) {
+        benchmark->Args({model, l2_normalize, quantize});
+      }
+    }
+  }
+}
+BENCHMARK(BM_EmbeddingPostprocessor)->Apply(EmbeddingPostprocessorArgs);
+
+}  // namespace
+}  // namespace processor
+}  // namespace task
+}  // namespace tflite
+
+BENCHMARK_MAIN();
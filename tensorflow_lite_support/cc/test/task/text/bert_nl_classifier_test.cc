@@ -201,6 +201,82 @@ TEST_F(BertNLClassifierTest, TestNLClassifier_ClassifyLongPositive_notOOB) {
             GetCategoryWithClassName("negative", results)->score);
 }
 
+TEST_F(BertNLClassifierTest, ClassifyBatchMatchesClassify) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BertNLClassifier> classifier,
+      BertNLClassifier::CreateFromFile(GetFullPath(kTestModelPath)));
+  const std::vector<std::string> reviews = {
+      "unflinchingly bleak and desperate",
+      "it's a charming and often affecting journey",
+      "the story is thin and the acting is wooden",
+      "a delightful , funny and moving film",
+  };
+  // More texts than tokenized in one chunk, split into several batches with
+  // a partial last one.
+  std::vector<std::string> texts;
+  for (int i = 0; i < 19; ++i) {
+    std::string text = reviews[i % reviews.size()];
+    for (int j = 0; j < i % 5; ++j) {
+      text += " indeed";
+    }
+    texts.push_back(text);
+  }
+  BertNLClassifier::BatchStats stats;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Category>> results,
+      classifier->ClassifyBatch(texts, /*max_batch_size=*/4, &stats));
+
+  EXPECT_EQ(stats.num_invocations, 5);
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    EXPECT_EQ(results[i], classifier->Classify(texts[i])) << "text #" << i;
+  }
+}
+
+TEST_F(BertNLClassifierTest, ClassifyBatchSucceedsWithEmptyBatch) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BertNLClassifier> classifier,
+      BertNLClassifier::CreateFromFile(GetFullPath(kTestModelPath)));
+  BertNLClassifier::BatchStats stats;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Category>> results,
+      classifier->ClassifyBatch({}, /*max_batch_size=*/4, &stats));
+
+  EXPECT_TRUE(results.empty());
+  EXPECT_EQ(stats.num_invocations, 0);
+}
+
+// The test model has a static sequence dimension: the dynamic sequence length
+// options are ignored and inputs of any length keep being padded, with the
+// same results. Resizing itself is covered by bert_preprocessor_test.
+TEST_F(BertNLClassifierTest, ClassifySucceedsWithDynamicSeqLenOptions) {
+  BertNLClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelPath));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BertNLClassifier> classifier,
+                               BertNLClassifier::CreateFromOptions(options));
+  options.mutable_bert_preprocessor_options()->set_dynamic_seq_len(true);
+  options.mutable_bert_preprocessor_options()->set_max_seq_len(kMaxSeqLen);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BertNLClassifier> dynamic_classifier,
+      BertNLClassifier::CreateFromOptions(options));
+  const std::string short_text = "unflinchingly bleak and desperate";
+  std::stringstream long_text;
+  long_text << "it's a charming and often affecting journey";
+  for (int i = 0; i < kMaxSeqLen; ++i) {
+    long_text << " long";
+  }
+
+  // Short input, input at the maximum sequence length, then short input again.
+  for (const std::string& text : {short_text, long_text.str(), short_text}) {
+    std::vector<Category> expected = classifier->Classify(text);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(dynamic_classifier->Classify(text), expected);
+  }
+}
+
 }  // namespace
 
 }  // namespace text
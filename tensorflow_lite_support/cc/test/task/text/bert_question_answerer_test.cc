@@ -233,6 +233,43 @@ TEST_F(BertQuestionAnswererTest,
                   TfLiteSupportStatus::kMetadataInvalidTokenizerError))));
 }
 
+// The test model has a static sequence dimension: the dynamic sequence length
+// options are ignored and inputs of any length keep being padded, with the
+// same results. Resizing itself is covered by bert_preprocessor_test.
+TEST_F(BertQuestionAnswererTest, AnswerSucceedsWithDynamicSeqLenOptions) {
+  BertQuestionAnswererOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestMobileBertWithMetadataModelPath));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<QuestionAnswerer> question_answerer,
+      BertQuestionAnswerer::CreateFromOptions(options));
+  options.mutable_bert_preprocessor_options()->set_dynamic_seq_len(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<QuestionAnswerer> dynamic_question_answerer,
+      BertQuestionAnswerer::CreateFromOptions(options));
+  const std::string short_context =
+      "Teachers may use a lesson plan to facilitate student learning, "
+      "providing a course of study which is called the curriculum.";
+  // Long enough to be truncated to the maximum sequence length.
+  const std::string long_context =
+      absl::StrCat(kContext, " ", kContext, " ", kContext);
+
+  // Short input, input at the maximum sequence length, then short input again.
+  for (const std::string& context :
+       {short_context, long_context, short_context}) {
+    std::vector<QaAnswer> expected =
+        question_answerer->Answer(context, kQuestion);
+    std::vector<QaAnswer> answer =
+        dynamic_question_answerer->Answer(context, kQuestion);
+    ASSERT_EQ(answer.size(), expected.size());
+    ASSERT_FALSE(answer.empty());
+    for (int i = 0; i < answer.size(); ++i) {
+      EXPECT_EQ(answer[i].text, expected[i].text);
+      EXPECT_NEAR(answer[i].pos.logit, expected[i].pos.logit, 1e-4);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace text
 }  // namespace task
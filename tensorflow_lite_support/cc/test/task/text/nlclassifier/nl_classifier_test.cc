@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/text/nlclassifier/nl_classifier.h"
 
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/strings/str_cat.h"  // from @com_google_absl
 #include "tensorflow/lite/core/shims/cc/shims_test_util.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/string_util.h"
@@ -36,6 +39,7 @@ namespace text {
 namespace nlclassifier {
 namespace {
 
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 using ::testing::Optional;
 using ::testing::TestWithParam;
@@ -287,6 +291,121 @@ TEST_F(ProtoOptionsTest, TestInferenceWithAssociatedLabelBuiltinOps) {
   EXPECT_THAT(results, UnorderedElementsAreArray(expected_class));
 }
 
+TEST_F(ProtoOptionsTest, TestInferenceWithMaxResults) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithLabelBuiltInOpsPath));
+  options.set_max_results(1);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NLClassifier> classifier,
+                       NLClassifier::CreateFromOptions(options));
+  std::vector<core::Category> results = classifier->Classify(kInputStr);
+  std::vector<core::Category> expected_class = {
+      {"Positive", 0.50667881965637207},
+  };
+
+  EXPECT_THAT(results, ElementsAreArray(expected_class));
+}
+
+TEST_F(ProtoOptionsTest, TestInferenceWithScoreThreshold) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithLabelBuiltInOpsPath));
+  options.set_score_threshold(0.5);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NLClassifier> classifier,
+                       NLClassifier::CreateFromOptions(options));
+  std::vector<core::Category> results = classifier->Classify(kInputStr);
+  std::vector<core::Category> expected_class = {
+      {"Positive", 0.50667881965637207},
+  };
+
+  EXPECT_THAT(results, ElementsAreArray(expected_class));
+}
+
+TEST_F(ProtoOptionsTest, CreateFromOptionsFailsWithZeroMaxResults) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithLabelBuiltInOpsPath));
+  options.set_max_results(0);
+  StatusOr<std::unique_ptr<NLClassifier>> nl_classifier_or =
+      NLClassifier::CreateFromOptions(options);
+
+  EXPECT_EQ(nl_classifier_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(nl_classifier_or.status().message(),
+              HasSubstr("Invalid `max_results` option"));
+}
+
+// Returns `num_texts` texts of various lengths, alternating positive and
+// negative reviews.
+std::vector<std::string> CreateBatchTexts(int num_texts) {
+  std::vector<std::string> texts;
+  for (int i = 0; i < num_texts; ++i) {
+    std::string text = i % 2 == 0 ? kPositiveInput : kNegativeInput;
+    for (int j = 0; j < i % 7; ++j) {
+      absl::StrAppend(&text, " really");
+    }
+    texts.push_back(std::move(text));
+  }
+  return texts;
+}
+
+TEST_F(ProtoOptionsTest, ClassifyBatchMatchesClassify) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithRegexTokenizer));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NLClassifier> classifier,
+                               NLClassifier::CreateFromOptions(options));
+  // More texts than tokenized in one chunk, split into several batches with
+  // a partial last one.
+  const std::vector<std::string> texts = CreateBatchTexts(/*num_texts=*/37);
+  NLClassifier::BatchStats stats;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<core::Category>> results,
+      classifier->ClassifyBatch(texts, /*max_batch_size=*/8, &stats));
+
+  EXPECT_EQ(stats.num_invocations, 5);
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    EXPECT_THAT(results[i], ElementsAreArray(classifier->Classify(texts[i])))
+        << "text #" << i;
+  }
+  // The input tensors are restored after the batch.
+  EXPECT_THAT(classifier->Classify(kPositiveInput),
+              UnorderedElementsAreArray(GetExpectedResultsOfPositiveInput()));
+}
+
+TEST_F(ProtoOptionsTest, ClassifyBatchSucceedsWithEmptyBatch) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithRegexTokenizer));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NLClassifier> classifier,
+                               NLClassifier::CreateFromOptions(options));
+  NLClassifier::BatchStats stats;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<core::Category>> results,
+      classifier->ClassifyBatch({}, /*max_batch_size=*/8, &stats));
+
+  EXPECT_TRUE(results.empty());
+  EXPECT_EQ(stats.num_invocations, 0);
+}
+
+TEST_F(ProtoOptionsTest, ClassifyBatchFailsWithZeroMaxBatchSize) {
+  NLClassifierProtoOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetFullPath(kTestModelWithRegexTokenizer));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<NLClassifier> classifier,
+                               NLClassifier::CreateFromOptions(options));
+
+  StatusOr<std::vector<std::vector<core::Category>>> results_or =
+      classifier->ClassifyBatch({kInputStr}, /*max_batch_size=*/0);
+
+  EXPECT_EQ(results_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(results_or.status().message(),
+              HasSubstr("Expected a positive max_batch_size"));
+}
+
 // Parameterized test.
 struct ProtoOptionsTestParamToString {
   std::string operator()(
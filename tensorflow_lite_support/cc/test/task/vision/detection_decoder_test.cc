@@ -0,0 +1,289 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/detection_decoder.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/raw_detection_options_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+
+constexpr float kTolerance = 1e-5;
+
+float Logit(float probability) {
+  return std::log(probability / (1 - probability));
+}
+
+TEST(GenerateSsdAnchorsTest, Succeeds) {
+  SsdAnchorsOptions options;
+  options.add_feature_map_sizes(2);
+  options.add_feature_map_sizes(1);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<Anchor> anchors,
+                               GenerateSsdAnchors(options));
+
+  // 2x2 locations with 3 anchors in the lowest layer, then 1 location with 5
+  // aspect ratios plus the interpolated scale.
+  ASSERT_EQ(anchors.size(), 18);
+  EXPECT_NEAR(anchors[0].y_center, 0.25, kTolerance);
+  EXPECT_NEAR(anchors[0].x_center, 0.25, kTolerance);
+  EXPECT_NEAR(anchors[0].height, 0.1, kTolerance);
+  EXPECT_NEAR(anchors[0].width, 0.1, kTolerance);
+  // Second anchor at the first location: scale 0.2, aspect ratio 2.
+  EXPECT_NEAR(anchors[1].height, 0.2 / std::sqrt(2), kTolerance);
+  EXPECT_NEAR(anchors[1].width, 0.2 * std::sqrt(2), kTolerance);
+  // Next location is on the same row.
+  EXPECT_NEAR(anchors[3].y_center, 0.25, kTolerance);
+  EXPECT_NEAR(anchors[3].x_center, 0.75, kTolerance);
+  // Last anchor: interpolated scale between 0.95 and 1.
+  EXPECT_NEAR(anchors[17].y_center, 0.5, kTolerance);
+  EXPECT_NEAR(anchors[17].height, std::sqrt(0.95), kTolerance);
+  EXPECT_NEAR(anchors[17].width, std::sqrt(0.95), kTolerance);
+}
+
+TEST(GenerateSsdAnchorsTest, FailsWithoutFeatureMapSizes) {
+  StatusOr<std::vector<Anchor>> anchors =
+      GenerateSsdAnchors(SsdAnchorsOptions());
+
+  EXPECT_EQ(anchors.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(anchors.status().message(), HasSubstr("feature_map_sizes"));
+}
+
+TEST(ParseAnchorsTest, Succeeds) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<Anchor> anchors,
+      ParseAnchors("0.1, 0.2, 0.3, 0.4\n\n0.5 0.6 0.7 0.8\n"));
+
+  ASSERT_EQ(anchors.size(), 2);
+  EXPECT_FLOAT_EQ(anchors[0].y_center, 0.1);
+  EXPECT_FLOAT_EQ(anchors[0].width, 0.4);
+  EXPECT_FLOAT_EQ(anchors[1].x_center, 0.6);
+  EXPECT_FLOAT_EQ(anchors[1].height, 0.7);
+}
+
+TEST(ParseAnchorsTest, FailsWithInvalidLine) {
+  StatusOr<std::vector<Anchor>> anchors = ParseAnchors("0.1 0.2 0.3\n");
+
+  EXPECT_EQ(anchors.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(anchors.status().message(), HasSubstr("line 1"));
+}
+
+class DetectionDecoderTest : public ::testing::Test {
+ protected:
+  DetectionDecoderTest() {
+    options_.set_box_coding(RawDetectionOptions::BOUNDARIES);
+    options_.set_score_activation(RawDetectionOptions::NONE);
+  }
+
+  RawDetectionOptions options_;
+  // Boxes 0 and 1 overlap with an IoU of 0.9, box 2 is disjoint from both.
+  const std::vector<float> boxes_ = {
+      0.0, 0.0, 0.5, 0.5,  //
+      0.0, 0.0, 0.5, 0.45,  //
+      0.5, 0.5, 1.0, 1.0,  //
+  };
+};
+
+TEST_F(DetectionDecoderTest, SuppressesOverlappingBoxesPerClass) {
+  // Two classes.
+  const std::vector<float> scores = {
+      0.9, 0.1,  //
+      0.8, 0.7,  //
+      0.2, 0.6,  //
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/3,
+                               /*num_classes=*/2, /*single_output=*/false));
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(boxes_.data(), scores.data(),
+                                    /*score_threshold=*/0.5,
+                                    /*max_detections=*/-1, &detections));
+
+  // Box 1 is suppressed by box 0 in class 0, but not in class 1.
+  ASSERT_EQ(detections.size(), 3);
+  EXPECT_EQ(detections[0].class_index, 0);
+  EXPECT_FLOAT_EQ(detections[0].score, 0.9);
+  EXPECT_FLOAT_EQ(detections[0].xmax, 0.5);
+  EXPECT_EQ(detections[1].class_index, 1);
+  EXPECT_FLOAT_EQ(detections[1].score, 0.7);
+  EXPECT_FLOAT_EQ(detections[1].xmax, 0.45);
+  EXPECT_EQ(detections[2].class_index, 1);
+  EXPECT_FLOAT_EQ(detections[2].score, 0.6);
+  EXPECT_FLOAT_EQ(detections[2].ymin, 0.5);
+}
+
+TEST_F(DetectionDecoderTest, SuppressesOverlappingBoxesAcrossClasses) {
+  options_.set_class_agnostic_nms(true);
+  const std::vector<float> scores = {
+      0.9, 0.1,  //
+      0.8, 0.7,  //
+      0.2, 0.6,  //
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/3,
+                               /*num_classes=*/2, /*single_output=*/false));
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(boxes_.data(), scores.data(),
+                                    /*score_threshold=*/0.5,
+                                    /*max_detections=*/-1, &detections));
+
+  ASSERT_EQ(detections.size(), 2);
+  EXPECT_EQ(detections[0].class_index, 0);
+  EXPECT_FLOAT_EQ(detections[0].score, 0.9);
+  EXPECT_EQ(detections[1].class_index, 1);
+  EXPECT_FLOAT_EQ(detections[1].score, 0.6);
+}
+
+TEST_F(DetectionDecoderTest, HonorsMaxDetectionsAndAllowedClasses) {
+  const std::vector<float> scores = {
+      0.9, 0.1,  //
+      0.8, 0.7,  //
+      0.2, 0.6,  //
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/3,
+                               /*num_classes=*/2, /*single_output=*/false));
+  decoder->SetAllowedClasses({false, true});
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(boxes_.data(), scores.data(),
+                                    /*score_threshold=*/0.5,
+                                    /*max_detections=*/1, &detections));
+
+  ASSERT_EQ(detections.size(), 1);
+  EXPECT_EQ(detections[0].class_index, 1);
+  EXPECT_FLOAT_EQ(detections[0].score, 0.7);
+}
+
+TEST_F(DetectionDecoderTest, DecodesAnchorsWithSigmoidScores) {
+  options_.set_box_coding(RawDetectionOptions::CENTER_SIZE_WITH_ANCHORS);
+  options_.set_score_activation(RawDetectionOptions::SIGMOID);
+  const std::vector<Anchor> anchors = {{0.5, 0.5, 0.2, 0.4},
+                                       {0.2, 0.2, 0.1, 0.1}};
+  // The first box is shifted down by half the anchor height, and twice as
+  // wide; the second one is below the score threshold.
+  const std::vector<float> boxes = {
+      5.0, 0.0, 0.0, 5.0 * std::log(2.0f),  //
+      0.0, 0.0, 0.0, 0.0,                   //
+  };
+  const std::vector<float> scores = {Logit(0.8), Logit(0.3)};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, anchors, /*num_boxes=*/2,
+                               /*num_classes=*/1, /*single_output=*/false));
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(boxes.data(), scores.data(),
+                                    /*score_threshold=*/0.5,
+                                    /*max_detections=*/-1, &detections));
+
+  ASSERT_EQ(detections.size(), 1);
+  EXPECT_NEAR(detections[0].score, 0.8, kTolerance);
+  EXPECT_NEAR(detections[0].ymin, 0.5, kTolerance);
+  EXPECT_NEAR(detections[0].ymax, 0.7, kTolerance);
+  EXPECT_NEAR(detections[0].xmin, 0.1, kTolerance);
+  EXPECT_NEAR(detections[0].xmax, 0.9, kTolerance);
+}
+
+TEST_F(DetectionDecoderTest, DecodesSingleOutputWithObjectness) {
+  options_.set_box_coding(RawDetectionOptions::CENTER_SIZE);
+  // Boxes as [x_center, y_center, width, height].
+  options_.add_box_index(1);
+  options_.add_box_index(0);
+  options_.add_box_index(3);
+  options_.add_box_index(2);
+  options_.set_has_objectness_score(true);
+  // Boxes, objectness, then scores for 2 classes.
+  const std::vector<float> output = {
+      0.5, 0.25, 0.2, 0.1, 0.5, 0.4, 0.9,  //
+      0.5, 0.5,  0.2, 0.2, 0.9, 0.8, 0.1,  //
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/2,
+                               /*num_classes=*/2, /*single_output=*/true));
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(output.data(), output.data(),
+                                    /*score_threshold=*/0.6,
+                                    /*max_detections=*/-1, &detections));
+
+  // The first box is pruned by its objectness.
+  ASSERT_EQ(detections.size(), 1);
+  EXPECT_EQ(detections[0].class_index, 0);
+  EXPECT_NEAR(detections[0].score, 0.72, kTolerance);
+  EXPECT_NEAR(detections[0].ymin, 0.4, kTolerance);
+  EXPECT_NEAR(detections[0].xmin, 0.4, kTolerance);
+}
+
+TEST_F(DetectionDecoderTest, SkipsBackgroundClassWithSoftmaxScores) {
+  options_.set_score_activation(RawDetectionOptions::SOFTMAX);
+  options_.set_has_background_class(true);
+  // Background, then 2 classes.
+  const std::vector<float> scores = {
+      0.0, std::log(3.0f), 0.0,  //
+      std::log(8.0f), 0.0, 0.0,  //
+      0.0, 0.0, std::log(2.0f),  //
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionDecoder> decoder,
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/3,
+                               /*num_classes=*/3, /*single_output=*/false));
+  std::vector<RawDetection> detections;
+
+  SUPPORT_ASSERT_OK(decoder->Decode(boxes_.data(), scores.data(),
+                                    /*score_threshold=*/0.4,
+                                    /*max_detections=*/-1, &detections));
+
+  ASSERT_EQ(detections.size(), 2);
+  EXPECT_EQ(detections[0].class_index, 0);
+  EXPECT_NEAR(detections[0].score, 0.6, kTolerance);
+  EXPECT_EQ(detections[1].class_index, 1);
+  EXPECT_NEAR(detections[1].score, 0.5, kTolerance);
+}
+
+TEST_F(DetectionDecoderTest, FailsWithMissingAnchors) {
+  options_.set_box_coding(RawDetectionOptions::CENTER_SIZE_WITH_ANCHORS);
+
+  StatusOr<std::unique_ptr<DetectionDecoder>> decoder =
+      DetectionDecoder::Create(options_, {}, /*num_boxes=*/3,
+                               /*num_classes=*/2, /*single_output=*/false);
+
+  EXPECT_EQ(decoder.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(decoder.status().message(), HasSubstr("one anchor per box"));
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
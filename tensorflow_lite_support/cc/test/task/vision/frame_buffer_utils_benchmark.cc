@@ -0,0 +1,290 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the FrameBufferUtils operations used by the vision tasks
+// to preprocess camera frames, across pixel formats and frame sizes.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/cc/test/task/vision:frame_buffer_utils_benchmark
+//
+// Append `-- --benchmark_out=<file> --benchmark_out_format=json` to write the
+// results in a machine-readable form, e.g. to track regressions over time.
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+// Size of the frames produced by the resize and preprocess benchmarks, i.e.
+// the input size of most vision models.
+constexpr int kModelInputSize = 224;
+
+const char* FormatName(FrameBuffer::Format format) {
+  switch (format) {
+    case FrameBuffer::Format::kRGBA:
+      return "RGBA";
+    case FrameBuffer::Format::kRGB:
+      return "RGB";
+    case FrameBuffer::Format::kNV12:
+      return "NV12";
+    case FrameBuffer::Format::kNV21:
+      return "NV21";
+    case FrameBuffer::Format::kYV12:
+      return "YV12";
+    case FrameBuffer::Format::kYV21:
+      return "YV21";
+    case FrameBuffer::Format::kGRAY:
+      return "GRAY";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+// A frame along with its backing buffer, filled with a gradient so that the
+// libyuv code paths see realistic (non-constant) data.
+struct Frame {
+  std::vector<uint8_t> data;
+  std::unique_ptr<FrameBuffer> buffer;
+};
+
+std::unique_ptr<Frame> CreateFrame(FrameBuffer::Dimension dimension,
+                                   FrameBuffer::Format format,
+                                   FrameBuffer::Orientation orientation =
+                                       FrameBuffer::Orientation::kTopLeft) {
+  auto frame = absl::make_unique<Frame>();
+  frame->data.resize(GetFrameBufferByteSize(dimension, format));
+  for (size_t i = 0; i < frame->data.size(); ++i) {
+    frame->data[i] = static_cast<uint8_t>(i * 7 + i / dimension.width);
+  }
+  auto buffer =
+      CreateFromRawBuffer(frame->data.data(), dimension, format, orientation);
+  if (!buffer.ok()) {
+    return nullptr;
+  }
+  frame->buffer = std::move(buffer).value();
+  return frame;
+}
+
+FrameBuffer::Format GetFormat(const benchmark::State& state, int index) {
+  return static_cast<FrameBuffer::Format>(state.range(index));
+}
+
+FrameBuffer::Dimension GetDimension(const benchmark::State& state, int index) {
+  return {static_cast<int>(state.range(index)),
+          static_cast<int>(state.range(index + 1))};
+}
+
+// Runs `operation` against an input and output frame until the benchmark is
+// done, reporting the input bytes processed per second.
+template <typename Operation>
+void RunBenchmark(benchmark::State& state, const Frame& input, Frame* output,
+                  Operation operation) {
+  std::unique_ptr<FrameBufferUtils> utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+  if (!operation(*utils, *input.buffer, output->buffer.get()).ok()) {
+    state.SkipWithError("Operation failed.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        operation(*utils, *input.buffer, output->buffer.get()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.data.size());
+}
+
+// Arguments are the input format, width and height, and the output format.
+void BM_Convert(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetDimension(state, 1);
+  auto input = CreateFrame(dimension, GetFormat(state, 0));
+  auto output = CreateFrame(dimension, GetFormat(state, 3));
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(absl::StrCat(FormatName(GetFormat(state, 0)), "->",
+                              FormatName(GetFormat(state, 3))));
+  RunBenchmark(state, *input, output.get(),
+               [](FrameBufferUtils& utils, const FrameBuffer& in,
+                  FrameBuffer* out) { return utils.Convert(in, out); });
+}
+
+void ConvertArgs(benchmark::internal::Benchmark* benchmark) {
+  using Format = FrameBuffer::Format;
+  const std::vector<std::pair<Format, Format>> conversions = {
+      {Format::kRGBA, Format::kRGB},  {Format::kRGB, Format::kGRAY},
+      {Format::kNV12, Format::kRGB},  {Format::kNV21, Format::kRGB},
+      {Format::kNV21, Format::kRGBA}, {Format::kYV12, Format::kRGB},
+      {Format::kNV21, Format::kYV12}, {Format::kNV21, Format::kGRAY},
+  };
+  for (const auto& conversion : conversions) {
+    for (const auto& size : {std::make_pair(640, 480),
+                             std::make_pair(1280, 720),
+                             std::make_pair(1920, 1080)}) {
+      benchmark->Args({static_cast<int>(conversion.first), size.first,
+                       size.second, static_cast<int>(conversion.second)});
+    }
+  }
+}
+
+// Arguments are the format, width and height of the input, resized to the
+// input size of a typical model.
+void BM_Resize(benchmark::State& state) {
+  auto input = CreateFrame(GetDimension(state, 1), GetFormat(state, 0));
+  auto output =
+      CreateFrame({kModelInputSize, kModelInputSize}, GetFormat(state, 0));
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(FormatName(GetFormat(state, 0)));
+  RunBenchmark(state, *input, output.get(),
+               [](FrameBufferUtils& utils, const FrameBuffer& in,
+                  FrameBuffer* out) { return utils.Resize(in, out); });
+}
+
+// Arguments are the format, width and height of the input, rotated by 90
+// degrees.
+void BM_Rotate(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetDimension(state, 1);
+  FrameBuffer::Dimension rotated_dimension = dimension;
+  rotated_dimension.Swap();
+  auto input = CreateFrame(dimension, GetFormat(state, 0));
+  auto output = CreateFrame(rotated_dimension, GetFormat(state, 0));
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(FormatName(GetFormat(state, 0)));
+  RunBenchmark(state, *input, output.get(),
+               [](FrameBufferUtils& utils, const FrameBuffer& in,
+                  FrameBuffer* out) {
+                 return utils.Rotate(
+                     in, FrameBufferUtils::RotationDegree::k90, out);
+               });
+}
+
+// Arguments are the format, width and height of the input, of which the
+// central region of half the size is cropped.
+void BM_Crop(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetDimension(state, 1);
+  auto input = CreateFrame(dimension, GetFormat(state, 0));
+  auto output = CreateFrame({dimension.width / 2, dimension.height / 2},
+                            GetFormat(state, 0));
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(FormatName(GetFormat(state, 0)));
+  const int x0 = dimension.width / 4;
+  const int y0 = dimension.height / 4;
+  RunBenchmark(state, *input, output.get(),
+               [&](FrameBufferUtils& utils, const FrameBuffer& in,
+                   FrameBuffer* out) {
+                 return utils.Crop(in, x0, y0, x0 + dimension.width / 2 - 1,
+                                   y0 + dimension.height / 2 - 1, out);
+               });
+}
+
+// Arguments are the format, width and height of the input.
+void BM_FlipHorizontally(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetDimension(state, 1);
+  auto input = CreateFrame(dimension, GetFormat(state, 0));
+  auto output = CreateFrame(dimension, GetFormat(state, 0));
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(FormatName(GetFormat(state, 0)));
+  RunBenchmark(state, *input, output.get(),
+               [](FrameBufferUtils& utils, const FrameBuffer& in,
+                  FrameBuffer* out) {
+                 return utils.FlipHorizontally(in, out);
+               });
+}
+
+// Arguments are the format, width and height of a camera frame in landscape
+// orientation, preprocessed into an upright RGB image at the input size of a
+// typical model, as done by the vision tasks.
+void BM_Preprocess(benchmark::State& state) {
+  auto input = CreateFrame(GetDimension(state, 1), GetFormat(state, 0),
+                           FrameBuffer::Orientation::kRightTop);
+  auto output = CreateFrame({kModelInputSize, kModelInputSize},
+                            FrameBuffer::Format::kRGB);
+  if (input == nullptr || output == nullptr) {
+    state.SkipWithError("Failed to create frames.");
+    return;
+  }
+  state.SetLabel(FormatName(GetFormat(state, 0)));
+  RunBenchmark(state, *input, output.get(),
+               [](FrameBufferUtils& utils, const FrameBuffer& in,
+                  FrameBuffer* out) {
+                 return utils.Preprocess(in, /*bounding_box=*/absl::nullopt,
+                                         out);
+               });
+}
+
+// Arguments are the format, width and height of the input, for the given
+// formats.
+void FormatAndSizeArgs(benchmark::internal::Benchmark* benchmark,
+                       const std::vector<FrameBuffer::Format>& formats) {
+  for (FrameBuffer::Format format : formats) {
+    for (const auto& size : {std::make_pair(640, 480),
+                             std::make_pair(1280, 720),
+                             std::make_pair(1920, 1080)}) {
+      benchmark->Args({static_cast<int>(format), size.first, size.second});
+    }
+  }
+}
+
+void AllFormatsArgs(benchmark::internal::Benchmark* benchmark) {
+  using Format = FrameBuffer::Format;
+  FormatAndSizeArgs(benchmark, {Format::kRGBA, Format::kRGB, Format::kNV21,
+                                Format::kYV12, Format::kGRAY});
+}
+
+// Grayscale frames can't be converted to RGB.
+void ColorFormatsArgs(benchmark::internal::Benchmark* benchmark) {
+  using Format = FrameBuffer::Format;
+  FormatAndSizeArgs(benchmark, {Format::kRGBA, Format::kRGB, Format::kNV21,
+                                Format::kYV12});
+}
+
+BENCHMARK(BM_Convert)->Apply(ConvertArgs);
+BENCHMARK(BM_Resize)->Apply(AllFormatsArgs);
+BENCHMARK(BM_Rotate)->Apply(AllFormatsArgs);
+BENCHMARK(BM_Crop)->Apply(AllFormatsArgs);
+BENCHMARK(BM_FlipHorizontally)->Apply(AllFormatsArgs);
+BENCHMARK(BM_Preprocess)->Apply(ColorFormatsArgs);
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+BENCHMARK_MAIN();
@@ -0,0 +1,224 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+
+#include <cstdlib>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::testing::Combine;
+using ::testing::Values;
+
+constexpr int kWidth = 40;
+constexpr int kHeight = 30;
+constexpr int kUvWidth = kWidth / 2;
+constexpr int kUvHeight = kHeight / 2;
+
+// Maximum absolute difference allowed between the single pass and the chained
+// operations, for each of the R, G, B and A channels. Both paths interpolate
+// luma bilinearly, but the chained operations resample the subsampled chroma
+// planes at each step (from an origin rounded down to an even pixel for odd
+// crops), while the single pass samples the nearest source chroma. On the
+// smooth test frame, this amounts to a few intensity levels once converted to
+// RGB, the most for NV12 and NV21 frames resized to odd sizes. Alpha is always
+// opaque.
+constexpr int kMaxChannelDifference[] = {8, 6, 8, 0};
+
+// Crop and resize applied before orientation.
+struct CropResize {
+  absl::optional<BoundingBox> crop;
+  FrameBuffer::Dimension resize_dimension;
+};
+
+BoundingBox CreateBoundingBox(int origin_x, int origin_y, int width,
+                              int height) {
+  BoundingBox box;
+  box.set_origin_x(origin_x);
+  box.set_origin_y(origin_y);
+  box.set_width(width);
+  box.set_height(height);
+  return box;
+}
+
+std::vector<CropResize> GetCropResizes() {
+  return {
+      // Orientation and conversion only.
+      {absl::nullopt, {kWidth, kHeight}},
+      // Resize only, to an odd size.
+      {absl::nullopt, {23, 17}},
+      // Crop with odd origin and size.
+      {CreateBoundingBox(3, 5, 21, 17), {21, 17}},
+      // Crop and downscale.
+      {CreateBoundingBox(7, 3, 25, 19), {13, 9}},
+      // Crop and upscale.
+      {CreateBoundingBox(1, 1, 15, 11), {31, 23}},
+  };
+}
+
+class FrameBufferUtilsYuvTest
+    : public ::testing::TestWithParam<
+          std::tuple<FrameBuffer::Format, FrameBuffer::Orientation,
+                     FrameBuffer::Format>> {
+ protected:
+  void SetUp() override {
+    // Smooth gradients, so that both paths are expected to agree within a few
+    // intensity levels.
+    for (int y = 0; y < kHeight; ++y) {
+      for (int x = 0; x < kWidth; ++x) {
+        y_plane_[y * kWidth + x] = 40 + 3 * x + 2 * y;
+      }
+    }
+    for (int y = 0; y < kUvHeight; ++y) {
+      for (int x = 0; x < kUvWidth; ++x) {
+        u_plane_[y * kUvWidth + x] = 100 + x;
+        v_plane_[y * kUvWidth + x] = 150 - y;
+        // Interleaved chroma, U first for NV12 and V first for NV21.
+        uv_plane_[y * kWidth + 2 * x] = 100 + x;
+        uv_plane_[y * kWidth + 2 * x + 1] = 150 - y;
+        vu_plane_[y * kWidth + 2 * x] = 150 - y;
+        vu_plane_[y * kWidth + 2 * x + 1] = 100 + x;
+      }
+    }
+  }
+
+  std::unique_ptr<FrameBuffer> CreateYuvFrame(
+      FrameBuffer::Format format, FrameBuffer::Orientation orientation) {
+    tflite::support::StatusOr<std::unique_ptr<FrameBuffer>> frame_or;
+    switch (format) {
+      case FrameBuffer::Format::kNV12:
+        frame_or = CreateFromYuvRawBuffer(
+            y_plane_.data(), /*u_plane=*/uv_plane_.data(),
+            /*v_plane=*/uv_plane_.data() + 1, format, {kWidth, kHeight},
+            /*row_stride_y=*/kWidth, /*row_stride_uv=*/kWidth,
+            /*pixel_stride_uv=*/2, orientation);
+        break;
+      case FrameBuffer::Format::kNV21:
+        frame_or = CreateFromYuvRawBuffer(
+            y_plane_.data(), /*u_plane=*/vu_plane_.data() + 1,
+            /*v_plane=*/vu_plane_.data(), format, {kWidth, kHeight},
+            /*row_stride_y=*/kWidth, /*row_stride_uv=*/kWidth,
+            /*pixel_stride_uv=*/2, orientation);
+        break;
+      default:
+        frame_or = CreateFromYuvRawBuffer(
+            y_plane_.data(), u_plane_.data(), v_plane_.data(), format,
+            {kWidth, kHeight}, /*row_stride_y=*/kWidth,
+            /*row_stride_uv=*/kUvWidth, /*pixel_stride_uv=*/1, orientation);
+        break;
+    }
+    EXPECT_TRUE(frame_or.ok());
+    return std::move(frame_or).value();
+  }
+
+  std::vector<uint8> y_plane_ = std::vector<uint8>(kWidth * kHeight);
+  std::vector<uint8> u_plane_ = std::vector<uint8>(kUvWidth * kUvHeight);
+  std::vector<uint8> v_plane_ = std::vector<uint8>(kUvWidth * kUvHeight);
+  std::vector<uint8> uv_plane_ = std::vector<uint8>(kWidth * kUvHeight);
+  std::vector<uint8> vu_plane_ = std::vector<uint8>(kWidth * kUvHeight);
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    Default, FrameBufferUtilsYuvTest,
+    Combine(Values(FrameBuffer::Format::kNV12, FrameBuffer::Format::kNV21,
+                   FrameBuffer::Format::kYV12),
+            Values(FrameBuffer::Orientation::kTopLeft,
+                   FrameBuffer::Orientation::kTopRight,
+                   FrameBuffer::Orientation::kBottomRight,
+                   FrameBuffer::Orientation::kBottomLeft,
+                   FrameBuffer::Orientation::kLeftTop,
+                   FrameBuffer::Orientation::kRightTop,
+                   FrameBuffer::Orientation::kRightBottom,
+                   FrameBuffer::Orientation::kLeftBottom),
+            Values(FrameBuffer::Format::kRGB, FrameBuffer::Format::kRGBA)));
+
+// Preprocess crops, resizes, orients and converts rotated YUV frames in a
+// single pass. Checks it against the chained operations it replaces.
+TEST_P(FrameBufferUtilsYuvTest, PreprocessMatchesChainedOperations) {
+  FrameBuffer::Format input_format;
+  FrameBuffer::Orientation input_orientation;
+  FrameBuffer::Format output_format;
+  std::tie(input_format, input_orientation, output_format) = GetParam();
+  std::unique_ptr<FrameBuffer> input =
+      CreateYuvFrame(input_format, input_orientation);
+  const int channels = output_format == FrameBuffer::Format::kRGBA ? 4 : 3;
+  FrameBufferUtils utils(FrameBufferUtils::ProcessEngine::kLibyuv);
+
+  for (const CropResize& crop_resize : GetCropResizes()) {
+    FrameBuffer::Dimension output_dimension = crop_resize.resize_dimension;
+    if (RequireDimensionSwap(input_orientation,
+                             FrameBuffer::Orientation::kTopLeft)) {
+      output_dimension.Swap();
+    }
+    const int output_size = output_dimension.Size() * channels;
+    std::vector<uint8> preprocessed(output_size);
+    std::vector<uint8> chained(output_size);
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<FrameBuffer> preprocessed_buffer,
+        CreateFromRawBuffer(preprocessed.data(), output_dimension,
+                            output_format));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<FrameBuffer> chained_buffer,
+        CreateFromRawBuffer(chained.data(), output_dimension, output_format));
+
+    SUPPORT_ASSERT_OK(utils.Preprocess(*input, crop_resize.crop,
+                                       preprocessed_buffer.get()));
+
+    std::vector<FrameBufferOperation> operations;
+    if (crop_resize.crop.has_value()) {
+      const BoundingBox& crop = *crop_resize.crop;
+      operations.push_back(CropResizeOperation(
+          crop.origin_x(), crop.origin_y(), {crop.width(), crop.height()},
+          crop_resize.resize_dimension));
+    } else if (crop_resize.resize_dimension != input->dimension()) {
+      operations.push_back(CropResizeOperation(0, 0, input->dimension(),
+                                               crop_resize.resize_dimension));
+    }
+    if (input_orientation != FrameBuffer::Orientation::kTopLeft) {
+      operations.push_back(OrientOperation(FrameBuffer::Orientation::kTopLeft));
+    }
+    operations.push_back(ConvertOperation(output_format));
+    SUPPORT_ASSERT_OK(
+        utils.Execute(*input, operations, chained_buffer.get()));
+
+    for (int i = 0; i < output_size; ++i) {
+      ASSERT_LE(std::abs(preprocessed[i] - chained[i]),
+                kMaxChannelDifference[i % channels])
+          << "pixel (" << (i / channels) % output_dimension.width << ", "
+          << (i / channels) / output_dimension.width << "), channel "
+          << i % channels << ", resize to "
+          << crop_resize.resize_dimension.width << "x"
+          << crop_resize.resize_dimension.height;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,134 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_conversion_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+constexpr int kWidth = 8;
+constexpr int kHeight = 4;
+
+class FrameConversionCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    frame_ = FrameBuffer::Create(
+        {{pixels_.data(), /*stride=*/{kWidth * 3, 3}}}, {kWidth, kHeight},
+        FrameBuffer::Format::kRGB, FrameBuffer::Orientation::kTopLeft,
+        absl::FromUnixMillis(1000));
+    roi_.set_width(kWidth);
+    roi_.set_height(kHeight);
+  }
+
+  FrameConversionKey CreateKey(const FrameBuffer& frame, int output_width) {
+    return FrameConversionKey::Create(frame, roi_, {output_width, 2},
+                                      FrameBuffer::Format::kRGB,
+                                      FrameBuffer::Orientation::kTopLeft);
+  }
+
+  static std::shared_ptr<const std::vector<uint8>> CreateData(int size,
+                                                              uint8 value) {
+    return std::make_shared<const std::vector<uint8>>(size, value);
+  }
+
+  std::vector<uint8> pixels_ = std::vector<uint8>(kWidth * kHeight * 3);
+  std::unique_ptr<FrameBuffer> frame_;
+  BoundingBox roi_;
+};
+
+TEST_F(FrameConversionCacheTest, ReturnsInsertedConversion) {
+  FrameConversionCache cache;
+  const FrameConversionKey key = CreateKey(*frame_, /*output_width=*/2);
+
+  EXPECT_EQ(cache.Lookup(key), nullptr);
+  auto data = CreateData(12, 42);
+  cache.Insert(key, data);
+  EXPECT_EQ(cache.Lookup(key), data);
+  EXPECT_EQ(cache.Lookup(CreateKey(*frame_, /*output_width=*/2)), data);
+
+  EXPECT_EQ(cache.hits(), 2);
+  EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST_F(FrameConversionCacheTest, DistinguishesFramesAndConversions) {
+  FrameConversionCache cache;
+  cache.Insert(CreateKey(*frame_, /*output_width=*/2), CreateData(12, 1));
+
+  // Different output.
+  EXPECT_EQ(cache.Lookup(CreateKey(*frame_, /*output_width=*/4)), nullptr);
+  // Different region of interest.
+  FrameConversionKey key = CreateKey(*frame_, /*output_width=*/2);
+  key.roi_x = 1;
+  EXPECT_EQ(cache.Lookup(key), nullptr);
+  // Same buffer, new timestamp.
+  auto next_frame = FrameBuffer::Create(
+      {{pixels_.data(), /*stride=*/{kWidth * 3, 3}}}, {kWidth, kHeight},
+      FrameBuffer::Format::kRGB, FrameBuffer::Orientation::kTopLeft,
+      absl::FromUnixMillis(1033));
+  EXPECT_EQ(cache.Lookup(CreateKey(*next_frame, /*output_width=*/2)),
+            nullptr);
+  // Same buffer and timestamp, different orientation.
+  auto rotated_frame = FrameBuffer::Create(
+      {{pixels_.data(), /*stride=*/{kWidth * 3, 3}}}, {kWidth, kHeight},
+      FrameBuffer::Format::kRGB, FrameBuffer::Orientation::kRightTop,
+      absl::FromUnixMillis(1000));
+  EXPECT_EQ(cache.Lookup(CreateKey(*rotated_frame, /*output_width=*/2)),
+            nullptr);
+}
+
+TEST_F(FrameConversionCacheTest, EvictsLeastRecentlyUsedConversions) {
+  FrameConversionCache cache(/*max_bytes=*/30);
+  const FrameConversionKey key1 = CreateKey(*frame_, /*output_width=*/1);
+  const FrameConversionKey key2 = CreateKey(*frame_, /*output_width=*/2);
+  const FrameConversionKey key3 = CreateKey(*frame_, /*output_width=*/3);
+  auto data1 = CreateData(10, 1);
+  cache.Insert(key1, data1);
+  cache.Insert(key2, CreateData(10, 2));
+  // Makes `key1` more recently used than `key2`.
+  ASSERT_EQ(cache.Lookup(key1), data1);
+
+  cache.Insert(key3, CreateData(15, 3));
+
+  EXPECT_EQ(cache.Lookup(key2), nullptr);
+  EXPECT_EQ(cache.Lookup(key1), data1);
+  EXPECT_NE(cache.Lookup(key3), nullptr);
+  // Evicted data remains valid for its holders.
+  cache.Clear();
+  EXPECT_EQ(cache.Lookup(key1), nullptr);
+  EXPECT_EQ((*data1)[9], 1);
+}
+
+TEST_F(FrameConversionCacheTest, DoesNotCacheConversionsLargerThanCache) {
+  FrameConversionCache cache(/*max_bytes=*/8);
+  const FrameConversionKey key = CreateKey(*frame_, /*output_width=*/2);
+
+  cache.Insert(key, CreateData(12, 1));
+
+  EXPECT_EQ(cache.Lookup(key), nullptr);
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
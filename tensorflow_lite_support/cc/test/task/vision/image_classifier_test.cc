@@ -27,9 +27,12 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/gmock.h"
 #include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/proto2.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
 #include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
+#include "tensorflow_lite_support/cc/task/core/task_stats.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
@@ -54,6 +57,10 @@ using ::tflite::support::StatusOr;
 using ::tflite::support::TfLiteSupportStatus;
 using ::tflite::task::JoinPath;
 using ::tflite::task::ParseTextProtoOrDie;
+using ::tflite::task::core::InferenceStage;
+using ::tflite::task::core::InitStage;
+using ::tflite::task::core::OpProfiler;
+using ::tflite::task::core::OpSummary;
 using ::tflite::task::core::PopulateTensor;
 using ::tflite::task::core::TaskAPIFactory;
 using ::tflite::task::core::TfLiteEngine;
@@ -231,6 +238,42 @@ TEST_F(CreateFromOptionsTest, FailsWithCombinedWhitelistAndBlacklist) {
                   absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
 }
 
+TEST_F(CreateFromOptionsTest, FailsWithRoiWorkersAndSingleOpResolver) {
+  ImageClassifierOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetQuantizedWithMetadata));
+  options.set_num_roi_workers(2);
+
+  StatusOr<std::unique_ptr<ImageClassifier>> image_classifier_or =
+      ImageClassifier::CreateFromOptions(
+          options, absl::make_unique<MobileNetQuantizedOpResolver>());
+
+  EXPECT_EQ(image_classifier_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(image_classifier_or.status().message(),
+              HasSubstr("OpResolverFactory"));
+  EXPECT_THAT(image_classifier_or.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(
+                  absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
+}
+
+TEST_F(CreateFromOptionsTest, SucceedsWithRoiWorkersAndOpResolverFactory) {
+  ImageClassifierOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetQuantizedWithMetadata));
+  options.set_num_roi_workers(3);
+  int num_op_resolvers = 0;
+
+  SUPPORT_ASSERT_OK(ImageClassifier::CreateFromOptions(
+      options, [&num_op_resolvers]() {
+        ++num_op_resolvers;
+        return absl::make_unique<MobileNetQuantizedOpResolver>();
+      }));
+  EXPECT_EQ(num_op_resolvers, 3);
+}
+
 TEST_F(CreateFromOptionsTest, SucceedsWithNumberOfThreads) {
   ImageClassifierOptions options;
   options.set_num_threads(4);
@@ -346,6 +389,128 @@ TEST(ClassifyTest, SucceedsWithRegionOfInterest) {
                                        )pb"));
 }
 
+TEST(ClassifyTest, SucceedsWithRegionsOfInterest) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("multi_objects.jpg"));
+  const FrameBuffer::Dimension dimension{rgb_image.width, rgb_image.height};
+  std::unique_ptr<FrameBuffer> rgb_frame_buffer =
+      CreateFromRgbRawBuffer(rgb_image.pixel_data, dimension);
+  // Convert to NV21, so that ClassifyRois converts the regions back to RGB.
+  std::vector<uint8> nv21_data(
+      GetBufferByteSize(dimension, FrameBuffer::Format::kNV21));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<FrameBuffer> nv21_frame_buffer,
+      CreateFromRawBuffer(nv21_data.data(), dimension,
+                          FrameBuffer::Format::kNV21));
+  SUPPORT_ASSERT_OK(
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv)
+          ->Convert(*rgb_frame_buffer, nv21_frame_buffer.get()));
+  ImageDataFree(&rgb_image);
+
+  ImageClassifierOptions options;
+  options.set_max_results(1);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetFloatWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                       ImageClassifier::CreateFromOptions(options));
+
+  // Crops around the soccer ball, the second one being slightly larger.
+  std::vector<BoundingBox> rois(2);
+  rois[0].set_origin_x(406);
+  rois[0].set_origin_y(110);
+  rois[0].set_width(148);
+  rois[0].set_height(153);
+  rois[1].set_origin_x(400);
+  rois[1].set_origin_y(104);
+  rois[1].set_width(160);
+  rois[1].set_height(165);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<ClassificationResult> results,
+      image_classifier->ClassifyRois(*nv21_frame_buffer, rois));
+
+  ASSERT_EQ(results.size(), 2);
+  for (const ClassificationResult& result : results) {
+    ASSERT_EQ(result.classifications_size(), 1);
+    ASSERT_EQ(result.classifications(0).classes_size(), 1);
+    EXPECT_EQ(result.classifications(0).classes(0).class_name(),
+              "soccer ball");
+  }
+}
+
+TEST(ClassifyTest, SucceedsWithRegionsOfInterestAndRoiWorkers) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("multi_objects.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+  // More regions than workers, of different sizes.
+  std::vector<BoundingBox> rois(5);
+  for (int i = 0; i < rois.size(); ++i) {
+    rois[i].set_origin_x(20 * i);
+    rois[i].set_origin_y(10 * i);
+    rois[i].set_width(rgb_image.width / (i + 1));
+    rois[i].set_height(rgb_image.height / (i + 1));
+  }
+
+  ImageClassifierOptions options;
+  options.set_max_results(3);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetFloatWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                               ImageClassifier::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      const std::vector<ClassificationResult> expected,
+      image_classifier->ClassifyRois(*frame_buffer, rois));
+
+  options.set_num_roi_workers(2);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(image_classifier,
+                               ImageClassifier::CreateFromOptions(options));
+  // Several calls, so that the workers classify different regions.
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        const std::vector<ClassificationResult> results,
+        image_classifier->ClassifyRois(*frame_buffer, rois));
+    ASSERT_EQ(results.size(), expected.size());
+    for (int j = 0; j < results.size(); ++j) {
+      ExpectApproximatelyEqual(results[j], expected[j]);
+    }
+  }
+  ImageDataFree(&rgb_image);
+}
+
+TEST(ClassifyTest, FailsWithRegionOfInterestOutOfBounds) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("multi_objects.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageClassifierOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetFloatWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                       ImageClassifier::CreateFromOptions(options));
+
+  std::vector<BoundingBox> rois(2);
+  rois[0].set_width(10);
+  rois[0].set_height(10);
+  rois[1].set_origin_x(rgb_image.width - 5);
+  rois[1].set_width(10);
+  rois[1].set_height(10);
+
+  StatusOr<std::vector<ClassificationResult>> results =
+      image_classifier->ClassifyRois(*frame_buffer, rois);
+  ImageDataFree(&rgb_image);
+
+  EXPECT_EQ(results.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(results.status().message(),
+              HasSubstr("Region of interest at index 1"));
+  EXPECT_THAT(results.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(
+                  absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
+}
+
 TEST(ClassifyTest, SucceedsWithQuantizedModel) {
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("burger.jpg"));
   std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
@@ -383,6 +548,136 @@ TEST(ClassifyTest, SucceedsWithQuantizedModel) {
           )pb"));
 }
 
+TEST(ClassifyTest, ClassifyIntoRecyclesResult) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+  BoundingBox roi;
+  roi.set_width(rgb_image.width);
+  roi.set_height(rgb_image.height);
+
+  ImageClassifierOptions options;
+  options.set_max_results(3);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetQuantizedWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                       ImageClassifier::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const ClassificationResult expected,
+                       image_classifier->Classify(*frame_buffer));
+
+  // Stale results are cleared.
+  ClassificationResult result = ParseTextProtoOrDie<ClassificationResult>(
+      R"pb(classifications {
+             classes { index: 1 score: 0.5 display_name: "stale" }
+             head_index: 3
+           }
+           classifications { head_index: 4 }
+      )pb");
+  SUPPORT_ASSERT_OK(image_classifier->ClassifyInto(*frame_buffer, roi, &result));
+  ExpectApproximatelyEqual(result, expected);
+  const Class* first_class = &result.classifications(0).classes(0);
+  SUPPORT_ASSERT_OK(image_classifier->ClassifyInto(*frame_buffer, roi, &result));
+  ExpectApproximatelyEqual(result, expected);
+  EXPECT_EQ(&result.classifications(0).classes(0), first_class);
+
+  tflite::support::proto::Arena arena;
+  ClassificationResult* arena_result =
+      tflite::support::proto::Arena::CreateMessage<ClassificationResult>(
+          &arena);
+  SUPPORT_ASSERT_OK(
+      image_classifier->ClassifyInto(*frame_buffer, roi, arena_result));
+  ExpectApproximatelyEqual(*arena_result, expected);
+  EXPECT_EQ(arena_result->classifications(0).classes(0).GetArena(), &arena);
+  ImageDataFree(&rgb_image);
+}
+
+TEST(ClassifyTest, RecordsLatencyStats) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageClassifierOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetQuantizedWithMetadata));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                       ImageClassifier::CreateFromOptions(options));
+  for (InitStage stage :
+       {InitStage::kLoadModel, InitStage::kVerifyAndBuildModel,
+        InitStage::kExtractMetadata, InitStage::kBuildInterpreter,
+        InitStage::kAllocateTensors}) {
+    EXPECT_EQ(image_classifier->GetStats().GetInitSummary(stage).count, 1);
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_ASSERT_OK(image_classifier->Classify(*frame_buffer));
+  }
+  for (InferenceStage stage :
+       {InferenceStage::kPreprocess, InferenceStage::kInvoke,
+        InferenceStage::kPostprocess, InferenceStage::kTotal}) {
+    EXPECT_EQ(image_classifier->GetStats().GetInferenceSummary(stage).count,
+              3);
+  }
+  const auto total = image_classifier->GetStats().GetInferenceSummary(
+      InferenceStage::kTotal);
+  EXPECT_GT(total.p50, absl::ZeroDuration());
+  EXPECT_LE(total.p50, total.p99);
+  EXPECT_LE(total.p99, total.max);
+
+  image_classifier->ResetStats();
+  EXPECT_EQ(image_classifier->GetStats()
+                .GetInferenceSummary(InferenceStage::kTotal)
+                .count,
+            0);
+  EXPECT_EQ(
+      image_classifier->GetStats().GetInitSummary(InitStage::kLoadModel).count,
+      1);
+  ImageDataFree(&rgb_image);
+}
+
+TEST(ClassifyTest, ProfilesOpsWhenEnabled) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageClassifierOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetQuantizedWithMetadata));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                       ImageClassifier::CreateFromOptions(options));
+  EXPECT_EQ(image_classifier->GetProfiler(), nullptr);
+
+  image_classifier->EnableProfiling();
+  for (int i = 0; i < 2; ++i) {
+    SUPPORT_ASSERT_OK(image_classifier->Classify(*frame_buffer));
+  }
+  OpProfiler* profiler = image_classifier->GetProfiler();
+  ASSERT_NE(profiler, nullptr);
+  const std::vector<OpSummary> summaries = profiler->GetOpSummaries();
+  ASSERT_FALSE(summaries.empty());
+  for (const OpSummary& summary : summaries) {
+    EXPECT_EQ(summary.count, 2);
+    EXPECT_LE(summary.min, summary.max);
+  }
+  EXPECT_THAT(profiler->ToString(), HasSubstr("CONV_2D"));
+  const std::string trace = profiler->ToChromeTraceJson();
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Preprocess\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Postprocess\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"CONV_2D\""));
+
+  image_classifier->DisableProfiling();
+  EXPECT_EQ(image_classifier->GetProfiler(), nullptr);
+  SUPPORT_ASSERT_OK(image_classifier->Classify(*frame_buffer));
+  ImageDataFree(&rgb_image);
+}
+
 TEST(ClassifyTest, SucceedsWithBaseOptions) {
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("burger.jpg"));
   std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/gmock.h"
 #include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/proto2.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/status_matchers.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
@@ -34,6 +35,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/proto/image_embedder_options_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/test/message_matchers.h"
 #include "tensorflow_lite_support/cc/test/test_utils.h"
 #include "tensorflow_lite_support/examples/task/vision/desktop/utils/image_utils.h"
 
@@ -44,6 +46,7 @@ namespace {
 
 using ::testing::HasSubstr;
 using ::testing::Optional;
+using ::tflite::support::EqualsProto;
 using ::tflite::support::kTfLiteSupportPayload;
 using ::tflite::support::StatusOr;
 using ::tflite::support::TfLiteSupportStatus;
@@ -421,6 +424,50 @@ TEST(EmbedTest, SucceedsWithRegionOfInterest) {
   EXPECT_LE(abs(similarity - expected_similarity), kSimilarityTolerancy);
 }
 
+// Extracts feature vectors into the same result allocated on an arena, and
+// checks that they are the same as the ones returned by Embed().
+TEST(EmbedTest, EmbedIntoRecyclesArenaResult) {
+  // Create embedder.
+  ImageEmbedderOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kMobileNetV3));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageEmbedder> embedder,
+                       ImageEmbedder::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> image_frame_buffer = CreateFromRgbRawBuffer(
+      image.pixel_data, FrameBuffer::Dimension{image.width, image.height});
+  // Bounding box in "burger.jpg" corresponding to "burger_crop.jpg".
+  BoundingBox roi;
+  roi.set_origin_x(0);
+  roi.set_origin_y(0);
+  roi.set_width(400);
+  roi.set_height(325);
+  BoundingBox full_roi;
+  full_roi.set_width(image.width);
+  full_roi.set_height(image.height);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const EmbeddingResult crop_expected,
+                       embedder->Embed(*image_frame_buffer, roi));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const EmbeddingResult image_expected,
+                       embedder->Embed(*image_frame_buffer));
+
+  tflite::support::proto::Arena arena;
+  EmbeddingResult* result =
+      tflite::support::proto::Arena::CreateMessage<EmbeddingResult>(&arena);
+  SUPPORT_ASSERT_OK(embedder->EmbedInto(*image_frame_buffer, roi, result));
+  EXPECT_THAT(*result, EqualsProto(crop_expected));
+  ASSERT_EQ(result->embeddings_size(), 1);
+  EXPECT_EQ(result->embeddings(0).GetArena(), &arena);
+  const Embedding* embedding = &result->embeddings(0);
+  SUPPORT_ASSERT_OK(
+      embedder->EmbedInto(*image_frame_buffer, full_roi, result));
+  ImageDataFree(&image);
+  EXPECT_THAT(*result, EqualsProto(image_expected));
+  // The cleared embedding is recycled.
+  ASSERT_EQ(result->embeddings_size(), 1);
+  EXPECT_EQ(&result->embeddings(0), embedding);
+  EXPECT_EQ(result->embeddings(0).GetArena(), &arena);
+}
+
 TEST(GetEmbeddingDimension, Succeeds) {
   // Create embedder.
   ImageEmbedderOptions options;
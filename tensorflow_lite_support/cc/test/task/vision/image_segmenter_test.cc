@@ -92,6 +92,10 @@ constexpr char kDeepLabV3PartialResult[] =
 // The maximum fraction of pixels in the candidate mask that can have a
 // different class than the golden mask for the test to pass.
 constexpr float kGoldenMaskTolerance = 1e-2;
+// Same as above, for masks stitched from tiles: each tile is segmented with
+// less context and at a higher resolution than the whole frame, which mostly
+// moves the borders between classes.
+constexpr float kTiledGoldenMaskTolerance = 1e-1;
 // Magnification factor used when creating the golden category masks to make
 // them more human-friendly. Each pixel in the golden masks has its value
 // multiplied by this factor, i.e. a value of 10 means class index 1, a value of
@@ -259,6 +263,40 @@ TEST_P(NumThreadsTest, FailsWithInvalidNumberOfThreads) {
                   absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
 }
 
+TEST_F(CreateFromOptionsTest, FailsWithTilingWorkersAndSingleOpResolver) {
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  options.mutable_tiling_options()->set_num_workers(2);
+
+  StatusOr<std::unique_ptr<ImageSegmenter>> image_segmenter_or =
+      ImageSegmenter::CreateFromOptions(
+          options, absl::make_unique<DeepLabOpResolver>());
+
+  EXPECT_EQ(image_segmenter_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(image_segmenter_or.status().message(),
+              HasSubstr("OpResolverFactory"));
+  EXPECT_THAT(image_segmenter_or.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(
+                  absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
+}
+
+TEST_F(CreateFromOptionsTest, SucceedsWithTilingWorkersAndOpResolverFactory) {
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  options.mutable_tiling_options()->set_num_workers(3);
+  int num_op_resolvers = 0;
+
+  SUPPORT_ASSERT_OK(ImageSegmenter::CreateFromOptions(
+      options, [&num_op_resolvers]() {
+        ++num_op_resolvers;
+        return absl::make_unique<DeepLabOpResolver>();
+      }));
+  EXPECT_EQ(num_op_resolvers, 3);
+}
+
 // Confidence masks tested in PostProcess unit tests below.
 TEST(SegmentTest, SucceedsWithCategoryMask) {
   // Load input and build frame buffer.
@@ -299,6 +337,205 @@ TEST(SegmentTest, SucceedsWithCategoryMask) {
   ImageDataFree(&golden_mask);
 }
 
+TEST(SegmentTest, SegmentIntoRecyclesResult) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
+                       LoadImage("segmentation_input_rotation0.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ImageSegmenter> category_segmenter,
+      ImageSegmenter::CreateFromOptions(options));
+  options.set_output_type(ImageSegmenterOptions::CONFIDENCE_MASK);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ImageSegmenter> confidence_segmenter,
+      ImageSegmenter::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult category_expected,
+                       category_segmenter->Segment(*frame_buffer));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult confidence_expected,
+                       confidence_segmenter->Segment(*frame_buffer));
+
+  // Stale results are cleared.
+  SegmentationResult result = ParseTextProtoOrDie<SegmentationResult>(
+      R"pb(segmentation { width: 2 height: 1 category_mask: "ab" }
+           segmentation { width: 1 height: 1 category_mask: "c" })pb");
+  SUPPORT_ASSERT_OK(confidence_segmenter->SegmentInto(*frame_buffer, &result));
+  EXPECT_THAT(result, EqualsProto(confidence_expected));
+  const Segmentation* segmentation = &result.segmentation(0);
+  const Segmentation::ConfidenceMask* confidence_mask =
+      &segmentation->confidence_masks().confidence_mask(0);
+  SUPPORT_ASSERT_OK(confidence_segmenter->SegmentInto(*frame_buffer, &result));
+  EXPECT_THAT(result, EqualsProto(confidence_expected));
+  EXPECT_EQ(&result.segmentation(0), segmentation);
+  EXPECT_EQ(&segmentation->confidence_masks().confidence_mask(0),
+            confidence_mask);
+
+  // The confidence masks of the reused result are replaced by a category
+  // mask, which is then overwritten in place.
+  SUPPORT_ASSERT_OK(category_segmenter->SegmentInto(*frame_buffer, &result));
+  EXPECT_THAT(result, EqualsProto(category_expected));
+  EXPECT_EQ(&result.segmentation(0), segmentation);
+  const char* category_mask = segmentation->category_mask().data();
+  SUPPORT_ASSERT_OK(category_segmenter->SegmentInto(*frame_buffer, &result));
+  EXPECT_THAT(result, EqualsProto(category_expected));
+  EXPECT_EQ(segmentation->category_mask().data(), category_mask);
+  ImageDataFree(&rgb_image);
+}
+
+TEST(SegmentTest, SucceedsWithTilingOptions) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
+                       LoadImage("segmentation_input_rotation0.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  // The 257x257 frame is split into 2x2 tiles of 160x160 pixels, each upscaled
+  // to the 257x257 model input size and output as 257x257 masks: the stitched
+  // mask is upscaled by the same 257/160 factor.
+  options.mutable_tiling_options()->set_tile_width(160);
+  options.mutable_tiling_options()->set_tile_height(160);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageSegmenter> image_segmenter,
+                       ImageSegmenter::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult result,
+                       image_segmenter->Segment(*frame_buffer));
+
+  ASSERT_EQ(result.segmentation_size(), 1);
+  const Segmentation& segmentation = result.segmentation(0);
+  EXPECT_EQ(segmentation.width(), 413);
+  EXPECT_EQ(segmentation.height(), 413);
+  ASSERT_EQ(segmentation.category_mask().size(), 413 * 413);
+  EXPECT_EQ(segmentation.colored_labels_size(), 21);
+
+  // Compare with the golden mask of the untiled frame, sampling the stitched
+  // mask at the center of each golden pixel.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData golden_mask,
+                       LoadImage("segmentation_golden_rotation0.png"));
+  const uint8* mask =
+      reinterpret_cast<const uint8*>(segmentation.category_mask().data());
+  int inconsistent_pixels = 0;
+  for (int y = 0; y < golden_mask.height; ++y) {
+    const int mask_y = (2 * y + 1) * segmentation.height() /
+                       (2 * golden_mask.height);
+    for (int x = 0; x < golden_mask.width; ++x) {
+      const int mask_x = (2 * x + 1) * segmentation.width() /
+                         (2 * golden_mask.width);
+      inconsistent_pixels +=
+          (mask[mask_y * segmentation.width() + mask_x] *
+               kGoldenMaskMagnificationFactor !=
+           golden_mask.pixel_data[y * golden_mask.width + x]);
+    }
+  }
+  EXPECT_LT(static_cast<float>(inconsistent_pixels) /
+                (golden_mask.width * golden_mask.height),
+            kTiledGoldenMaskTolerance);
+  ImageDataFree(&rgb_image);
+  ImageDataFree(&golden_mask);
+}
+
+TEST(SegmentTest, SucceedsWithTilingOptionsAndConfidenceMask) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
+                               LoadImage("segmentation_input_rotation0.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  options.mutable_tiling_options()->set_tile_width(160);
+  options.mutable_tiling_options()->set_tile_height(160);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageSegmenter> image_segmenter,
+                               ImageSegmenter::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult category_result,
+                               image_segmenter->Segment(*frame_buffer));
+  options.set_output_type(ImageSegmenterOptions::CONFIDENCE_MASK);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(image_segmenter,
+                               ImageSegmenter::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult confidence_result,
+                               image_segmenter->Segment(*frame_buffer));
+
+  // The confidence masks are blended the same way, rows of tiles after rows of
+  // tiles: the highest confidence of each pixel is the class of the category
+  // mask.
+  ASSERT_EQ(confidence_result.segmentation_size(), 1);
+  const Segmentation& segmentation = confidence_result.segmentation(0);
+  EXPECT_EQ(segmentation.width(), 413);
+  EXPECT_EQ(segmentation.height(), 413);
+  ASSERT_EQ(segmentation.confidence_masks().confidence_mask_size(), 21);
+  const std::string& category_mask =
+      category_result.segmentation(0).category_mask();
+  for (int i = 0; i < 413 * 413; ++i) {
+    int class_index = 0;
+    float max_confidence = 0.0f;
+    for (int d = 0; d < 21; ++d) {
+      const auto& confidence_mask =
+          segmentation.confidence_masks().confidence_mask(d);
+      ASSERT_EQ(confidence_mask.value_size(), 413 * 413);
+      if (confidence_mask.value(i) > max_confidence) {
+        class_index = d;
+        max_confidence = confidence_mask.value(i);
+      }
+    }
+    ASSERT_EQ(class_index, static_cast<uint8>(category_mask[i]))
+        << "at pixel " << i;
+  }
+  ImageDataFree(&rgb_image);
+}
+
+TEST(SegmentTest, SucceedsWithSeveralTilingWorkers) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
+                               LoadImage("segmentation_input_rotation0.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ImageSegmenterOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kDeepLabV3));
+  // 4x4 tiles, for more tiles than workers.
+  options.mutable_tiling_options()->set_tile_width(128);
+  options.mutable_tiling_options()->set_tile_height(128);
+  options.mutable_tiling_options()->set_min_overlap_ratio(0.5);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageSegmenter> image_segmenter,
+                               ImageSegmenter::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult expected,
+                               image_segmenter->Segment(*frame_buffer));
+  const std::string& expected_mask =
+      expected.segmentation(0).category_mask();
+
+  options.mutable_tiling_options()->set_num_workers(3);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(image_segmenter,
+                               ImageSegmenter::CreateFromOptions(options));
+  // Several inferences, so that the workers process different tiles.
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(const SegmentationResult result,
+                                 image_segmenter->Segment(*frame_buffer));
+
+    ASSERT_EQ(result.segmentation_size(), 1);
+    const Segmentation& segmentation = result.segmentation(0);
+    EXPECT_EQ(segmentation.width(), expected.segmentation(0).width());
+    EXPECT_EQ(segmentation.height(), expected.segmentation(0).height());
+    ASSERT_EQ(segmentation.category_mask().size(), expected_mask.size());
+    // The tiles are blended in a different order, which may only flip pixels
+    // whose top classes are tied up to float rounding.
+    int inconsistent_pixels = 0;
+    for (int j = 0; j < expected_mask.size(); ++j) {
+      inconsistent_pixels +=
+          (segmentation.category_mask()[j] != expected_mask[j]);
+    }
+    EXPECT_LT(static_cast<float>(inconsistent_pixels) / expected_mask.size(),
+              1e-3);
+  }
+  ImageDataFree(&rgb_image);
+}
+
 TEST(SegmentTest, SucceedsWithOrientation) {
   // Load input and build frame buffer with kRightBottom orientation.
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
@@ -0,0 +1,217 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/core/shims/cc/shims_test_util.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::TfLiteEngine;
+
+constexpr int kWidth = 8;
+constexpr int kHeight = 6;
+
+// Returns a metadata buffer with single-value NormalizationOptions for the
+// input tensor.
+std::string BuildNormalizationMetadata(float mean_value, float std_value) {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto normalization_options = tflite::CreateNormalizationOptions(
+      builder, builder.CreateVector<float>({mean_value}),
+      builder.CreateVector<float>({std_value}));
+  const auto process_units = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::ProcessUnit>>{
+          tflite::CreateProcessUnit(
+              builder, tflite::ProcessUnitOptions_NormalizationOptions,
+              normalization_options.Union())});
+  tflite::TensorMetadataBuilder tensor_metadata_builder(builder);
+  tensor_metadata_builder.add_process_units(process_units);
+  const auto input_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{
+          tensor_metadata_builder.Finish()});
+  tflite::SubGraphMetadataBuilder subgraph_metadata_builder(builder);
+  subgraph_metadata_builder.add_input_tensor_metadata(input_tensor_metadata);
+  const auto subgraph_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::SubGraphMetadata>>{
+          subgraph_metadata_builder.Finish()});
+  tflite::ModelMetadataBuilder model_metadata_builder(builder);
+  model_metadata_builder.add_subgraph_metadata(subgraph_metadata);
+  tflite::FinishModelMetadataBuffer(builder, model_metadata_builder.Finish());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Builds a model dequantizing an input image tensor of shape
+// [1, kHeight, kWidth, 3] and type `type`, with quantization parameters if
+// `scale` is set, and `metadata` if not empty.
+std::string BuildImageModel(tflite::TensorType type,
+                            absl::optional<float> scale,
+                            const std::string& metadata) {
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  auto dequantize_code = absl::make_unique<tflite::OperatorCodeT>();
+  dequantize_code->builtin_code = tflite::BuiltinOperator_DEQUANTIZE;
+  dequantize_code->deprecated_builtin_code =
+      tflite::BuiltinOperator_DEQUANTIZE;
+  dequantize_code->version = type == tflite::TensorType_FLOAT16 ? 3 : 2;
+  model.operator_codes.push_back(std::move(dequantize_code));
+
+  auto subgraph = absl::make_unique<tflite::SubGraphT>();
+  auto input = absl::make_unique<tflite::TensorT>();
+  input->name = "image";
+  input->type = type;
+  input->buffer = 0;
+  input->shape = {1, kHeight, kWidth, 3};
+  if (scale.has_value()) {
+    input->quantization = absl::make_unique<tflite::QuantizationParametersT>();
+    input->quantization->scale = {*scale};
+    input->quantization->zero_point = {-10};
+  }
+  subgraph->tensors.push_back(std::move(input));
+  auto output = absl::make_unique<tflite::TensorT>();
+  output->name = "output";
+  output->type = tflite::TensorType_FLOAT32;
+  output->buffer = 0;
+  output->shape = {1, kHeight, kWidth, 3};
+  subgraph->tensors.push_back(std::move(output));
+  subgraph->inputs = {0};
+  subgraph->outputs = {1};
+  auto dequantize = absl::make_unique<tflite::OperatorT>();
+  dequantize->opcode_index = 0;
+  dequantize->inputs = {0};
+  dequantize->outputs = {1};
+  subgraph->operators.push_back(std::move(dequantize));
+  model.subgraphs.push_back(std::move(subgraph));
+
+  if (!metadata.empty()) {
+    auto metadata_buffer = absl::make_unique<tflite::BufferT>();
+    metadata_buffer->data.assign(metadata.begin(), metadata.end());
+    model.buffers.push_back(std::move(metadata_buffer));
+    auto model_metadata = absl::make_unique<tflite::MetadataT>();
+    model_metadata->name = "TFLITE_METADATA";
+    model_metadata->buffer = 1;
+    model.metadata.push_back(std::move(model_metadata));
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+class BuildInputImageTensorSpecsTest : public tflite_shims::testing::Test {
+ protected:
+  StatusOr<ImageTensorSpecs> BuildSpecs(tflite::TensorType type,
+                                        absl::optional<float> scale,
+                                        const std::string& metadata = "") {
+    model_buffer_ = BuildImageModel(type, scale, metadata);
+    engine_ = absl::make_unique<TfLiteEngine>();
+    RETURN_IF_ERROR(engine_->BuildModelFromFlatBuffer(model_buffer_.data(),
+                                                      model_buffer_.size()));
+    RETURN_IF_ERROR(engine_->InitInterpreter());
+    return BuildInputImageTensorSpecs(*engine_->interpreter(),
+                                      *engine_->metadata_extractor());
+  }
+
+  std::string model_buffer_;
+  std::unique_ptr<TfLiteEngine> engine_;
+};
+
+TEST_F(BuildInputImageTensorSpecsTest, SucceedsWithInt8Input) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      ImageTensorSpecs specs,
+      BuildSpecs(tflite::TensorType_INT8, /*scale=*/0.5f));
+
+  EXPECT_EQ(specs.tensor_type, kTfLiteInt8);
+  EXPECT_EQ(specs.image_width, kWidth);
+  EXPECT_EQ(specs.image_height, kHeight);
+  // NormalizationOptions are optional for int8 inputs.
+  EXPECT_FALSE(specs.normalization_options.has_value());
+}
+
+TEST_F(BuildInputImageTensorSpecsTest,
+       SucceedsWithInt8InputAndNormalizationOptions) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      ImageTensorSpecs specs,
+      BuildSpecs(tflite::TensorType_INT8, /*scale=*/0.5f,
+                 BuildNormalizationMetadata(127.5f, 127.5f)));
+
+  EXPECT_EQ(specs.tensor_type, kTfLiteInt8);
+  ASSERT_TRUE(specs.normalization_options.has_value());
+  EXPECT_EQ(specs.normalization_options->num_values, 1);
+  EXPECT_FLOAT_EQ(specs.normalization_options->mean_values[0], 127.5f);
+  EXPECT_FLOAT_EQ(specs.normalization_options->std_values[0], 127.5f);
+}
+
+TEST_F(BuildInputImageTensorSpecsTest, FailsWithInt8InputAndNonPositiveScale) {
+  for (absl::optional<float> scale : {absl::optional<float>(),
+                                      absl::optional<float>(0.0f),
+                                      absl::optional<float>(-0.5f)}) {
+    StatusOr<ImageTensorSpecs> specs_or =
+        BuildSpecs(tflite::TensorType_INT8, scale);
+
+    EXPECT_EQ(specs_or.status().code(), absl::StatusCode::kInvalidArgument);
+    EXPECT_THAT(specs_or.status().message(), HasSubstr("positive scale"));
+  }
+}
+
+TEST_F(BuildInputImageTensorSpecsTest, SucceedsWithFloat16Input) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      ImageTensorSpecs specs,
+      BuildSpecs(tflite::TensorType_FLOAT16, /*scale=*/absl::nullopt,
+                 BuildNormalizationMetadata(127.5f, 127.5f)));
+
+  EXPECT_EQ(specs.tensor_type, kTfLiteFloat16);
+  EXPECT_EQ(specs.image_width, kWidth);
+  EXPECT_EQ(specs.image_height, kHeight);
+  ASSERT_TRUE(specs.normalization_options.has_value());
+  EXPECT_FLOAT_EQ(specs.normalization_options->mean_values[2], 127.5f);
+  EXPECT_FLOAT_EQ(specs.normalization_options->std_values[2], 127.5f);
+}
+
+TEST_F(BuildInputImageTensorSpecsTest,
+       FailsWithFloat16InputWithoutNormalizationOptions) {
+  StatusOr<ImageTensorSpecs> specs_or =
+      BuildSpecs(tflite::TensorType_FLOAT16, /*scale=*/absl::nullopt);
+
+  EXPECT_EQ(specs_or.status().code(), absl::StatusCode::kNotFound);
+  EXPECT_THAT(specs_or.status().message(), HasSubstr("NormalizationOptions"));
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,267 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_lite_support/cc/task/vision/utils/image_tiling.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/tiling_options_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::testing::Each;
+
+void ExpectTile(const BoundingBox& tile, int x, int y, int width, int height) {
+  EXPECT_EQ(tile.origin_x(), x);
+  EXPECT_EQ(tile.origin_y(), y);
+  EXPECT_EQ(tile.width(), width);
+  EXPECT_EQ(tile.height(), height);
+}
+
+TEST(ComputeTilesTest, SingleTileForSmallFrames) {
+  std::vector<BoundingBox> tiles =
+      ComputeTiles({/*width=*/200, /*height=*/100},
+                   {/*width=*/224, /*height=*/224}, /*min_overlap_ratio=*/0.2);
+
+  ASSERT_EQ(tiles.size(), 1);
+  ExpectTile(tiles[0], 0, 0, 200, 100);
+}
+
+TEST(ComputeTilesTest, SpreadsTilesEvenly) {
+  std::vector<BoundingBox> tiles =
+      ComputeTiles({/*width=*/640, /*height=*/300},
+                   {/*width=*/224, /*height=*/224}, /*min_overlap_ratio=*/0.2);
+
+  // 4 tiles are needed horizontally (3 * 180 + 224 >= 640), 2 vertically.
+  ASSERT_EQ(tiles.size(), 8);
+  const int expected_xs[] = {0, 139, 277, 416};
+  for (int i = 0; i < 8; ++i) {
+    ExpectTile(tiles[i], expected_xs[i % 4], i < 4 ? 0 : 76, 224, 224);
+  }
+}
+
+TEST(ComputeTilesTest, CoversFrameWithMinOverlap) {
+  for (int frame_size : {225, 400, 401, 1000, 1920}) {
+    for (float min_overlap_ratio : {0.f, 0.1f, 0.5f, 0.99f}) {
+      std::vector<BoundingBox> tiles =
+          ComputeTiles({frame_size, /*height=*/10},
+                       {/*width=*/224, /*height=*/10}, min_overlap_ratio);
+
+      ASSERT_FALSE(tiles.empty());
+      EXPECT_EQ(tiles.front().origin_x(), 0);
+      EXPECT_EQ(tiles.back().origin_x() + tiles.back().width(), frame_size);
+      for (size_t i = 1; i < tiles.size(); ++i) {
+        EXPECT_GE(tiles[i - 1].origin_x() + tiles[i - 1].width() -
+                      tiles[i].origin_x(),
+                  static_cast<int>(min_overlap_ratio * 224));
+      }
+    }
+  }
+}
+
+TEST(GetNumTileWorkersTest, DefaultsToOneWorker) {
+  TilingOptions options;
+  EXPECT_EQ(GetNumTileWorkers(options), 1);
+  options.set_num_workers(3);
+  EXPECT_EQ(GetNumTileWorkers(options), 3);
+  // One worker per hardware thread.
+  options.set_num_workers(0);
+  EXPECT_GE(GetNumTileWorkers(options), 1);
+}
+
+TEST(TileWorkerPoolTest, ProcessesEachTileOnce) {
+  for (int num_workers : {1, 4, 50}) {
+    TileWorkerPool pool;
+    pool.Start(num_workers);
+    EXPECT_EQ(pool.num_workers(), num_workers);
+    // Each tile is only written by the worker processing it.
+    std::vector<int> num_calls(20, 0);
+    std::vector<int> worker_indices(20, -1);
+
+    SUPPORT_ASSERT_OK(pool.ProcessTiles(
+        num_calls.size(),
+        [&](int worker_index, int tile_index) -> absl::Status {
+          ++num_calls[tile_index];
+          worker_indices[tile_index] = worker_index;
+          return absl::OkStatus();
+        }));
+
+    for (int i = 0; i < num_calls.size(); ++i) {
+      EXPECT_EQ(num_calls[i], 1);
+      EXPECT_GE(worker_indices[i], 0);
+      EXPECT_LT(worker_indices[i], std::min<int>(num_workers, 20));
+    }
+  }
+}
+
+TEST(TileWorkerPoolTest, ProcessesTilesWithoutStart) {
+  TileWorkerPool pool;
+  std::vector<int> worker_indices(5, -1);
+
+  SUPPORT_ASSERT_OK(pool.ProcessTiles(
+      worker_indices.size(),
+      [&](int worker_index, int tile_index) -> absl::Status {
+        worker_indices[tile_index] = worker_index;
+        return absl::OkStatus();
+      }));
+
+  EXPECT_EQ(pool.num_workers(), 1);
+  EXPECT_THAT(worker_indices, Each(0));
+}
+
+TEST(TileWorkerPoolTest, ReusesThreadsAcrossCalls) {
+  TileWorkerPool pool;
+  pool.Start(/*num_workers=*/4);
+  absl::Mutex mutex;
+  std::set<std::thread::id> thread_ids;
+
+  for (int call = 0; call < 50; ++call) {
+    std::vector<int> num_calls(call % 7, 0);
+    SUPPORT_ASSERT_OK(pool.ProcessTiles(
+        num_calls.size(),
+        [&](int worker_index, int tile_index) -> absl::Status {
+          ++num_calls[tile_index];
+          absl::MutexLock lock(&mutex);
+          thread_ids.insert(std::this_thread::get_id());
+          return absl::OkStatus();
+        }));
+    EXPECT_THAT(num_calls, Each(1));
+  }
+
+  // The calling thread and the 3 threads started once.
+  EXPECT_LE(thread_ids.size(), 4);
+}
+
+TEST(TileWorkerPoolTest, ReturnsFirstError) {
+  for (int num_workers : {1, 4}) {
+    TileWorkerPool pool;
+    pool.Start(num_workers);
+    // The pool recovers from the error of the first call.
+    for (int call = 0; call < 2; ++call) {
+      absl::Status status = pool.ProcessTiles(
+          20, [](int worker_index, int tile_index) -> absl::Status {
+            if (tile_index == 5) {
+              return absl::InternalError("Tile 5 failed");
+            }
+            return absl::OkStatus();
+          });
+
+      EXPECT_EQ(status.code(), absl::StatusCode::kInternal);
+      EXPECT_EQ(status.message(), "Tile 5 failed");
+    }
+    SUPPORT_EXPECT_OK(pool.ProcessTiles(
+        20, [](int worker_index, int tile_index) { return absl::OkStatus(); }));
+  }
+}
+
+TEST(TileWorkerPoolTest, StopsAfterErrorWithSingleWorker) {
+  TileWorkerPool pool;
+  int num_calls = 0;
+  absl::Status status = pool.ProcessTiles(
+      20, [&num_calls](int worker_index, int tile_index) -> absl::Status {
+        ++num_calls;
+        return tile_index == 5 ? absl::InternalError("Tile 5 failed")
+                               : absl::OkStatus();
+      });
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInternal);
+  EXPECT_EQ(num_calls, 6);
+}
+
+void AddDetection(int x, int y, int width, int height, int index, float score,
+                  DetectionResult* results) {
+  Detection* detection = results->add_detections();
+  detection->mutable_bounding_box()->set_origin_x(x);
+  detection->mutable_bounding_box()->set_origin_y(y);
+  detection->mutable_bounding_box()->set_width(width);
+  detection->mutable_bounding_box()->set_height(height);
+  Class* detection_class = detection->add_classes();
+  detection_class->set_index(index);
+  detection_class->set_score(score);
+}
+
+TEST(MergeOverlappingDetectionsTest, MergesObjectCutByTileBorder) {
+  DetectionResult results;
+  // A tile ending at x = 10 only sees the left part of the object, which is
+  // fully seen by the next tile. Their IoU is only 0.4, but the partial box is
+  // contained in the whole one.
+  AddDetection(6, 0, 4, 8, /*index=*/1, /*score=*/0.6, &results);
+  AddDetection(6, 0, 10, 8, /*index=*/1, /*score=*/0.8, &results);
+  DetectionResult merged_results;
+
+  MergeOverlappingDetections(results, /*overlap_threshold=*/0.5,
+                             /*max_results=*/-1, &merged_results);
+
+  ASSERT_EQ(merged_results.detections_size(), 1);
+  EXPECT_EQ(merged_results.detections(0).bounding_box().width(), 10);
+  EXPECT_FLOAT_EQ(merged_results.detections(0).classes(0).score(), 0.8);
+}
+
+TEST(MergeOverlappingDetectionsTest, KeepsOtherClassesAndDistantObjects) {
+  DetectionResult results;
+  AddDetection(0, 0, 10, 10, /*index=*/1, /*score=*/0.9, &results);
+  AddDetection(2, 2, 6, 6, /*index=*/2, /*score=*/0.7, &results);
+  AddDetection(20, 0, 10, 10, /*index=*/1, /*score=*/0.8, &results);
+  DetectionResult merged_results;
+
+  MergeOverlappingDetections(results, /*overlap_threshold=*/0.5,
+                             /*max_results=*/-1, &merged_results);
+
+  ASSERT_EQ(merged_results.detections_size(), 3);
+  EXPECT_EQ(merged_results.detections(0).classes(0).index(), 1);
+  EXPECT_EQ(merged_results.detections(1).bounding_box().origin_x(), 20);
+  EXPECT_EQ(merged_results.detections(2).classes(0).index(), 2);
+}
+
+TEST(MergeOverlappingDetectionsTest, KeepsMaxResults) {
+  DetectionResult results;
+  AddDetection(0, 0, 10, 10, /*index=*/1, /*score=*/0.5, &results);
+  AddDetection(20, 0, 10, 10, /*index=*/1, /*score=*/0.9, &results);
+  AddDetection(40, 0, 10, 10, /*index=*/1, /*score=*/0.7, &results);
+  DetectionResult merged_results;
+
+  MergeOverlappingDetections(results, /*overlap_threshold=*/0.5,
+                             /*max_results=*/2, &merged_results);
+
+  ASSERT_EQ(merged_results.detections_size(), 2);
+  EXPECT_EQ(merged_results.detections(0).bounding_box().origin_x(), 20);
+  EXPECT_EQ(merged_results.detections(1).bounding_box().origin_x(), 40);
+}
+
+TEST(GetTileBlendingWeightTest, DecreasesTowardsBorders) {
+  EXPECT_EQ(GetTileBlendingWeight(0, 5), 1.f);
+  EXPECT_EQ(GetTileBlendingWeight(1, 5), 2.f);
+  EXPECT_EQ(GetTileBlendingWeight(2, 5), 3.f);
+  EXPECT_EQ(GetTileBlendingWeight(3, 5), 2.f);
+  EXPECT_EQ(GetTileBlendingWeight(4, 5), 1.f);
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -15,15 +15,22 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/vision/object_detector.h"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/cord.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/shims/cc/shims_test_util.h"
 #include "tensorflow/lite/kernels/builtin_op_kernels.h"
 #include "tensorflow/lite/mutable_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/gmock.h"
 #include "tensorflow_lite_support/cc/port/gtest.h"
@@ -41,6 +48,8 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/test/message_matchers.h"
 #include "tensorflow_lite_support/cc/test/test_utils.h"
 #include "tensorflow_lite_support/examples/task/vision/desktop/utils/image_utils.h"
+#include "tensorflow_lite_support/metadata/cc/metadata_populator.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
 namespace tflite {
 
@@ -62,6 +71,7 @@ namespace {
 
 using ::testing::HasSubstr;
 using ::testing::Optional;
+using ::tflite::metadata::ModelMetadataPopulator;
 using ::tflite::support::EqualsProto;
 using ::tflite::support::kTfLiteSupportPayload;
 using ::tflite::support::StatusOr;
@@ -312,6 +322,61 @@ TEST_P(NumThreadsTest, FailsWithInvalidNumberOfThreads) {
                   absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
 }
 
+TEST_F(CreateFromOptionsTest, FailsWithInvalidTilingOverlap) {
+  ObjectDetectorOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  options.mutable_tiling_options()->set_min_overlap_ratio(1);
+
+  StatusOr<std::unique_ptr<ObjectDetector>> object_detector_or =
+      ObjectDetector::CreateFromOptions(options);
+
+  EXPECT_EQ(object_detector_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(object_detector_or.status().message(),
+              HasSubstr("Invalid `min_overlap_ratio`"));
+  EXPECT_THAT(object_detector_or.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(
+                  absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
+}
+
+TEST_F(CreateFromOptionsTest, FailsWithTilingWorkersAndSingleOpResolver) {
+  ObjectDetectorOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  options.mutable_tiling_options()->set_num_workers(2);
+
+  StatusOr<std::unique_ptr<ObjectDetector>> object_detector_or =
+      ObjectDetector::CreateFromOptions(
+          options, absl::make_unique<MobileSsdQuantizedOpResolver>());
+
+  EXPECT_EQ(object_detector_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(object_detector_or.status().message(),
+              HasSubstr("OpResolverFactory"));
+  EXPECT_THAT(object_detector_or.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(
+                  absl::StrCat(TfLiteSupportStatus::kInvalidArgumentError))));
+}
+
+TEST_F(CreateFromOptionsTest, SucceedsWithTilingWorkersAndOpResolverFactory) {
+  ObjectDetectorOptions options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  options.mutable_tiling_options()->set_num_workers(3);
+  int num_op_resolvers = 0;
+
+  SUPPORT_ASSERT_OK(ObjectDetector::CreateFromOptions(
+      options, [&num_op_resolvers]() {
+        ++num_op_resolvers;
+        return absl::make_unique<MobileSsdQuantizedOpResolver>();
+      }));
+  EXPECT_EQ(num_op_resolvers, 3);
+}
+
 class DetectTest : public tflite_shims::testing::Test {};
 
 TEST_F(DetectTest, Succeeds) {
@@ -336,6 +401,101 @@ TEST_F(DetectTest, Succeeds) {
       result, ParseTextProtoOrDie<DetectionResult>(kExpectResults));
 }
 
+TEST_F(DetectTest, DetectIntoRecyclesResult) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("cats_and_dogs.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ObjectDetectorOptions options;
+  options.set_max_results(4);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ObjectDetector> object_detector,
+                       ObjectDetector::CreateFromOptions(options));
+
+  DetectionResult result;
+  SUPPORT_ASSERT_OK(object_detector->DetectInto(*frame_buffer, &result));
+  ExpectApproximatelyEqual(
+      result, ParseTextProtoOrDie<DetectionResult>(kExpectResults));
+  const Detection* first_detection = &result.detections(0);
+  SUPPORT_ASSERT_OK(object_detector->DetectInto(*frame_buffer, &result));
+  ImageDataFree(&rgb_image);
+  ExpectApproximatelyEqual(
+      result, ParseTextProtoOrDie<DetectionResult>(kExpectResults));
+  EXPECT_EQ(&result.detections(0), first_detection);
+}
+
+TEST_F(DetectTest, SucceedsWithTilingOptions) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("cats_and_dogs.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ObjectDetectorOptions options;
+  options.set_max_results(4);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  // Smaller than the frame, so that it gets split into several tiles.
+  options.mutable_tiling_options()->set_tile_width(rgb_image.width / 2);
+  options.mutable_tiling_options()->set_tile_height(rgb_image.height / 2);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ObjectDetector> object_detector,
+                       ObjectDetector::CreateFromOptions(options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const DetectionResult result,
+                       object_detector->Detect(*frame_buffer));
+  ASSERT_GT(result.detections_size(), 0);
+  EXPECT_LE(result.detections_size(), 4);
+  for (int i = 0; i < result.detections_size(); ++i) {
+    const BoundingBox& box = result.detections(i).bounding_box();
+    EXPECT_GE(box.origin_x(), 0);
+    EXPECT_GE(box.origin_y(), 0);
+    EXPECT_LE(box.origin_x() + box.width(), rgb_image.width);
+    EXPECT_LE(box.origin_y() + box.height(), rgb_image.height);
+    if (i > 0) {
+      EXPECT_LE(result.detections(i).classes(0).score(),
+                result.detections(i - 1).classes(0).score());
+    }
+  }
+  ImageDataFree(&rgb_image);
+}
+
+TEST_F(DetectTest, SucceedsWithSeveralTilingWorkers) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image,
+                               LoadImage("cats_and_dogs.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      rgb_image.pixel_data,
+      FrameBuffer::Dimension{rgb_image.width, rgb_image.height});
+
+  ObjectDetectorOptions options;
+  options.set_max_results(4);
+  options.mutable_model_file_with_metadata()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileSsdWithMetadata));
+  // 3x3 tiles plus the whole frame, for more tiles than workers.
+  options.mutable_tiling_options()->set_tile_width(rgb_image.width / 2);
+  options.mutable_tiling_options()->set_tile_height(rgb_image.height / 2);
+  options.mutable_tiling_options()->set_min_overlap_ratio(0.5);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ObjectDetector> object_detector,
+                               ObjectDetector::CreateFromOptions(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const DetectionResult expected,
+                               object_detector->Detect(*frame_buffer));
+
+  options.mutable_tiling_options()->set_num_workers(3);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(object_detector,
+                               ObjectDetector::CreateFromOptions(options));
+  // Several inferences, so that the workers process different tiles.
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(const DetectionResult result,
+                                 object_detector->Detect(*frame_buffer));
+    ExpectApproximatelyEqual(result, expected);
+  }
+  ImageDataFree(&rgb_image);
+}
+
 TEST_F(DetectTest, SucceedswithBaseOptions) {
   SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData rgb_image, LoadImage("cats_and_dogs.jpg"));
   std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
@@ -639,6 +799,248 @@ TEST_F(PostprocessTest, SucceedsWithBlacklistOption) {
           )pb"));
 }
 
+// The raw outputs model ignores its 4x4 RGB input and outputs constant boxes
+// and scores, by adding zero to them. Boxes are normalized [ymin, xmin, ymax,
+// xmax], and the first class of the scores is a background class.
+constexpr char kRawOutputsLabelsName[] = "labels.txt";
+constexpr int kRawOutputsNumBoxes = 2;
+constexpr int kRawOutputsNumClasses = 3;
+
+// Returns a tensor buffer holding `values`.
+std::unique_ptr<tflite::BufferT> CreateFloatBuffer(
+    const std::vector<float>& values) {
+  auto buffer = absl::make_unique<tflite::BufferT>();
+  buffer->data.resize(values.size() * sizeof(float));
+  std::memcpy(buffer->data.data(), values.data(), buffer->data.size());
+  return buffer;
+}
+
+// Returns a metadata buffer attaching the labels file to the scores output.
+std::string BuildRawOutputsMetadata() {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto labels_name = builder.CreateString(kRawOutputsLabelsName);
+  tflite::AssociatedFileBuilder associated_file_builder(builder);
+  associated_file_builder.add_name(labels_name);
+  associated_file_builder.add_type(
+      tflite::AssociatedFileType_TENSOR_AXIS_LABELS);
+  const auto associated_files = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::AssociatedFile>>{
+          associated_file_builder.Finish()});
+  tflite::TensorMetadataBuilder scores_metadata_builder(builder);
+  scores_metadata_builder.add_associated_files(associated_files);
+  const auto scores_metadata = scores_metadata_builder.Finish();
+  const auto boxes_metadata = tflite::TensorMetadataBuilder(builder).Finish();
+  const auto image_metadata = tflite::TensorMetadataBuilder(builder).Finish();
+
+  const auto input_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{image_metadata});
+  const auto output_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::TensorMetadata>>{
+          boxes_metadata, scores_metadata});
+  tflite::SubGraphMetadataBuilder subgraph_metadata_builder(builder);
+  subgraph_metadata_builder.add_input_tensor_metadata(input_tensor_metadata);
+  subgraph_metadata_builder.add_output_tensor_metadata(output_tensor_metadata);
+  const auto subgraph_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<tflite::SubGraphMetadata>>{
+          subgraph_metadata_builder.Finish()});
+  tflite::ModelMetadataBuilder model_metadata_builder(builder);
+  model_metadata_builder.add_subgraph_metadata(subgraph_metadata);
+  tflite::FinishModelMetadataBuffer(builder, model_metadata_builder.Finish());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Builds the raw outputs model, with `labels` as labels file.
+std::string BuildRawOutputsModel(const std::string& labels) {
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  model.buffers.push_back(CreateFloatBuffer({0}));
+  model.buffers.push_back(CreateFloatBuffer({/*box 0*/ 0.25, 0.25, 0.75, 0.5,
+                                             /*box 1*/ 0.5, 0.5, 1.0, 1.0}));
+  // Box 0 is a cat (class 1) and box 1 a dog (class 2). The background score
+  // of box 0 is the highest, but never reported.
+  model.buffers.push_back(CreateFloatBuffer({/*box 0*/ 0.9, 0.8, 0.1,
+                                             /*box 1*/ 0.3, 0.2, 0.7}));
+  auto add_code = absl::make_unique<tflite::OperatorCodeT>();
+  add_code->builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->deprecated_builtin_code = tflite::BuiltinOperator_ADD;
+  add_code->version = 1;
+  model.operator_codes.push_back(std::move(add_code));
+
+  auto subgraph = absl::make_unique<tflite::SubGraphT>();
+  auto add_tensor = [&subgraph](const std::string& name,
+                                tflite::TensorType type,
+                                const std::vector<int>& shape, int buffer) {
+    auto tensor = absl::make_unique<tflite::TensorT>();
+    tensor->name = name;
+    tensor->type = type;
+    tensor->shape = shape;
+    tensor->buffer = buffer;
+    subgraph->tensors.push_back(std::move(tensor));
+  };
+  add_tensor("image", tflite::TensorType_UINT8, {1, 4, 4, 3}, 0);
+  add_tensor("zero", tflite::TensorType_FLOAT32, {1}, 1);
+  add_tensor("raw_boxes", tflite::TensorType_FLOAT32,
+             {1, kRawOutputsNumBoxes, 4}, 2);
+  add_tensor("raw_scores", tflite::TensorType_FLOAT32,
+             {1, kRawOutputsNumBoxes, kRawOutputsNumClasses}, 3);
+  add_tensor("boxes", tflite::TensorType_FLOAT32, {1, kRawOutputsNumBoxes, 4},
+             0);
+  add_tensor("scores", tflite::TensorType_FLOAT32,
+             {1, kRawOutputsNumBoxes, kRawOutputsNumClasses}, 0);
+  subgraph->inputs = {0};
+  subgraph->outputs = {4, 5};
+  for (int i = 0; i < 2; ++i) {
+    auto add = absl::make_unique<tflite::OperatorT>();
+    add->opcode_index = 0;
+    add->inputs = {2 + i, 1};
+    add->outputs = {4 + i};
+    add->builtin_options.Set(tflite::AddOptionsT());
+    subgraph->operators.push_back(std::move(add));
+  }
+  model.subgraphs.push_back(std::move(subgraph));
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+
+  auto populator = ModelMetadataPopulator::CreateFromModelBuffer(
+      reinterpret_cast<const char*>(builder.GetBufferPointer()),
+      builder.GetSize());
+  EXPECT_TRUE(populator.ok());
+  const std::string metadata = BuildRawOutputsMetadata();
+  (*populator)->LoadMetadata(metadata.data(), metadata.size());
+  (*populator)->LoadAssociatedFiles({{kRawOutputsLabelsName, labels}});
+  auto model_with_metadata = (*populator)->Populate();
+  EXPECT_TRUE(model_with_metadata.ok());
+  return *model_with_metadata;
+}
+
+class RawOutputsTest : public tflite_shims::testing::Test {
+ protected:
+  ObjectDetectorOptions GetOptions(const std::string& labels) {
+    model_ = BuildRawOutputsModel(labels);
+    ObjectDetectorOptions options;
+    options.mutable_model_file_with_metadata()->set_file_content(model_);
+    options.set_score_threshold(0.5);
+    RawDetectionOptions* raw_options = options.mutable_raw_detection_options();
+    raw_options->set_box_coding(RawDetectionOptions::BOUNDARIES);
+    raw_options->set_score_activation(RawDetectionOptions::NONE);
+    raw_options->set_has_background_class(true);
+    return options;
+  }
+
+  std::unique_ptr<FrameBuffer> CreateFrameBuffer(
+      FrameBuffer::Orientation orientation =
+          FrameBuffer::Orientation::kTopLeft) {
+    return CreateFromRgbRawBuffer(pixels_.data(),
+                                  {/*width=*/16, /*height=*/8}, orientation);
+  }
+
+  std::string model_;
+  std::vector<uint8_t> pixels_ = std::vector<uint8_t>(16 * 8 * 3, 128);
+};
+
+TEST_F(RawOutputsTest, Succeeds) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ObjectDetector> object_detector,
+      ObjectDetector::CreateFromOptions(GetOptions("cat\ndog\n")));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const DetectionResult result,
+                               object_detector->Detect(*CreateFrameBuffer()));
+
+  // Boxes are denormalized to the 16x8 frame, and class indices don't count
+  // the background class.
+  ExpectApproximatelyEqual(
+      result,
+      ParseTextProtoOrDie<DetectionResult>(
+          R"pb(detections {
+                 bounding_box { origin_x: 4 origin_y: 2 width: 4 height: 4 }
+                 classes { index: 0 score: 0.8 class_name: "cat" }
+               }
+               detections {
+                 bounding_box { origin_x: 8 origin_y: 4 width: 8 height: 4 }
+                 classes { index: 1 score: 0.7 class_name: "dog" }
+               }
+          )pb"));
+}
+
+TEST_F(RawOutputsTest, SucceedsWithFrameBufferOrientation) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ObjectDetector> object_detector,
+      ObjectDetector::CreateFromOptions(GetOptions("cat\ndog\n")));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      const DetectionResult result,
+      object_detector->Detect(
+          *CreateFrameBuffer(FrameBuffer::Orientation::kBottomRight)));
+
+  ExpectApproximatelyEqual(
+      result,
+      ParseTextProtoOrDie<DetectionResult>(
+          R"pb(detections {
+                 bounding_box { origin_x: 8 origin_y: 2 width: 4 height: 4 }
+                 classes { index: 0 score: 0.8 class_name: "cat" }
+               }
+               detections {
+                 bounding_box { origin_x: 0 origin_y: 0 width: 8 height: 4 }
+                 classes { index: 1 score: 0.7 class_name: "dog" }
+               }
+          )pb"));
+}
+
+TEST_F(RawOutputsTest, SucceedsWithRegionOfInterest) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PostprocessTest::TestObjectDetector> object_detector,
+      PostprocessTest::TestObjectDetector::CreateFromOptions(
+          GetOptions("cat\ndog\n")));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFrameBuffer();
+  // Runs the model, whose outputs don't depend on the region of interest.
+  SUPPORT_ASSERT_OK(object_detector->Detect(*frame_buffer));
+  const std::vector<TfLiteTensor*> outputs =
+      object_detector->GetOutputTensors();
+  const std::vector<const TfLiteTensor*> output_tensors(outputs.begin(),
+                                                        outputs.end());
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      const DetectionResult result,
+      object_detector->Postprocess(
+          output_tensors, *frame_buffer,
+          ParseTextProtoOrDie<BoundingBox>(
+              "origin_x: 4 origin_y: 2 width: 8 height: 4")));
+
+  // Boxes are denormalized to the 8x4 region, then offset by its origin.
+  ExpectApproximatelyEqual(
+      result,
+      ParseTextProtoOrDie<DetectionResult>(
+          R"pb(detections {
+                 bounding_box { origin_x: 6 origin_y: 3 width: 2 height: 2 }
+                 classes { index: 0 score: 0.8 class_name: "cat" }
+               }
+               detections {
+                 bounding_box { origin_x: 8 origin_y: 4 width: 4 height: 2 }
+                 classes { index: 1 score: 0.7 class_name: "dog" }
+               }
+          )pb"));
+}
+
+TEST_F(RawOutputsTest, FailsWithMissingLabels) {
+  // Without a background class, the model has 3 classes for 2 labels.
+  ObjectDetectorOptions options = GetOptions("cat\ndog\n");
+  options.mutable_raw_detection_options()->set_has_background_class(false);
+
+  StatusOr<std::unique_ptr<ObjectDetector>> object_detector_or =
+      ObjectDetector::CreateFromOptions(options);
+
+  EXPECT_EQ(object_detector_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(object_detector_or.status().message(),
+              HasSubstr("model has 3 classes"));
+  EXPECT_THAT(object_detector_or.status().GetPayload(kTfLiteSupportPayload),
+              Optional(absl::Cord(absl::StrCat(
+                  TfLiteSupportStatus::kMetadataInconsistencyError))));
+}
+
 }  // namespace
 }  // namespace vision
 }  // namespace task
@@ -0,0 +1,277 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_lite_support/cc/task/vision/utils/pixel_lookup_tables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+
+constexpr uint16 kHalfOne = 0x3c00;
+constexpr uint16 kHalfInfinity = 0x7c00;
+
+uint16 FloatToHalfBits(float value) { return FloatToHalf(value).data; }
+
+TEST(FloatToHalfTest, ConvertsRepresentableValues) {
+  EXPECT_EQ(FloatToHalfBits(0.0f), 0x0000);
+  EXPECT_EQ(FloatToHalfBits(-0.0f), 0x8000);
+  EXPECT_EQ(FloatToHalfBits(1.0f), kHalfOne);
+  EXPECT_EQ(FloatToHalfBits(-2.0f), 0xc000);
+  EXPECT_EQ(FloatToHalfBits(127.5f), 0x57f8);
+  // Largest finite half.
+  EXPECT_EQ(FloatToHalfBits(65504.0f), 0x7bff);
+  // Smallest normal half.
+  EXPECT_EQ(FloatToHalfBits(std::ldexp(1.0f, -14)), 0x0400);
+}
+
+TEST(FloatToHalfTest, RoundsToNearestEven) {
+  // Half precision values around 1 are 2^-10 apart.
+  const float ulp = std::ldexp(1.0f, -10);
+  // Ties round to the even mantissa.
+  EXPECT_EQ(FloatToHalfBits(1.0f + ulp / 2), kHalfOne);
+  EXPECT_EQ(FloatToHalfBits(1.0f + 3 * ulp / 2), kHalfOne + 2);
+  EXPECT_EQ(FloatToHalfBits(-1.0f - ulp / 2), 0x8000 | kHalfOne);
+  // Others round to the nearest value.
+  EXPECT_EQ(FloatToHalfBits(1.0f + ulp / 2 + ulp / 64), kHalfOne + 1);
+  EXPECT_EQ(FloatToHalfBits(1.0f + ulp / 2 - ulp / 64), kHalfOne);
+  // Rounding up the mantissa carries into the exponent.
+  EXPECT_EQ(FloatToHalfBits(2.0f - ulp / 4), 0x4000);
+}
+
+TEST(FloatToHalfTest, ConvertsSubnormals) {
+  // Subnormal halves are multiples of 2^-24.
+  const float unit = std::ldexp(1.0f, -24);
+  EXPECT_EQ(FloatToHalfBits(unit), 0x0001);
+  EXPECT_EQ(FloatToHalfBits(-unit), 0x8001);
+  EXPECT_EQ(FloatToHalfBits(512 * unit), 0x0200);
+  // Largest subnormal half.
+  EXPECT_EQ(FloatToHalfBits(1023 * unit), 0x03ff);
+  // Ties round to even.
+  EXPECT_EQ(FloatToHalfBits(unit / 2), 0x0000);
+  EXPECT_EQ(FloatToHalfBits(1.5f * unit), 0x0002);
+  EXPECT_EQ(FloatToHalfBits(2.5f * unit), 0x0002);
+  // Values too small underflow to zero.
+  EXPECT_EQ(FloatToHalfBits(unit / 4), 0x0000);
+  EXPECT_EQ(FloatToHalfBits(-unit / 4), 0x8000);
+  EXPECT_EQ(FloatToHalfBits(std::numeric_limits<float>::denorm_min()),
+            0x0000);
+  // Rounding up the largest subnormals gives the smallest normal half.
+  EXPECT_EQ(FloatToHalfBits(1023.75f * unit), 0x0400);
+}
+
+TEST(FloatToHalfTest, OverflowsToInfinity) {
+  EXPECT_EQ(FloatToHalfBits(65519.0f), 0x7bff);
+  // Halfway between the largest finite half and 2^16: rounds to even, i.e.
+  // infinity.
+  EXPECT_EQ(FloatToHalfBits(65520.0f), kHalfInfinity);
+  EXPECT_EQ(FloatToHalfBits(1e10f), kHalfInfinity);
+  EXPECT_EQ(FloatToHalfBits(-1e10f), 0x8000 | kHalfInfinity);
+  EXPECT_EQ(FloatToHalfBits(std::numeric_limits<float>::max()),
+            kHalfInfinity);
+  EXPECT_EQ(FloatToHalfBits(std::numeric_limits<float>::infinity()),
+            kHalfInfinity);
+  EXPECT_EQ(FloatToHalfBits(-std::numeric_limits<float>::infinity()),
+            0x8000 | kHalfInfinity);
+}
+
+TEST(FloatToHalfTest, ConvertsNaN) {
+  for (float nan : {std::numeric_limits<float>::quiet_NaN(),
+                    -std::numeric_limits<float>::quiet_NaN(),
+                    std::numeric_limits<float>::signaling_NaN()}) {
+    const uint16 half = FloatToHalfBits(nan);
+    // All exponent bits set, and a non-zero mantissa.
+    EXPECT_EQ(half & kHalfInfinity, kHalfInfinity);
+    EXPECT_NE(half & 0x03ff, 0);
+  }
+}
+
+TEST(BuildInt8LookupTablesTest, QuantizesPixelValues) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      PixelLookupTables<int8> tables,
+      BuildInt8LookupTables(absl::nullopt, /*scale=*/1.0f,
+                            /*zero_point=*/-128));
+
+  for (int c = 0; c < 3; ++c) {
+    for (int pixel = 0; pixel < 256; ++pixel) {
+      EXPECT_EQ(tables[c][pixel], pixel - 128);
+    }
+  }
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      tables, BuildInt8LookupTables(absl::nullopt, /*scale=*/4.0f,
+                                    /*zero_point=*/-100));
+
+  EXPECT_EQ(tables[0][0], -100);
+  // 5 / 4 rounds to 1, 6 / 4 to 2.
+  EXPECT_EQ(tables[1][5], -99);
+  EXPECT_EQ(tables[2][6], -98);
+  EXPECT_EQ(tables[0][255], -36);
+}
+
+TEST(BuildInt8LookupTablesTest, ClampsQuantizedValues) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      PixelLookupTables<int8> tables,
+      BuildInt8LookupTables(absl::nullopt, /*scale=*/0.5f,
+                            /*zero_point=*/-200));
+
+  for (int c = 0; c < 3; ++c) {
+    for (int pixel = 0; pixel < 256; ++pixel) {
+      const int expected = std::min(std::max(2 * pixel - 200, -128), 127);
+      EXPECT_EQ(tables[c][pixel], expected);
+    }
+  }
+  EXPECT_EQ(tables[0][0], -128);
+  EXPECT_EQ(tables[0][255], 127);
+}
+
+TEST(BuildInt8LookupTablesTest, NormalizesPerChannel) {
+  NormalizationOptions options = {/*mean_values=*/{0.0f, 127.5f, 255.0f},
+                                  /*std_values=*/{1.0f, 0.5f, 2.0f},
+                                  /*num_values=*/3};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      PixelLookupTables<int8> tables,
+      BuildInt8LookupTables(options, /*scale=*/1.0f, /*zero_point=*/0));
+
+  // R: pixel, clamped.
+  EXPECT_EQ(tables[0][0], 0);
+  EXPECT_EQ(tables[0][100], 100);
+  EXPECT_EQ(tables[0][200], 127);
+  // G: 2 * (pixel - 127.5), clamped.
+  EXPECT_EQ(tables[1][127], -1);
+  EXPECT_EQ(tables[1][128], 1);
+  EXPECT_EQ(tables[1][150], 45);
+  EXPECT_EQ(tables[1][0], -128);
+  EXPECT_EQ(tables[1][255], 127);
+  // B: (pixel - 255) / 2. Ties round away from zero.
+  EXPECT_EQ(tables[2][255], 0);
+  EXPECT_EQ(tables[2][0], -128);
+  EXPECT_EQ(tables[2][100], -78);
+}
+
+TEST(BuildInt8LookupTablesTest, NormalizesWithSingleValue) {
+  NormalizationOptions options = {/*mean_values=*/{127.5f, 0.0f, 0.0f},
+                                  /*std_values=*/{127.5f, 0.0f, 0.0f},
+                                  /*num_values=*/1};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      PixelLookupTables<int8> tables,
+      BuildInt8LookupTables(options, /*scale=*/1.0f / 128, /*zero_point=*/0));
+
+  for (int c = 0; c < 3; ++c) {
+    EXPECT_EQ(tables[c][0], -128);
+    EXPECT_EQ(tables[c][255], 127);
+  }
+}
+
+TEST(BuildInt8LookupTablesTest, FailsWithZeroStdValue) {
+  NormalizationOptions options = {/*mean_values=*/{0.0f, 0.0f, 0.0f},
+                                  /*std_values=*/{1.0f, 0.0f, 1.0f},
+                                  /*num_values=*/3};
+
+  StatusOr<PixelLookupTables<int8>> tables_or =
+      BuildInt8LookupTables(options, /*scale=*/1.0f, /*zero_point=*/0);
+
+  EXPECT_EQ(tables_or.status().code(), absl::StatusCode::kInternal);
+  EXPECT_THAT(tables_or.status().message(), HasSubstr("std_values"));
+}
+
+TEST(BuildFloat16LookupTablesTest, NormalizesPerChannel) {
+  NormalizationOptions options = {/*mean_values=*/{127.5f, 0.0f, 0.0f},
+                                  /*std_values=*/{127.5f, 2.0f, 4.0f},
+                                  /*num_values=*/3};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(PixelLookupTables<TfLiteFloat16> tables,
+                               BuildFloat16LookupTables(options));
+
+  EXPECT_EQ(tables[0][0].data, 0x8000 | kHalfOne);
+  EXPECT_EQ(tables[0][255].data, kHalfOne);
+  EXPECT_EQ(tables[1][0].data, 0x0000);
+  EXPECT_EQ(tables[1][255].data, 0x57f8);
+  EXPECT_EQ(tables[2][4].data, kHalfOne);
+  for (int c = 0; c < 3; ++c) {
+    for (int pixel = 0; pixel < 256; ++pixel) {
+      EXPECT_EQ(tables[c][pixel].data,
+                FloatToHalfBits((1.0f / options.std_values[c]) *
+                                (pixel - options.mean_values[c])));
+    }
+  }
+}
+
+TEST(BuildFloat16LookupTablesTest, FailsWithZeroStdValue) {
+  NormalizationOptions options = {/*mean_values=*/{0.0f, 0.0f, 0.0f},
+                                  /*std_values=*/{0.0f, 0.0f, 0.0f},
+                                  /*num_values=*/1};
+
+  StatusOr<PixelLookupTables<TfLiteFloat16>> tables_or =
+      BuildFloat16LookupTables(options);
+
+  EXPECT_EQ(tables_or.status().code(), absl::StatusCode::kInternal);
+  EXPECT_THAT(tables_or.status().message(), HasSubstr("std_values"));
+}
+
+TEST(PopulateFromLookupTablesTest, SkipsRowPadding) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      PixelLookupTables<int8> tables,
+      BuildInt8LookupTables(absl::nullopt, /*scale=*/1.0f,
+                            /*zero_point=*/-128));
+  // 2 rows of 2 pixels, with 2 padding bytes at the end of each row.
+  const std::vector<uint8> input = {128, 129, 130, 131, 132, 133, 0,   0,
+                                    134, 135, 136, 137, 138, 139, 255, 255};
+  // The last element must be left untouched.
+  std::vector<int8> output(13, 42);
+
+  PopulateFromLookupTables(input.data(), /*num_rows=*/2, /*row_pixels=*/2,
+                           /*input_row_stride_bytes=*/8, tables,
+                           output.data());
+
+  EXPECT_THAT(output, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 42));
+}
+
+TEST(PopulateFromLookupTablesTest, MapsEachChannelThroughItsTable) {
+  NormalizationOptions options = {/*mean_values=*/{0.0f, 0.0f, 0.0f},
+                                  /*std_values=*/{1.0f, 2.0f, 4.0f},
+                                  /*num_values=*/3};
+  SUPPORT_ASSERT_OK_AND_ASSIGN(PixelLookupTables<TfLiteFloat16> tables,
+                               BuildFloat16LookupTables(options));
+  const std::vector<uint8> input = {1, 2, 4, 2, 4, 8};
+  std::vector<TfLiteFloat16> output(6);
+
+  PopulateFromLookupTables(input.data(), /*num_rows=*/1, /*row_pixels=*/2,
+                           /*input_row_stride_bytes=*/6, tables,
+                           output.data());
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(output[i].data, kHalfOne);
+    EXPECT_EQ(output[3 + i].data, FloatToHalfBits(2.0f));
+  }
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,202 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// End-to-end benchmarks of the vision tasks (preprocessing, inference and
+// postprocessing) on the test models, for an RGB image and for the same image
+// as a NV21 camera frame.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/cc/test/task/vision:vision_task_benchmark
+//
+// Append `-- --benchmark_out=<file> --benchmark_out_format=json` to write the
+// results in a machine-readable form, e.g. to track regressions over time.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/image_embedder.h"
+#include "tensorflow_lite_support/cc/task/vision/image_segmenter.h"
+#include "tensorflow_lite_support/cc/task/vision/object_detector.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_embedder_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_segmenter_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/object_detector_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/examples/task/vision/desktop/utils/image_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::tflite::support::StatusOr;
+
+constexpr char kTestDataDirectory[] =
+    "./tensorflow_lite_support/cc/test/testdata/task/vision/";
+constexpr char kMobileNetQuantized[] = "mobilenet_v1_0.25_224_quant.tflite";
+constexpr char kMobileNetFloat[] = "mobilenet_v1_0.25_224_1_default_1.tflite";
+constexpr char kMobileSsd[] =
+    "coco_ssd_mobilenet_v1_1.0_quant_2018_06_29.tflite";
+constexpr char kDeepLabV3[] = "deeplabv3.tflite";
+constexpr char kImage[] = "burger.jpg";
+
+// The input image, both as a RGB buffer and as a NV21 camera frame.
+class Inputs {
+ public:
+  static StatusOr<std::unique_ptr<Inputs>> Create() {
+    ASSIGN_OR_RETURN(ImageData image, DecodeImageFromFile(absl::StrCat(
+                                          kTestDataDirectory, kImage)));
+    auto inputs = absl::WrapUnique(new Inputs(image));
+    ImageDataFree(&image);
+    RETURN_IF_ERROR(inputs->CreateNv21Frame());
+    return inputs;
+  }
+
+  const FrameBuffer& Get(bool nv21) const {
+    return nv21 ? *nv21_frame_ : *rgb_frame_;
+  }
+
+ private:
+  explicit Inputs(const ImageData& image)
+      : rgb_pixels_(image.pixel_data, image.pixel_data +
+                                          image.width * image.height * 3),
+        rgb_frame_(CreateFromRgbRawBuffer(
+            rgb_pixels_.data(), {image.width, image.height})) {}
+
+  absl::Status CreateNv21Frame() {
+    const FrameBuffer::Dimension dimension = rgb_frame_->dimension();
+    nv21_pixels_.resize(
+        GetFrameBufferByteSize(dimension, FrameBuffer::Format::kNV21));
+    ASSIGN_OR_RETURN(nv21_frame_,
+                     CreateFromRawBuffer(nv21_pixels_.data(), dimension,
+                                         FrameBuffer::Format::kNV21));
+    return FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv)
+        ->Convert(*rgb_frame_, nv21_frame_.get());
+  }
+
+  std::vector<uint8> rgb_pixels_;
+  std::unique_ptr<FrameBuffer> rgb_frame_;
+  std::vector<uint8> nv21_pixels_;
+  std::unique_ptr<FrameBuffer> nv21_frame_;
+};
+
+template <typename Task, typename Options>
+StatusOr<std::unique_ptr<Task>> CreateTask(const std::string& model_name,
+                                           int num_threads) {
+  Options options;
+  options.mutable_model_file_with_metadata()->set_file_name(
+      absl::StrCat(kTestDataDirectory, model_name));
+  options.set_num_threads(num_threads);
+  return Task::CreateFromOptions(options);
+}
+
+// Runs `run` on the input selected by the first argument (0 for RGB, 1 for
+// NV21) with the task created from `model_name`, using the number of threads
+// given by the second argument.
+template <typename Task, typename Options, typename Run>
+void RunBenchmark(benchmark::State& state, const std::string& model_name,
+                  Run run) {
+  auto inputs = Inputs::Create();
+  auto task = CreateTask<Task, Options>(model_name, state.range(1));
+  if (!inputs.ok() || !task.ok()) {
+    state.SkipWithError("Failed to create the inputs or the task.");
+    return;
+  }
+  const FrameBuffer& frame_buffer = (*inputs)->Get(state.range(0));
+  if (!run(task->get(), frame_buffer).ok()) {
+    state.SkipWithError("Inference failed.");
+    return;
+  }
+  state.SetLabel(state.range(0) ? "NV21" : "RGB");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(run(task->get(), frame_buffer));
+  }
+}
+
+void BM_ClassifyQuantized(benchmark::State& state) {
+  RunBenchmark<ImageClassifier, ImageClassifierOptions>(
+      state, kMobileNetQuantized,
+      [](ImageClassifier* classifier, const FrameBuffer& frame_buffer) {
+        return classifier->Classify(frame_buffer);
+      });
+}
+
+void BM_ClassifyFloat(benchmark::State& state) {
+  RunBenchmark<ImageClassifier, ImageClassifierOptions>(
+      state, kMobileNetFloat,
+      [](ImageClassifier* classifier, const FrameBuffer& frame_buffer) {
+        return classifier->Classify(frame_buffer);
+      });
+}
+
+void BM_Detect(benchmark::State& state) {
+  RunBenchmark<ObjectDetector, ObjectDetectorOptions>(
+      state, kMobileSsd,
+      [](ObjectDetector* detector, const FrameBuffer& frame_buffer) {
+        return detector->Detect(frame_buffer);
+      });
+}
+
+void BM_Segment(benchmark::State& state) {
+  RunBenchmark<ImageSegmenter, ImageSegmenterOptions>(
+      state, kDeepLabV3,
+      [](ImageSegmenter* segmenter, const FrameBuffer& frame_buffer) {
+        return segmenter->Segment(frame_buffer);
+      });
+}
+
+void BM_Embed(benchmark::State& state) {
+  RunBenchmark<ImageEmbedder, ImageEmbedderOptions>(
+      state, kMobileNetFloat,
+      [](ImageEmbedder* embedder, const FrameBuffer& frame_buffer) {
+        return embedder->Embed(frame_buffer);
+      });
+}
+
+// Arguments are whether the input is a NV21 frame (instead of a RGB buffer)
+// and the number of threads of the interpreter.
+void BenchmarkArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int nv21 : {0, 1}) {
+    for (int num_threads : {1, 4}) {
+      benchmark->Args({nv21, num_threads});
+    }
+  }
+  benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_ClassifyQuantized)->Apply(BenchmarkArgs);
+BENCHMARK(BM_ClassifyFloat)->Apply(BenchmarkArgs);
+BENCHMARK(BM_Detect)->Apply(BenchmarkArgs);
+BENCHMARK(BM_Segment)->Apply(BenchmarkArgs);
+BENCHMARK(BM_Embed)->Apply(BenchmarkArgs);
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+BENCHMARK_MAIN();
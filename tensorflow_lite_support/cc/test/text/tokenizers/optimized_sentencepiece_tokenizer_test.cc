@@ -0,0 +1,125 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/text/tokenizers/optimized_sentencepiece_tokenizer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "src/sentencepiece_model.pb.h"  // from @com_google_sentencepiece
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/task_utils.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/sentencepiece_tokenizer.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/model_converter.h"
+
+namespace tflite {
+namespace support {
+namespace text {
+namespace tokenizer {
+namespace {
+
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
+using ::tflite::ops::custom::sentencepiece::ConvertSentencepieceModelToFlatBuffer;
+using ::tflite::task::JoinPath;
+using ::tflite::task::core::LoadBinaryContent;
+
+constexpr char kTestSPModelPath[] =
+    "/tensorflow_lite_support/custom_ops/kernel/"
+    "sentencepiece/testdata/sentencepiece.model";
+
+std::string LoadTestModel() {
+  return LoadBinaryContent(
+      JoinPath("./" /*test src dir*/, kTestSPModelPath).c_str());
+}
+
+class OptimizedSentencePieceTokenizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const std::string model = LoadTestModel();
+    reference_ = absl::make_unique<SentencePieceTokenizer>(model.data(),
+                                                           model.size());
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        tokenizer_, OptimizedSentencePieceTokenizer::CreateFromModel(model));
+  }
+
+  std::unique_ptr<SentencePieceTokenizer> reference_;
+  std::unique_ptr<OptimizedSentencePieceTokenizer> tokenizer_;
+};
+
+TEST_F(OptimizedSentencePieceTokenizerTest, MatchesSentencePieceTokenizer) {
+  for (const std::string input :
+       {"Hello world!", "  Hello   world  ", "",
+        "Hello world! This is a longer sentence."}) {
+    EXPECT_THAT(tokenizer_->TokenizeToIds(input),
+                ElementsAreArray(reference_->TokenizeToIds(input)))
+        << input;
+    EXPECT_THAT(tokenizer_->Tokenize(input).subwords,
+                ElementsAreArray(reference_->Tokenize(input).subwords))
+        << input;
+  }
+}
+
+TEST_F(OptimizedSentencePieceTokenizerTest, LookupMatchesSentencePiece) {
+  for (const std::string piece : {"\xe2\x96\x81Hello", "s", "not-a-piece"}) {
+    int id = -1;
+    int reference_id = -2;
+    EXPECT_TRUE(tokenizer_->LookupId(piece, &id));
+    reference_->LookupId(piece, &reference_id);
+    // Missing pieces map to the unknown id.
+    EXPECT_EQ(id, reference_id) << piece;
+  }
+  for (int id = 0; id < 4000; id += 97) {
+    absl::string_view piece;
+    absl::string_view reference_piece;
+    reference_->LookupWord(id, &reference_piece);
+    EXPECT_TRUE(tokenizer_->LookupWord(id, &piece));
+    EXPECT_EQ(piece, reference_piece) << id;
+  }
+}
+
+TEST(OptimizedSentencePieceTokenizerCreationTest, FailsWithNonUnigramModel) {
+  ::sentencepiece::ModelProto model;
+  const std::string unigram_model = LoadTestModel();
+  ASSERT_TRUE(model.ParseFromString(unigram_model));
+  ASSERT_EQ(model.trainer_spec().model_type(),
+            ::sentencepiece::TrainerSpec::UNIGRAM);
+  model.mutable_trainer_spec()->set_model_type(
+      ::sentencepiece::TrainerSpec::BPE);
+  const std::string bpe_model = model.SerializeAsString();
+
+  auto tokenizer_or =
+      OptimizedSentencePieceTokenizer::CreateFromModel(bpe_model);
+
+  EXPECT_EQ(tokenizer_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(tokenizer_or.status().message(), HasSubstr("UNIGRAM"));
+  auto encoder_config_or = ConvertSentencepieceModelToFlatBuffer(bpe_model);
+  EXPECT_EQ(encoder_config_or.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(encoder_config_or.status().message(), HasSubstr("BPE"));
+}
+
+}  // namespace
+}  // namespace tokenizer
+}  // namespace text
+}  // namespace support
+}  // namespace tflite
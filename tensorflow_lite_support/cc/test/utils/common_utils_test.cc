@@ -0,0 +1,199 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/utils/common_utils.h"
+
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace support {
+namespace utils {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(SplitLinesTest, SplitsOnNewlines) {
+  EXPECT_THAT(SplitLines("a\nbc\n\nd"), ElementsAre("a", "bc", "", "d"));
+}
+
+TEST(SplitLinesTest, IgnoresTrailingNewline) {
+  EXPECT_THAT(SplitLines("a\nb\n"), ElementsAre("a", "b"));
+  EXPECT_THAT(SplitLines("\n"), ElementsAre(""));
+  EXPECT_THAT(SplitLines(""), IsEmpty());
+}
+
+TEST(SplitLinesTest, SkipsEmptyLines) {
+  EXPECT_THAT(SplitLines("\na\n\n\nb\n\n", /*skip_empty_lines=*/true),
+              ElementsAre("a", "b"));
+}
+
+TEST(SplitLinesTest, ReturnsViewsIntoBuffer) {
+  const std::string buffer = "first\nsecond";
+
+  const std::vector<absl::string_view> lines = SplitLines(buffer);
+
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_EQ(lines[0].data(), buffer.data());
+  EXPECT_EQ(lines[1].data(), buffer.data() + 6);
+}
+
+TEST(LoadVocabFromBufferTest, SkipsEmptyLines) {
+  const std::string buffer = "hello\n\nworld\n";
+
+  EXPECT_THAT(LoadVocabFromBuffer(buffer.data(), buffer.size()),
+              ElementsAre("hello", "world"));
+}
+
+TEST(LoadVocabAndIndexFromBufferTest, IgnoresMalformedLines) {
+  const std::string buffer = "hello 1\nworld 2 extra\nnoid\nbad x\n\nlast 3";
+
+  EXPECT_THAT(LoadVocabAndIndexFromBuffer(buffer.data(), buffer.size()),
+              UnorderedElementsAre(Pair("hello", 1), Pair("world", 2),
+                                   Pair("last", 3)));
+}
+
+TEST(InternedVocabTest, FromBufferAssignsIdsInOrder) {
+  const InternedVocab vocab = InternedVocab::FromBuffer("hello\n\nworld\n");
+
+  EXPECT_EQ(vocab.size(), 2);
+  int id;
+  ASSERT_TRUE(vocab.LookupId("hello", &id));
+  EXPECT_EQ(id, 0);
+  ASSERT_TRUE(vocab.LookupId("world", &id));
+  EXPECT_EQ(id, 1);
+  absl::string_view token;
+  ASSERT_TRUE(vocab.LookupWord(1, &token));
+  EXPECT_EQ(token, "world");
+}
+
+TEST(InternedVocabTest, FromTokens) {
+  const InternedVocab vocab = InternedVocab::FromTokens({"a", "b", "c"});
+
+  EXPECT_EQ(vocab.size(), 3);
+  EXPECT_TRUE(vocab.Contains("c"));
+  EXPECT_FALSE(vocab.Contains("d"));
+}
+
+TEST(InternedVocabTest, LookupFailsForMissingEntries) {
+  const InternedVocab vocab = InternedVocab::FromBufferWithIds("a 0\nc 2");
+  int id;
+  absl::string_view token;
+
+  EXPECT_FALSE(vocab.LookupId("b", &id));
+  EXPECT_FALSE(vocab.LookupId("", &id));
+  EXPECT_FALSE(vocab.LookupWord(-1, &token));
+  EXPECT_FALSE(vocab.LookupWord(1, &token));
+  EXPECT_FALSE(vocab.LookupWord(3, &token));
+  EXPECT_FALSE(vocab.LookupWord(INT_MAX, &token));
+}
+
+TEST(InternedVocabTest, FromBufferWithIdsIgnoresBadLines) {
+  const InternedVocab vocab = InternedVocab::FromBufferWithIds(
+      "a 0\nnoid\nbad x\nnegative -1\n\nb 1 extra\n");
+
+  EXPECT_EQ(vocab.size(), 2);
+  EXPECT_FALSE(vocab.Contains("noid"));
+  EXPECT_FALSE(vocab.Contains("bad"));
+  EXPECT_FALSE(vocab.Contains("negative"));
+  int id;
+  ASSERT_TRUE(vocab.LookupId("b", &id));
+  EXPECT_EQ(id, 1);
+}
+
+TEST(InternedVocabTest, FromBufferWithIdsKeepsLastDuplicate) {
+  // "a" maps to both 0 and 1, and id 1 to both "a" and "b".
+  const InternedVocab vocab =
+      InternedVocab::FromBufferWithIds("a 0\na 1\nb 1\n");
+
+  EXPECT_EQ(vocab.size(), 2);
+  int id;
+  ASSERT_TRUE(vocab.LookupId("a", &id));
+  EXPECT_EQ(id, 1);
+  absl::string_view token;
+  ASSERT_TRUE(vocab.LookupWord(0, &token));
+  EXPECT_EQ(token, "a");
+  ASSERT_TRUE(vocab.LookupWord(1, &token));
+  EXPECT_EQ(token, "b");
+}
+
+TEST(InternedVocabTest, FromBufferWithIdsSupportsGaps) {
+  const InternedVocab vocab = InternedVocab::FromBufferWithIds("a 3\nb 0\n");
+
+  EXPECT_EQ(vocab.size(), 2);
+  absl::string_view token;
+  ASSERT_TRUE(vocab.LookupWord(3, &token));
+  EXPECT_EQ(token, "a");
+  EXPECT_FALSE(vocab.LookupWord(1, &token));
+}
+
+TEST(InternedVocabTest, FromBufferWithIdsSupportsSparseIds) {
+  const std::vector<std::pair<std::string, int>> entries = {
+      {"small", 0}, {"large", 2000000000}, {"max", INT_MAX}};
+  std::string buffer;
+  for (const auto& entry : entries) {
+    buffer += entry.first + " " + std::to_string(entry.second) + "\n";
+  }
+
+  const InternedVocab vocab = InternedVocab::FromBufferWithIds(buffer);
+
+  EXPECT_EQ(vocab.size(), 3);
+  for (const auto& entry : entries) {
+    int id;
+    ASSERT_TRUE(vocab.LookupId(entry.first, &id));
+    EXPECT_EQ(id, entry.second);
+    absl::string_view token;
+    ASSERT_TRUE(vocab.LookupWord(entry.second, &token));
+    EXPECT_EQ(token, entry.first);
+  }
+  absl::string_view token;
+  EXPECT_FALSE(vocab.LookupWord(1, &token));
+  EXPECT_FALSE(vocab.LookupWord(-1, &token));
+}
+
+TEST(InternedVocabTest, ViewsSurviveMovesAndBufferRelease) {
+  std::string buffer = "hello 0\nworld 1\n";
+  InternedVocab vocab = InternedVocab::FromBufferWithIds(buffer);
+  buffer.assign(buffer.size(), 'x');
+
+  const InternedVocab moved = std::move(vocab);
+
+  absl::string_view token;
+  ASSERT_TRUE(moved.LookupWord(1, &token));
+  EXPECT_EQ(token, "world");
+  EXPECT_TRUE(moved.Contains("hello"));
+}
+
+TEST(InternedVocabTest, SucceedsWithEmptyBuffer) {
+  const InternedVocab vocab = InternedVocab::FromBufferWithIds("");
+
+  EXPECT_EQ(vocab.size(), 0);
+  absl::string_view token;
+  EXPECT_FALSE(vocab.LookupWord(0, &token));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace support
+}  // namespace tflite
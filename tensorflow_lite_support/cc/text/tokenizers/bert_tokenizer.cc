@@ -24,35 +24,27 @@ namespace tokenizer {
 
 FlatHashMapBackedWordpiece::FlatHashMapBackedWordpiece(
     const std::vector<std::string>& vocab)
-    : vocab_{vocab} {
-  for (int i = 0; i < vocab_.size(); ++i) {
-    index_map_[vocab_[i]] = i;
-  }
-}
+    : vocab_{utils::InternedVocab::FromTokens(vocab)} {}
+
+FlatHashMapBackedWordpiece::FlatHashMapBackedWordpiece(
+    const char* vocab_buffer_data, size_t vocab_buffer_size)
+    : vocab_{utils::InternedVocab::FromBuffer(
+          absl::string_view(vocab_buffer_data, vocab_buffer_size))} {}
 
 tensorflow::text::LookupStatus FlatHashMapBackedWordpiece::Contains(
     absl::string_view key, bool* value) const {
-  *value = index_map_.contains(key);
+  *value = vocab_.Contains(key);
   return tensorflow::text::LookupStatus();
 }
 
 bool FlatHashMapBackedWordpiece::LookupId(const absl::string_view key,
                                           int* result) const {
-  auto it = index_map_.find(key);
-  if (it == index_map_.end()) {
-    return false;
-  }
-  *result = it->second;
-  return true;
+  return vocab_.LookupId(key, result);
 }
 
 bool FlatHashMapBackedWordpiece::LookupWord(int vocab_id,
                                             absl::string_view* result) const {
-  if (vocab_id >= vocab_.size() || vocab_id < 0) {
-    return false;
-  }
-  *result = vocab_[vocab_id];
-  return true;
+  return vocab_.LookupWord(vocab_id, result);
 }
 
 TokenizerResult BertTokenizer::Tokenize(const std::string& input) {
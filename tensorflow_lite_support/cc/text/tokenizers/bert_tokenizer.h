@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <fstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"  // from @com_google_absl
@@ -68,11 +69,17 @@ struct BertTokenizerOptions {
 };
 
 // A flat-hash-map based implementation of WordpieceVocab, used in
-// BertTokenizer to invoke tensorflow::text::WordpieceTokenize within.
+// BertTokenizer to invoke tensorflow::text::WordpieceTokenize within. The
+// vocabulary is interned into a single arena (see utils::InternedVocab).
 class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
  public:
   explicit FlatHashMapBackedWordpiece(const std::vector<std::string>& vocab);
 
+  // Builds the vocabulary straight from a buffer with one token on each line,
+  // without intermediate per-token strings.
+  FlatHashMapBackedWordpiece(const char* vocab_buffer_data,
+                             size_t vocab_buffer_size);
+
   tensorflow::text::LookupStatus Contains(absl::string_view key,
                                           bool* value) const override;
   bool LookupId(absl::string_view key, int* result) const;
@@ -80,9 +87,8 @@ class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
   int VocabularySize() const { return vocab_.size(); }
 
  private:
-  // All words indexed position in vocabulary file.
-  std::vector<std::string> vocab_;
-  absl::flat_hash_map<absl::string_view, int> index_map_;
+  // All words, indexed by position in vocabulary file.
+  utils::InternedVocab vocab_;
 };
 
 // Wordpiece tokenizer for bert models. Initialized with a vocab file or vector.
@@ -91,10 +97,7 @@ class BertTokenizer : public tflite::support::text::tokenizer::Tokenizer {
   // Initialize the tokenizer from vocab vector and tokenizer configs.
   explicit BertTokenizer(const std::vector<std::string>& vocab,
                          const BertTokenizerOptions& options = {})
-      : vocab_{FlatHashMapBackedWordpiece(vocab)},
-        options_{options},
-        delim_re_{options.delim_str},
-        include_delim_re_{options.include_delim_str} {}
+      : BertTokenizer(FlatHashMapBackedWordpiece(vocab), options) {}
 
   // Initialize the tokenizer from file path to vocab and tokenizer configs.
   explicit BertTokenizer(const std::string& path_to_vocab,
@@ -106,7 +109,7 @@ class BertTokenizer : public tflite::support::text::tokenizer::Tokenizer {
   BertTokenizer(const char* vocab_buffer_data, size_t vocab_buffer_size,
                 const BertTokenizerOptions& options = {})
       : BertTokenizer(
-            utils::LoadVocabFromBuffer(vocab_buffer_data, vocab_buffer_size),
+            FlatHashMapBackedWordpiece(vocab_buffer_data, vocab_buffer_size),
             options) {}
 
   // Perform tokenization, return tokenized results containing the subwords.
@@ -135,6 +138,13 @@ class BertTokenizer : public tflite::support::text::tokenizer::Tokenizer {
   int VocabularySize() const { return vocab_.VocabularySize(); }
 
  private:
+  BertTokenizer(FlatHashMapBackedWordpiece vocab,
+                const BertTokenizerOptions& options)
+      : vocab_{std::move(vocab)},
+        options_{options},
+        delim_re_{options.delim_str},
+        include_delim_re_{options.include_delim_str} {}
+
   tflite::support::text::tokenizer::FlatHashMapBackedWordpiece vocab_;
   BertTokenizerOptions options_;
   RE2 delim_re_;
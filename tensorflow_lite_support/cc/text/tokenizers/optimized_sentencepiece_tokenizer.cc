@@ -0,0 +1,177 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/text/tokenizers/optimized_sentencepiece_tokenizer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "src/sentencepiece_model.pb.h"  // from @com_google_sentencepiece
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/encoder_config_generated.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/model_converter.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/optimized_encoder.h"
+
+namespace tflite {
+namespace support {
+namespace text {
+namespace tokenizer {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::ops::custom::sentencepiece::ConvertSentencepieceModelToFlatBuffer;
+using ::tflite::ops::custom::sentencepiece::EncoderConfig;
+using ::tflite::ops::custom::sentencepiece::EncoderResult;
+using ::tflite::ops::custom::sentencepiece::EncoderVersion_SENTENCE_PIECE;
+using ::tflite::ops::custom::sentencepiece::EncodeString;
+using ::tflite::ops::custom::sentencepiece::GetEncoderConfig;
+using ::tflite::ops::custom::sentencepiece::VerifyEncoderConfigBuffer;
+using ::tflite::support::utils::InternedVocab;
+using ::tflite::support::utils::SplitLines;
+
+}  // namespace
+
+/* static */
+StatusOr<std::unique_ptr<OptimizedSentencePieceTokenizer>>
+OptimizedSentencePieceTokenizer::CreateFromModel(
+    absl::string_view spmodel_buffer) {
+  ::sentencepiece::ModelProto model;
+  if (!model.ParseFromArray(spmodel_buffer.data(), spmodel_buffer.size())) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Failed to parse the SentencePiece model.",
+        TfLiteSupportStatus::kMetadataInvalidTokenizerError);
+  }
+  if (model.trainer_spec().model_type() !=
+      ::sentencepiece::TrainerSpec::UNIGRAM) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrCat("Unsupported SentencePiece model type: ",
+                     ::sentencepiece::TrainerSpec::ModelType_Name(
+                         model.trainer_spec().model_type()),
+                     ", only UNIGRAM models are supported."),
+        TfLiteSupportStatus::kMetadataInvalidTokenizerError);
+  }
+  auto encoder_config = ConvertSentencepieceModelToFlatBuffer(model);
+  if (!encoder_config.ok()) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrCat("Failed to convert the SentencePiece model: ",
+                     encoder_config.status().message()),
+        TfLiteSupportStatus::kMetadataInvalidTokenizerError);
+  }
+  std::vector<std::string> pieces;
+  pieces.reserve(model.pieces_size());
+  for (const auto& piece : model.pieces()) {
+    pieces.push_back(piece.piece());
+  }
+  // Use absl::WrapUnique() to call private constructor:
+  // https://abseil.io/tips/126.
+  return absl::WrapUnique(new OptimizedSentencePieceTokenizer(
+      std::move(encoder_config).value(), InternedVocab::FromTokens(pieces)));
+}
+
+/* static */
+StatusOr<std::unique_ptr<OptimizedSentencePieceTokenizer>>
+OptimizedSentencePieceTokenizer::CreateFromEncoderConfig(
+    absl::string_view encoder_config_buffer, absl::string_view vocab_buffer) {
+  if (!IsEncoderConfig(encoder_config_buffer)) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Invalid SentencePiece encoder config.",
+        TfLiteSupportStatus::kMetadataInvalidTokenizerError);
+  }
+  // Keep the piece only, dropping the optional score.
+  std::vector<std::string> pieces;
+  for (absl::string_view line : SplitLines(vocab_buffer)) {
+    pieces.emplace_back(line.substr(0, line.find('\t')));
+  }
+  return absl::WrapUnique(new OptimizedSentencePieceTokenizer(
+      std::string(encoder_config_buffer), InternedVocab::FromTokens(pieces)));
+}
+
+/* static */
+bool OptimizedSentencePieceTokenizer::IsEncoderConfig(
+    absl::string_view buffer) {
+  flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+  if (!VerifyEncoderConfigBuffer(verifier)) {
+    return false;
+  }
+  const EncoderConfig* config = GetEncoderConfig(buffer.data());
+  return config->version() == EncoderVersion_SENTENCE_PIECE &&
+         config->pieces() != nullptr && config->pieces_scores() != nullptr;
+}
+
+OptimizedSentencePieceTokenizer::OptimizedSentencePieceTokenizer(
+    std::string encoder_config, InternedVocab vocab)
+    : encoder_config_(std::move(encoder_config)), vocab_(std::move(vocab)) {
+  unknown_id_ = GetEncoderConfig(encoder_config_.data())->unknown_code();
+}
+
+TokenizerResult OptimizedSentencePieceTokenizer::Tokenize(
+    const std::string& input) {
+  const EncoderResult encoded =
+      EncodeString(input, encoder_config_.data(), /*add_bos=*/false,
+                   /*add_eos=*/false, /*reverse=*/false);
+  TokenizerResult result;
+  result.subwords.reserve(encoded.codes.size());
+  for (int i = 0; i < encoded.codes.size(); ++i) {
+    absl::string_view piece;
+    if (encoded.codes[i] == unknown_id_ ||
+        !vocab_.LookupWord(encoded.codes[i], &piece)) {
+      // Unknown pieces span from their offset to the next one.
+      const int begin = encoded.offsets[i];
+      const int end = i + 1 < encoded.offsets.size()
+                          ? std::max(begin, encoded.offsets[i + 1])
+                          : static_cast<int>(input.size());
+      piece = absl::string_view(input).substr(begin, end - begin);
+    }
+    result.subwords.emplace_back(piece);
+  }
+  return result;
+}
+
+std::vector<int> OptimizedSentencePieceTokenizer::TokenizeToIds(
+    const std::string& input) {
+  EncoderResult encoded =
+      EncodeString(input, encoder_config_.data(), /*add_bos=*/false,
+                   /*add_eos=*/false, /*reverse=*/false);
+  return std::move(encoded.codes);
+}
+
+bool OptimizedSentencePieceTokenizer::LookupId(absl::string_view key,
+                                               int* result) const {
+  if (!vocab_.LookupId(key, result)) {
+    *result = unknown_id_;
+  }
+  return true;
+}
+
+bool OptimizedSentencePieceTokenizer::LookupWord(
+    int vocab_id, absl::string_view* result) const {
+  return vocab_.LookupWord(vocab_id, result);
+}
+
+}  // namespace tokenizer
+}  // namespace text
+}  // namespace support
+}  // namespace tflite
@@ -0,0 +1,94 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_OPTIMIZED_SENTENCEPIECE_TOKENIZER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_OPTIMIZED_SENTENCEPIECE_TOKENIZER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/tokenizer.h"
+#include "tensorflow_lite_support/cc/utils/common_utils.h"
+
+namespace tflite {
+namespace support {
+namespace text {
+namespace tokenizer {
+
+// SentencePiece tokenizer built on the optimized encoder of the
+// SENTENCEPIECE_TOKENIZER custom op: the SentencePiece model is converted once
+// into a flatbuffer holding double-array tries of the pieces and of the
+// normalization rules, which is then used for encoding without going through
+// the sentencepiece library.
+//
+// Unlike SentencePieceTokenizer, creation errors are reported as a status and
+// TokenizeToIds() returns the piece ids without building the piece strings.
+class OptimizedSentencePieceTokenizer : public Tokenizer {
+ public:
+  // Creates a tokenizer from a serialized SentencePiece model (ModelProto),
+  // converting it to the optimized encoder format. Only UNIGRAM models are
+  // supported: an error is returned for BPE, word or char models.
+  static tflite::support::StatusOr<
+      std::unique_ptr<OptimizedSentencePieceTokenizer>>
+  CreateFromModel(absl::string_view spmodel_buffer);
+
+  // Creates a tokenizer from a model already converted to the optimized encoder
+  // format (see ConvertSentencepieceModelToFlatBuffer()) and from its
+  // vocabulary, holding one piece per line optionally followed by a tab and its
+  // score, as in the ".vocab" files written by SentencePiece training. Both
+  // buffers are copied.
+  static tflite::support::StatusOr<
+      std::unique_ptr<OptimizedSentencePieceTokenizer>>
+  CreateFromEncoderConfig(absl::string_view encoder_config_buffer,
+                          absl::string_view vocab_buffer);
+
+  // Returns true if `buffer` holds a model converted to the optimized encoder
+  // format rather than a serialized SentencePiece model.
+  static bool IsEncoderConfig(absl::string_view buffer);
+
+  // Perform tokenization, return tokenized results. Unknown pieces are returned
+  // as the corresponding span of `input`.
+  TokenizerResult Tokenize(const std::string& input) override;
+
+  // Perform tokenization, return the ids of the pieces.
+  std::vector<int> TokenizeToIds(const std::string& input) override;
+
+  // Find the id of a string token. As with SentencePieceTokenizer, tokens
+  // missing from the vocabulary map to the unknown id.
+  bool LookupId(absl::string_view key, int* result) const override;
+
+  // Find the string token of an id.
+  bool LookupWord(int vocab_id, absl::string_view* result) const override;
+
+ private:
+  OptimizedSentencePieceTokenizer(std::string encoder_config,
+                                  tflite::support::utils::InternedVocab vocab);
+
+  // The model in the optimized encoder format.
+  std::string encoder_config_;
+  // The pieces, indexed by id.
+  tflite::support::utils::InternedVocab vocab_;
+  int unknown_id_;
+};
+
+}  // namespace tokenizer
+}  // namespace text
+}  // namespace support
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_OPTIMIZED_SENTENCEPIECE_TOKENIZER_H_
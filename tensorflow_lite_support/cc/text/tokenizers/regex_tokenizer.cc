@@ -29,15 +29,6 @@ namespace {
 constexpr char kStart[] = "<START>";
 constexpr char kPad[] = "<PAD>";
 constexpr char kUnknown[] = "<UNKNOWN>";
-
-void buildIndexTokenMap(
-    const absl::node_hash_map<std::string, int>& token_index_map,
-    absl::node_hash_map<int, absl::string_view>* index_token_map) {
-  for (const auto& token : token_index_map) {
-    (*index_token_map)[token.second] = token.first;
-  }
-}
-
 }  // namespace
 
 // RE2::FindAndConsume requires the delim_re_ to have a matching group in order
@@ -47,18 +38,15 @@ void buildIndexTokenMap(
 RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
                                const std::string& path_to_vocab)
     : delim_re_{absl::Substitute("($0)", regex_pattern)},
-      token_index_map_{utils::LoadVocabAndIndexFromFile(path_to_vocab)} {
-  buildIndexTokenMap(token_index_map_, &index_token_map_);
-}
+      vocab_{utils::InternedVocab::FromBufferWithIds(
+          utils::ReadFileToString(path_to_vocab))} {}
 
 RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
                                const char* vocab_buffer_data,
                                size_t vocab_buffer_size)
     : delim_re_{absl::Substitute("($0)", regex_pattern)},
-      token_index_map_{utils::LoadVocabAndIndexFromBuffer(vocab_buffer_data,
-                                                          vocab_buffer_size)} {
-  buildIndexTokenMap(token_index_map_, &index_token_map_);
-}
+      vocab_{utils::InternedVocab::FromBufferWithIds(
+          absl::string_view(vocab_buffer_data, vocab_buffer_size))} {}
 
 TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
   absl::string_view leftover(input.data());
@@ -90,21 +78,11 @@ TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
 }
 
 bool RegexTokenizer::LookupId(absl::string_view key, int* result) const {
-  auto it = token_index_map_.find(key);
-  if (it == token_index_map_.end()) {
-    return false;
-  }
-  *result = it->second;
-  return true;
+  return vocab_.LookupId(key, result);
 }
 
 bool RegexTokenizer::LookupWord(int vocab_id, absl::string_view* result) const {
-  auto it = index_token_map_.find(vocab_id);
-  if (it == index_token_map_.end()) {
-    return false;
-  }
-  *result = it->second;
-  return true;
+  return vocab_.LookupWord(vocab_id, result);
 }
 
 bool RegexTokenizer::GetStartToken(int* start_token) {
@@ -16,9 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 
-#include "absl/container/node_hash_map.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 #include "re2/re2.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/tokenizer.h"
+#include "tensorflow_lite_support/cc/utils/common_utils.h"
 
 namespace tflite {
 namespace support {
@@ -47,8 +48,7 @@ class RegexTokenizer : public Tokenizer {
 
  private:
   RE2 delim_re_;
-  absl::node_hash_map<std::string, int> token_index_map_;
-  absl::node_hash_map<int, absl::string_view> index_token_map_;
+  utils::InternedVocab vocab_;
 };
 
 }  // namespace tokenizer
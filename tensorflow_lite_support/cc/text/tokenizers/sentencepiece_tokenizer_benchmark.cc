@@ -0,0 +1,169 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmark comparing the SentencePieceTokenizer, which wraps the
+// sentencepiece library, with the OptimizedSentencePieceTokenizer, both for
+// load time and for the latency of converting one sentence into ids (the way
+// BertPreprocessor does).
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/cc/text/tokenizers:sentencepiece_tokenizer_benchmark
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow_lite_support/cc/text/tokenizers/optimized_sentencepiece_tokenizer.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/sentencepiece_tokenizer.h"
+#include "tensorflow_lite_support/cc/utils/common_utils.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/model_converter.h"
+
+namespace tflite {
+namespace support {
+namespace text {
+namespace tokenizer {
+namespace {
+
+using ::tflite::ops::custom::sentencepiece::ConvertSentencepieceModel;
+using ::tflite::support::utils::ReadFileToString;
+
+constexpr char kModelPath[] =
+    "./tensorflow_lite_support/custom_ops/kernel/sentencepiece/testdata/"
+    "sentencepiece.model";
+
+const std::string& GetModel() {
+  static const std::string* model =
+      new std::string(ReadFileToString(kModelPath));
+  return *model;
+}
+
+// Builds a sentence of `num_words` words.
+std::string BuildSentence(int num_words) {
+  const std::vector<std::string> words = {
+      "The",      "quick",   "brown", "fox",        "jumps", "over",
+      "the",      "lazy",    "dog.",  "Tokenizers", "split", "sentences",
+      "into",     "pieces,", "some",  "unusual",    "ones",  "like",
+      "café",     "or",      "42",    "included!"};
+  std::string sentence;
+  for (int i = 0; i < num_words; ++i) {
+    if (i > 0) sentence += " ";
+    sentence += words[(i * 7) % words.size()];
+  }
+  return sentence;
+}
+
+// Converts `text` into ids with the generic Tokenizer interface, as done before
+// TokenizeToIds() was introduced.
+std::vector<int> TokenizeAndLookupIds(Tokenizer* tokenizer,
+                                      const std::string& text) {
+  const TokenizerResult result = tokenizer->Tokenize(text);
+  std::vector<int> ids(result.subwords.size(), 0);
+  for (int i = 0; i < result.subwords.size(); ++i) {
+    tokenizer->LookupId(result.subwords[i], &ids[i]);
+  }
+  return ids;
+}
+
+void BM_LoadSentencePieceTokenizer(benchmark::State& state) {
+  const std::string& model = GetModel();
+  for (auto _ : state) {
+    SentencePieceTokenizer tokenizer(model.data(), model.size());
+    benchmark::DoNotOptimize(tokenizer);
+  }
+}
+BENCHMARK(BM_LoadSentencePieceTokenizer);
+
+void BM_LoadOptimizedSentencePieceTokenizer(benchmark::State& state) {
+  const std::string& model = GetModel();
+  for (auto _ : state) {
+    auto tokenizer = OptimizedSentencePieceTokenizer::CreateFromModel(model);
+    if (!tokenizer.ok()) {
+      state.SkipWithError("Failed to create tokenizer.");
+      return;
+    }
+    benchmark::DoNotOptimize(tokenizer);
+  }
+}
+BENCHMARK(BM_LoadOptimizedSentencePieceTokenizer);
+
+// Loads a model already converted to the optimized encoder format, as when it
+// is packed in the metadata.
+void BM_LoadOptimizedSentencePieceTokenizerFromEncoderConfig(
+    benchmark::State& state) {
+  const std::string encoder_config = ConvertSentencepieceModel(GetModel());
+  auto reference = OptimizedSentencePieceTokenizer::CreateFromModel(GetModel());
+  if (!reference.ok()) {
+    state.SkipWithError("Failed to create tokenizer.");
+    return;
+  }
+  std::string vocab;
+  absl::string_view piece;
+  for (int id = 0; (*reference)->LookupWord(id, &piece); ++id) {
+    vocab.append(piece.data(), piece.size());
+    vocab += "\t0\n";
+  }
+  for (auto _ : state) {
+    auto tokenizer = OptimizedSentencePieceTokenizer::CreateFromEncoderConfig(
+        encoder_config, vocab);
+    if (!tokenizer.ok()) {
+      state.SkipWithError("Failed to create tokenizer.");
+      return;
+    }
+    benchmark::DoNotOptimize(tokenizer);
+  }
+}
+BENCHMARK(BM_LoadOptimizedSentencePieceTokenizerFromEncoderConfig);
+
+void BM_SentencePieceTokenizer(benchmark::State& state) {
+  const std::string& model = GetModel();
+  SentencePieceTokenizer tokenizer(model.data(), model.size());
+  const std::string sentence = BuildSentence(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TokenizeAndLookupIds(&tokenizer, sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+BENCHMARK(BM_SentencePieceTokenizer)->Arg(8)->Arg(32)->Arg(128);
+
+void BM_OptimizedSentencePieceTokenizer(benchmark::State& state) {
+  const std::string& model = GetModel();
+  SentencePieceTokenizer reference(model.data(), model.size());
+  auto tokenizer = OptimizedSentencePieceTokenizer::CreateFromModel(model);
+  if (!tokenizer.ok()) {
+    state.SkipWithError("Failed to create tokenizer.");
+    return;
+  }
+  const std::string sentence = BuildSentence(state.range(0));
+  if ((*tokenizer)->TokenizeToIds(sentence) !=
+      TokenizeAndLookupIds(&reference, sentence)) {
+    state.SkipWithError("Ids differ from the reference tokenizer.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize((*tokenizer)->TokenizeToIds(sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+BENCHMARK(BM_OptimizedSentencePieceTokenizer)->Arg(8)->Arg(32)->Arg(128);
+
+}  // namespace
+}  // namespace tokenizer
+}  // namespace text
+}  // namespace support
+}  // namespace tflite
+
+BENCHMARK_MAIN();
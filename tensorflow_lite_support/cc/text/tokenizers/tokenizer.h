@@ -43,6 +43,20 @@ class Tokenizer {
   // Find the string token from an id.
   virtual bool LookupWord(int vocab_id, absl::string_view* result) const = 0;
 
+  // Perform tokenization to get the ids of the tokens, as found by LookupId():
+  // tokens missing from the vocabulary map to the unknown id for tokenizers
+  // that have one (e.g. SentencePiece ones), and to 0 otherwise. Tokenizers
+  // that compute the ids natively should override this to skip building the
+  // intermediate strings.
+  virtual std::vector<int> TokenizeToIds(const std::string& input) {
+    const TokenizerResult result = Tokenize(input);
+    std::vector<int> ids(result.subwords.size(), 0);
+    for (int i = 0; i < result.subwords.size(); ++i) {
+      LookupId(result.subwords[i], &ids[i]);
+    }
+    return ids;
+  }
+
   // Destructor.
   virtual ~Tokenizer() = default;
 };
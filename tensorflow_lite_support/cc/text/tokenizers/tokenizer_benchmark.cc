@@ -0,0 +1,135 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the BertTokenizer and the RegexTokenizer, both for
+// splitting a sentence into tokens and for converting it into ids (the way
+// the text preprocessors do). See sentencepiece_tokenizer_benchmark.cc for the
+// SentencePiece tokenizers.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/cc/text/tokenizers:tokenizer_benchmark
+//
+// Append `-- --benchmark_out=<file> --benchmark_out_format=json` to write the
+// results in a machine-readable form, e.g. to track regressions over time.
+
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/bert_tokenizer.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/regex_tokenizer.h"
+
+namespace tflite {
+namespace support {
+namespace text {
+namespace tokenizer {
+namespace {
+
+constexpr char kRegexVocabPath[] =
+    "./tensorflow_lite_support/cc/test/testdata/task/text/"
+    "vocab_for_regex_tokenizer.txt";
+constexpr char kRegexPattern[] = "[^\\w\\']+";
+
+const std::vector<std::string>& GetWords() {
+  static const std::vector<std::string>* words = new std::vector<std::string>{
+      "The",      "quick",   "brown", "fox",        "jumps", "over",
+      "the",      "lazy",    "dog.",  "Tokenizers", "split", "sentences",
+      "into",     "pieces,", "some",  "unusual",    "ones",  "like",
+      "café",     "or",      "42",    "included!"};
+  return *words;
+}
+
+// Builds a sentence of `num_words` words.
+std::string BuildSentence(int num_words) {
+  const std::vector<std::string>& words = GetWords();
+  std::string sentence;
+  for (int i = 0; i < num_words; ++i) {
+    if (i > 0) sentence += " ";
+    sentence += words[(i * 7) % words.size()];
+  }
+  return sentence;
+}
+
+// Builds a wordpiece vocabulary covering the words of `BuildSentence`, some
+// of them only as several subwords, as well as filler entries so that the
+// lookups hit a realistically sized table.
+std::vector<std::string> BuildBertVocab() {
+  std::vector<std::string> vocab = {
+      "[PAD]", "[UNK]", "[CLS]", "[SEP]", "the", "quick", "brown", "fox",
+      "jump", "##s", "over", "lazy", "dog", ".", "token", "##izer", "split",
+      "sent", "##ence", "into", "piece", ",", "some", "un", "##usual", "one",
+      "like", "cafe", "or", "4", "##2", "include", "##d", "!"};
+  for (int i = 0; i < 30000; ++i) {
+    vocab.push_back("filler" + std::to_string(i));
+  }
+  return vocab;
+}
+
+void BM_BertTokenize(benchmark::State& state) {
+  BertTokenizer tokenizer(BuildBertVocab());
+  const std::string sentence = BuildSentence(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tokenizer.Tokenize(sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+
+void BM_BertTokenizeToIds(benchmark::State& state) {
+  BertTokenizer tokenizer(BuildBertVocab());
+  const std::string sentence = BuildSentence(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tokenizer.TokenizeToIds(sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+
+void BM_RegexTokenize(benchmark::State& state) {
+  RegexTokenizer tokenizer(kRegexPattern, kRegexVocabPath);
+  const std::string sentence = BuildSentence(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tokenizer.Tokenize(sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+
+void BM_RegexTokenizeToIds(benchmark::State& state) {
+  RegexTokenizer tokenizer(kRegexPattern, kRegexVocabPath);
+  const std::string sentence = BuildSentence(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tokenizer.TokenizeToIds(sentence));
+  }
+  state.SetBytesProcessed(state.iterations() * sentence.size());
+}
+
+// The argument is the number of words of the sentence.
+void BenchmarkArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int num_words : {8, 64, 512}) {
+    benchmark->Arg(num_words);
+  }
+}
+
+BENCHMARK(BM_BertTokenize)->Apply(BenchmarkArgs);
+BENCHMARK(BM_BertTokenizeToIds)->Apply(BenchmarkArgs);
+BENCHMARK(BM_RegexTokenize)->Apply(BenchmarkArgs);
+BENCHMARK(BM_RegexTokenizeToIds)->Apply(BenchmarkArgs);
+
+}  // namespace
+}  // namespace tokenizer
+}  // namespace text
+}  // namespace support
+}  // namespace tflite
+
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/bert_tokenizer.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/optimized_sentencepiece_tokenizer.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/regex_tokenizer.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/sentencepiece_tokenizer.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
@@ -79,7 +80,22 @@ StatusOr<std::unique_ptr<Tokenizer>> CreateTokenizerFromProcessUnit(
       ASSIGN_OR_RETURN(absl::string_view model_buffer,
                        CheckAndLoadFirstAssociatedFile(
                            options->sentencePiece_model(), metadata_extractor));
-      // TODO(b/160647204): Extract sentence piece model vocabulary
+      if (OptimizedSentencePieceTokenizer::IsEncoderConfig(model_buffer)) {
+        // The model is already converted to the optimized encoder format: the
+        // pieces come from the vocabulary file.
+        ASSIGN_OR_RETURN(absl::string_view vocab_buffer,
+                         CheckAndLoadFirstAssociatedFile(options->vocab_file(),
+                                                         metadata_extractor));
+        return OptimizedSentencePieceTokenizer::CreateFromEncoderConfig(
+            model_buffer, vocab_buffer);
+      }
+      auto optimized_tokenizer =
+          OptimizedSentencePieceTokenizer::CreateFromModel(model_buffer);
+      if (optimized_tokenizer.ok()) {
+        return std::move(optimized_tokenizer).value();
+      }
+      // The optimized encoder only supports UNIGRAM models: other model
+      // types go through the sentencepiece library.
       return absl::make_unique<SentencePieceTokenizer>(model_buffer.data(),
                                                        model_buffer.size());
     }
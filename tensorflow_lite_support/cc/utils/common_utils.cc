@@ -15,80 +15,208 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/utils/common_utils.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 
-#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
 
 namespace tflite {
 namespace support {
 namespace utils {
 namespace {
-struct membuf : std::streambuf {
-  membuf(char* begin, char* end) { this->setg(begin, begin, end); }
-};
-
-void ReadIStreamLineByLine(
-    std::istream* istream,
-    const std::function<void(std::string)>& line_processor) {
-  std::string str;
-  while (std::getline(*istream, str)) {
-    if (!str.empty()) {
-      line_processor(str);
-    }
+
+// Calls `line_processor` on each line of `buffer`, as a view into `buffer`. A
+// trailing newline does not produce a final empty line.
+template <typename LineProcessor>
+void ForEachLine(absl::string_view buffer, LineProcessor&& line_processor) {
+  const char* begin = buffer.data();
+  const char* const end = buffer.data() + buffer.size();
+  while (begin < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(begin, '\n', end - begin));
+    const char* line_end = newline == nullptr ? end : newline;
+    line_processor(absl::string_view(begin, line_end - begin));
+    begin = line_end + 1;
   }
 }
 
-absl::node_hash_map<std::string, int> ReadIStreamLineSplits(
-    std::istream* istream) {
-  absl::node_hash_map<std::string, int> vocab_index_map;
-  std::string str;
-  ReadIStreamLineByLine(istream, [&vocab_index_map](const std::string& str) {
-    std::vector<std::string> v = absl::StrSplit(str, ' ');
-    vocab_index_map[v[0]] = std::stoi(v[1]);
-  });
-  return vocab_index_map;
+// Parses a "<token> <id>" line. Returns false if the line is malformed.
+bool ParseTokenAndId(absl::string_view line, absl::string_view* token,
+                     int* id) {
+  const size_t space = line.find(' ');
+  if (space == absl::string_view::npos) {
+    return false;
+  }
+  *token = line.substr(0, space);
+  absl::string_view id_str = line.substr(space + 1);
+  id_str = id_str.substr(0, id_str.find(' '));
+  return absl::SimpleAtoi(id_str, id);
 }
 
-std::vector<std::string> ReadIStreamByLine(std::istream* istream) {
-  std::vector<std::string> vocab_from_file;
-  std::string str;
+}  // namespace
 
-  ReadIStreamLineByLine(istream, [&vocab_from_file](const std::string& str) {
-    vocab_from_file.push_back(str);
-  });
-  return vocab_from_file;
+std::string ReadFileToString(const std::string& path) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
 }
 
-}  // namespace
-
 std::vector<std::string> LoadVocabFromFile(const std::string& path_to_vocab) {
-  std::vector<std::string> vocab_from_file;
-  std::ifstream in(path_to_vocab.c_str());
-  return ReadIStreamByLine(&in);
+  const std::string contents = ReadFileToString(path_to_vocab);
+  return LoadVocabFromBuffer(contents.data(), contents.size());
 }
 
 std::vector<std::string> LoadVocabFromBuffer(const char* vocab_buffer_data,
                                              const size_t vocab_buffer_size) {
-  membuf sbuf(const_cast<char*>(vocab_buffer_data),
-              const_cast<char*>(vocab_buffer_data + vocab_buffer_size));
-  std::istream in(&sbuf);
-  return ReadIStreamByLine(&in);
+  std::vector<std::string> vocab;
+  for (absl::string_view line :
+       SplitLines(absl::string_view(vocab_buffer_data, vocab_buffer_size),
+                  /*skip_empty_lines=*/true)) {
+    vocab.emplace_back(line);
+  }
+  return vocab;
 }
 
 absl::node_hash_map<std::string, int> LoadVocabAndIndexFromFile(
     const std::string& path_to_vocab) {
-  absl::node_hash_map<std::string, int> vocab_index_map;
-  std::ifstream in(path_to_vocab.c_str());
-  return ReadIStreamLineSplits(&in);
+  const std::string contents = ReadFileToString(path_to_vocab);
+  return LoadVocabAndIndexFromBuffer(contents.data(), contents.size());
 }
 
 absl::node_hash_map<std::string, int> LoadVocabAndIndexFromBuffer(
     const char* vocab_buffer_data, const size_t vocab_buffer_size) {
-  membuf sbuf(const_cast<char*>(vocab_buffer_data),
-              const_cast<char*>(vocab_buffer_data + vocab_buffer_size));
   absl::node_hash_map<std::string, int> vocab_index_map;
-  std::istream in(&sbuf);
-  return ReadIStreamLineSplits(&in);
+  ForEachLine(absl::string_view(vocab_buffer_data, vocab_buffer_size),
+              [&vocab_index_map](absl::string_view line) {
+                absl::string_view token;
+                int id;
+                if (ParseTokenAndId(line, &token, &id)) {
+                  vocab_index_map[std::string(token)] = id;
+                }
+              });
+  return vocab_index_map;
+}
+
+std::vector<absl::string_view> SplitLines(absl::string_view buffer,
+                                          bool skip_empty_lines) {
+  std::vector<absl::string_view> lines;
+  // Counting newlines first is also memchr-bound, and saves the reallocations.
+  lines.reserve(std::count(buffer.begin(), buffer.end(), '\n') + 1);
+  ForEachLine(buffer, [&lines, skip_empty_lines](absl::string_view line) {
+    if (!skip_empty_lines || !line.empty()) {
+      lines.push_back(line);
+    }
+  });
+  return lines;
+}
+
+/* static */
+InternedVocab InternedVocab::FromBuffer(absl::string_view vocab_buffer) {
+  std::vector<absl::string_view> tokens =
+      SplitLines(vocab_buffer, /*skip_empty_lines=*/true);
+  std::vector<int> ids(tokens.size());
+  for (int i = 0; i < ids.size(); ++i) {
+    ids[i] = i;
+  }
+  InternedVocab vocab;
+  vocab.Intern(tokens, ids);
+  return vocab;
+}
+
+/* static */
+InternedVocab InternedVocab::FromBufferWithIds(absl::string_view vocab_buffer) {
+  std::vector<absl::string_view> tokens;
+  std::vector<int> ids;
+  ForEachLine(vocab_buffer, [&tokens, &ids](absl::string_view line) {
+    absl::string_view token;
+    int id;
+    if (ParseTokenAndId(line, &token, &id) && id >= 0) {
+      tokens.push_back(token);
+      ids.push_back(id);
+    }
+  });
+  InternedVocab vocab;
+  vocab.Intern(tokens, ids);
+  return vocab;
+}
+
+/* static */
+InternedVocab InternedVocab::FromTokens(
+    const std::vector<std::string>& tokens) {
+  std::vector<absl::string_view> token_views(tokens.begin(), tokens.end());
+  std::vector<int> ids(tokens.size());
+  for (int i = 0; i < ids.size(); ++i) {
+    ids[i] = i;
+  }
+  InternedVocab vocab;
+  vocab.Intern(token_views, ids);
+  return vocab;
+}
+
+void InternedVocab::Intern(const std::vector<absl::string_view>& tokens,
+                           const std::vector<int>& ids) {
+  size_t arena_size = 0;
+  int max_id = -1;
+  for (int i = 0; i < tokens.size(); ++i) {
+    arena_size += tokens[i].size();
+    max_id = std::max(max_id, ids[i]);
+  }
+  arena_ = std::unique_ptr<char[]>(new char[arena_size]);
+  // Compared in 64 bits, as ids may be as large as INT_MAX.
+  const bool dense = static_cast<int64_t>(max_id) <
+                     static_cast<int64_t>(kMaxDenseIdsPerToken) * tokens.size();
+  id_to_token_.assign(dense ? max_id + 1 : 0, absl::string_view());
+  sparse_id_to_token_.clear();
+  if (!dense) {
+    sparse_id_to_token_.reserve(tokens.size());
+  }
+  token_to_id_.clear();
+  token_to_id_.reserve(tokens.size());
+  num_ids_ = 0;
+
+  char* arena_end = arena_.get();
+  for (int i = 0; i < tokens.size(); ++i) {
+    memcpy(arena_end, tokens[i].data(), tokens[i].size());
+    const absl::string_view interned(arena_end, tokens[i].size());
+    arena_end += tokens[i].size();
+    // Later entries override earlier ones, as with the map-based loaders.
+    token_to_id_[interned] = ids[i];
+    absl::string_view& id_token =
+        dense ? id_to_token_[ids[i]] : sparse_id_to_token_[ids[i]];
+    if (id_token.data() == nullptr) {
+      num_ids_++;
+    }
+    id_token = interned;
+  }
+}
+
+bool InternedVocab::LookupId(absl::string_view token, int* id) const {
+  auto it = token_to_id_.find(token);
+  if (it == token_to_id_.end()) {
+    return false;
+  }
+  *id = it->second;
+  return true;
+}
+
+bool InternedVocab::LookupWord(int id, absl::string_view* token) const {
+  if (!sparse_id_to_token_.empty()) {
+    auto it = sparse_id_to_token_.find(id);
+    if (it == sparse_id_to_token_.end()) {
+      return false;
+    }
+    *token = it->second;
+    return true;
+  }
+  if (id < 0 || id >= id_to_token_.size() ||
+      id_to_token_[id].data() == nullptr) {
+    return false;
+  }
+  *token = id_to_token_[id];
+  return true;
 }
 
 }  // namespace utils
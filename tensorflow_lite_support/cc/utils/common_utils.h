@@ -16,10 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_UTILS_COMMON_UTILS_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_UTILS_COMMON_UTILS_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
 #include "absl/container/node_hash_map.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 
 namespace tflite {
 namespace support {
@@ -42,6 +45,76 @@ absl::node_hash_map<std::string, int> LoadVocabAndIndexFromFile(
 // line separated by space, create a map of <vocab, index>.
 absl::node_hash_map<std::string, int> LoadVocabAndIndexFromBuffer(
     const char* vocab_buffer_data, const size_t vocab_buffer_size);
+
+// Reads the whole content of the file at `path`. Returns an empty string if the
+// file can't be read.
+std::string ReadFileToString(const std::string& path);
+
+// Splits a buffer into lines delimited by '\n', returned as views into the
+// buffer (no copy is performed). Newlines are located with memchr, which libc
+// implementations vectorize. A trailing newline does not produce a final empty
+// line. Empty lines are kept, unless `skip_empty_lines` is true.
+std::vector<absl::string_view> SplitLines(absl::string_view buffer,
+                                          bool skip_empty_lines = false);
+
+// A vocabulary whose tokens are interned into a single contiguous arena, i.e.
+// stored back to back in one allocation and exposed as string_views. This
+// avoids one heap allocation per token and keeps lookups cache-friendly.
+//
+// Instances are movable: the string_views remain valid across moves.
+class InternedVocab {
+ public:
+  InternedVocab() = default;
+
+  // Builds a vocab from a buffer with one token on each line. Empty lines are
+  // ignored, and ids are assigned in order of appearance.
+  static InternedVocab FromBuffer(absl::string_view vocab_buffer);
+
+  // Builds a vocab from a buffer with one token and its corresponding id on
+  // each line, separated by space. Malformed lines and negative ids are
+  // ignored. Sparse ids are supported, but dense ones are looked up faster.
+  static InternedVocab FromBufferWithIds(absl::string_view vocab_buffer);
+
+  // Builds a vocab from a vector of tokens, ids being the vector indices.
+  static InternedVocab FromTokens(const std::vector<std::string>& tokens);
+
+  // Finds the id of a token. Returns false if the token is not in the vocab.
+  bool LookupId(absl::string_view token, int* id) const;
+
+  // Finds the token with the provided id. Returns false if there is none.
+  bool LookupWord(int id, absl::string_view* token) const;
+
+  // Returns true if the token is in the vocab.
+  bool Contains(absl::string_view token) const {
+    return token_to_id_.contains(token);
+  }
+
+  // Returns the number of distinct ids in the vocab.
+  int size() const { return num_ids_; }
+
+ private:
+  // Copies the provided tokens into the arena and builds the lookup tables.
+  void Intern(const std::vector<absl::string_view>& tokens,
+              const std::vector<int>& ids);
+
+  // Ids up to this many times the number of tokens are looked up in
+  // `id_to_token_`, larger ones in `sparse_id_to_token_`. This bounds the
+  // table size whatever the ids found in vocab files.
+  static constexpr int kMaxDenseIdsPerToken = 2;
+
+  // The arena holding all token bytes.
+  std::unique_ptr<char[]> arena_;
+  // Token views into `arena_`, indexed by id, if ids are dense. Missing ids map
+  // to default-constructed views, with a null data pointer.
+  std::vector<absl::string_view> id_to_token_;
+  // Token views into `arena_` by id, if ids are sparse.
+  absl::flat_hash_map<int, absl::string_view> sparse_id_to_token_;
+  // Maps token views into `arena_` to their ids.
+  absl::flat_hash_map<absl::string_view, int> token_to_id_;
+  // Number of distinct ids.
+  int num_ids_ = 0;
+};
+
 }  // namespace utils
 }  // namespace support
 }  // namespace tflite
@@ -0,0 +1,677 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// This file contains the logic of C++ model wrapper generation.
+//
+// As for the Android wrapper, the model and its metadata are first gathered in
+// an intermediate `ModelInfo` structure, which is then rendered through
+// `CodeWriter` templates. The generated header looks like:
+//
+// [ includes ]
+// [ "spec" namespace ]  ( constexpr shapes, types, parameters and labels )
+// [ class ]             ( factory, then Classify() with the pre and
+//                         postprocessing specialized for the model )
+
+#include "tensorflow_lite_support/codegen/cc_generator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/codegen/code_generator.h"
+#include "tensorflow_lite_support/codegen/metadata_helper.h"
+#include "tensorflow_lite_support/codegen/utils.h"
+#include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+namespace support {
+namespace codegen {
+
+namespace {
+
+using details_cc::ModelInfo;
+using ::tflite::metadata::ModelMetadataExtractor;
+
+constexpr int kNumRgbChannels = 3;
+
+std::string GetModelVersionedName(const ModelMetadata* metadata) {
+  std::string model_name = "MyModel";
+  if (metadata->name() != nullptr && !(metadata->name()->str().empty())) {
+    model_name = metadata->name()->str();
+  }
+  std::string model_version = "unknown";
+  if (metadata->version() != nullptr && !(metadata->version()->str().empty())) {
+    model_version = metadata->version()->str();
+  }
+  return model_name + " (Version: " + model_version + ")";
+}
+
+// Returns the shortest float literal which parses back to `value`, e.g.
+// "127.5f" or "1.0f".
+std::string FloatLiteral(float value) {
+  char buffer[32];
+  for (int precision = 6; precision <= 9; precision++) {
+    snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    if (std::strtof(buffer, nullptr) == value) break;
+  }
+  std::string literal = buffer;
+  if (literal.find_first_of(".e") == std::string::npos) {
+    literal += ".0";
+  }
+  return literal + "f";
+}
+
+// Escapes `s` into the contents of a C++ string literal.
+std::string EscapeStringLiteral(const std::string& s) {
+  std::string escaped;
+  escaped.reserve(s.size());
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (isprint(static_cast<unsigned char>(c))) {
+      escaped += c;
+    } else {
+      // Octal escapes have at most 3 digits, so they can't swallow the next
+      // character as hexadecimal ones would.
+      char buffer[5];
+      snprintf(buffer, sizeof(buffer), "\\%03o", static_cast<unsigned char>(c));
+      escaped += buffer;
+    }
+  }
+  return escaped;
+}
+
+std::string GetTypeName(TensorType type) {
+  switch (type) {
+    case TensorType_UINT8:
+      return "uint8_t";
+    case TensorType_FLOAT32:
+      return "float";
+    default:
+      return "";
+  }
+}
+
+std::string GetTfLiteTypeName(const std::string& type_name) {
+  return type_name == "float" ? "kTfLiteFloat32" : "kTfLiteUInt8";
+}
+
+bool FillInputInfo(const Model& model, const TensorMetadata& metadata,
+                   ModelInfo* model_info, ErrorReporter* err) {
+  const SubGraph* graph = model.subgraphs()->Get(0);
+  const Tensor* tensor = graph->tensors()->Get(graph->inputs()->Get(0));
+  const auto* shape = tensor->shape();
+  if (shape == nullptr || shape->size() != 4 || shape->Get(0) != 1 ||
+      shape->Get(3) != kNumRgbChannels) {
+    err->Error("The input tensor must have a [1, height, width, 3] shape.");
+    return false;
+  }
+  model_info->input_height = shape->Get(1);
+  model_info->input_width = shape->Get(2);
+  model_info->input_channels = shape->Get(3);
+  model_info->input_type = GetTypeName(tensor->type());
+  if (model_info->input_type.empty()) {
+    err->Error("The input tensor must be of type uint8 or float32.");
+    return false;
+  }
+  if (metadata.content() == nullptr ||
+      metadata.content()->content_properties_type() !=
+          ContentProperties_ImageProperties) {
+    err->Error("The input tensor metadata must have image properties.");
+    return false;
+  }
+  if (metadata.content()
+          ->content_properties_as_ImageProperties()
+          ->color_space() != ColorSpaceType_RGB) {
+    err->Error("Only RGB input images are supported.");
+    return false;
+  }
+  if (model_info->input_type != "float") {
+    return true;
+  }
+
+  // Float inputs need normalization, broadcast to all channels if needed.
+  const int normalization_unit = FindNormalizationUnit(&metadata, "input", err);
+  if (normalization_unit < 0) {
+    err->Error("Float input tensors require NormalizationOptions.");
+    return false;
+  }
+  const auto* options = metadata.process_units()
+                            ->Get(normalization_unit)
+                            ->options_as_NormalizationOptions();
+  const auto* mean_values = options->mean();
+  const auto* std_values = options->std();
+  if (mean_values == nullptr || std_values == nullptr ||
+      (mean_values->size() != 1 && mean_values->size() != kNumRgbChannels) ||
+      mean_values->size() != std_values->size()) {
+    err->Error(
+        "NormalizationOptions must have 1 or 3 mean and std values, as many "
+        "of each.");
+    return false;
+  }
+  for (int c = 0; c < kNumRgbChannels; c++) {
+    const int i = mean_values->size() == 1 ? 0 : c;
+    if (std::abs(std_values->Get(i)) < 1e-8) {
+      err->Error("NormalizationOptions std values can't be 0.");
+      return false;
+    }
+    model_info->mean_values.push_back(mean_values->Get(i));
+    model_info->std_values.push_back(std_values->Get(i));
+  }
+  return true;
+}
+
+bool FillOutputInfo(const Model& model, const TensorMetadata& metadata,
+                    const ModelMetadataExtractor& extractor,
+                    ModelInfo* model_info, ErrorReporter* err) {
+  const SubGraph* graph = model.subgraphs()->Get(0);
+  const Tensor* tensor = graph->tensors()->Get(graph->outputs()->Get(0));
+  const auto* shape = tensor->shape();
+  // Accept [1, num_classes] as well as [1, 1, 1, num_classes] scores.
+  bool valid_shape = shape != nullptr && shape->size() >= 2;
+  for (int i = 0; valid_shape && i < shape->size() - 1; i++) {
+    valid_shape = shape->Get(i) == 1;
+  }
+  if (!valid_shape) {
+    err->Error("The output tensor must have a [1, num_classes] shape.");
+    return false;
+  }
+  model_info->num_classes = shape->Get(shape->size() - 1);
+  model_info->output_type = GetTypeName(tensor->type());
+  if (model_info->output_type.empty()) {
+    err->Error("The output tensor must be of type uint8 or float32.");
+    return false;
+  }
+  model_info->output_scale = 1.0f;
+  model_info->output_zero_point = 0;
+  if (model_info->output_type == "uint8_t") {
+    const QuantizationParameters* quantization = tensor->quantization();
+    if (quantization == nullptr || quantization->scale() == nullptr ||
+        quantization->scale()->size() != 1 ||
+        quantization->zero_point() == nullptr ||
+        quantization->zero_point()->size() != 1) {
+      err->Error("Quantized output tensors must have per-tensor parameters.");
+      return false;
+    }
+    model_info->output_scale = quantization->scale()->Get(0);
+    model_info->output_zero_point = quantization->zero_point()->Get(0);
+  }
+
+  const std::string labels_file =
+      ModelMetadataExtractor::FindFirstAssociatedFileName(
+          metadata, AssociatedFileType_TENSOR_AXIS_LABELS);
+  if (labels_file.empty()) {
+    err->Warning("No label file found on the output tensor.");
+    return true;
+  }
+  auto labels = extractor.GetAssociatedFile(labels_file);
+  if (!labels.ok()) {
+    err->Error("Cannot read label file %s: %s", labels_file.c_str(),
+               std::string(labels.status().message()).c_str());
+    return false;
+  }
+  std::string label;
+  for (const char c : *labels) {
+    if (c == '\n') {
+      model_info->labels.push_back(label);
+      label.clear();
+    } else if (c != '\r') {
+      label += c;
+    }
+  }
+  if (!label.empty()) {
+    model_info->labels.push_back(label);
+  }
+  if (model_info->labels.size() != model_info->num_classes) {
+    err->Error("Found %d labels for %d classes in label file %s.",
+               static_cast<int>(model_info->labels.size()),
+               model_info->num_classes, labels_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool CreateModelInfo(const char* model_buffer, size_t model_size,
+                     const std::string& namespace_name,
+                     const std::string& model_class_name,
+                     const std::string& header_dir, ModelInfo* model_info,
+                     ErrorReporter* err) {
+  auto extractor =
+      ModelMetadataExtractor::CreateFromModelBuffer(model_buffer, model_size);
+  if (!extractor.ok()) {
+    err->Error("Cannot read model from the buffer: %s",
+               std::string(extractor.status().message()).c_str());
+    return false;
+  }
+  const ModelMetadata* metadata = (*extractor)->GetModelMetadata();
+  if (!CodeGenerator::VerifyMetadata(metadata, err)) {
+    err->Error("Validating metadata failed.");
+    return false;
+  }
+  const Model* model = GetModel(model_buffer);
+  const auto* graph = metadata->subgraph_metadata()->Get(0);
+  if (model->subgraphs() == nullptr || model->subgraphs()->size() != 1 ||
+      model->subgraphs()->Get(0)->inputs()->size() != 1 ||
+      model->subgraphs()->Get(0)->outputs()->size() != 1 ||
+      graph->input_tensor_metadata() == nullptr ||
+      graph->input_tensor_metadata()->size() != 1 ||
+      graph->output_tensor_metadata() == nullptr ||
+      graph->output_tensor_metadata()->size() != 1) {
+    err->Error(
+        "Only image classification models, with one input and one output "
+        "tensor, are supported.");
+    return false;
+  }
+
+  model_info->namespace_name = namespace_name;
+  model_info->model_class_name = model_class_name;
+  model_info->model_versioned_name = GetModelVersionedName(metadata);
+  model_info->header_path = JoinPath(
+      header_dir, CamelCaseToSnakeCase(model_class_name) + CC_HEADER_EXT);
+  return FillInputInfo(*model, *graph->input_tensor_metadata()->Get(0),
+                       model_info, err) &&
+         FillOutputInfo(*model, *graph->output_tensor_metadata()->Get(0),
+                        **extractor, model_info, err);
+}
+
+std::string GetHeaderGuard(const std::string& header_path) {
+  std::string guard;
+  for (const char c : header_path) {
+    guard += isalnum(c) ? toupper(c) : '_';
+  }
+  return guard + "_";
+}
+
+std::vector<std::string> SplitNamespace(const std::string& namespace_name) {
+  std::vector<std::string> names;
+  size_t begin = 0;
+  size_t end;
+  while ((end = namespace_name.find("::", begin)) != std::string::npos) {
+    names.push_back(namespace_name.substr(begin, end - begin));
+    begin = end + 2;
+  }
+  names.push_back(namespace_name.substr(begin));
+  return names;
+}
+
+// C++14 has no nested namespace definitions, so "a::b" is opened as
+// "namespace a {" then "namespace b {".
+std::string OpenNamespaces(const std::string& namespace_name) {
+  std::string lines;
+  for (const auto& name : SplitNamespace(namespace_name)) {
+    lines += "namespace " + name + " {\n";
+  }
+  lines.pop_back();
+  return lines;
+}
+
+std::string CloseNamespaces(const std::string& namespace_name) {
+  std::string lines;
+  for (const auto& name : SplitNamespace(namespace_name)) {
+    lines = "}  // namespace " + name + "\n" + lines;
+  }
+  lines.pop_back();
+  return lines;
+}
+
+void SetCodeWriterWithModelInfo(CodeWriter* code_writer,
+                                const ModelInfo& model_info) {
+  code_writer->SetTokenValue("NAMESPACE_OPEN",
+                             OpenNamespaces(model_info.namespace_name));
+  code_writer->SetTokenValue("NAMESPACE_CLOSE",
+                             CloseNamespaces(model_info.namespace_name));
+  code_writer->SetTokenValue("MODEL_CLASS_NAME", model_info.model_class_name);
+  code_writer->SetTokenValue(
+      "SPEC", CamelCaseToSnakeCase(model_info.model_class_name) + "_spec");
+  code_writer->SetTokenValue("MODEL_VERSIONED_NAME",
+                             model_info.model_versioned_name);
+  code_writer->SetTokenValue("HEADER_GUARD",
+                             GetHeaderGuard(model_info.header_path));
+  code_writer->SetTokenValue("INPUT_HEIGHT",
+                             std::to_string(model_info.input_height));
+  code_writer->SetTokenValue("INPUT_WIDTH",
+                             std::to_string(model_info.input_width));
+  code_writer->SetTokenValue("INPUT_CHANNELS",
+                             std::to_string(model_info.input_channels));
+  code_writer->SetTokenValue("INPUT_TYPE", model_info.input_type);
+  code_writer->SetTokenValue("INPUT_TFLITE_TYPE",
+                             GetTfLiteTypeName(model_info.input_type));
+  code_writer->SetTokenValue("NUM_CLASSES",
+                             std::to_string(model_info.num_classes));
+  code_writer->SetTokenValue("OUTPUT_TYPE", model_info.output_type);
+  code_writer->SetTokenValue("OUTPUT_TFLITE_TYPE",
+                             GetTfLiteTypeName(model_info.output_type));
+  code_writer->SetTokenValue("OUTPUT_SCALE",
+                             FloatLiteral(model_info.output_scale));
+  code_writer->SetTokenValue("OUTPUT_ZERO_POINT",
+                             std::to_string(model_info.output_zero_point));
+}
+
+// Returns the initializer of a float array, e.g. "{0.5f, 1.0f}".
+std::string FloatArrayInitializer(const std::vector<float>& values) {
+  std::string initializer = "{";
+  for (int i = 0; i < values.size(); i++) {
+    if (i > 0) initializer += ", ";
+    initializer += FloatLiteral(values[i]);
+  }
+  return initializer + "}";
+}
+
+// The following functions generate the wrapper header for a model.
+
+void GenerateSpec(CodeWriter* code_writer, const ModelInfo& model) {
+  code_writer->Append(R"(// Compile-time description of the model the wrapper was generated for.
+namespace {{SPEC}} {
+
+// Input image: [1, kInputHeight, kInputWidth, kInputChannels] RGB pixels.
+constexpr int kInputHeight = {{INPUT_HEIGHT}};
+constexpr int kInputWidth = {{INPUT_WIDTH}};
+constexpr int kInputChannels = {{INPUT_CHANNELS}};
+constexpr int kInputSize = kInputHeight * kInputWidth * kInputChannels;
+using InputType = {{INPUT_TYPE}};
+constexpr TfLiteType kInputTfLiteType = {{INPUT_TFLITE_TYPE}};)");
+  if (model.input_type == "float") {
+    std::vector<float> inverse_std_values;
+    for (float std_value : model.std_values) {
+      inverse_std_values.push_back(1.0f / std_value);
+    }
+    code_writer->SetTokenValue("MEAN_VALUES",
+                               FloatArrayInitializer(model.mean_values));
+    code_writer->SetTokenValue("INVERSE_STD_VALUES",
+                               FloatArrayInitializer(inverse_std_values));
+    code_writer->Append(R"(
+// Input normalization: (pixel - kMean[c]) * kInverseStd[c].
+constexpr float kMean[kInputChannels] =
+    {{MEAN_VALUES}};
+constexpr float kInverseStd[kInputChannels] =
+    {{INVERSE_STD_VALUES}};)");
+  }
+  code_writer->Append(R"(
+// Output scores: [1, kNumClasses].
+constexpr int kNumClasses = {{NUM_CLASSES}};
+using OutputType = {{OUTPUT_TYPE}};
+constexpr TfLiteType kOutputTfLiteType = {{OUTPUT_TFLITE_TYPE}};)");
+  if (model.output_type == "uint8_t") {
+    code_writer->Append(R"(
+// Output dequantization: kOutputScale * (score - kOutputZeroPoint).
+constexpr float kOutputScale = {{OUTPUT_SCALE}};
+constexpr int kOutputZeroPoint = {{OUTPUT_ZERO_POINT}};)");
+  }
+  if (!model.labels.empty()) {
+    code_writer->NewLine();
+    code_writer->Append("constexpr const char* kLabels[kNumClasses] = {");
+    code_writer->Indent();
+    code_writer->Indent();
+    for (const auto& label : model.labels) {
+      code_writer->SetTokenValue("LABEL", EscapeStringLiteral(label));
+      code_writer->Append("\"{{LABEL}}\",");
+    }
+    code_writer->Outdent();
+    code_writer->Outdent();
+    code_writer->Append("};");
+  }
+  code_writer->Append(R"(
+}  // namespace {{SPEC}}
+)");
+}
+
+void GenerateClass(CodeWriter* code_writer, const ModelInfo& model) {
+  code_writer->Append(R"(// Classifier for {{MODEL_VERSIONED_NAME}}.
+//
+// Pre and postprocessing are specialized for the model described in
+// {{SPEC}}, which is checked once at creation time.
+class {{MODEL_CLASS_NAME}} {
+ public:
+  struct Category {
+    int index;
+    float score;
+    // Null if the model has no labels.
+    const char* label;
+  };
+
+  // Creates a classifier from a model file, which must have the same input and
+  // output tensors as the one this wrapper was generated for.
+  static tflite::support::StatusOr<std::unique_ptr<{{MODEL_CLASS_NAME}}>>
+  CreateFromFile(const std::string& model_path, int num_threads = 1) {
+    auto model = tflite::FlatBufferModel::BuildFromFile(model_path.c_str());
+    if (model == nullptr) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kNotFound,
+          absl::StrCat("Unable to load model file: ", model_path),
+          tflite::support::TfLiteSupportStatus::kFileNotFoundError);
+    }
+    tflite::ops::builtin::BuiltinOpResolver resolver;
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    if (tflite::InterpreterBuilder(*model, resolver)(&interpreter,
+                                                     num_threads) !=
+            kTfLiteOk ||
+        interpreter->AllocateTensors() != kTfLiteOk) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInternal, "Unable to build the interpreter.");
+    }
+    RETURN_IF_ERROR(CheckTensors(*interpreter));
+    return absl::WrapUnique(
+        new {{MODEL_CLASS_NAME}}(std::move(model), std::move(interpreter)));
+  }
+
+  // Classifies `rgb_pixels`, holding kInputHeight rows of kInputWidth
+  // interleaved RGB pixels as described in the spec namespace. Returns the
+  // `max_results` best categories (all of them if negative), by decreasing
+  // score.
+  tflite::support::StatusOr<std::vector<Category>> Classify(
+      const uint8_t* rgb_pixels, int max_results = -1) {
+    namespace spec = {{SPEC}};)");
+  code_writer->Indent();
+  code_writer->Indent();
+  if (model.input_type == "float") {
+    code_writer->Append(R"(float* input = interpreter_->typed_input_tensor<float>(0);
+for (int i = 0; i < spec::kInputHeight * spec::kInputWidth; ++i) {
+  for (int c = 0; c < spec::kInputChannels; ++c) {
+    input[c] = (static_cast<float>(rgb_pixels[c]) - spec::kMean[c]) *
+               spec::kInverseStd[c];
+  }
+  input += spec::kInputChannels;
+  rgb_pixels += spec::kInputChannels;
+})");
+  } else {
+    code_writer->Append(R"(std::memcpy(interpreter_->typed_input_tensor<uint8_t>(0), rgb_pixels,
+            spec::kInputSize);)");
+  }
+  code_writer->Append(R"(if (interpreter_->Invoke() != kTfLiteOk) {
+  return tflite::support::CreateStatusWithPayload(
+      absl::StatusCode::kInternal, "Running inference failed.");
+}
+
+const spec::OutputType* scores =
+    interpreter_->typed_output_tensor<spec::OutputType>(0);
+const int num_results = max_results < 0
+                            ? spec::kNumClasses
+                            : std::min(max_results, spec::kNumClasses);
+// The permutation left by previous calls is as good a start as any, the
+// order being total.
+std::partial_sort(indices_.begin(), indices_.begin() + num_results,
+                  indices_.end(), [scores](int a, int b) {
+                    return scores[a] > scores[b] ||
+                           (scores[a] == scores[b] && a < b);
+                  });
+std::vector<Category> categories(num_results);
+for (int i = 0; i < num_results; ++i) {
+  const int index = indices_[i];
+  categories[i].index = index;)");
+  code_writer->Indent();
+  if (model.output_type == "uint8_t") {
+    code_writer->Append(
+        "categories[i].score =\n"
+        "    spec::kOutputScale *\n"
+        "    (static_cast<int>(scores[index]) - spec::kOutputZeroPoint);");
+  } else {
+    code_writer->Append("categories[i].score = scores[index];");
+  }
+  code_writer->Append(model.labels.empty()
+                          ? "categories[i].label = nullptr;"
+                          : "categories[i].label = spec::kLabels[index];");
+  code_writer->Outdent();
+  code_writer->Append(R"(}
+return categories;)");
+  code_writer->Outdent();
+  code_writer->Outdent();
+  code_writer->Append(R"(  }
+
+ private:
+  {{MODEL_CLASS_NAME}}(
+      std::unique_ptr<tflite::FlatBufferModel> model,
+      std::unique_ptr<tflite::Interpreter> interpreter)
+      : model_(std::move(model)), interpreter_(std::move(interpreter)) {
+    std::iota(indices_.begin(), indices_.end(), 0);
+  }
+
+  static absl::Status CheckTensors(const tflite::Interpreter& interpreter) {
+    namespace spec = {{SPEC}};
+    const TfLiteTensor* input =
+        interpreter.inputs().size() == 1 ? interpreter.input_tensor(0)
+                                         : nullptr;
+    if (input == nullptr || input->type != spec::kInputTfLiteType ||
+        input->dims->size != 4 || input->dims->data[0] != 1 ||
+        input->dims->data[1] != spec::kInputHeight ||
+        input->dims->data[2] != spec::kInputWidth ||
+        input->dims->data[3] != spec::kInputChannels) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "The input tensor differs from the one of the generated model.",
+          tflite::support::TfLiteSupportStatus::
+              kInvalidInputTensorDimensionsError);
+    }
+    const TfLiteTensor* output =
+        interpreter.outputs().size() == 1 ? interpreter.output_tensor(0)
+                                          : nullptr;
+    int num_elements = 1;
+    for (int i = 0; output != nullptr && i < output->dims->size; ++i) {
+      num_elements *= output->dims->data[i];
+    }
+    if (output == nullptr || output->type != spec::kOutputTfLiteType ||
+        num_elements != spec::kNumClasses) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "The output tensor differs from the one of the generated model.",
+          tflite::support::TfLiteSupportStatus::
+              kInvalidOutputTensorDimensionsError);
+    })");
+  if (model.output_type == "uint8_t") {
+    code_writer->Append(R"(    if (output->params.scale != spec::kOutputScale ||
+        output->params.zero_point != spec::kOutputZeroPoint) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "The output quantization differs from the one of the generated "
+          "model.",
+          tflite::support::TfLiteSupportStatus::kInvalidOutputTensorTypeError);
+    })");
+  }
+  code_writer->Append(R"(    return absl::OkStatus();
+  }
+
+  std::unique_ptr<tflite::FlatBufferModel> model_;
+  std::unique_ptr<tflite::Interpreter> interpreter_;
+  // The class indices, sorted by decreasing score for the `num_results` first
+  // ones after Classify().
+  std::array<int, {{SPEC}}::kNumClasses> indices_;
+};
+)");
+}
+
+GenerationResult::File GenerateHeader(const ModelInfo& model,
+                                      ErrorReporter* err) {
+  CodeWriter code_writer(err);
+  code_writer.SetIndentString("  ");
+  SetCodeWriterWithModelInfo(&code_writer, model);
+  code_writer.Append(R"(// Generated by TFLite Support. Do not edit.
+
+#ifndef {{HEADER_GUARD}}
+#define {{HEADER_GUARD}}
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/kernels/register.h"
+#include "tensorflow/lite/model.h"
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+{{NAMESPACE_OPEN}}
+)");
+  GenerateSpec(&code_writer, model);
+  GenerateClass(&code_writer, model);
+  code_writer.Append(R"({{NAMESPACE_CLOSE}}
+
+#endif  // {{HEADER_GUARD}})");
+  return GenerationResult::File{model.header_path, code_writer.ToString()};
+}
+
+}  // namespace
+
+CcGenerator::CcGenerator(const std::string& header_dir)
+    : CodeGenerator(), header_dir_(header_dir) {}
+
+GenerationResult CcGenerator::Generate(const char* model_buffer,
+                                       size_t model_size,
+                                       const std::string& namespace_name,
+                                       const std::string& model_class_name) {
+  GenerationResult result;
+  for (const auto& name : SplitNamespace(namespace_name)) {
+    if (name.empty() || ConvertToValidName(name) != name) {
+      err_.Error("Invalid namespace: %s", namespace_name.c_str());
+      return result;
+    }
+  }
+  if (model_class_name.empty() || !isupper(model_class_name[0]) ||
+      !std::all_of(model_class_name.begin(), model_class_name.end(),
+                   [](char c) { return isalnum(c); })) {
+    err_.Error("Invalid class name, expected in upper camel case: %s",
+               model_class_name.c_str());
+    return result;
+  }
+  ModelInfo model_info;
+  if (!CreateModelInfo(model_buffer, model_size, namespace_name,
+                       model_class_name, header_dir_, &model_info, &err_)) {
+    err_.Error("Codegen will generate nothing.");
+    return result;
+  }
+  result.files.push_back(GenerateHeader(model_info, &err_));
+  return result;
+}
+
+std::string CcGenerator::GetErrorMessage() { return err_.GetMessage(); }
+
+}  // namespace codegen
+}  // namespace support
+}  // namespace tflite
@@ -0,0 +1,106 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CODEGEN_CC_GENERATOR_H_
+#define TENSORFLOW_LITE_SUPPORT_CODEGEN_CC_GENERATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/codegen/code_generator.h"
+#include "tensorflow_lite_support/codegen/utils.h"
+
+namespace tflite {
+namespace support {
+namespace codegen {
+
+namespace details_cc {
+
+/// The intermediate data structure for generating code from the model and its
+/// metadata. Should only be used as const reference when created.
+struct ModelInfo {
+  std::string namespace_name;
+  std::string model_class_name;
+  std::string model_versioned_name;
+  // e.g. "tensorflow_lite_support/codegen/my_model.h", used for header guards.
+  std::string header_path;
+
+  // Input image, as a [1, height, width, 3] RGB tensor.
+  int input_height;
+  int input_width;
+  int input_channels;
+  // Either "uint8_t" or "float".
+  std::string input_type;
+  // Per-channel normalization, only set for float inputs.
+  std::vector<float> mean_values;
+  std::vector<float> std_values;
+
+  // Output scores, as a [1, num_classes] tensor.
+  int num_classes;
+  // Either "uint8_t" or "float".
+  std::string output_type;
+  // Only set for quantized outputs.
+  float output_scale;
+  int output_zero_point;
+  // One per class. Empty if the output has no axis labels.
+  std::vector<std::string> labels;
+};
+
+}  // namespace details_cc
+
+constexpr char CC_HEADER_EXT[] = ".h";
+
+/// Generates a C++ wrapper specialized for a given image classification model,
+/// based on its TFLite metadata.
+///
+/// Unlike the Task Library's ImageClassifier, which inspects the model at
+/// runtime, the generated wrapper has the tensor shapes and types, the
+/// normalization and quantization parameters and the labels baked in as
+/// compile-time constants: pre and postprocessing only contain the code needed
+/// for this model, as loops over constant bounds. The wrapper checks once at
+/// creation time that the model matches the one it was generated from.
+class CcGenerator : public CodeGenerator {
+ public:
+  /// Creates a CcGenerator.
+  /// Args:
+  /// - header_dir: The directory of the generated header, relative to the
+  /// workspace root (e.g. "my_project/models"), used for its path and header
+  /// guard.
+  explicit CcGenerator(const std::string& header_dir);
+
+  /// Generates the wrapper header. Returns the file path and content.
+  /// Args:
+  /// - model_buffer: The TFLite model with Metadata filled, and the associated
+  /// label files packed.
+  /// - namespace_name: The C++ namespace of the generated class, e.g.
+  /// "my_project::models".
+  /// - model_class_name: The name of the generated wrapper class, such as
+  /// "MobileNetV2Classifier". The header is named after it, in snake case.
+  GenerationResult Generate(const char* model_buffer, size_t model_size,
+                            const std::string& namespace_name,
+                            const std::string& model_class_name);
+
+  std::string GetErrorMessage();
+
+ private:
+  const std::string header_dir_;
+  ErrorReporter err_;
+};
+
+}  // namespace codegen
+}  // namespace support
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CODEGEN_CC_GENERATOR_H_
@@ -0,0 +1,270 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/codegen/cc_generator.h"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/codegen/utils.h"
+#include "tensorflow_lite_support/metadata/cc/metadata_populator.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+
+namespace tflite {
+namespace support {
+namespace codegen {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tflite::metadata::ModelMetadataPopulator;
+
+constexpr char kTestDataDirectory[] = "tensorflow_lite_support/codegen/testdata";
+constexpr char kNamespace[] = "tflite::support::codegen::testing";
+constexpr char kLabelsName[] = "labels.txt";
+
+// Describes the synthetic image classification models of the tests.
+struct TestModel {
+  // Either TensorType_FLOAT32 or TensorType_UINT8, for input and output.
+  TensorType type = TensorType_FLOAT32;
+  std::vector<int> input_shape = {1, 2, 2, 3};
+  std::vector<int> output_shape = {1, 3};
+  std::string name;
+  std::string version;
+  // Attached to the output tensor if not empty.
+  std::string labels;
+};
+
+std::string BuildMetadata(const TestModel& test_model) {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto image_properties =
+      CreateImageProperties(builder, ColorSpaceType_RGB);
+  const auto content = CreateContent(builder, ContentProperties_ImageProperties,
+                                     image_properties.Union());
+  std::vector<flatbuffers::Offset<ProcessUnit>> process_units;
+  if (test_model.type == TensorType_FLOAT32) {
+    const auto normalization_options = CreateNormalizationOptions(
+        builder, builder.CreateVector(std::vector<float>{127.5f}),
+        builder.CreateVector(std::vector<float>{127.5f}));
+    process_units.push_back(
+        CreateProcessUnit(builder, ProcessUnitOptions_NormalizationOptions,
+                          normalization_options.Union()));
+  }
+  const auto process_units_vector = builder.CreateVector(process_units);
+  TensorMetadataBuilder input_metadata_builder(builder);
+  input_metadata_builder.add_content(content);
+  input_metadata_builder.add_process_units(process_units_vector);
+  const auto input_metadata = input_metadata_builder.Finish();
+
+  std::vector<flatbuffers::Offset<AssociatedFile>> associated_files;
+  if (!test_model.labels.empty()) {
+    const auto labels_name = builder.CreateString(kLabelsName);
+    AssociatedFileBuilder associated_file_builder(builder);
+    associated_file_builder.add_name(labels_name);
+    associated_file_builder.add_type(AssociatedFileType_TENSOR_AXIS_LABELS);
+    associated_files.push_back(associated_file_builder.Finish());
+  }
+  const auto associated_files_vector = builder.CreateVector(associated_files);
+  TensorMetadataBuilder output_metadata_builder(builder);
+  output_metadata_builder.add_associated_files(associated_files_vector);
+  const auto output_metadata = output_metadata_builder.Finish();
+
+  const auto input_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<TensorMetadata>>{input_metadata});
+  const auto output_tensor_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<TensorMetadata>>{output_metadata});
+  SubGraphMetadataBuilder subgraph_metadata_builder(builder);
+  subgraph_metadata_builder.add_input_tensor_metadata(input_tensor_metadata);
+  subgraph_metadata_builder.add_output_tensor_metadata(output_tensor_metadata);
+  const auto subgraph_metadata = builder.CreateVector(
+      std::vector<flatbuffers::Offset<SubGraphMetadata>>{
+          subgraph_metadata_builder.Finish()});
+  const auto name = builder.CreateString(test_model.name);
+  const auto version = builder.CreateString(test_model.version);
+  ModelMetadataBuilder model_metadata_builder(builder);
+  model_metadata_builder.add_name(name);
+  model_metadata_builder.add_version(version);
+  model_metadata_builder.add_subgraph_metadata(subgraph_metadata);
+  FinishModelMetadataBuffer(builder, model_metadata_builder.Finish());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Returns a model with the tensors of `test_model`, its metadata and labels.
+// The model has no operators, as the generator does not run it.
+std::string BuildModel(const TestModel& test_model) {
+  ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<BufferT>());
+  auto subgraph = absl::make_unique<SubGraphT>();
+  for (const auto& shape : {test_model.input_shape, test_model.output_shape}) {
+    auto tensor = absl::make_unique<TensorT>();
+    tensor->type = test_model.type;
+    tensor->buffer = 0;
+    tensor->shape = shape;
+    subgraph->tensors.push_back(std::move(tensor));
+  }
+  subgraph->tensors[0]->name = "image";
+  subgraph->tensors[1]->name = "probability";
+  if (test_model.type == TensorType_UINT8) {
+    auto quantization = absl::make_unique<QuantizationParametersT>();
+    quantization->scale = {0.00390625f};
+    quantization->zero_point = {3};
+    subgraph->tensors[1]->quantization = std::move(quantization);
+  }
+  subgraph->inputs = {0};
+  subgraph->outputs = {1};
+  model.subgraphs.push_back(std::move(subgraph));
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(Model::Pack(builder, &model), ModelIdentifier());
+
+  auto populator = ModelMetadataPopulator::CreateFromModelBuffer(
+      reinterpret_cast<const char*>(builder.GetBufferPointer()),
+      builder.GetSize());
+  EXPECT_TRUE(populator.ok());
+  const std::string metadata = BuildMetadata(test_model);
+  (*populator)->LoadMetadata(metadata.data(), metadata.size());
+  if (!test_model.labels.empty()) {
+    (*populator)->LoadAssociatedFiles({{kLabelsName, test_model.labels}});
+  }
+  auto model_with_metadata = (*populator)->Populate();
+  EXPECT_TRUE(model_with_metadata.ok());
+  return *model_with_metadata;
+}
+
+TestModel GetFloatModel() {
+  TestModel test_model;
+  test_model.name = "Tiny classifier";
+  test_model.version = "v1";
+  test_model.labels = "cat\ndog\nbird\n";
+  return test_model;
+}
+
+TestModel GetQuantizedModel() {
+  TestModel test_model;
+  test_model.type = TensorType_UINT8;
+  return test_model;
+}
+
+std::string ReadGoldenFile(const std::string& name) {
+  std::ifstream file("./" + JoinPath(kTestDataDirectory, name));
+  EXPECT_TRUE(file.good()) << "Unable to read " << name;
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// Generates the header of `test_model`, checking that it succeeds.
+GenerationResult::File GenerateHeader(const TestModel& test_model,
+                                      const std::string& class_name) {
+  const std::string model = BuildModel(test_model);
+  CcGenerator generator(kTestDataDirectory);
+  GenerationResult result =
+      generator.Generate(model.data(), model.size(), kNamespace, class_name);
+  EXPECT_EQ(result.files.size(), 1) << generator.GetErrorMessage();
+  return result.files.empty() ? GenerationResult::File{} : result.files[0];
+}
+
+// Returns the error message of a generation expected to fail.
+std::string GenerateError(const TestModel& test_model,
+                          const std::string& namespace_name,
+                          const std::string& class_name) {
+  const std::string model = BuildModel(test_model);
+  CcGenerator generator(kTestDataDirectory);
+  GenerationResult result = generator.Generate(model.data(), model.size(),
+                                               namespace_name, class_name);
+  EXPECT_TRUE(result.files.empty());
+  return generator.GetErrorMessage();
+}
+
+TEST(CcGeneratorTest, GeneratesFloatModelWrapper) {
+  const GenerationResult::File header =
+      GenerateHeader(GetFloatModel(), "TinyFloatClassifier");
+
+  EXPECT_EQ(header.path,
+            "tensorflow_lite_support/codegen/testdata/tiny_float_classifier.h");
+  EXPECT_EQ(header.content,
+            ReadGoldenFile("tiny_float_classifier.h.golden"));
+}
+
+TEST(CcGeneratorTest, GeneratesQuantizedModelWrapper) {
+  const GenerationResult::File header =
+      GenerateHeader(GetQuantizedModel(), "TinyQuantClassifier");
+
+  EXPECT_EQ(header.path,
+            "tensorflow_lite_support/codegen/testdata/tiny_quant_classifier.h");
+  EXPECT_EQ(header.content,
+            ReadGoldenFile("tiny_quant_classifier.h.golden"));
+}
+
+TEST(CcGeneratorTest, AcceptsFourDimensionalScores) {
+  TestModel test_model = GetFloatModel();
+  test_model.output_shape = {1, 1, 1, 3};
+
+  const GenerationResult::File header =
+      GenerateHeader(test_model, "TinyFloatClassifier");
+
+  EXPECT_EQ(header.content,
+            ReadGoldenFile("tiny_float_classifier.h.golden"));
+}
+
+TEST(CcGeneratorTest, FailsWithInvalidNames) {
+  EXPECT_THAT(GenerateError(GetFloatModel(), "Invalid::Namespace",
+                            "TinyFloatClassifier"),
+              HasSubstr("Invalid namespace"));
+  EXPECT_THAT(GenerateError(GetFloatModel(), "a::::b", "TinyFloatClassifier"),
+              HasSubstr("Invalid namespace"));
+  EXPECT_THAT(GenerateError(GetFloatModel(), kNamespace, "tinyClassifier"),
+              HasSubstr("Invalid class name"));
+  EXPECT_THAT(GenerateError(GetFloatModel(), kNamespace, "Tiny_Classifier"),
+              HasSubstr("Invalid class name"));
+}
+
+TEST(CcGeneratorTest, FailsWithNonImageInput) {
+  TestModel test_model = GetFloatModel();
+  test_model.input_shape = {1, 2, 2, 1};
+
+  EXPECT_THAT(GenerateError(test_model, kNamespace, "TinyFloatClassifier"),
+              HasSubstr("[1, height, width, 3]"));
+}
+
+TEST(CcGeneratorTest, FailsWithInvalidScoresShape) {
+  TestModel test_model = GetFloatModel();
+  test_model.output_shape = {2, 3};
+
+  EXPECT_THAT(GenerateError(test_model, kNamespace, "TinyFloatClassifier"),
+              HasSubstr("[1, num_classes]"));
+}
+
+TEST(CcGeneratorTest, FailsWithMismatchedLabels) {
+  TestModel test_model = GetFloatModel();
+  test_model.labels = "cat\ndog\n";
+
+  EXPECT_THAT(GenerateError(test_model, kNamespace, "TinyFloatClassifier"),
+              HasSubstr("Found 2 labels for 3 classes"));
+}
+
+}  // namespace
+}  // namespace codegen
+}  // namespace support
+}  // namespace tflite
@@ -0,0 +1,128 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmark comparing the C++ wrapper generated for the quantized
+// MobileNet test model (see the "mobile_net_quant_classifier" genrule) with
+// the generic ImageClassifier, both classifying an image already at the input
+// size of the model and returning the top 5 categories.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/codegen:cc_wrapper_benchmark
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/codegen/mobile_net_quant_classifier.h"
+
+namespace tflite {
+namespace support {
+namespace codegen {
+namespace testing {
+namespace {
+
+using ::tflite::task::vision::CreateFromRgbRawBuffer;
+using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::ImageClassifier;
+using ::tflite::task::vision::ImageClassifierOptions;
+
+constexpr char kModelPath[] =
+    "./tensorflow_lite_support/cc/test/testdata/task/vision/"
+    "mobilenet_v1_0.25_224_quant.tflite";
+constexpr int kMaxResults = 5;
+
+// Builds a smooth synthetic RGB image at the input size of the model.
+std::vector<uint8_t> BuildImage() {
+  namespace spec = mobile_net_quant_classifier_spec;
+  std::vector<uint8_t> pixels(spec::kInputSize);
+  for (int y = 0; y < spec::kInputHeight; ++y) {
+    for (int x = 0; x < spec::kInputWidth; ++x) {
+      uint8_t* pixel = &pixels[(y * spec::kInputWidth + x) * 3];
+      pixel[0] = x;
+      pixel[1] = y;
+      pixel[2] = (x + y) / 2;
+    }
+  }
+  return pixels;
+}
+
+StatusOr<std::unique_ptr<ImageClassifier>> CreateImageClassifier() {
+  ImageClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      kModelPath);
+  options.mutable_base_options()
+      ->mutable_compute_settings()
+      ->mutable_tflite_settings()
+      ->mutable_cpu_settings()
+      ->set_num_threads(1);
+  options.set_max_results(kMaxResults);
+  return ImageClassifier::CreateFromOptions(options);
+}
+
+void BM_GeneratedClassifier(benchmark::State& state) {
+  auto classifier = MobileNetQuantClassifier::CreateFromFile(kModelPath);
+  auto reference = CreateImageClassifier();
+  if (!classifier.ok() || !reference.ok()) {
+    state.SkipWithError("Failed to create classifier.");
+    return;
+  }
+  const std::vector<uint8_t> pixels = BuildImage();
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      pixels.data(), {mobile_net_quant_classifier_spec::kInputWidth,
+                      mobile_net_quant_classifier_spec::kInputHeight});
+  auto categories = (*classifier)->Classify(pixels.data(), kMaxResults);
+  auto expected = (*reference)->Classify(*frame_buffer);
+  if (!categories.ok() || !expected.ok() ||
+      categories->front().index !=
+          expected->classifications(0).classes(0).index()) {
+    state.SkipWithError("Results differ from the ImageClassifier ones.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        (*classifier)->Classify(pixels.data(), kMaxResults));
+  }
+}
+BENCHMARK(BM_GeneratedClassifier);
+
+void BM_ImageClassifier(benchmark::State& state) {
+  auto classifier = CreateImageClassifier();
+  if (!classifier.ok()) {
+    state.SkipWithError("Failed to create classifier.");
+    return;
+  }
+  const std::vector<uint8_t> pixels = BuildImage();
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      pixels.data(), {mobile_net_quant_classifier_spec::kInputWidth,
+                      mobile_net_quant_classifier_spec::kInputHeight});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize((*classifier)->Classify(*frame_buffer));
+  }
+}
+BENCHMARK(BM_ImageClassifier);
+
+}  // namespace
+}  // namespace testing
+}  // namespace codegen
+}  // namespace support
+}  // namespace tflite
+
+BENCHMARK_MAIN();
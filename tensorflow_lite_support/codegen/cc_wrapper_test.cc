@@ -0,0 +1,168 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Checks the C++ wrapper generated for the quantized MobileNet test model (see
+// the "mobile_net_quant_classifier_gen" genrule) against ImageClassifier.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/codegen/mobile_net_quant_classifier.h"
+
+namespace tflite {
+namespace support {
+namespace codegen {
+namespace testing {
+namespace {
+
+using ::testing::FloatEq;
+using ::testing::StrEq;
+using ::tflite::task::vision::ClassificationResult;
+using ::tflite::task::vision::Classifications;
+using ::tflite::task::vision::CreateFromRgbRawBuffer;
+using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::ImageClassifier;
+using ::tflite::task::vision::ImageClassifierOptions;
+
+namespace spec = mobile_net_quant_classifier_spec;
+
+constexpr char kTestDataDirectory[] =
+    "./tensorflow_lite_support/cc/test/testdata/task/vision/";
+constexpr char kModelName[] = "mobilenet_v1_0.25_224_quant.tflite";
+// Same architecture, with float input and output tensors.
+constexpr char kFloatModelName[] = "mobilenet_v1_0.25_224_1_default_1.tflite";
+
+std::string GetModelPath(const std::string& model_name) {
+  return std::string(kTestDataDirectory) + model_name;
+}
+
+// Returns a synthetic RGB image at the input size of the model, varying with
+// `seed`.
+std::vector<uint8_t> BuildImage(int seed) {
+  std::vector<uint8_t> pixels(spec::kInputSize);
+  for (int y = 0; y < spec::kInputHeight; ++y) {
+    for (int x = 0; x < spec::kInputWidth; ++x) {
+      uint8_t* pixel = &pixels[(y * spec::kInputWidth + x) * 3];
+      pixel[0] = x * seed;
+      pixel[1] = y + 32 * seed;
+      pixel[2] = (x + y) / (seed + 1);
+    }
+  }
+  return pixels;
+}
+
+StatusOr<std::unique_ptr<ImageClassifier>> CreateImageClassifier() {
+  ImageClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetModelPath(kModelName));
+  // All classes, as the order of equal scores is unspecified.
+  options.set_max_results(-1);
+  return ImageClassifier::CreateFromOptions(options);
+}
+
+TEST(MobileNetQuantClassifierTest, MatchesImageClassifier) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<MobileNetQuantClassifier> classifier,
+      MobileNetQuantClassifier::CreateFromFile(GetModelPath(kModelName)));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> reference,
+                               CreateImageClassifier());
+
+  for (int seed = 0; seed < 3; ++seed) {
+    SCOPED_TRACE(seed);
+    const std::vector<uint8_t> pixels = BuildImage(seed);
+    std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+        pixels.data(), {spec::kInputWidth, spec::kInputHeight});
+
+    SUPPORT_ASSERT_OK_AND_ASSIGN(const auto categories,
+                                 classifier->Classify(pixels.data()));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(const ClassificationResult expected,
+                                 reference->Classify(*frame_buffer));
+
+    ASSERT_EQ(expected.classifications_size(), 1);
+    const Classifications& classifications = expected.classifications(0);
+    ASSERT_EQ(categories.size(), spec::kNumClasses);
+    ASSERT_EQ(classifications.classes_size(), spec::kNumClasses);
+    absl::flat_hash_map<int, int> expected_positions;
+    for (int i = 0; i < classifications.classes_size(); ++i) {
+      expected_positions[classifications.classes(i).index()] = i;
+    }
+    for (int i = 0; i < categories.size(); ++i) {
+      const auto& category = categories[i];
+      ASSERT_TRUE(expected_positions.contains(category.index));
+      const auto& expected_class =
+          classifications.classes(expected_positions[category.index]);
+      EXPECT_THAT(category.score, FloatEq(expected_class.score()));
+      EXPECT_THAT(category.label, StrEq(expected_class.class_name()));
+      if (i > 0) {
+        EXPECT_GE(categories[i - 1].score, category.score);
+      }
+    }
+    // The best category is only well defined if its score is not tied.
+    if (classifications.classes(0).score() >
+        classifications.classes(1).score()) {
+      EXPECT_EQ(categories[0].index, classifications.classes(0).index());
+    }
+  }
+}
+
+TEST(MobileNetQuantClassifierTest, ReturnsMaxResults) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<MobileNetQuantClassifier> classifier,
+      MobileNetQuantClassifier::CreateFromFile(GetModelPath(kModelName)));
+  const std::vector<uint8_t> pixels = BuildImage(/*seed=*/1);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const auto all,
+                               classifier->Classify(pixels.data()));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(const auto top,
+                               classifier->Classify(pixels.data(), 5));
+
+  ASSERT_EQ(top.size(), 5);
+  for (int i = 0; i < top.size(); ++i) {
+    EXPECT_EQ(top[i].index, all[i].index);
+    EXPECT_EQ(top[i].score, all[i].score);
+  }
+}
+
+TEST(MobileNetQuantClassifierTest, FailsWithMissingModel) {
+  EXPECT_EQ(MobileNetQuantClassifier::CreateFromFile(GetModelPath("missing"))
+                .status()
+                .code(),
+            absl::StatusCode::kNotFound);
+}
+
+TEST(MobileNetQuantClassifierTest, FailsWithDifferentModel) {
+  EXPECT_EQ(
+      MobileNetQuantClassifier::CreateFromFile(GetModelPath(kFloatModelName))
+          .status()
+          .code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace codegen
+}  // namespace support
+}  // namespace tflite
@@ -0,0 +1,91 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Generates the C++ wrapper of an image classification model with metadata,
+// e.g. from a genrule:
+//
+//   genrule(
+//       name = "my_classifier_gen",
+//       srcs = ["my_model.tflite"],
+//       outs = ["my_classifier.h"],
+//       cmd = "$(location :generate_cc_wrapper)"
+//             " --model_path=$< --output_path=$@ --header_dir=my/package"
+//             " --cc_namespace=my::package --class_name=MyClassifier",
+//       tools = [":generate_cc_wrapper"],
+//   )
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/flags/parse.h"  // from @com_google_absl
+#include "tensorflow_lite_support/codegen/cc_generator.h"
+
+ABSL_FLAG(std::string, model_path, "",
+          "Path to the '.tflite' model with metadata.");
+ABSL_FLAG(std::string, cc_namespace, "",
+          "C++ namespace of the generated class, e.g. 'my::package'.");
+ABSL_FLAG(std::string, class_name, "",
+          "Name of the generated class, in upper camel case.");
+ABSL_FLAG(std::string, header_dir, "",
+          "Directory of the generated header relative to the workspace root, "
+          "used for its header guard.");
+ABSL_FLAG(std::string, output_path, "",
+          "Where to write the generated header. Defaults to its path under "
+          "'header_dir', named after 'class_name'.");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  if (absl::GetFlag(FLAGS_model_path).empty() ||
+      absl::GetFlag(FLAGS_cc_namespace).empty() ||
+      absl::GetFlag(FLAGS_class_name).empty()) {
+    std::cerr << "Missing mandatory 'model_path', 'cc_namespace' or "
+                 "'class_name' argument.\n";
+    return 1;
+  }
+
+  std::ifstream model_file(absl::GetFlag(FLAGS_model_path), std::ios::binary);
+  if (!model_file) {
+    std::cerr << "Unable to open " << absl::GetFlag(FLAGS_model_path) << "\n";
+    return 1;
+  }
+  std::stringstream model_buffer;
+  model_buffer << model_file.rdbuf();
+  const std::string model = model_buffer.str();
+
+  tflite::support::codegen::CcGenerator generator(
+      absl::GetFlag(FLAGS_header_dir));
+  const auto result =
+      generator.Generate(model.data(), model.size(),
+                         absl::GetFlag(FLAGS_cc_namespace),
+                         absl::GetFlag(FLAGS_class_name));
+  std::cerr << generator.GetErrorMessage();
+  if (result.files.empty()) {
+    return 1;
+  }
+  const auto& header = result.files.front();
+  const std::string output_path = absl::GetFlag(FLAGS_output_path).empty()
+                                      ? header.path
+                                      : absl::GetFlag(FLAGS_output_path);
+  std::ofstream output_file(output_path);
+  output_file << header.content;
+  if (!output_file) {
+    std::cerr << "Unable to write " << output_path << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -180,6 +180,27 @@ std::string SnakeCaseToCamelCase(const std::string& s) {
   return t;
 }
 
+std::string CamelCaseToSnakeCase(const std::string& s) {
+  std::string t;
+  t.reserve(s.length() + s.length() / 2);
+  for (size_t i = 0; i < s.size(); i++) {
+    const char c = s[i];
+    if (isupper(c)) {
+      // Start a new word before an upper case letter following a lower case
+      // letter or a digit, or ending an acronym ("HTTPServer" -> "http_server").
+      if (i > 0 && (islower(s[i - 1]) || isdigit(s[i - 1]) ||
+                    (isupper(s[i - 1]) && i + 1 < s.size() &&
+                     islower(s[i + 1])))) {
+        t += '_';
+      }
+      t += tolower(c);
+    } else {
+      t += c;
+    }
+  }
+  return t;
+}
+
 std::string JoinPath(const std::string& a, const std::string& b) {
   if (a.empty()) return b;
   std::string a_fixed = a;
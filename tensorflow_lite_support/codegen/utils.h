@@ -116,6 +116,10 @@ class CodeWriter {
 /// string "s" is already in snake case; or unexpected behavior may occur.
 std::string SnakeCaseToCamelCase(const std::string& s);
 
+/// Converts FooBarName to foo_bar_name. Acronyms are kept as one word, so
+/// HTTPServer becomes http_server.
+std::string CamelCaseToSnakeCase(const std::string& s);
+
 /// Joins 2 parts of file path into one, connected by unix path seperator '/'.
 /// It's callers duty to ensure the two parts are valid.
 std::string JoinPath(const std::string& a, const std::string& b);
@@ -91,6 +91,15 @@ TEST(CaseConversionTest, TestSnakeToCamel) {
   EXPECT_EQ("camel", SnakeCaseToCamelCase("camel"));
 }
 
+TEST(CaseConversionTest, TestCamelToSnake) {
+  EXPECT_EQ("im_a_snake", CamelCaseToSnakeCase("ImASnake"));
+  EXPECT_EQ("im_a_snake", CamelCaseToSnakeCase("imASnake"));
+  EXPECT_EQ("mobile_net_v2_classifier",
+            CamelCaseToSnakeCase("MobileNetV2Classifier"));
+  EXPECT_EQ("http_server", CamelCaseToSnakeCase("HTTPServer"));
+  EXPECT_EQ("snake", CamelCaseToSnakeCase("snake"));
+}
+
 }  // namespace
 }  // namespace codegen
 }  // namespace support
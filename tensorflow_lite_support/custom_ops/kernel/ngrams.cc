@@ -15,10 +15,20 @@ limitations under the License.
 
 #include "tensorflow_lite_support/custom_ops/kernel/ngrams.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "flatbuffers/flexbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/context.h"
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/string_util.h"
+#include "tensorflow_lite_support/custom_ops/kernel/string_tensor_writer.h"
 
 namespace tflite {
 namespace ops {
@@ -45,6 +55,11 @@ namespace ngrams {
 // Output:
 // * output: A string tensor that matches the rank of 'data'.  Will be a ragged
 //     tensor if 'data' is a ragged tensor.
+//
+// The output row_splits and the size of every n-gram are computed in a first
+// pass over the token lengths, which gives the exact size of the output
+// values. The n-grams are then joined straight from the input tensor into the
+// output buffer, the rows being split across the CPU backend thread pool.
 
 // Both the input and output tensors use the same indices.
 constexpr int kValues = 0;
@@ -66,6 +81,10 @@ struct NgramsAttributes {
         string_separator(m["string_separator"].ToString()) {}
 };
 
+// Rows are not split across tasks below this many output bytes per task, as
+// the overhead of the thread pool would outweigh the gain.
+constexpr int64_t kMinBytesPerTask = 16 * 1024;
+
 inline bool OutputIsTensor(TfLiteNode* node) { return NumOutputs(node) == 1; }
 inline int NumRowSplits(TfLiteNode* node) {
   return NumInputs(node) - kRowSplitsStart;
@@ -86,6 +105,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   TF_LITE_ENSURE(context, attributes.reduction_type == kStringJoin);
   TF_LITE_ENSURE(context, attributes.axis == -1);
+  TF_LITE_ENSURE(context, attributes.width > 0);
 
   TfLiteTensor* output_values = GetOutput(context, node, kValues);
   if (OutputIsTensor(node)) {
@@ -118,9 +138,62 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+// Writes the n-grams of `num_rows` rows of tokens, starting at `first_row`.
+// The window over the tokens of a row is a contiguous range of the input
+// tensor, so tokens are read in place rather than gathered.
+class NgramsTask : public cpu_backend_threadpool::Task {
+ public:
+  NgramsTask(const TfLiteTensor* input_values, const int64_t* input_row_splits,
+             const int64_t* output_row_splits, const int64_t* payload_offsets,
+             int first_row, int num_rows, int width, StringRef separator,
+             TfLiteTensor* output_values, int num_ngrams)
+      : input_values_(input_values),
+        input_row_splits_(input_row_splits),
+        output_row_splits_(output_row_splits),
+        payload_offsets_(payload_offsets),
+        first_row_(first_row),
+        num_rows_(num_rows),
+        width_(width),
+        separator_(separator),
+        output_values_(output_values),
+        num_ngrams_(num_ngrams) {}
+
+  void Run() override {
+    StringTensorWriter writer(output_values_, num_ngrams_,
+                              output_row_splits_[first_row_],
+                              payload_offsets_[first_row_]);
+    for (int i = first_row_; i < first_row_ + num_rows_; ++i) {
+      for (int64_t start = input_row_splits_[i];
+           start + width_ <= input_row_splits_[i + 1]; ++start) {
+        writer.StartString();
+        for (int j = 0; j < width_; ++j) {
+          if (j > 0) {
+            writer.Append(separator_.str, separator_.len);
+          }
+          const StringRef token = GetString(input_values_, start + j);
+          writer.Append(token.str, token.len);
+        }
+      }
+    }
+  }
+
+ private:
+  const TfLiteTensor* input_values_;
+  const int64_t* input_row_splits_;
+  const int64_t* output_row_splits_;
+  const int64_t* payload_offsets_;
+  const int first_row_;
+  const int num_rows_;
+  const int width_;
+  const StringRef separator_;
+  TfLiteTensor* output_values_;
+  const int num_ngrams_;
+};
+
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const auto& attributes =
       *reinterpret_cast<NgramsAttributes*>(node->user_data);
+  const int width = attributes.width;
 
   // Storage for the dummy input and output row_splits used in the tensor case.
   std::vector<int64_t> tensor_input_row_splits;
@@ -134,13 +207,17 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
   if (OutputIsTensor(node)) {
     // Generate mock input and output innermost row_splits.
-    int64_t total_tokens = NumElements(input_values);
-    int64_t tokens_per_element =
-        SizeOfDimension(input_values, NumDimensions(input_values) - 1);
-    tensor_input_row_splits.reserve(total_tokens / tokens_per_element + 1);
-    tensor_output_row_splits.resize(total_tokens / tokens_per_element + 1);
-    for (int64_t i = 0; i <= total_tokens; i += tokens_per_element) {
-      tensor_input_row_splits.push_back(i);
+    const int num_dims = NumDimensions(input_values);
+    int64_t num_rows = 1;
+    for (int i = 0; i < num_dims - 1; ++i) {
+      num_rows *= SizeOfDimension(input_values, i);
+    }
+    const int64_t tokens_per_element =
+        SizeOfDimension(input_values, num_dims - 1);
+    tensor_input_row_splits.resize(num_rows + 1);
+    tensor_output_row_splits.resize(num_rows + 1);
+    for (int64_t i = 0; i <= num_rows; ++i) {
+      tensor_input_row_splits[i] = i * tokens_per_element;
     }
     input_row_splits = tensor_input_row_splits.data();
     output_row_splits = tensor_output_row_splits.data();
@@ -165,31 +242,73 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     output_row_splits = output_tensor_row_splits->data.i64;
     n_row_splits = SizeOfDimension(input_tensor_row_splits, 0);
   }
+  TF_LITE_ENSURE(context, n_row_splits > 0);
+  const int num_rows = n_row_splits - 1;
 
-  DynamicBuffer buffer;
+  // First pass: compute the output row_splits and the offset of the payload of
+  // each row, with a running sum of the token lengths over the window.
   StringRef separator;
   separator.str = attributes.string_separator.c_str();
   separator.len = attributes.string_separator.length();
-  int buffer_index = 0;
-  for (int i = 0; i < n_row_splits - 1; ++i) {
-    output_row_splits[i] = buffer_index;
-    std::vector<StringRef> tokens;
-    for (int j = input_row_splits[i]; j < input_row_splits[i + 1]; ++j) {
-      tokens.emplace_back(GetString(input_values, j));
-      if (tokens.size() < attributes.width) continue;
-      tokens.erase(tokens.begin(),
-                   tokens.begin() + tokens.size() - attributes.width);
-      buffer.AddJoinedString(tokens, separator);
-      ++buffer_index;
+  std::vector<int64_t> payload_offsets(n_row_splits);
+  int64_t num_ngrams = 0;
+  int64_t payload_size = 0;
+  for (int i = 0; i < num_rows; ++i) {
+    output_row_splits[i] = num_ngrams;
+    payload_offsets[i] = payload_size;
+    const int64_t begin = input_row_splits[i];
+    int64_t window_size = 0;
+    for (int64_t j = begin; j < input_row_splits[i + 1]; ++j) {
+      window_size += GetString(input_values, j).len;
+      if (j - begin >= width) {
+        window_size -= GetString(input_values, j - width).len;
+      }
+      if (j - begin + 1 >= width) {
+        payload_size += window_size + (width - 1) * separator.len;
+        ++num_ngrams;
+      }
     }
   }
-  output_row_splits[n_row_splits - 1] = buffer_index;
+  output_row_splits[num_rows] = num_ngrams;
+  payload_offsets[num_rows] = payload_size;
 
   TfLiteTensor* output_values = GetOutput(context, node, kValues);
-  if (OutputIsTensor(node)) {
-    buffer.WriteToTensor(output_values, /*new_shape=*/nullptr);
-  } else {
-    buffer.WriteToTensorAsVector(output_values);
+  TF_LITE_ENSURE(context,
+                 num_ngrams <= std::numeric_limits<int32_t>::max() &&
+                     payload_size <= std::numeric_limits<int32_t>::max());
+  TfLiteIntArray* output_shape = nullptr;
+  if (!OutputIsTensor(node)) {
+    output_shape = TfLiteIntArrayCreate(1);
+    output_shape->data[0] = num_ngrams;
+  }
+  TF_LITE_ENSURE_STATUS(ResizeStringTensor(context, output_values, output_shape,
+                                           num_ngrams, payload_size));
+  StringTensorWriter::WriteHeader(output_values, num_ngrams, payload_size);
+
+  // Second pass: split the rows into contiguous ranges of about the same
+  // payload size, one per thread, and write them.
+  CpuBackendContext* cpu_backend_context =
+      CpuBackendContext::GetFromContext(context);
+  const int num_tasks = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>({cpu_backend_context->max_num_threads(), num_rows,
+                            payload_size / kMinBytesPerTask})));
+  std::vector<NgramsTask> tasks;
+  tasks.reserve(num_tasks);
+  for (int first_row = 0, i = 0; i < num_rows;) {
+    ++i;
+    const int num_ended_tasks = tasks.size() + 1;
+    if (i == num_rows ||
+        (num_ended_tasks < num_tasks &&
+         payload_offsets[i] * num_tasks >= payload_size * num_ended_tasks)) {
+      tasks.emplace_back(input_values, input_row_splits, output_row_splits,
+                         payload_offsets.data(), first_row, i - first_row,
+                         width, separator, output_values, num_ngrams);
+      first_row = i;
+    }
+  }
+  if (!tasks.empty()) {
+    cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                    cpu_backend_context);
   }
 
   return kTfLiteOk;
@@ -0,0 +1,205 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmark comparing the Ngrams op with a reference implementation that
+// gathers the tokens of each row in a vector, erasing them as the window
+// slides, and copies the n-grams through a DynamicBuffer.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/custom_ops/kernel:ngrams_benchmark
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/test_util.h"
+#include "tensorflow/lite/string_util.h"
+#include "tensorflow_lite_support/custom_ops/kernel/ngrams.h"
+
+namespace tflite {
+namespace ops {
+namespace custom {
+namespace ngrams {
+namespace {
+
+// Reference implementation, supporting ragged inputs with a single row_splits
+// tensor only.
+namespace reference {
+
+struct Attributes {
+  int width;
+  std::string string_separator;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  const flexbuffers::Map m =
+      flexbuffers::GetRoot(reinterpret_cast<const uint8_t*>(buffer), length)
+          .AsMap();
+  return new Attributes{m["width"].AsInt32(),
+                        m["string_separator"].ToString()};
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<Attributes*>(buffer);
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  SetTensorToDynamic(GetOutput(context, node, 0));
+  TfLiteIntArray* row_splits_shape = TfLiteIntArrayCreate(1);
+  row_splits_shape->data[0] = SizeOfDimension(GetInput(context, node, 1), 0);
+  return context->ResizeTensor(context, GetOutput(context, node, 1),
+                               row_splits_shape);
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  const auto& attributes = *reinterpret_cast<Attributes*>(node->user_data);
+  const TfLiteTensor* input_values = GetInput(context, node, 0);
+  const int64_t* input_row_splits = GetInput(context, node, 1)->data.i64;
+  int64_t* output_row_splits = GetOutput(context, node, 1)->data.i64;
+  const int n_row_splits = SizeOfDimension(GetInput(context, node, 1), 0);
+
+  DynamicBuffer buffer;
+  StringRef separator;
+  separator.str = attributes.string_separator.c_str();
+  separator.len = attributes.string_separator.length();
+  int buffer_index = 0;
+  for (int i = 0; i < n_row_splits - 1; ++i) {
+    output_row_splits[i] = buffer_index;
+    std::vector<StringRef> tokens;
+    for (int j = input_row_splits[i]; j < input_row_splits[i + 1]; ++j) {
+      tokens.emplace_back(GetString(input_values, j));
+      if (tokens.size() < attributes.width) continue;
+      tokens.erase(tokens.begin(),
+                   tokens.begin() + tokens.size() - attributes.width);
+      buffer.AddJoinedString(tokens, separator);
+      ++buffer_index;
+    }
+  }
+  output_row_splits[n_row_splits - 1] = buffer_index;
+  buffer.WriteToTensorAsVector(GetOutput(context, node, 0));
+  return kTfLiteOk;
+}
+
+TfLiteRegistration* Register() {
+  static TfLiteRegistration r = {Init, Free, Prepare, Eval};
+  return &r;
+}
+
+}  // namespace reference
+
+class NgramsModel : public SingleOpModel {
+ public:
+  NgramsModel(const std::function<TfLiteRegistration*()>& registration,
+              int width, const std::vector<std::string>& tokens,
+              const std::vector<int64_t>& row_splits, int num_threads) {
+    input_values_ = AddInput(TensorType_STRING);
+    input_row_splits_ = AddInput(TensorType_INT64);
+    AddOutput(TensorType_STRING);
+    AddOutput(TensorType_INT64);
+
+    flexbuffers::Builder fbb;
+    size_t start_map = fbb.StartMap();
+    fbb.Int("width", width);
+    fbb.String("string_separator", " ");
+    fbb.Int("axis", -1);
+    fbb.String("reduction_type", "STRING_JOIN");
+    fbb.EndMap(start_map);
+    fbb.Finish();
+    SetCustomOp("tftext:Ngrams", fbb.GetBuffer(), registration);
+
+    BuildInterpreter({{static_cast<int>(tokens.size())},
+                      {static_cast<int>(row_splits.size())}});
+    interpreter_->SetNumThreads(num_threads);
+    PopulateStringTensor(input_values_, tokens);
+    PopulateTensor(input_row_splits_, row_splits);
+  }
+
+  void Run() { interpreter_->Invoke(); }
+
+ private:
+  int input_values_;
+  int input_row_splits_;
+};
+
+// Builds a ragged batch of `batch_size` sentences of 10 to 60 words, as
+// produced by a whitespace tokenizer. Returns the total size of the tokens.
+int64_t BuildInput(int batch_size, std::vector<std::string>* tokens,
+                   std::vector<int64_t>* row_splits) {
+  const std::vector<std::string> words = {
+      "the",      "quick",    "brown",    "fox",      "jumps",
+      "over",     "lazy",     "dog,",     "ngrams",   "are",
+      "a",        "cheap",    "yet",      "powerful", "feature",
+      "for",      "text",     "models.",  "café",     "naïve"};
+  int64_t input_bytes = 0;
+  row_splits->push_back(0);
+  for (int i = 0; i < batch_size; ++i) {
+    const int num_words = 10 + (i * 37) % 51;
+    for (int j = 0; j < num_words; ++j) {
+      tokens->push_back(words[(i * 31 + j * 7) % words.size()]);
+      input_bytes += tokens->back().size();
+    }
+    row_splits->push_back(tokens->size());
+  }
+  return input_bytes;
+}
+
+void RunBenchmark(benchmark::State& state,
+                  const std::function<TfLiteRegistration*()>& registration) {
+  std::vector<std::string> tokens;
+  std::vector<int64_t> row_splits;
+  const int64_t input_bytes = BuildInput(state.range(0), &tokens, &row_splits);
+  NgramsModel model(registration, /*width=*/state.range(1), tokens, row_splits,
+                    /*num_threads=*/state.range(2));
+  for (auto _ : state) {
+    model.Run();
+  }
+  state.SetBytesProcessed(state.iterations() * input_bytes);
+}
+
+void BM_Ngrams(benchmark::State& state) {
+  RunBenchmark(state, Register_tftext_Ngrams);
+}
+
+void BM_ReferenceNgrams(benchmark::State& state) {
+  RunBenchmark(state, reference::Register);
+}
+
+// Arguments are the batch size, the width of the n-grams and the number of
+// threads of the interpreter.
+void BenchmarkArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int batch_size : {1, 32, 512}) {
+    for (int width : {2, 3}) {
+      for (int num_threads : {1, 4}) {
+        benchmark->Args({batch_size, width, num_threads});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_Ngrams)->Apply(BenchmarkArgs);
+BENCHMARK(BM_ReferenceNgrams)->Apply(BenchmarkArgs);
+
+}  // namespace
+}  // namespace ngrams
+}  // namespace custom
+}  // namespace ops
+}  // namespace tflite
+
+BENCHMARK_MAIN();
@@ -286,6 +286,18 @@ TEST(NgramsTest, RaggedTensorMultidimensionalInputWidthTwo) {
               ElementsAre(4, 3, 2, 1, 1, 2, 3, 5));
 }
 
+TEST(NgramsTest, RaggedTensorEmptyRowsAndTokens) {
+  std::vector<std::vector<int64_t>> nested_row_lengths;
+  nested_row_lengths.push_back({0, 3, 1, 0, 2});
+  NgramsModel m(2, "-", {"this", "", "a", "test", "", ""},
+                nested_row_lengths);
+  EXPECT_THAT(m.GetValuesTensorShape(), ElementsAre(3));
+  EXPECT_THAT(m.ExtractValuesTensorVector(), ElementsAre("this-", "-a", "-"));
+  ASSERT_THAT(m.GetNumNestedRowLengths(), 1);
+  EXPECT_THAT(m.GetRowLengthsTensorShape(0), ElementsAre(5));
+  EXPECT_THAT(m.ExtractRowLengthsTensorVector(0), ElementsAre(0, 2, 0, 0, 1));
+}
+
 }  // namespace test
 }  // namespace ngrams
 }  // namespace custom
@@ -13,13 +13,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "flatbuffers/flexbuffers.h"  // from @flatbuffers
 #include "tensorflow/core/util/ragged_to_dense_util_common.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/context.h"
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/internal/types.h"
@@ -42,6 +47,10 @@ constexpr int kOutputTensor = 0;
 
 constexpr char kRowPartitionTypesAttr[] = "row_partition_types";
 
+// Minimum size of the output written by each task of the row splits fast path,
+// below which splitting the rows across threads costs more than it saves.
+constexpr int kMinOutputBytesPerTask = 64 * 1024;
+
 struct ConversionAttributes {
   std::vector<tensorflow::RowPartitionType> partition_types;
   int ragged_rank = 0;
@@ -545,6 +554,155 @@ void SetOutput(TfLiteContext* context, int ragged_rank,
   }
 }
 
+// Fast path for ragged tensors with a single ROW_SPLITS partition, by far the
+// most common case (e.g. padding the output of tokenizers): each output row is
+// a contiguous run of values followed by padding, so rows are copied with
+// memcpy and padded with std::fill_n, which compilers turn into vector stores,
+// without going through the generic output index.
+//
+// Copies the rows [begin_row, end_row) of the output.
+template <typename VALUE_TYPE, typename INDEX_TYPE>
+class CopyRowsTask : public cpu_backend_threadpool::Task {
+ public:
+  CopyRowsTask(const INDEX_TYPE* row_splits, int num_value_rows,
+               const VALUE_TYPE* values, VALUE_TYPE default_value, int width,
+               int value_element_size, int begin_row, int end_row,
+               VALUE_TYPE* output)
+      : row_splits_(row_splits),
+        num_value_rows_(num_value_rows),
+        values_(values),
+        default_value_(default_value),
+        width_(width),
+        value_element_size_(value_element_size),
+        begin_row_(begin_row),
+        end_row_(end_row),
+        output_(output) {}
+
+  void Run() override {
+    const int64_t row_size = static_cast<int64_t>(width_) * value_element_size_;
+    for (int row = begin_row_; row < end_row_; ++row) {
+      VALUE_TYPE* dst = output_ + row * row_size;
+      int64_t num_copied = 0;
+      if (row < num_value_rows_) {
+        // Values are indexed from the first row split, as in
+        // CalculateOutputIndexRowSplit().
+        const int64_t begin = row_splits_[row] - row_splits_[0];
+        const int64_t row_length =
+            std::min<int64_t>(width_, row_splits_[row + 1] - row_splits_[row]);
+        if (row_length > 0) {
+          num_copied = row_length * value_element_size_;
+          memcpy(dst, values_ + begin * value_element_size_,
+                 num_copied * sizeof(VALUE_TYPE));
+        }
+      }
+      std::fill_n(dst + num_copied, row_size - num_copied, default_value_);
+    }
+  }
+
+ private:
+  const INDEX_TYPE* row_splits_;
+  int num_value_rows_;
+  const VALUE_TYPE* values_;
+  VALUE_TYPE default_value_;
+  int width_;
+  int value_element_size_;
+  int begin_row_;
+  int end_row_;
+  VALUE_TYPE* output_;
+};
+
+// Splits the rows in ranges of the same size across the CPU backend threads
+// when the output is large enough.
+template <typename VALUE_TYPE, typename INDEX_TYPE>
+void CopyRows(TfLiteContext* context, const TfLiteTensor& row_splits,
+              const TfLiteTensor& values_tensor,
+              const TfLiteTensor& default_value_tensor,
+              TfLiteTensor* output_tensor) {
+  const RuntimeShape output_shape = GetTensorShape(output_tensor);
+  const int num_rows = output_shape.Dims(0);
+  const int width = output_shape.Dims(1);
+  const int value_element_size =
+      RuntimeShape(output_shape.DimensionsCount() - 2,
+                   output_shape.DimsData() + 2)
+          .FlatSize();
+  const int num_value_rows =
+      std::min(num_rows, std::max(0, NumElements(&row_splits) - 1));
+
+  const int64_t output_bytes =
+      static_cast<int64_t>(output_shape.FlatSize()) * sizeof(VALUE_TYPE);
+  const int max_num_threads =
+      CpuBackendContext::GetFromContext(context)->max_num_threads();
+  const int num_tasks = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(std::min(max_num_threads, num_rows),
+                           output_bytes / kMinOutputBytesPerTask)));
+
+  std::vector<CopyRowsTask<VALUE_TYPE, INDEX_TYPE>> tasks;
+  tasks.reserve(num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    tasks.emplace_back(
+        GetTensorData<INDEX_TYPE>(&row_splits), num_value_rows,
+        GetTensorData<VALUE_TYPE>(&values_tensor),
+        *GetTensorData<VALUE_TYPE>(&default_value_tensor), width,
+        value_element_size,
+        static_cast<int>(static_cast<int64_t>(num_rows) * i / num_tasks),
+        static_cast<int>(static_cast<int64_t>(num_rows) * (i + 1) / num_tasks),
+        GetTensorData<VALUE_TYPE>(output_tensor));
+  }
+  if (num_tasks == 1) {
+    tasks.front().Run();
+  } else {
+    cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                    CpuBackendContext::GetFromContext(context));
+  }
+}
+
+template <typename VALUE_TYPE>
+TfLiteStatus SetOutputFromRowSplitsT(TfLiteContext* context,
+                                     const TfLiteTensor& row_splits,
+                                     const TfLiteTensor& values_tensor,
+                                     const TfLiteTensor& default_value_tensor,
+                                     TfLiteTensor* output_tensor) {
+  switch (row_splits.type) {
+    case kTfLiteInt32:
+      CopyRows<VALUE_TYPE, int32_t>(context, row_splits, values_tensor,
+                                    default_value_tensor, output_tensor);
+      return kTfLiteOk;
+    case kTfLiteInt64:
+      CopyRows<VALUE_TYPE, int64_t>(context, row_splits, values_tensor,
+                                    default_value_tensor, output_tensor);
+      return kTfLiteOk;
+    default:
+      context->ReportError(context, "Unsupported row split type");
+      return kTfLiteError;
+  }
+}
+
+TfLiteStatus SetOutputFromRowSplits(TfLiteContext* context,
+                                    const TfLiteTensor& row_splits,
+                                    const TfLiteTensor& values_tensor,
+                                    const TfLiteTensor& default_value_tensor,
+                                    TfLiteTensor* output_tensor) {
+  switch (output_tensor->type) {
+    case kTfLiteInt32:
+      return SetOutputFromRowSplitsT<int32_t>(context, row_splits,
+                                              values_tensor,
+                                              default_value_tensor,
+                                              output_tensor);
+    case kTfLiteInt64:
+      return SetOutputFromRowSplitsT<int64_t>(context, row_splits,
+                                              values_tensor,
+                                              default_value_tensor,
+                                              output_tensor);
+    case kTfLiteFloat32:
+      return SetOutputFromRowSplitsT<float>(context, row_splits, values_tensor,
+                                            default_value_tensor,
+                                            output_tensor);
+    default:
+      context->ReportError(context, "Not supported values type");
+      return kTfLiteError;
+  }
+}
+
 }  // namespace
 
 void* Initialize(TfLiteContext* context, const char* buffer, size_t length) {
@@ -651,6 +809,13 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
   // Copy data.
   const int full_size = multiplier.front() * output_shape.Dims(0);
+  if (full_size > 0 && attributes->ragged_rank == 1 &&
+      attributes->GetRowPartitionTypeByDimension(0) ==
+          tensorflow::RowPartitionType::ROW_SPLITS) {
+    return SetOutputFromRowSplits(
+        context, *GetRowPartitionTensor(*attributes, context, node, 0),
+        input_values, default_value, &output_tensor);
+  }
   if (full_size > 0) {
     std::vector<int> output_index, new_output_index;
     int nvals = input_values.dims->data[0];
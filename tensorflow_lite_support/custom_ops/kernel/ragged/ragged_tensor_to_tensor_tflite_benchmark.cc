@@ -0,0 +1,144 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmark of the RaggedTensorToTensor op densifying a ragged batch of
+// rows, partitioned either by row splits (which has a dedicated row-copying
+// path) or by value row ids.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/custom_ops/kernel/ragged:ragged_tensor_to_tensor_tflite_benchmark
+//
+// Append `-- --benchmark_out=<file> --benchmark_out_format=json` to write the
+// results in a machine-readable form, e.g. to track regressions over time.
+
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/kernels/test_util.h"
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+
+namespace tflite {
+namespace ops {
+namespace custom {
+TfLiteRegistration* Register_RAGGED_TENSOR_TO_TENSOR();
+}  // namespace custom
+}  // namespace ops
+
+namespace {
+
+class RaggedTensorToTensorModel : public SingleOpModel {
+ public:
+  // Densifies `values`, partitioned by `row_splits` if `use_value_rowids` is
+  // false, or by the equivalent value row ids otherwise, into a
+  // [num_rows, width] tensor.
+  RaggedTensorToTensorModel(const std::vector<float>& values,
+                            const std::vector<int>& row_splits, int width,
+                            bool use_value_rowids, int num_threads) {
+    const int num_rows = row_splits.size() - 1;
+    std::vector<int> partition;
+    std::vector<std::string> partition_types;
+    if (use_value_rowids) {
+      partition_types = {"FIRST_DIM_SIZE", "VALUE_ROWIDS"};
+      for (int row = 0; row < num_rows; ++row) {
+        partition.insert(partition.end(), row_splits[row + 1] - row_splits[row],
+                         row);
+      }
+    } else {
+      partition_types = {"ROW_SPLITS"};
+      partition = row_splits;
+    }
+
+    const int shape = AddInput(TensorType_INT32);
+    const int input_values = AddInput(TensorType_FLOAT32);
+    const int default_value = AddInput(TensorType_FLOAT32);
+    int first_dim_size = -1;
+    if (use_value_rowids) first_dim_size = AddInput(TensorType_INT32);
+    const int partition_tensor = AddInput(TensorType_INT32);
+    AddOutput(TensorType_FLOAT32);
+
+    flexbuffers::Builder fbb;
+    size_t start = fbb.StartMap();
+    {
+      size_t start = fbb.StartVector("row_partition_types");
+      for (const auto& s : partition_types) {
+        fbb.String(s);
+      }
+      fbb.EndVector(start, /*typed=*/true, /*fixed=*/false);
+    }
+    fbb.Int("num_row_partition_tensors", partition_types.size());
+    fbb.EndMap(start);
+    fbb.Finish();
+    SetCustomOp("RaggedTensorToTensor", fbb.GetBuffer(),
+                ops::custom::Register_RAGGED_TENSOR_TO_TENSOR);
+
+    std::vector<std::vector<int>> shapes = {
+        {2}, {static_cast<int>(values.size())}, {1}};
+    if (use_value_rowids) shapes.push_back({1});
+    shapes.push_back({static_cast<int>(partition.size())});
+    BuildInterpreter(shapes);
+    interpreter_->SetNumThreads(num_threads);
+
+    PopulateTensor(shape, {num_rows, width});
+    PopulateTensor(input_values, values);
+    PopulateTensor(default_value, {0.f});
+    if (use_value_rowids) PopulateTensor(first_dim_size, {num_rows});
+    PopulateTensor(partition_tensor, partition);
+  }
+
+  void Run() { interpreter_->Invoke(); }
+};
+
+// Arguments are the number of rows, the width of the output, whether to
+// partition by value row ids (instead of row splits) and the number of
+// threads of the interpreter. Rows hold between 1/4 and 5/4 of the width.
+void BM_RaggedTensorToTensor(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  const int width = state.range(1);
+  std::vector<int> row_splits = {0};
+  for (int row = 0; row < num_rows; ++row) {
+    row_splits.push_back(row_splits.back() + width / 4 +
+                         (row * 37) % (width + 1));
+  }
+  const std::vector<float> values(row_splits.back(), 1.f);
+  RaggedTensorToTensorModel model(values, row_splits, width,
+                                  /*use_value_rowids=*/state.range(2),
+                                  /*num_threads=*/state.range(3));
+  for (auto _ : state) {
+    model.Run();
+  }
+  state.SetBytesProcessed(state.iterations() * num_rows * width *
+                          sizeof(float));
+}
+
+void BenchmarkArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int num_rows : {32, 1024}) {
+    for (int width : {16, 256}) {
+      for (int use_value_rowids : {0, 1}) {
+        for (int num_threads : {1, 4}) {
+          benchmark->Args({num_rows, width, use_value_rowids, num_threads});
+        }
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_RaggedTensorToTensor)->Apply(BenchmarkArgs);
+
+}  // namespace
+}  // namespace tflite
+
+BENCHMARK_MAIN();
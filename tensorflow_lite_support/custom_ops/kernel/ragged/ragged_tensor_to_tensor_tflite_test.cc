@@ -44,7 +44,8 @@ class RaggedTensorToTensorOpModel : public SingleOpModel {
                                   partition_tensors_shapes,
                               std::vector<std::string> partition_types,
                               TensorType value_type = TensorType_FLOAT32,
-                              TensorType index_type = TensorType_INT32) {
+                              TensorType index_type = TensorType_INT32,
+                              int num_threads = -1) {
     // A structure to collect shapes for the input.
     std::vector<std::vector<int>> shapes;
     input_shape_ = AddInput(index_type);
@@ -73,7 +74,8 @@ class RaggedTensorToTensorOpModel : public SingleOpModel {
     fbb.Finish();
     SetCustomOp("RaggedTensorToTensor", fbb.GetBuffer(),
                 ops::custom::Register_RAGGED_TENSOR_TO_TENSOR);
-    BuildInterpreter(shapes);
+    BuildInterpreter(shapes, num_threads, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/true);
   }
 
   std::vector<int> GetOutputShape() { return GetTensorShape(output_); }
@@ -151,6 +153,79 @@ TEST(RaggedTensorToTensorTest, RaggedTensorToTensorRowSplits) {
                                          .4, .5, .6, .7, .8, .9, 1.5, 1.5}));
 }
 
+TEST(RaggedTensorToTensorTest, RaggedTensorToTensorRowSplitsTruncated) {
+  // params = [[.1, .2, .3], [], [.4, .5, .6, .7], [.8, .9]]
+  // Rows are truncated to 2 values and a fifth row of defaults is added.
+  RaggedTensorToTensorOpModel model(2,      // output_shape_dims
+                                    {9},    // values_shape
+                                    {{5}},  // partition_tensors_shapes
+                                    std::vector<std::string>({"ROW_SPLITS"}));
+  model.InvokeFloat(
+      {5, 2},                                // shape
+      {.1, .2, .3, .4, .5, .6, .7, .8, .9},  // values
+      1.5,                                   // default_value
+      std::vector<std::vector<int>>({std::vector<int>({0, 3, 3, 7, 9})}));
+  EXPECT_THAT(model.GetOutputShape(), testing::ElementsAreArray({5, 2}));
+  EXPECT_THAT(model.GetOutputFloat(),
+              testing::ElementsAreArray(
+                  {.1, .2, 1.5, 1.5, .4, .5, .8, .9, 1.5, 1.5}));
+}
+
+TEST(RaggedTensorToTensorTest, RaggedTensorToTensorRowSplitsLarge) {
+  // Large enough for the rows to be split across several tasks.
+  constexpr int kNumRows = 2048;
+  constexpr int kWidth = 64;
+  std::vector<int> row_splits = {0};
+  std::vector<int> value_rowids;
+  std::vector<int32> values;
+  std::vector<int32> expected;
+  for (int i = 0; i < kNumRows; ++i) {
+    const int row_length = (i * 37) % (kWidth + 16);
+    for (int j = 0; j < row_length; ++j) {
+      values.push_back(i * 1000 + j);
+      value_rowids.push_back(i);
+    }
+    row_splits.push_back(values.size());
+    for (int j = 0; j < kWidth; ++j) {
+      expected.push_back(j < row_length ? i * 1000 + j : -1);
+    }
+  }
+  const int num_values = values.size();
+
+  // Row splits fast path, on one thread and split across several tasks.
+  for (int num_threads : {1, 4}) {
+    RaggedTensorToTensorOpModel model(
+        2,                                         // output_shape_dims
+        {num_values},                              // values_shape
+        {{static_cast<int>(row_splits.size())}},  // partition_tensors_shapes
+        std::vector<std::string>({"ROW_SPLITS"}), TensorType_INT32,
+        TensorType_INT32, num_threads);
+    model.InvokeInt({kNumRows, kWidth},  // shape
+                    values,              // values
+                    -1,                  // default_value
+                    std::vector<std::vector<int>>({row_splits}));
+    EXPECT_THAT(model.GetOutputShape(),
+                testing::ElementsAreArray({kNumRows, kWidth}));
+    EXPECT_THAT(model.GetOutputInt(), testing::ElementsAreArray(expected))
+        << "num_threads: " << num_threads;
+  }
+
+  // Generic path, with the same ragged tensor given as value row ids.
+  RaggedTensorToTensorOpModel generic_model(
+      2,                    // output_shape_dims
+      {num_values},         // values_shape
+      {{1}, {num_values}},  // partition_tensors_shapes
+      std::vector<std::string>({"FIRST_DIM_SIZE", "VALUE_ROWIDS"}),
+      TensorType_INT32);
+  generic_model.InvokeInt(
+      {kNumRows, kWidth},  // shape
+      values,              // values
+      -1,                  // default_value
+      std::vector<std::vector<int>>({{kNumRows}, value_rowids}));
+  EXPECT_THAT(generic_model.GetOutputInt(),
+              testing::ElementsAreArray(expected));
+}
+
 TEST(RaggedTensorToTensorTest, RaggedTensorToTensor_3DParams) {
   // params = [
   //           [[]],
@@ -17,7 +17,6 @@ limitations under the License.
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/str_replace.h"  // from @com_google_absl
-#include "src/sentencepiece_model.pb.h"  // from @com_google_sentencepiece
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/decoder_config_generated.h"
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/double_array_trie_builder.h"
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/encoder_config_generated.h"
@@ -55,6 +54,21 @@ tflite::support::StatusOr<std::string> ConvertSentencepieceModelToFlatBuffer(
         "Invalid configuration, can't parse SentencePiece model config " +
         model_config.InitializationErrorString());
   }
+  return ConvertSentencepieceModelToFlatBuffer(model_config, encoding_offset);
+}
+
+tflite::support::StatusOr<std::string> ConvertSentencepieceModelToFlatBuffer(
+    const ::sentencepiece::ModelProto& model_config, int encoding_offset) {
+  // The encoder implements the unigram segmentation only: BPE, word and char
+  // models would be silently encoded differently than by SentencePiece.
+  if (model_config.trainer_spec().model_type() !=
+      ::sentencepiece::TrainerSpec::UNIGRAM) {
+    return absl::InvalidArgumentError(
+        "Unsupported SentencePiece model type " +
+        ::sentencepiece::TrainerSpec::ModelType_Name(
+            model_config.trainer_spec().model_type()) +
+        ", only UNIGRAM models can be converted.");
+  }
   // Convert sentencepieces.
   std::vector<std::string> pieces;
   pieces.reserve(model_config.pieces_size());
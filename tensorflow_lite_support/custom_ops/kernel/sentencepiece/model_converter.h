@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_SUPPORT_CUSTOM_OPS_KERNEL_SENTENCEPIECE_MODEL_CONVERTER_H_
 #include <string>
 
+#include "src/sentencepiece_model.pb.h"  // from @com_google_sentencepiece
 #include "tensorflow_lite_support/cc/port/statusor.h"
 
 namespace tflite {
@@ -26,9 +27,14 @@ namespace sentencepiece {
 
 // Converts Sentencepiece configuration to flatbuffer format.
 // encoding_offset is used by some encoders that combine different encodings.
+// Only UNIGRAM models are supported, an error is returned for other types.
 tflite::support::StatusOr<std::string> ConvertSentencepieceModelToFlatBuffer(
     const std::string& model_config_str, int encoding_offset = 0);
 
+// Same as above, for an already parsed Sentencepiece configuration.
+tflite::support::StatusOr<std::string> ConvertSentencepieceModelToFlatBuffer(
+    const ::sentencepiece::ModelProto& model_config, int encoding_offset = 0);
+
 // Converts Sentencepiece configuration to flatbuffer format for encoder.
 // encoding_offset is used by some encoders that combine different encodings.
 tflite::support::StatusOr<std::string>
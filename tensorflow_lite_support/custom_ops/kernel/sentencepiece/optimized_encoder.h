@@ -18,11 +18,14 @@ limitations under the License.
 
 // Sentencepiece encoder optimized with memmapped model.
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/double_array_trie.h"
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/encoder_config_generated.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/utils.h"
 
 namespace tflite {
 namespace ops {
@@ -36,6 +39,49 @@ struct EncoderResult {
   std::vector<int> codes;
   std::vector<int> offsets;
 };
+
+// Encoder bound to one configuration, which must outlive it. The tries are
+// resolved once and the intermediate buffers are reused across calls, so that
+// encoding a batch of strings does not allocate once the buffers have grown.
+// Not thread-safe: use one encoder per thread.
+class Encoder {
+ public:
+  // The configuration version must be EncoderVersion_SENTENCE_PIECE.
+  explicit Encoder(const EncoderConfig& config);
+
+  // Normalizes `input` in a single pass applying the normalization rules,
+  // the removal of extra whitespaces and the escaping of whitespaces. Fills
+  // `normalized` and `offsets`, holding for each normalized byte the offset of
+  // the input byte it comes from.
+  void Normalize(utils::string_view input, std::string* normalized,
+                 std::vector<int>* offsets);
+
+  // Encodes one string into `result`, whose content is replaced.
+  void Encode(utils::string_view input, bool add_bos, bool add_eos,
+              bool reverse, EncoderResult* result);
+
+ private:
+  struct LatticeElement {
+    float score = 0;
+    int code = -1;
+    int prev_position = -1;
+    LatticeElement(float score_, int code_, int prev_position_)
+        : score(score_), code(code_), prev_position(prev_position_) {}
+    LatticeElement() {}
+  };
+
+  const EncoderConfig& config_;
+  const DoubleArrayTrie piece_matcher_;
+  // Null if the configuration has no normalization rules.
+  std::unique_ptr<DoubleArrayTrie> normalizer_;
+
+  // Buffers reused across calls.
+  std::string prefixed_input_;
+  std::string normalized_;
+  std::vector<int> offsets_;
+  std::vector<LatticeElement> lattice_;
+};
+
 std::tuple<std::string, std::vector<int>> NormalizeString(
     const std::string& in_string, const EncoderConfig& config);
 
@@ -170,6 +170,36 @@ TEST(OptimizedEncoder, ConfigConverter) {
   }
 }
 
+TEST(OptimizedEncoder, EncoderReusedAcrossStrings) {
+  std::string config;
+  auto status = internal::StdReadFileToString(
+      JoinPath("./" /*test src dir*/, kConfigFilePath), &config);
+  ASSERT_TRUE(status.ok());
+
+  ::sentencepiece::SentencePieceProcessor processor;
+  ASSERT_TRUE(processor.LoadFromSerializedProto(config).ok());
+  const auto converted_model = ConvertSentencepieceModel(config);
+  Encoder encoder(*GetEncoderConfig(converted_model.data()));
+  EncoderResult encoded;
+  // Longer strings first, so that the buffers of the encoder are reused for
+  // shorter ones.
+  for (const std::string test_string :
+       {"Hello world! This is a longer sentence.", "  Hello   world  ", "",
+        "Hello"}) {
+    encoder.Encode(utils::string_view(test_string), /*add_bos=*/false,
+                   /*add_eos=*/false, /*reverse=*/false, &encoded);
+    ASSERT_EQ(encoded.codes.size(), encoded.offsets.size());
+
+    ::sentencepiece::SentencePieceText reference_encoded;
+    ASSERT_TRUE(processor.Encode(test_string, &reference_encoded).ok());
+    EXPECT_EQ(encoded.codes.size(), reference_encoded.pieces_size());
+    for (int i = 0; i < encoded.codes.size(); ++i) {
+      EXPECT_EQ(encoded.codes[i], reference_encoded.pieces(i).id());
+      EXPECT_EQ(encoded.offsets[i], reference_encoded.pieces(i).begin());
+    }
+  }
+}
+
 }  // namespace
 }  // namespace sentencepiece
 }  // namespace custom
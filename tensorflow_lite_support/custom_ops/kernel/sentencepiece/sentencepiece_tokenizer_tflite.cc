@@ -16,11 +16,19 @@ limitations under the License.
 /**
  * Sentencepiece tflite tokenizer implementation.
  */
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/encoder_config_generated.h"
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/optimized_encoder.h"
 #include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/sentencepiece_tokenizer.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/utils.h"
 #include "flatbuffers/flexbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/context.h"
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/model.h"
@@ -44,6 +52,56 @@ TfLiteIntArray* CreateSizeArray(const std::initializer_list<int>& sizes) {
   }
   return array_size;
 }
+
+// Strings are not split across tasks below this many input bytes per task, as
+// the overhead of the thread pool would outweigh the gain.
+constexpr int kMinBytesPerTask = 4096;
+
+// Encodes a range of the input strings, keeping the codes of all of them in one
+// buffer to be copied into the output values.
+class EncodeTask : public cpu_backend_threadpool::Task {
+ public:
+  EncodeTask(const EncoderConfig& config, const TfLiteTensor& input_text,
+             int begin, int end, bool add_bos, bool add_eos, bool reverse)
+      : config_(config),
+        input_text_(input_text),
+        begin_(begin),
+        end_(end),
+        add_bos_(add_bos),
+        add_eos_(add_eos),
+        reverse_(reverse) {}
+
+  void Run() override {
+    Encoder encoder(config_);
+    EncoderResult result;
+    codes_.clear();
+    num_codes_.clear();
+    num_codes_.reserve(end_ - begin_);
+    for (int i = begin_; i < end_; ++i) {
+      const StringRef strref = GetString(&input_text_, i);
+      encoder.Encode(utils::string_view(strref.str, strref.len), add_bos_,
+                     add_eos_, reverse_, &result);
+      codes_.insert(codes_.end(), result.codes.begin(), result.codes.end());
+      num_codes_.push_back(result.codes.size());
+    }
+  }
+
+  int begin() const { return begin_; }
+  const std::vector<int>& codes() const { return codes_; }
+  // Number of codes of each string of the range.
+  const std::vector<int>& num_codes() const { return num_codes_; }
+
+ private:
+  const EncoderConfig& config_;
+  const TfLiteTensor& input_text_;
+  const int begin_;
+  const int end_;
+  const bool add_bos_;
+  const bool add_eos_;
+  const bool reverse_;
+  std::vector<int> codes_;
+  std::vector<int> num_codes_;
+};
 }  // namespace
 
 // Initializes text encoder object from serialized parameters.
@@ -82,36 +140,70 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       context->tensors[node->inputs->data[tensorflow::ops::kReverseInput]];
   const bool reverse = reverse_tensor.data.b[0];
 
-  std::vector<int32> encoded;
-  std::vector<int32> splits;
+  // The config is resolved once for the whole batch.
+  const EncoderConfig* config = GetEncoderConfig(model_buffer_data);
+  TF_LITE_ENSURE_MSG(
+      context,
+      config->version() == EncoderVersion::EncoderVersion_SENTENCE_PIECE,
+      "Sentencepiece conversion failed");
+
+  // Split the strings into contiguous ranges of about the same number of bytes,
+  // one per thread.
   const int num_strings = tflite::GetStringCount(&input_text);
+  int total_bytes = 0;
   for (int i = 0; i < num_strings; ++i) {
-    const auto strref = tflite::GetString(&input_text, i);
-    const auto res = EncodeString(std::string(strref.str, strref.len),
-                                  model_buffer_data, add_bos, add_eos, reverse);
-    TF_LITE_ENSURE_MSG(context, res.type == EncoderResultType::SUCCESS,
-                       "Sentencepiece conversion failed");
-    std::copy(res.codes.begin(), res.codes.end(), std::back_inserter(encoded));
-    splits.emplace_back(encoded.size());
+    total_bytes += tflite::GetString(&input_text, i).len;
+  }
+  CpuBackendContext* cpu_backend_context =
+      CpuBackendContext::GetFromContext(context);
+  const int num_tasks =
+      std::max(1, std::min({cpu_backend_context->max_num_threads(),
+                            num_strings, total_bytes / kMinBytesPerTask}));
+  std::vector<EncodeTask> tasks;
+  tasks.reserve(num_tasks);
+  for (int begin = 0, bytes = 0, i = 0; i < num_strings;) {
+    bytes += tflite::GetString(&input_text, i++).len;
+    const int num_ended_tasks = tasks.size() + 1;
+    if (i == num_strings ||
+        (num_ended_tasks < num_tasks &&
+         static_cast<int64_t>(bytes) * num_tasks >=
+             static_cast<int64_t>(total_bytes) * num_ended_tasks)) {
+      tasks.emplace_back(*config, input_text, begin, i, add_bos, add_eos,
+                         reverse);
+      begin = i;
+    }
+  }
+  if (!tasks.empty()) {
+    cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                    cpu_backend_context);
   }
 
+  int num_codes = 0;
+  for (const EncodeTask& task : tasks) {
+    num_codes += task.codes().size();
+  }
   TfLiteTensor& output_values =
       context->tensors[node->outputs->data[kOutputValuesInd]];
   TF_LITE_ENSURE_OK(context,
-                    context->ResizeTensor(
-                        context, &output_values,
-                        CreateSizeArray({static_cast<int>(encoded.size())})));
-  int32_t* output_values_flat = output_values.data.i32;
-  std::copy(encoded.begin(), encoded.end(), output_values_flat);
+                    context->ResizeTensor(context, &output_values,
+                                          CreateSizeArray({num_codes})));
   TfLiteTensor& output_splits =
       context->tensors[node->outputs->data[kOutputSplitsInd]];
-  TF_LITE_ENSURE_OK(
-      context, context->ResizeTensor(
-                   context, &output_splits,
-                   CreateSizeArray({static_cast<int>(splits.size() + 1)})));
+  TF_LITE_ENSURE_OK(context,
+                    context->ResizeTensor(context, &output_splits,
+                                          CreateSizeArray({num_strings + 1})));
+  int32_t* output_values_flat = output_values.data.i32;
   int32_t* output_splits_flat = output_splits.data.i32;
-  *output_splits_flat = 0;
-  std::copy(splits.begin(), splits.end(), output_splits_flat + 1);
+  output_splits_flat[0] = 0;
+  for (const EncodeTask& task : tasks) {
+    output_values_flat = std::copy(task.codes().begin(), task.codes().end(),
+                                   output_values_flat);
+    for (int i = 0; i < task.num_codes().size(); ++i) {
+      const int index = task.begin() + i;
+      output_splits_flat[index + 1] =
+          output_splits_flat[index] + task.num_codes()[i];
+    }
+  }
   return kTfLiteOk;
 }
 }  // namespace tokenizer
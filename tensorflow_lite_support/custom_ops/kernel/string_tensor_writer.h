@@ -0,0 +1,123 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CUSTOM_OPS_KERNEL_STRING_TENSOR_WRITER_H_
+#define TENSORFLOW_LITE_SUPPORT_CUSTOM_OPS_KERNEL_STRING_TENSOR_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "tensorflow/lite/context.h"
+
+namespace tflite {
+namespace ops {
+namespace custom {
+
+// Writes strings into a string tensor whose buffer has already been sized for
+// `num_strings` strings and their payloads (see ResizeStringTensor()). The
+// layout is the one produced by DynamicBuffer: the number of strings, followed
+// by the `num_strings + 1` offsets of the strings, followed by the payloads,
+// all offsets being relative to the beginning of the buffer.
+//
+// This lets kernels which can compute the size of their outputs up front write
+// them without any intermediate copy.
+class StringTensorWriter {
+ public:
+  // Creates a writer for all the strings of `tensor`, which must all be added
+  // before calling Finish().
+  StringTensorWriter(TfLiteTensor* tensor, int num_strings)
+      : StringTensorWriter(tensor, num_strings, /*index=*/0,
+                           /*payload_offset=*/0) {
+    reinterpret_cast<int32_t*>(buffer_)[0] = num_strings;
+  }
+
+  // Creates a writer for the strings of `tensor` starting at the `index`-th
+  // one, whose payload starts `payload_offset` bytes after the beginning of the
+  // payloads. Writers covering disjoint ranges of strings can be used
+  // concurrently; the header is written once with WriteHeader().
+  StringTensorWriter(TfLiteTensor* tensor, int num_strings, int index,
+                     size_t payload_offset)
+      : buffer_(tensor->data.raw),
+        offsets_(reinterpret_cast<int32_t*>(tensor->data.raw) + 1),
+        num_strings_(num_strings),
+        index_(index),
+        offset_(HeaderSize(num_strings) + payload_offset) {}
+
+  static size_t HeaderSize(int num_strings) {
+    return (num_strings + 2) * sizeof(int32_t);
+  }
+
+  // Writes the number of strings and the end offset of the last one, for
+  // tensors written by writers covering ranges of strings.
+  static void WriteHeader(TfLiteTensor* tensor, int num_strings,
+                          size_t payload_size) {
+    int32_t* header = reinterpret_cast<int32_t*>(tensor->data.raw);
+    header[0] = num_strings;
+    header[num_strings + 1] = HeaderSize(num_strings) + payload_size;
+  }
+
+  void AddString(const char* str, int length) {
+    StartString();
+    Append(str, length);
+  }
+
+  // Starts a new string, whose content is then added with Append().
+  void StartString() { offsets_[index_++] = offset_; }
+
+  // Appends `length` bytes to the current string.
+  void Append(const char* str, int length) {
+    if (length > 0) {
+      memcpy(buffer_ + offset_, str, length);
+      offset_ += length;
+    }
+  }
+
+  // Writes the end offset of the last string. Must be called once all
+  // `num_strings` strings have been added.
+  void Finish() { offsets_[num_strings_] = offset_; }
+
+ private:
+  char* buffer_;
+  int32_t* offsets_;
+  int num_strings_;
+  int index_;
+  int32_t offset_;
+};
+
+// Resizes `tensor` to `new_shape` (taking ownership of it) unless it is null,
+// and allocates its buffer for `num_strings` strings totalling `payload_size`
+// bytes.
+inline TfLiteStatus ResizeStringTensor(TfLiteContext* context,
+                                       TfLiteTensor* tensor,
+                                       TfLiteIntArray* new_shape,
+                                       int num_strings, size_t payload_size) {
+  const size_t total_size =
+      StringTensorWriter::HeaderSize(num_strings) + payload_size;
+  TF_LITE_ENSURE(context, total_size <= static_cast<size_t>(
+                                            std::numeric_limits<int32_t>::max()));
+  if (new_shape != nullptr) {
+    TF_LITE_ENSURE_STATUS(context->ResizeTensor(context, tensor, new_shape));
+  }
+  TfLiteTensorRealloc(total_size, tensor);
+  return kTfLiteOk;
+}
+
+}  // namespace custom
+}  // namespace ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CUSTOM_OPS_KERNEL_STRING_TENSOR_WRITER_H_
@@ -16,12 +16,13 @@ limitations under the License.
 #include "tensorflow_lite_support/custom_ops/kernel/whitespace_tokenizer.h"
 
 #include <algorithm>
-#include <utility>
-#include <vector>
+#include <cstdint>
+#include <cstring>
 
 #include "tensorflow/lite/context.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/string_util.h"
+#include "tensorflow_lite_support/custom_ops/kernel/string_tensor_writer.h"
 #include "libutf/utf.h"
 
 constexpr int kInput = 0;
@@ -43,6 +44,11 @@ namespace whitespace_tokenizer {
 // * A string tensor (the innermost values of the ragged tensor)
 // * N int64 tensors (the row_splits of the ragged tensor, where N is the
 //   rank of the input tensor)
+//
+// The input is tokenized twice without any intermediate storage: a first pass
+// counts the tokens and their total size, which gives the exact size of the
+// outputs, and a second pass writes the string tensor header and payloads
+// directly into the output buffer.
 
 inline bool OutputIsPaddedTensor(TfLiteNode* node) {
   return NumOutputs(node) == 1;
@@ -57,20 +63,76 @@ inline int charntorune(Rune* r, const char* s, int n) {
   return bytes_read;
 }
 
-std::vector<std::pair<const char*, int>> Tokenize(StringRef str) {
-  const char* p = str.str;
-  int n = str.len;
+// Whitespace lookup table for ASCII characters, built from isspacerune() so
+// that the ASCII fast path and the rune decoding path always agree.
+struct AsciiWhitespaceTable {
+  AsciiWhitespaceTable() {
+    for (int c = 0; c < 128; ++c) {
+      is_space[c] = isspacerune(c);
+    }
+  }
+  bool is_space[128];
+};
+
+inline const AsciiWhitespaceTable& GetAsciiWhitespaceTable() {
+  static const AsciiWhitespaceTable* table = new AsciiWhitespaceTable();
+  return *table;
+}
 
-  std::vector<std::pair<const char*, int>> tokens;
+// Skips 8 bytes at a time as long as they are all printable ASCII characters
+// other than space, i.e. in [0x21, 0x7F], none of which is whitespace. A word
+// is in that range iff no byte has its high bit set, and subtracting 0x21 from
+// each byte does not borrow (the first byte below 0x21 would wrap around and
+// set its high bit). Returns a pointer to the first byte of the first word
+// that can't be skipped.
+inline const char* SkipAsciiNonSpaceWords(const char* p, const char* end) {
+  constexpr uint64_t kOnes = 0x0101010101010101ULL;
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  while (end - p >= 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if (((word - 0x21 * kOnes) | word) & kHighBits) break;
+    p += 8;
+  }
+  return p;
+}
+
+// Calls `token_callback(const char* token, int length)` on each whitespace
+// separated token of `str`. ASCII bytes are classified with a lookup table,
+// and runs of non-whitespace ASCII bytes inside tokens are skipped one word at
+// a time: runes are only decoded for non-ASCII bytes. As in TF.Text,
+// tokenization stops at the first invalid UTF-8 sequence.
+template <typename TokenCallback>
+inline void ForEachToken(StringRef str, TokenCallback&& token_callback) {
+  const AsciiWhitespaceTable& ascii_table = GetAsciiWhitespaceTable();
+  const char* p = str.str;
+  const char* const end = str.str + str.len;
   const char* start = nullptr;
-  while (n > 0) {
+  while (p < end) {
+    const unsigned char byte = static_cast<unsigned char>(*p);
+    if (byte < 0x80) {
+      if (ascii_table.is_space[byte]) {
+        if (start != nullptr) {
+          token_callback(start, static_cast<int>(p - start));
+          start = nullptr;
+        }
+        ++p;
+      } else {
+        if (start == nullptr) {
+          start = p;
+        }
+        p = SkipAsciiNonSpaceWords(p + 1, end);
+      }
+      continue;
+    }
+
     Rune r;
-    int c = charntorune(&r, p, n);
+    int c = charntorune(&r, p, static_cast<int>(end - p));
     if (r == Runeerror) break;
 
     if (isspacerune(r)) {
       if (start != nullptr) {
-        tokens.push_back({start, p - start});
+        token_callback(start, static_cast<int>(p - start));
       }
       start = nullptr;
     } else {
@@ -78,74 +140,94 @@ std::vector<std::pair<const char*, int>> Tokenize(StringRef str) {
         start = p;
       }
     }
-
     p += c;
-    n -= c;
   }
   if (start != nullptr) {
-    tokens.push_back({start, p - start});
+    token_callback(start, static_cast<int>(p - start));
   }
-
-  return tokens;
 }
 
-TfLiteStatus WritePaddedOutput(
-    const std::vector<std::vector<std::pair<const char*, int>>>& list_of_tokens,
-    const TfLiteTensor* input, TfLiteTensor* output_values) {
+TfLiteStatus WritePaddedOutput(TfLiteContext* context,
+                               const TfLiteTensor* input, int input_size,
+                               TfLiteTensor* output_values) {
+  // First pass: find the largest number of tokens and the total payload size.
+  int max_tokens = 0;
+  size_t payload_size = 0;
+  for (int i = 0; i < input_size; ++i) {
+    int num_tokens = 0;
+    ForEachToken(GetString(input, i), [&](const char*, int length) {
+      ++num_tokens;
+      payload_size += length;
+    });
+    max_tokens = std::max(max_tokens, num_tokens);
+  }
+
   TfLiteIntArray* output_shape = TfLiteIntArrayCreate(NumDimensions(input) + 1);
   for (int i = 0; i < NumDimensions(input); ++i) {
     output_shape->data[i] = SizeOfDimension(input, i);
   }
-
-  size_t max_tokens = 0;
-  for (const auto& tokens : list_of_tokens) {
-    max_tokens = std::max(max_tokens, tokens.size());
-  }
-
   output_shape->data[NumDimensions(input)] = max_tokens;
-  DynamicBuffer buffer;
-  for (const auto& tokens : list_of_tokens) {
-    for (const auto& token : tokens) {
-      buffer.AddString(token.first, token.second);
-    }
-    for (int i = tokens.size(); i < max_tokens; ++i) {
-      buffer.AddString(nullptr, 0);
+  const int num_strings = input_size * max_tokens;
+  TF_LITE_ENSURE_STATUS(ResizeStringTensor(context, output_values, output_shape,
+                                           num_strings, payload_size));
+
+  // Second pass: write the tokens, padding each row with empty strings.
+  StringTensorWriter writer(output_values, num_strings);
+  for (int i = 0; i < input_size; ++i) {
+    int num_tokens = 0;
+    ForEachToken(GetString(input, i), [&](const char* token, int length) {
+      writer.AddString(token, length);
+      ++num_tokens;
+    });
+    for (; num_tokens < max_tokens; ++num_tokens) {
+      writer.AddString(nullptr, 0);
     }
   }
-  buffer.WriteToTensor(output_values, output_shape);
+  writer.Finish();
   return kTfLiteOk;
 }
 
-TfLiteStatus WriteRaggedOutput(
-    const std::vector<std::vector<std::pair<const char*, int>>>& list_of_tokens,
-    const TfLiteTensor* input, TfLiteTensor* output_values,
-    std::vector<TfLiteTensor*> nested_row_splits) {
+TfLiteStatus WriteRaggedOutput(TfLiteContext* context, TfLiteNode* node,
+                               const TfLiteTensor* input, int input_size,
+                               TfLiteTensor* output_values) {
   // The outer dimensions of the ragged tensor are all non-ragged.
-  for (int i = 0; i < nested_row_splits.size() - 1; ++i) {
+  for (int i = 0; i < NumDimensions(input) - 1; ++i) {
     int row_splits_step = SizeOfDimension(input, i + 1);
-    TfLiteTensor* row_splits = nested_row_splits[i];
+    TfLiteTensor* row_splits =
+        GetOutput(context, node, kOutputRowSplitsStart + i);
     for (int j = 0; j < SizeOfDimension(row_splits, 0); ++j) {
       row_splits->data.i64[j] = j * row_splits_step;
     }
   }
 
-  // Generate the innermost row_splits and values tensors.
-  TfLiteTensor* row_splits = nested_row_splits.back();
+  // First pass: generate the innermost row_splits, and compute the total
+  // payload size.
+  TfLiteTensor* row_splits = GetOutput(
+      context, node, kOutputRowSplitsStart + NumDimensions(input) - 1);
+  int num_tokens = 0;
+  size_t payload_size = 0;
+  for (int i = 0; i < input_size; ++i) {
+    row_splits->data.i64[i] = num_tokens;
+    ForEachToken(GetString(input, i), [&](const char*, int length) {
+      ++num_tokens;
+      payload_size += length;
+    });
+  }
+  row_splits->data.i64[input_size] = num_tokens;
+
   TfLiteIntArray* output_shape = TfLiteIntArrayCreate(1);
-  DynamicBuffer buffer;
-  int token_index = 0;
-  int row_splits_index = 0;
-  for (const auto& tokens : list_of_tokens) {
-    row_splits->data.i64[row_splits_index] = token_index;
-    for (const auto& token : tokens) {
-      buffer.AddString(token.first, token.second);
-      ++token_index;
-    }
-    ++row_splits_index;
+  output_shape->data[0] = num_tokens;
+  TF_LITE_ENSURE_STATUS(ResizeStringTensor(context, output_values, output_shape,
+                                           num_tokens, payload_size));
+
+  // Second pass: write the values.
+  StringTensorWriter writer(output_values, num_tokens);
+  for (int i = 0; i < input_size; ++i) {
+    ForEachToken(GetString(input, i), [&](const char* token, int length) {
+      writer.AddString(token, length);
+    });
   }
-  row_splits->data.i64[row_splits_index] = token_index;
-  output_shape->data[0] = token_index;
-  buffer.WriteToTensor(output_values, output_shape);
+  writer.Finish();
   return kTfLiteOk;
 }
 
@@ -186,28 +268,13 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     input_size *= SizeOfDimension(input, i);
   }
 
-  std::vector<std::vector<std::pair<const char*, int>>> list_of_tokens;
-  list_of_tokens.reserve(input_size);
-  for (int i = 0; i < input_size; ++i) {
-    list_of_tokens.emplace_back(Tokenize(GetString(input, i)));
-  }
-
   TfLiteTensor* output_values = GetOutput(context, node, kOutputValues);
   TF_LITE_ENSURE(context, IsDynamicTensor(output_values));
 
   if (OutputIsPaddedTensor(node)) {
-    return WritePaddedOutput(list_of_tokens, input, output_values);
-  }
-
-  std::vector<TfLiteTensor*> nested_row_splits;
-  nested_row_splits.reserve(NumDimensions(input));
-  for (int i = 0; i < NumDimensions(input); ++i) {
-    TfLiteTensor* output_row_splits =
-        GetOutput(context, node, kOutputRowSplitsStart + i);
-    nested_row_splits.push_back(output_row_splits);
+    return WritePaddedOutput(context, input, input_size, output_values);
   }
-  return WriteRaggedOutput(list_of_tokens, input, output_values,
-                           nested_row_splits);
+  return WriteRaggedOutput(context, node, input, input_size, output_values);
 }
 
 }  // namespace whitespace_tokenizer
@@ -0,0 +1,217 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmark comparing the WhitespaceTokenizer op with a reference
+// implementation that buffers all the tokens in nested vectors, decodes every
+// byte as a rune and copies the tokens through a DynamicBuffer.
+//
+// Usage:
+//   bazel run -c opt \
+//     tensorflow_lite_support/custom_ops/kernel:whitespace_tokenizer_benchmark
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/test_util.h"
+#include "tensorflow/lite/string_util.h"
+#include "tensorflow_lite_support/custom_ops/kernel/whitespace_tokenizer.h"
+#include "libutf/utf.h"
+
+namespace tflite {
+namespace ops {
+namespace custom {
+namespace whitespace_tokenizer {
+namespace {
+
+// Reference implementation, supporting ragged outputs only.
+namespace reference {
+
+int charntorune(Rune* r, const char* s, int n) {
+  const int bytes_read = chartorune(r, const_cast<char*>(s));
+  if (bytes_read > n) {
+    *r = Runeerror;
+    return 0;
+  }
+  return bytes_read;
+}
+
+std::vector<std::pair<const char*, int>> Tokenize(StringRef str) {
+  const char* p = str.str;
+  int n = str.len;
+
+  std::vector<std::pair<const char*, int>> tokens;
+  const char* start = nullptr;
+  while (n > 0) {
+    Rune r;
+    int c = charntorune(&r, p, n);
+    if (r == Runeerror) break;
+
+    if (isspacerune(r)) {
+      if (start != nullptr) {
+        tokens.push_back({start, p - start});
+      }
+      start = nullptr;
+    } else {
+      if (start == nullptr) {
+        start = p;
+      }
+    }
+
+    p += c;
+    n -= c;
+  }
+  if (start != nullptr) {
+    tokens.push_back({start, p - start});
+  }
+
+  return tokens;
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  SetTensorToDynamic(GetOutput(context, node, 0));
+  const TfLiteTensor* input = GetInput(context, node, 0);
+  TfLiteIntArray* row_splits_shape = TfLiteIntArrayCreate(1);
+  row_splits_shape->data[0] = NumElements(input) + 1;
+  return context->ResizeTensor(context, GetOutput(context, node, 1),
+                               row_splits_shape);
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteTensor* input = GetInput(context, node, 0);
+  const int input_size = NumElements(input);
+  std::vector<std::vector<std::pair<const char*, int>>> list_of_tokens;
+  list_of_tokens.reserve(input_size);
+  for (int i = 0; i < input_size; ++i) {
+    list_of_tokens.emplace_back(Tokenize(GetString(input, i)));
+  }
+
+  TfLiteTensor* row_splits = GetOutput(context, node, 1);
+  DynamicBuffer buffer;
+  int token_index = 0;
+  int row_splits_index = 0;
+  for (const auto& tokens : list_of_tokens) {
+    row_splits->data.i64[row_splits_index++] = token_index;
+    for (const auto& token : tokens) {
+      buffer.AddString(token.first, token.second);
+      ++token_index;
+    }
+  }
+  row_splits->data.i64[row_splits_index] = token_index;
+  TfLiteIntArray* output_shape = TfLiteIntArrayCreate(1);
+  output_shape->data[0] = token_index;
+  buffer.WriteToTensor(GetOutput(context, node, 0), output_shape);
+  return kTfLiteOk;
+}
+
+TfLiteRegistration* Register() {
+  static TfLiteRegistration r = {nullptr, nullptr, Prepare, Eval};
+  return &r;
+}
+
+}  // namespace reference
+
+class TokenizerModel : public SingleOpModel {
+ public:
+  TokenizerModel(const std::function<TfLiteRegistration*()>& registration,
+                 const std::vector<std::string>& input_values) {
+    input_ = AddInput(TensorType_STRING);
+    AddOutput(TensorType_STRING);
+    AddOutput(TensorType_INT64);
+    SetCustomOp("WhitespaceTokenizer", {}, registration);
+    BuildInterpreter({{static_cast<int>(input_values.size())}});
+    PopulateStringTensor(input_, input_values);
+  }
+
+  void Run() { interpreter_->Invoke(); }
+
+ private:
+  int input_;
+};
+
+// Builds a batch of `batch_size` sentences of about 30 words each. If
+// `non_ascii` is true, one word in four contains accented characters and
+// words are sometimes separated by non-breaking spaces.
+std::vector<std::string> BuildInput(int batch_size, bool non_ascii) {
+  const std::vector<std::string> ascii_words = {
+      "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog,",
+      "tokenization", "is", "a", "surprisingly", "expensive", "step."};
+  const std::vector<std::string> non_ascii_words = {
+      "café", "naïve", "über", "señor", "中文"};
+  std::vector<std::string> input;
+  input.reserve(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    std::string sentence;
+    for (int j = 0; j < 30; ++j) {
+      if (j > 0) {
+        sentence += (non_ascii && (i + j) % 7 == 0) ? "\xc2\xa0" : " ";
+      }
+      if (non_ascii && (i + j) % 4 == 0) {
+        sentence += non_ascii_words[(i + j) % non_ascii_words.size()];
+      } else {
+        sentence += ascii_words[(i * 31 + j) % ascii_words.size()];
+      }
+    }
+    input.push_back(std::move(sentence));
+  }
+  return input;
+}
+
+void RunBenchmark(benchmark::State& state,
+                  const std::function<TfLiteRegistration*()>& registration) {
+  const std::vector<std::string> input =
+      BuildInput(state.range(0), /*non_ascii=*/state.range(1));
+  int64_t input_bytes = 0;
+  for (const auto& sentence : input) {
+    input_bytes += sentence.size();
+  }
+  TokenizerModel model(registration, input);
+  for (auto _ : state) {
+    model.Run();
+  }
+  state.SetBytesProcessed(state.iterations() * input_bytes);
+}
+
+void BM_WhitespaceTokenizer(benchmark::State& state) {
+  RunBenchmark(state, Register_tftext_WhitespaceTokenizer);
+}
+
+void BM_ReferenceWhitespaceTokenizer(benchmark::State& state) {
+  RunBenchmark(state, reference::Register);
+}
+
+// Arguments are the batch size, and whether the input contains non-ASCII
+// characters.
+void BenchmarkArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int batch_size : {1, 32, 512}) {
+    for (int non_ascii : {0, 1}) {
+      benchmark->Args({batch_size, non_ascii});
+    }
+  }
+}
+
+BENCHMARK(BM_WhitespaceTokenizer)->Apply(BenchmarkArgs);
+BENCHMARK(BM_ReferenceWhitespaceTokenizer)->Apply(BenchmarkArgs);
+
+}  // namespace
+}  // namespace whitespace_tokenizer
+}  // namespace custom
+}  // namespace ops
+}  // namespace tflite
+
+BENCHMARK_MAIN();
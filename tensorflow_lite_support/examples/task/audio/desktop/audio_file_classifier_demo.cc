@@ -0,0 +1,114 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Example usage:
+// bazel run -c opt \
+//  tensorflow_lite_support/examples/task/audio/desktop:audio_file_classifier_demo \
+//  -- \
+//  --model_path=/path/to/model.tflite \
+//  --audio_wav_paths=/path/to/audio1.wav,/path/to/audio2.wav \
+//  --num_workers=4
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/flags/parse.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/audio/audio_file_classifier.h"
+
+ABSL_FLAG(std::string, model_path, "",
+          "Absolute path to the '.tflite' audio classification model.");
+ABSL_FLAG(std::vector<std::string>, audio_wav_paths, {},
+          "Comma-separated list of absolute paths to the 16-bit PCM WAV files "
+          "to classify. The WAV files must match the number of channels and "
+          "the sampling rate expected by the model (as in the Metadata), and "
+          "can be of any duration.");
+ABSL_FLAG(float, window_hop_seconds, 0.f,
+          "Hop between two consecutive windows, in seconds. Defaults to half "
+          "the model input duration.");
+ABSL_FLAG(int, num_workers, 1,
+          "Number of interpreters classifying windows in parallel. If <= 0, "
+          "one per hardware thread is used.");
+ABSL_FLAG(int, max_results, 5,
+          "Maximum number of classes kept for each window.");
+ABSL_FLAG(float, segment_score_threshold, 0.5f,
+          "Minimum score for a class to be part of a segment.");
+
+int main(int argc, char** argv) {
+  // Parse command line arguments and perform sanity checks.
+  absl::ParseCommandLine(argc, argv);
+  if (absl::GetFlag(FLAGS_model_path).empty()) {
+    std::cerr << "Missing mandatory 'model_path' argument.\n";
+    return 1;
+  }
+  if (absl::GetFlag(FLAGS_audio_wav_paths).empty()) {
+    std::cerr << "Missing mandatory 'audio_wav_paths' argument.\n";
+    return 1;
+  }
+
+  // Build the AudioFileClassifier.
+  tflite::task::audio::AudioFileClassifierOptions options;
+  auto* classifier_options = options.mutable_classifier_options();
+  classifier_options->mutable_base_options()
+      ->mutable_model_file()
+      ->set_file_name(absl::GetFlag(FLAGS_model_path));
+  classifier_options->set_max_results(absl::GetFlag(FLAGS_max_results));
+  options.set_window_hop_seconds(absl::GetFlag(FLAGS_window_hop_seconds));
+  options.set_num_workers(absl::GetFlag(FLAGS_num_workers));
+  options.set_segment_score_threshold(
+      absl::GetFlag(FLAGS_segment_score_threshold));
+  auto classifier =
+      tflite::task::audio::AudioFileClassifier::CreateFromOptions(options);
+  if (!classifier.ok()) {
+    std::cerr << "Initialization failed: " << classifier.status().message()
+              << "\n";
+    return 1;
+  }
+
+  // Run classification and display the per-file timelines.
+  double total_audio_seconds = 0;
+  double total_wall_seconds = 0;
+  for (const auto& wav_path : absl::GetFlag(FLAGS_audio_wav_paths)) {
+    auto result = (*classifier)->ClassifyFile(wav_path);
+    if (!result.ok()) {
+      std::cerr << "Classification of " << wav_path
+                << " failed: " << result.status().message() << "\n";
+      return 1;
+    }
+    std::cout << absl::StrFormat(
+        "\n%s: %.1f s of audio, %d windows, %.1f audio-s/s on %d workers\n",
+        wav_path, result->audio_duration_seconds(), result->windows_size(),
+        result->throughput(), (*classifier)->GetNumWorkers());
+    for (const auto& segment : result->segments()) {
+      std::cout << absl::StrFormat(
+          "\t[%8.2f s - %8.2f s] head %d, %s (max %.3f, mean %.3f)\n",
+          segment.start_seconds(), segment.end_seconds(), segment.head_index(),
+          segment.display_name().empty() ? segment.class_name()
+                                         : segment.display_name(),
+          segment.max_score(), segment.mean_score());
+    }
+    total_audio_seconds += result->audio_duration_seconds();
+    total_wall_seconds += result->wall_time_seconds();
+  }
+  if (total_wall_seconds > 0) {
+    std::cout << absl::StrFormat(
+        "\nTotal: %.1f s of audio in %.1f s (%.1f audio-s/s)\n",
+        total_audio_seconds, total_wall_seconds,
+        total_audio_seconds / total_wall_seconds);
+  }
+  return 0;
+}
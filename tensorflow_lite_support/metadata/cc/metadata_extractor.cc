@@ -20,11 +20,13 @@ limitations under the License.
 #include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "lib/zip.h"  // from @org_libzip
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/metadata/cc/utils/zip_stored_files.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
 namespace tflite {
@@ -69,8 +71,15 @@ const T* GetItemFromVector(
   }
   return src_vector->Get(index);
 }
+
 }  // namespace
 
+ModelMetadataExtractor::~ModelMetadataExtractor() {
+  if (zip_archive_ != nullptr) {
+    zip_close(zip_archive_);
+  }
+}
+
 /* static */
 tflite::support::StatusOr<std::unique_ptr<ModelMetadataExtractor>>
 ModelMetadataExtractor::CreateFromModelBuffer(const char* buffer_data,
@@ -220,39 +229,35 @@ absl::Status ModelMetadataExtractor::ExtractAssociatedFiles(
   // [1]: https://libzip.org/documentation/zip_source_free.html
   std::move(zip_source_cleanup).Cancel();
 
+  // Index the associated files without reading them. Files stored uncompressed
+  // are resolved to their location in the model buffer, the others are
+  // inflated on first access.
+  const absl::flat_hash_map<std::string, absl::string_view> stored_files =
+      FindStoredZipFiles(buffer_data, buffer_size);
+  bool needs_zip_archive = false;
   const int num_files = zip_get_num_entries(zip_archive, /*flags=*/0);
   for (int index = 0; index < num_files; ++index) {
     // Get file stats.
     struct zip_stat zip_file_stat;
     zip_stat_init(&zip_file_stat);
     zip_stat_index(zip_archive, index, /*flags=*/0, &zip_file_stat);
-    absl::string_view filename = zip_file_stat.name;
-    const auto unzip_filesize = zip_file_stat.size;
-
-    // Open file.
-    zip_file* zip_file = zip_fopen_index(zip_archive, index, /*flags=*/0);
-    if (zip_file == nullptr) {
-      return CreateStatusWithPayload(
-          StatusCode::kUnknown,
-          absl::StrFormat("Unable to open associated file with name: %s",
-                          zip_file_stat.name),
-          TfLiteSupportStatus::kMetadataAssociatedFileZipError);
+    const std::string filename = zip_file_stat.name;
+
+    AssociatedFile& associated_file = associated_files_[filename];
+    associated_file.index = index;
+    associated_file.size = zip_file_stat.size;
+    associated_file.stored_data = nullptr;
+    auto it = stored_files.find(filename);
+    if (it != stored_files.end() && it->second.size() == zip_file_stat.size) {
+      associated_file.stored_data = it->second.data();
+    } else {
+      needs_zip_archive = true;
     }
-    auto zip_file_cleanup = SimpleCleanUp([zip_file] { zip_fclose(zip_file); });
-
-    // Unzip file.
-    char* unzip_buffer = new char[unzip_filesize];
-    auto unzip_buffer_cleanup =
-        SimpleCleanUp([unzip_buffer] { delete[] unzip_buffer; });
-    if (zip_fread(zip_file, unzip_buffer, unzip_filesize) != unzip_filesize) {
-      return CreateStatusWithPayload(
-          StatusCode::kUnknown,
-          absl::StrFormat("Unzipping failed for file: %s.", filename),
-          TfLiteSupportStatus::kMetadataAssociatedFileZipError);
-    }
-
-    // Copy file contents in map.
-    associated_files_[filename] = std::string(unzip_buffer, unzip_filesize);
+  }
+  if (needs_zip_archive) {
+    // Keep the archive open for lazy extraction.
+    std::move(zip_archive_cleanup).Cancel();
+    zip_archive_ = zip_archive;
   }
   return absl::OkStatus();
 }
@@ -266,7 +271,39 @@ ModelMetadataExtractor::GetAssociatedFile(const std::string& filename) const {
         absl::StrFormat("No associated file with name: %s", filename),
         TfLiteSupportStatus::kMetadataAssociatedFileNotFoundError);
   }
-  return it->second;
+  const AssociatedFile& associated_file = it->second;
+  if (associated_file.stored_data != nullptr) {
+    return absl::string_view(associated_file.stored_data,
+                             associated_file.size);
+  }
+
+  absl::MutexLock lock(&zip_mutex_);
+  if (associated_file.inflated_data != nullptr) {
+    return absl::string_view(*associated_file.inflated_data);
+  }
+  // Open file.
+  zip_file* zip_file =
+      zip_fopen_index(zip_archive_, associated_file.index, /*flags=*/0);
+  if (zip_file == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Unable to open associated file with name: %s",
+                        filename),
+        TfLiteSupportStatus::kMetadataAssociatedFileZipError);
+  }
+  auto zip_file_cleanup = SimpleCleanUp([zip_file] { zip_fclose(zip_file); });
+
+  // Unzip file.
+  auto inflated_data = absl::make_unique<std::string>(associated_file.size, 0);
+  if (zip_fread(zip_file, &(*inflated_data)[0], associated_file.size) !=
+      static_cast<zip_int64_t>(associated_file.size)) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Unzipping failed for file: %s.", filename),
+        TfLiteSupportStatus::kMetadataAssociatedFileZipError);
+  }
+  associated_file.inflated_data = std::move(inflated_data);
+  return absl::string_view(*associated_file.inflated_data);
 }
 
 const flatbuffers::Vector<flatbuffers::Offset<tflite::TensorMetadata>>*
@@ -15,13 +15,21 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_METADATA_CC_METADATA_EXTRACTOR_H_
 #define TENSORFLOW_LITE_SUPPORT_METADATA_CC_METADATA_EXTRACTOR_H_
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "absl/container/flat_hash_map.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
+// Forward declaration of the libzip archive type, see lib/zip.h.
+struct zip;
+
 namespace tflite {
 namespace metadata {
 
@@ -72,9 +80,21 @@ class ModelMetadataExtractor {
     return model_metadata_;
   }
 
+  ~ModelMetadataExtractor();
+
   // Gets the contents of the associated file with the provided name packed into
   // the model metadata. An error is returned if there is no such associated
   // file.
+  //
+  // Associated files are extracted lazily, upon first access. Files stored
+  // uncompressed in the zip archive (which is what the metadata populators
+  // produce) are never copied: the returned string_view points directly into
+  // the model buffer provided at creation time. Compressed files are inflated
+  // once, and then cached for the lifetime of this object. In both cases the
+  // returned string_view is valid as long as this object (and the model
+  // buffer) are alive.
+  //
+  // This method is thread-safe.
   tflite::support::StatusOr<absl::string_view> GetAssociatedFile(
       const std::string& filename) const;
 
@@ -137,18 +157,38 @@ class ModelMetadataExtractor {
   ModelMetadataExtractor() = default;
   // Initializes the ModelMetadataExtractor from the provided Model FlatBuffer.
   absl::Status InitFromModelBuffer(const char* buffer_data, size_t buffer_size);
-  // Extracts and stores in associated_files_ the associated files (if present)
-  // packed into the model FlatBuffer data.
+  // Indexes in associated_files_ the associated files (if present) packed
+  // into the model FlatBuffer data, without reading their contents.
   absl::Status ExtractAssociatedFiles(const char* buffer_data,
                                       size_t buffer_size);
+  // An associated file, as indexed by ExtractAssociatedFiles().
+  struct AssociatedFile {
+    // The index of the file in zip_archive_.
+    int64_t index;
+    // The uncompressed size of the file, in bytes.
+    uint64_t size;
+    // Points to the file contents in the model buffer if the file is stored
+    // uncompressed, nullptr otherwise.
+    const char* stored_data;
+    // The inflated file contents, if the file is compressed and has already
+    // been accessed. Guarded by zip_mutex_.
+    mutable std::unique_ptr<std::string> inflated_data;
+  };
   // Pointer to the TFLite Model object from which to read the ModelMetadata.
   const tflite::Model* model_{nullptr};
   // Pointer to the extracted ModelMetadata, if any.
   const tflite::ModelMetadata* model_metadata_{nullptr};
   // The files associated with the ModelMetadata, as a map with the filename
-  // (corresponding to a basename, e.g. "labels.txt") as key and the file
-  // contents as value.
-  absl::flat_hash_map<std::string, std::string> associated_files_;
+  // (corresponding to a basename, e.g. "labels.txt") as key. Never modified
+  // after initialization, apart from the lazily inflated contents.
+  absl::flat_hash_map<std::string, AssociatedFile> associated_files_;
+  // The zip archive appended to the model buffer, kept open for lazily
+  // inflating compressed associated files, or nullptr if there is none or all
+  // associated files are stored uncompressed.
+  zip* zip_archive_{nullptr};
+  // Guards accesses to zip_archive_, which is not thread-safe, and to the
+  // lazily inflated contents.
+  mutable absl::Mutex zip_mutex_;
 };
 
 }  // namespace metadata
@@ -0,0 +1,218 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "contrib/minizip/ioapi.h"
+#include "contrib/minizip/zip.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/metadata/cc/utils/zip_mem_file.h"
+#include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
+
+namespace tflite {
+namespace metadata {
+namespace {
+
+constexpr char kLabelsName[] = "labels.txt";
+constexpr char kLabels[] = "cat\ndog\nbird\n";
+
+// Returns a model without subgraphs, holding a minimal ModelMetadata.
+std::string BuildModelWithMetadata() {
+  flatbuffers::FlatBufferBuilder metadata_builder;
+  const auto name = metadata_builder.CreateString("test model");
+  tflite::ModelMetadataBuilder model_metadata_builder(metadata_builder);
+  model_metadata_builder.add_name(name);
+  tflite::FinishModelMetadataBuffer(metadata_builder,
+                                    model_metadata_builder.Finish());
+
+  tflite::ModelT model;
+  model.version = 3;
+  model.buffers.push_back(absl::make_unique<tflite::BufferT>());
+  auto metadata_buffer = absl::make_unique<tflite::BufferT>();
+  metadata_buffer->data.assign(
+      metadata_builder.GetBufferPointer(),
+      metadata_builder.GetBufferPointer() + metadata_builder.GetSize());
+  model.buffers.push_back(std::move(metadata_buffer));
+  auto metadata = absl::make_unique<tflite::MetadataT>();
+  metadata->name = "TFLITE_METADATA";
+  metadata->buffer = 1;
+  model.metadata.push_back(std::move(metadata));
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(tflite::Model::Pack(builder, &model),
+                 tflite::ModelIdentifier());
+  return std::string(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Appends to `model` a zip archive holding `files`, as (name, contents) pairs,
+// compressed with `method`: 0 to store them, Z_DEFLATED to deflate them.
+std::string AppendZip(
+    const std::string& model,
+    const std::vector<std::pair<std::string, std::string>>& files,
+    int method) {
+  ZipMemFile mem_file(model.data(), model.size());
+  zipFile zf = zipOpen2(/*pathname=*/nullptr, APPEND_STATUS_CREATEAFTER,
+                        /*globalcomment=*/nullptr, &mem_file.GetFileFuncDef());
+  EXPECT_NE(zf, nullptr);
+  for (const auto& file : files) {
+    EXPECT_EQ(zipOpenNewFileInZip(zf, file.first.c_str(), /*zipfi=*/nullptr,
+                                  /*extrafield_local=*/nullptr,
+                                  /*size_extrafield_local=*/0,
+                                  /*extrafield_global=*/nullptr,
+                                  /*size_extrafield_global=*/0,
+                                  /*comment=*/nullptr, method,
+                                  /*level=*/Z_DEFAULT_COMPRESSION),
+              ZIP_OK);
+    EXPECT_EQ(
+        zipWriteInFileInZip(zf, file.second.data(), file.second.size()),
+        ZIP_OK);
+    EXPECT_EQ(zipCloseFileInZip(zf), ZIP_OK);
+  }
+  EXPECT_EQ(zipClose(zf, /*global_comment=*/nullptr), ZIP_OK);
+  return std::string(mem_file.GetFileContent());
+}
+
+// Returns the offset of the data of the first file of the zip archive starting
+// at `archive_offset` in `buffer`.
+size_t FindFirstFileData(const std::string& buffer, size_t archive_offset) {
+  const size_t local_header = buffer.find("PK\x03\x04", archive_offset);
+  EXPECT_NE(local_header, std::string::npos);
+  auto read_uint16 = [&buffer](size_t offset) {
+    return static_cast<uint8_t>(buffer[offset]) |
+           (static_cast<uint8_t>(buffer[offset + 1]) << 8);
+  };
+  return local_header + 30 + read_uint16(local_header + 26) +
+         read_uint16(local_header + 28);
+}
+
+// Returns whether `data` points inside `buffer`.
+bool PointsInto(absl::string_view data, const std::string& buffer) {
+  return data.data() >= buffer.data() &&
+         data.data() + data.size() <= buffer.data() + buffer.size();
+}
+
+TEST(ModelMetadataExtractorTest, ReturnsStoredFilesWithoutCopy) {
+  const std::string model = AppendZip(
+      BuildModelWithMetadata(),
+      {{kLabelsName, kLabels}, {"vocab.txt", "hello\nworld\n"}}, /*method=*/0);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::string_view labels,
+                               extractor->GetAssociatedFile(kLabelsName));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::string_view vocab,
+                               extractor->GetAssociatedFile("vocab.txt"));
+
+  EXPECT_EQ(labels, kLabels);
+  EXPECT_EQ(labels.data(), model.data() + model.find(kLabels));
+  EXPECT_EQ(vocab, "hello\nworld\n");
+  EXPECT_TRUE(PointsInto(vocab, model));
+}
+
+TEST(ModelMetadataExtractorTest, InflatesDeflatedFilesOnFirstAccess) {
+  const std::string model_without_zip = BuildModelWithMetadata();
+  std::string model = AppendZip(model_without_zip, {{kLabelsName, kLabels}},
+                                /*method=*/Z_DEFLATED);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+  // The extractor reads from the model buffer: corrupting the deflated data
+  // now makes any later inflation fail (0xff starts an invalid block).
+  model[FindFirstFileData(model, model_without_zip.size())] = '\xff';
+
+  EXPECT_FALSE(extractor->GetAssociatedFile(kLabelsName).ok());
+}
+
+TEST(ModelMetadataExtractorTest, InflatesDeflatedFilesOnlyOnce) {
+  const std::string model_without_zip = BuildModelWithMetadata();
+  std::string model = AppendZip(model_without_zip, {{kLabelsName, kLabels}},
+                                /*method=*/Z_DEFLATED);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::string_view first,
+                               extractor->GetAssociatedFile(kLabelsName));
+  EXPECT_EQ(first, kLabels);
+  EXPECT_FALSE(PointsInto(first, model));
+  // The inflated contents are cached: the deflated data is not read again.
+  model[FindFirstFileData(model, model_without_zip.size())] = '\xff';
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::string_view second,
+                               extractor->GetAssociatedFile(kLabelsName));
+
+  EXPECT_EQ(second.data(), first.data());
+  EXPECT_EQ(second, kLabels);
+}
+
+TEST(ModelMetadataExtractorTest, FailsWithUnknownFile) {
+  const std::string model = AppendZip(BuildModelWithMetadata(),
+                                      {{kLabelsName, kLabels}}, /*method=*/0);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+
+  EXPECT_EQ(extractor->GetAssociatedFile("vocab.txt").status().code(),
+            absl::StatusCode::kNotFound);
+}
+
+TEST(ModelMetadataExtractorTest, SucceedsWithoutArchive) {
+  const std::string model = BuildModelWithMetadata();
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+
+  ASSERT_NE(extractor->GetModelMetadata(), nullptr);
+  EXPECT_EQ(extractor->GetAssociatedFile(kLabelsName).status().code(),
+            absl::StatusCode::kNotFound);
+}
+
+TEST(ModelMetadataExtractorTest, SucceedsWithTruncatedEndOfCentralDirectory) {
+  std::string model = AppendZip(BuildModelWithMetadata(),
+                                {{kLabelsName, kLabels}}, /*method=*/0);
+  // Cuts the end of central directory record in the middle.
+  model.resize(model.size() - 10);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModelMetadataExtractor> extractor,
+      ModelMetadataExtractor::CreateFromModelBuffer(model.data(),
+                                                    model.size()));
+
+  EXPECT_EQ(extractor->GetAssociatedFile(kLabelsName).status().code(),
+            absl::StatusCode::kNotFound);
+}
+
+}  // namespace
+}  // namespace metadata
+}  // namespace tflite
@@ -0,0 +1,239 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/metadata/cc/utils/zip_stored_files.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace metadata {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::Key;
+using ::testing::UnorderedElementsAre;
+
+constexpr char kPrefix[] = "not a zip archive";
+
+struct ZipEntry {
+  std::string name;
+  std::string contents;
+  uint16_t compression_method = 0;
+  uint16_t flags = 0;
+};
+
+void AppendUint16(uint16_t value, std::string* data) {
+  data->push_back(static_cast<char>(value & 0xff));
+  data->push_back(static_cast<char>(value >> 8));
+}
+
+void AppendUint32(uint32_t value, std::string* data) {
+  AppendUint16(value & 0xffff, data);
+  AppendUint16(value >> 16, data);
+}
+
+// Returns the end of central directory record of an archive.
+std::string BuildEndOfCentralDirectory(uint16_t num_entries,
+                                       uint32_t central_directory_size,
+                                       uint32_t central_directory_offset,
+                                       const std::string& comment) {
+  std::string eocd;
+  AppendUint32(0x06054b50, &eocd);
+  AppendUint32(0, &eocd);  // Disk numbers.
+  AppendUint16(num_entries, &eocd);
+  AppendUint16(num_entries, &eocd);
+  AppendUint32(central_directory_size, &eocd);
+  AppendUint32(central_directory_offset, &eocd);
+  AppendUint16(comment.size(), &eocd);
+  return eocd + comment;
+}
+
+// Returns `prefix` followed by a zip archive holding `entries`, written as is
+// whatever their compression method. The offsets recorded in the archive are
+// relative to its start, plus `offset_base`. CRCs are left to 0, as they are
+// not checked.
+std::string BuildBufferWithZip(const std::string& prefix,
+                               const std::vector<ZipEntry>& entries,
+                               uint32_t offset_base = 0,
+                               const std::string& comment = "") {
+  std::string archive;
+  std::string central_directory;
+  for (const ZipEntry& entry : entries) {
+    const uint32_t local_header_offset = offset_base + archive.size();
+    AppendUint32(0x04034b50, &archive);
+    AppendUint16(10, &archive);  // Version needed to extract.
+    AppendUint16(entry.flags, &archive);
+    AppendUint16(entry.compression_method, &archive);
+    AppendUint32(0, &archive);  // Modification time and date.
+    AppendUint32(0, &archive);  // CRC.
+    AppendUint32(entry.contents.size(), &archive);
+    AppendUint32(entry.contents.size(), &archive);
+    AppendUint16(entry.name.size(), &archive);
+    AppendUint16(0, &archive);  // Extra field length.
+    archive += entry.name + entry.contents;
+
+    AppendUint32(0x02014b50, &central_directory);
+    AppendUint16(10, &central_directory);  // Version made by.
+    AppendUint16(10, &central_directory);  // Version needed to extract.
+    AppendUint16(entry.flags, &central_directory);
+    AppendUint16(entry.compression_method, &central_directory);
+    AppendUint32(0, &central_directory);  // Modification time and date.
+    AppendUint32(0, &central_directory);  // CRC.
+    AppendUint32(entry.contents.size(), &central_directory);
+    AppendUint32(entry.contents.size(), &central_directory);
+    AppendUint16(entry.name.size(), &central_directory);
+    AppendUint16(0, &central_directory);  // Extra field length.
+    AppendUint16(0, &central_directory);  // Comment length.
+    AppendUint32(0, &central_directory);  // Disk number and internal attrs.
+    AppendUint32(0, &central_directory);  // External attributes.
+    AppendUint32(local_header_offset, &central_directory);
+    central_directory += entry.name;
+  }
+  const uint32_t central_directory_offset = offset_base + archive.size();
+  return prefix + archive + central_directory +
+         BuildEndOfCentralDirectory(entries.size(), central_directory.size(),
+                                    central_directory_offset, comment);
+}
+
+std::vector<ZipEntry> GetStoredEntries() {
+  return {{"labels.txt", "cat\ndog\n"}, {"vocab.txt", "hello\nworld\n"}};
+}
+
+TEST(FindStoredZipFilesTest, FindsFilesWithoutCopy) {
+  const std::string buffer = BuildBufferWithZip(kPrefix, GetStoredEntries());
+
+  const auto stored_files = FindStoredZipFiles(buffer.data(), buffer.size());
+
+  ASSERT_THAT(stored_files,
+              UnorderedElementsAre(Key("labels.txt"), Key("vocab.txt")));
+  const absl::string_view labels = stored_files.at("labels.txt");
+  EXPECT_EQ(labels, "cat\ndog\n");
+  EXPECT_EQ(labels.data(), buffer.data() + buffer.find("cat\ndog\n"));
+  const absl::string_view vocab = stored_files.at("vocab.txt");
+  EXPECT_EQ(vocab, "hello\nworld\n");
+  EXPECT_EQ(vocab.data(), buffer.data() + buffer.find("hello\nworld\n"));
+}
+
+TEST(FindStoredZipFilesTest, FindsFilesWithOffsetsFromBufferStart) {
+  // Archives appended to a model may record offsets from the model start.
+  const std::string buffer =
+      BuildBufferWithZip(kPrefix, GetStoredEntries(),
+                         /*offset_base=*/sizeof(kPrefix) - 1);
+
+  const auto stored_files = FindStoredZipFiles(buffer.data(), buffer.size());
+
+  ASSERT_EQ(stored_files.size(), 2);
+  EXPECT_EQ(stored_files.at("labels.txt"), "cat\ndog\n");
+  EXPECT_EQ(stored_files.at("vocab.txt"), "hello\nworld\n");
+}
+
+TEST(FindStoredZipFilesTest, FindsFilesInArchiveWithComment) {
+  const std::string buffer =
+      BuildBufferWithZip(kPrefix, GetStoredEntries(), /*offset_base=*/0,
+                         /*comment=*/"a comment");
+
+  EXPECT_EQ(FindStoredZipFiles(buffer.data(), buffer.size()).size(), 2);
+}
+
+TEST(FindStoredZipFilesTest, SkipsCompressedAndEncryptedFiles) {
+  const std::string buffer = BuildBufferWithZip(
+      kPrefix, {{"stored.txt", "stored"},
+                {"deflated.txt", "deflated", /*compression_method=*/8},
+                {"encrypted.txt", "encrypted", /*compression_method=*/0,
+                 /*flags=*/1}});
+
+  const auto stored_files = FindStoredZipFiles(buffer.data(), buffer.size());
+
+  EXPECT_THAT(stored_files, UnorderedElementsAre(Key("stored.txt")));
+}
+
+TEST(FindStoredZipFilesTest, FindsNothingWithoutEndOfCentralDirectory) {
+  const std::string buffer(100, 'x');
+  // Includes buffers shorter than the end of central directory record.
+  for (size_t size = 0; size <= buffer.size(); ++size) {
+    EXPECT_THAT(FindStoredZipFiles(buffer.data(), size), IsEmpty())
+        << "for size " << size;
+  }
+}
+
+TEST(FindStoredZipFilesTest, FindsNothingWithTruncatedEndOfCentralDirectory) {
+  const std::string buffer = BuildBufferWithZip(kPrefix, GetStoredEntries());
+  // Removes from 1 byte to the whole record (22 bytes).
+  for (size_t removed = 1; removed <= 22; ++removed) {
+    EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size() - removed),
+                IsEmpty())
+        << "with " << removed << " bytes removed";
+  }
+}
+
+TEST(FindStoredZipFilesTest, FindsNothingWithTruncatedComment) {
+  std::string buffer =
+      BuildBufferWithZip(kPrefix, GetStoredEntries(), /*offset_base=*/0,
+                         /*comment=*/"a comment");
+  buffer.pop_back();
+
+  EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size()), IsEmpty());
+}
+
+TEST(FindStoredZipFilesTest, HandlesEndOfCentralDirectoryNearBufferStart) {
+  // An empty archive is just the end of central directory record, which may
+  // then start anywhere in the first 22 bytes of the buffer.
+  for (size_t offset = 0; offset <= 22; ++offset) {
+    const std::string buffer =
+        std::string(offset, 'x') +
+        BuildEndOfCentralDirectory(/*num_entries=*/0,
+                                   /*central_directory_size=*/0,
+                                   /*central_directory_offset=*/0,
+                                   /*comment=*/"");
+    EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size()), IsEmpty())
+        << "for offset " << offset;
+  }
+  // A record followed by a comment longer than what precedes it.
+  const std::string buffer =
+      "x" + BuildEndOfCentralDirectory(0, 0, 0, std::string(100, 'c'));
+  EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size()), IsEmpty());
+}
+
+TEST(FindStoredZipFilesTest, FindsNothingWithOutOfBoundsCentralDirectory) {
+  for (const std::string& eocd :
+       {// Central directory larger than the data preceding the record.
+        BuildEndOfCentralDirectory(/*num_entries=*/1,
+                                   /*central_directory_size=*/1000,
+                                   /*central_directory_offset=*/0, ""),
+        // Central directory offset past the start of the buffer.
+        BuildEndOfCentralDirectory(/*num_entries=*/1,
+                                   /*central_directory_size=*/0,
+                                   /*central_directory_offset=*/1000, "")}) {
+    const std::string buffer = kPrefix + eocd;
+    EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size()), IsEmpty());
+  }
+}
+
+TEST(FindStoredZipFilesTest, SkipsFilesWithOutOfBoundsData) {
+  std::string buffer = BuildBufferWithZip(kPrefix, {{"labels.txt", "cat"}});
+  // Makes the local header claim a name far longer than the archive.
+  buffer[sizeof(kPrefix) - 1 + 26] = '\xff';
+
+  EXPECT_THAT(FindStoredZipFiles(buffer.data(), buffer.size()), IsEmpty());
+}
+
+}  // namespace
+}  // namespace metadata
+}  // namespace tflite
@@ -0,0 +1,143 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/metadata/cc/utils/zip_stored_files.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace tflite {
+namespace metadata {
+
+namespace {
+
+// Zip format constants, see:
+// https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+constexpr uint32_t kLocalFileHeaderSignature = 0x04034b50;
+constexpr size_t kLocalFileHeaderSize = 30;
+constexpr uint32_t kCentralDirectoryHeaderSignature = 0x02014b50;
+constexpr size_t kCentralDirectoryHeaderSize = 46;
+constexpr uint32_t kEndOfCentralDirectorySignature = 0x06054b50;
+constexpr size_t kEndOfCentralDirectorySize = 22;
+constexpr size_t kMaxZipCommentSize = 0xFFFF;
+constexpr uint16_t kStoredCompressionMethod = 0;
+constexpr uint16_t kEncryptedFlag = 0x1;
+constexpr uint32_t kZip64Marker = 0xFFFFFFFF;
+
+// Reads little-endian integers from (possibly unaligned) zip records.
+uint16_t ReadUint16(const char* data) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  return bytes[0] | (bytes[1] << 8);
+}
+uint32_t ReadUint32(const char* data) {
+  return ReadUint16(data) | (static_cast<uint32_t>(ReadUint16(data + 2)) << 16);
+}
+
+}  // namespace
+
+absl::flat_hash_map<std::string, absl::string_view> FindStoredZipFiles(
+    const char* buffer_data, size_t buffer_size) {
+  absl::flat_hash_map<std::string, absl::string_view> stored_files;
+  if (buffer_size < kEndOfCentralDirectorySize) {
+    return stored_files;
+  }
+  // Look for the end of central directory record, which is followed by a
+  // variable-length comment.
+  // The scan works on offsets so as to never form a pointer before the start
+  // of the buffer.
+  const char* eocd = nullptr;
+  const size_t min_offset =
+      buffer_size -
+      std::min(buffer_size, kEndOfCentralDirectorySize + kMaxZipCommentSize);
+  for (size_t offset = buffer_size - kEndOfCentralDirectorySize;; --offset) {
+    const char* p = buffer_data + offset;
+    if (ReadUint32(p) == kEndOfCentralDirectorySignature &&
+        offset + kEndOfCentralDirectorySize + ReadUint16(p + 20) ==
+            buffer_size) {
+      eocd = p;
+      break;
+    }
+    if (offset == min_offset) {
+      break;
+    }
+  }
+  if (eocd == nullptr) {
+    return stored_files;
+  }
+  const uint16_t num_entries = ReadUint16(eocd + 10);
+  const uint32_t central_directory_size = ReadUint32(eocd + 12);
+  const uint32_t central_directory_offset = ReadUint32(eocd + 16);
+  if (central_directory_size > static_cast<size_t>(eocd - buffer_data)) {
+    return stored_files;
+  }
+  // The archive is appended to the model: offsets recorded in the zip records
+  // may be relative to the start of the archive rather than to the start of
+  // the buffer. Deduce the shift from the actual central directory location.
+  const char* central_directory = eocd - central_directory_size;
+  if (central_directory_offset >
+      static_cast<size_t>(central_directory - buffer_data)) {
+    return stored_files;
+  }
+  const char* archive_start = central_directory - central_directory_offset;
+
+  const char* entry = central_directory;
+  for (int i = 0; i < num_entries; ++i) {
+    if (entry + kCentralDirectoryHeaderSize > eocd ||
+        ReadUint32(entry) != kCentralDirectoryHeaderSignature) {
+      break;
+    }
+    const uint16_t flags = ReadUint16(entry + 8);
+    const uint16_t compression_method = ReadUint16(entry + 10);
+    const uint32_t compressed_size = ReadUint32(entry + 20);
+    const uint32_t uncompressed_size = ReadUint32(entry + 24);
+    const uint16_t name_length = ReadUint16(entry + 28);
+    const uint16_t extra_length = ReadUint16(entry + 30);
+    const uint16_t comment_length = ReadUint16(entry + 32);
+    const uint32_t local_header_offset = ReadUint32(entry + 42);
+    const char* name = entry + kCentralDirectoryHeaderSize;
+    entry = name + name_length + extra_length + comment_length;
+    if (entry > eocd) {
+      break;
+    }
+    if (compression_method != kStoredCompressionMethod ||
+        (flags & kEncryptedFlag) != 0 ||
+        compressed_size != uncompressed_size ||
+        uncompressed_size == kZip64Marker ||
+        local_header_offset == kZip64Marker ||
+        local_header_offset + kLocalFileHeaderSize >
+            static_cast<size_t>(central_directory - archive_start)) {
+      continue;
+    }
+    const char* local_header = archive_start + local_header_offset;
+    if (ReadUint32(local_header) != kLocalFileHeaderSignature) {
+      continue;
+    }
+    const size_t data_offset = local_header_offset + kLocalFileHeaderSize +
+                               ReadUint16(local_header + 26) +
+                               ReadUint16(local_header + 28);
+    const size_t archive_size = central_directory - archive_start;
+    if (data_offset > archive_size ||
+        uncompressed_size > archive_size - data_offset) {
+      continue;
+    }
+    const char* data = archive_start + data_offset;
+    stored_files.emplace(std::string(name, name_length),
+                         absl::string_view(data, uncompressed_size));
+  }
+  return stored_files;
+}
+
+}  // namespace metadata
+}  // namespace tflite
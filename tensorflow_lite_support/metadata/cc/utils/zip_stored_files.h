@@ -0,0 +1,40 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_METADATA_CC_UTILS_ZIP_STORED_FILES_H_
+#define TENSORFLOW_LITE_SUPPORT_METADATA_CC_UTILS_ZIP_STORED_FILES_H_
+
+#include <cstddef>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+
+namespace tflite {
+namespace metadata {
+
+// Locates the files stored uncompressed in the zip archive appended to the
+// provided buffer, and returns a map from their names to their contents. The
+// lookup relies on the zip central directory only and does not copy any data.
+// Any file that can't be resolved this way (compressed, encrypted, zip64, or
+// malformed records) is simply absent from the returned map, and must be read
+// through libzip instead.
+absl::flat_hash_map<std::string, absl::string_view> FindStoredZipFiles(
+    const char* buffer_data, size_t buffer_size);
+
+}  // namespace metadata
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_METADATA_CC_UTILS_ZIP_STORED_FILES_H_